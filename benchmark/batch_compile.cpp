@@ -0,0 +1,126 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+#include <options.h>
+
+#include <benchmark/benchmark.h>
+
+#include <c10/util/irange.h>
+
+#include <cuda_runtime.h>
+
+#include <benchmark/utils.h>
+#include <test/utils.h>
+
+using namespace nvfuser;
+
+// Warm-up time of a fusion with many segments, i.e., the time of the first
+// call including the scheduling and compilation of every segment. The
+// kernels are compiled one NVRTC program each, or in batches of one program.
+
+static void BatchCompile_WarmUp(
+    benchmark::State& benchmark_state,
+    bool batch_compile) {
+  EnableOptionsGuard opt_guard;
+  if (batch_compile) {
+    EnableOptionsGuard::getCurOptions().set(EnableOption::BatchCompile);
+  }
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<c10::IValue> aten_inputs = {at::randn({8, 128}, options)};
+
+  for (auto _ : benchmark_state) {
+    // A new cache has to compile all of its segments again
+    benchmark_state.PauseTiming();
+    auto fec = makeSegmentChain(benchmark_state.range(0));
+    benchmark_state.ResumeTiming();
+
+    fec->runFusionWithInputs(aten_inputs);
+    C10_CUDA_CHECK(cudaDeviceSynchronize());
+  }
+}
+
+static void NvFuserScheduler_BatchCompile_Eager(
+    benchmark::State& benchmark_state) {
+  BatchCompile_WarmUp(benchmark_state, false);
+}
+
+static void NvFuserScheduler_BatchCompile_Batched(
+    benchmark::State& benchmark_state) {
+  BatchCompile_WarmUp(benchmark_state, true);
+}
+
+BENCHMARK(NvFuserScheduler_BatchCompile_Eager)
+    ->Arg(16)
+    ->Arg(64)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(NvFuserScheduler_BatchCompile_Batched)
+    ->Arg(16)
+    ->Arg(64)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Warm-up time of a model-sized set of fusions of one to four segments,
+// compiled one cache at a time by their first call, or together by
+// FusionExecutorCache::compileFusionsBatch, which batches the kernels of all
+// the caches.
+
+static void BatchCompile_WarmUpCaches(
+    benchmark::State& benchmark_state,
+    bool across_caches) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::BatchCompile);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<c10::IValue> aten_inputs = {at::randn({8, 128}, options)};
+
+  for (auto _ : benchmark_state) {
+    benchmark_state.PauseTiming();
+    std::vector<std::unique_ptr<FusionExecutorCache>> fecs;
+    std::vector<std::pair<FusionExecutorCache*, std::vector<c10::IValue>>>
+        fusions;
+    for (auto i : c10::irange(benchmark_state.range(0))) {
+      fecs.push_back(makeSegmentChain(1 + i % 4));
+      fusions.emplace_back(fecs.back().get(), aten_inputs);
+    }
+    benchmark_state.ResumeTiming();
+
+    if (across_caches) {
+      FusionExecutorCache::compileFusionsBatch(fusions);
+    } else {
+      for (auto& fec : fecs) {
+        fec->runFusionWithInputs(aten_inputs);
+      }
+    }
+    C10_CUDA_CHECK(cudaDeviceSynchronize());
+  }
+}
+
+static void NvFuserScheduler_BatchCompile_PerCache(
+    benchmark::State& benchmark_state) {
+  BatchCompile_WarmUpCaches(benchmark_state, false);
+}
+
+static void NvFuserScheduler_BatchCompile_AcrossCaches(
+    benchmark::State& benchmark_state) {
+  BatchCompile_WarmUpCaches(benchmark_state, true);
+}
+
+BENCHMARK(NvFuserScheduler_BatchCompile_PerCache)
+    ->Arg(16)
+    ->Arg(64)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(NvFuserScheduler_BatchCompile_AcrossCaches)
+    ->Arg(16)
+    ->Arg(64)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,116 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <device_lower/lower2device.h>
+#include <fusion.h>
+#include <inlining.h>
+#include <ir/all_nodes.h>
+#include <ir/builder.h>
+#include <ir/utils.h>
+#include <ops/all_ops.h>
+
+#include <benchmark/benchmark.h>
+
+#include <benchmark/utils.h>
+#include <test/utils.h>
+
+using namespace nvfuser;
+
+// Host-side benchmarks of the creation, copy and lowering of large fusions,
+// which are dominated by the allocation and registration of IR nodes.
+
+//------------------------------------------------------------------------------
+
+// Builds a chain of num_layers pointwise layers, each followed by a
+// reduction and a broadcast, so that the fusion has a few nodes of every kind
+static void setupLargeFusion(Fusion* fusion, int64_t num_layers) {
+  FusionGuard fg(fusion);
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+
+  TensorView* x = tv0;
+  for (auto i : c10::irange(num_layers)) {
+    auto y = add(mul(x, tv1), IrBuilder::create<Val>((double)i));
+    y = exp(y);
+    auto z = broadcast(sum(y, {1}), {false, true});
+    x = div(y, z);
+  }
+  fusion->addOutput(x);
+}
+
+static void NvFuserScheduler_IrContainer_Build(
+    benchmark::State& benchmark_state) {
+  for (auto _ : benchmark_state) {
+    Fusion fusion;
+    setupLargeFusion(&fusion, benchmark_state.range(0));
+  }
+}
+
+static void NvFuserScheduler_IrContainer_FusionCopy(
+    benchmark::State& benchmark_state) {
+  Fusion fusion;
+  setupLargeFusion(&fusion, benchmark_state.range(0));
+
+  for (auto _ : benchmark_state) {
+    Fusion copy(fusion);
+    benchmark::DoNotOptimize(copy.vals().size());
+  }
+  benchmark_state.counters["vals"] = (double)fusion.vals().size();
+  benchmark_state.counters["exprs"] = (double)fusion.unordered_exprs().size();
+}
+
+static void NvFuserScheduler_IrContainer_Lower(
+    benchmark::State& benchmark_state) {
+  Fusion fusion;
+  setupLargeFusion(&fusion, benchmark_state.range(0));
+  {
+    FusionGuard fg(&fusion);
+    inlineMost();
+  }
+
+  for (auto _ : benchmark_state) {
+    GpuLower gpu_lower(&fusion);
+  }
+}
+
+// Topological queries repeated by the schedulers between two mutations of
+// the fusion
+static void NvFuserScheduler_IrContainer_GraphQueries(
+    benchmark::State& benchmark_state) {
+  Fusion fusion;
+  setupLargeFusion(&fusion, benchmark_state.range(0));
+  FusionGuard fg(&fusion);
+
+  for (auto _ : benchmark_state) {
+    benchmark::DoNotOptimize(fusion.exprs().size());
+    benchmark::DoNotOptimize(ir_utils::allTvs(&fusion).size());
+  }
+}
+
+BENCHMARK(NvFuserScheduler_IrContainer_Build)
+    ->RangeMultiplier(10)
+    ->Range(10, 1000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(NvFuserScheduler_IrContainer_FusionCopy)
+    ->RangeMultiplier(10)
+    ->Range(10, 1000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(NvFuserScheduler_IrContainer_Lower)
+    ->RangeMultiplier(10)
+    ->Range(10, 100)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(NvFuserScheduler_IrContainer_GraphQueries)
+    ->RangeMultiplier(10)
+    ->Range(10, 1000)
+    ->Unit(benchmark::kMicrosecond);
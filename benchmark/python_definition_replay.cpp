@@ -0,0 +1,95 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <ops/all_ops.h>
+#include <options.h>
+#include <python_frontend/fusion_cache.h>
+#include <python_frontend/fusion_definition.h>
+#include <python_frontend/fusion_record.h>
+
+#include <benchmark/benchmark.h>
+
+#include <benchmark/utils.h>
+
+using namespace nvfuser;
+using namespace nvfuser::python_frontend;
+
+// Host time of replaying a python definition already in the FusionCache,
+// i.e., recording its operations and looking it up, as done by a model that
+// rebuilds its definition at every step. The records are looked up in the
+// trie one at a time, or the whole definition is looked up by its hash.
+
+namespace {
+
+// Records a chain of num_ops negations of a 2D tensor
+void defineChain(FusionDefinition& fd, int64_t num_ops) {
+  fd.setupDefinition();
+  auto tv = fd.defineTensor(2);
+  fd.defineRecord(new TensorRecord(
+      {fd.recordingState(tv())}, {-1, -1}, {true, true}, DataType::Float));
+  for (auto i : c10::irange(num_ops)) {
+    (void)i;
+    auto out = fd.defineTensor(2);
+    fd.defineRecord(new OpRecord<TensorView*, TensorView*>(
+        {fd.recordingState(tv())},
+        {fd.recordingState(out())},
+        "ops.neg",
+        serde::RecordType_Unary_TV,
+        static_cast<TensorView* (*)(TensorView*)>(neg)));
+    tv = out;
+  }
+  fd.defineRecord(new OutputRecord<TensorView>(
+      {fd.recordingState(tv())}, serde::RecordType_OutputTv));
+  fd.finalizeDefinition();
+}
+
+} // namespace
+
+static void PythonDefinition_Replay(
+    benchmark::State& benchmark_state,
+    bool hash_lookup) {
+  EnableOptionsGuard opt_guard;
+  if (hash_lookup) {
+    EnableOptionsGuard::getCurOptions().set(
+        EnableOption::DefinitionHashLookup);
+  }
+  const auto num_ops = benchmark_state.range(0);
+  const size_t max_length = num_ops + 2;
+
+  FusionCache::reset();
+  {
+    FusionDefinition fd(std::nullopt, max_length);
+    defineChain(fd, num_ops);
+  }
+
+  for (auto _ : benchmark_state) {
+    FusionDefinition fd(std::nullopt, max_length);
+    defineChain(fd, num_ops);
+    NVF_ERROR(fd.id().value() == 0);
+  }
+  benchmark_state.SetItemsProcessed(benchmark_state.iterations() * num_ops);
+}
+
+static void NvFuserScheduler_PythonDefinition_TrieWalk(
+    benchmark::State& benchmark_state) {
+  PythonDefinition_Replay(benchmark_state, false);
+}
+
+static void NvFuserScheduler_PythonDefinition_HashLookup(
+    benchmark::State& benchmark_state) {
+  PythonDefinition_Replay(benchmark_state, true);
+}
+
+BENCHMARK(NvFuserScheduler_PythonDefinition_TrieWalk)
+    ->Arg(16)
+    ->Arg(256)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_PythonDefinition_HashLookup)
+    ->Arg(16)
+    ->Arg(256)
+    ->Unit(benchmark::kMicrosecond);
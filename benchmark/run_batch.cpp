@@ -0,0 +1,104 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+
+#include <benchmark/benchmark.h>
+
+#include <benchmark/utils.h>
+#include <test/utils.h>
+
+using namespace nvfuser;
+
+// Host time per set of inputs of running a small pointwise fusion over a
+// batch of sets, one runFusionWithInputs call per set or one
+// runFusionWithInputsBatch call for the batch. Kernel launches are disabled,
+// so the difference is the encoding and lookup of the inputs that the batch
+// skips for the sets of a signature it already saw.
+
+namespace {
+
+std::unique_ptr<FusionExecutorCache> makeBatchFusion() {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(2);
+  auto s2 = IrBuilder::create<Val>(DataType::Double);
+  fusion_ptr->addInput(tv0);
+  fusion_ptr->addInput(tv1);
+  fusion_ptr->addInput(s2);
+  fusion_ptr->addOutput(add(mul(tv0, s2), tv1));
+
+  return std::make_unique<FusionExecutorCache>(std::move(fusion_ptr));
+}
+
+// The sets of the batch alternate between num_signatures shapes
+std::vector<std::vector<c10::IValue>> makeBatch(
+    int64_t batch_size,
+    int64_t num_signatures) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<std::vector<c10::IValue>> batch;
+  for (auto i : c10::irange(batch_size)) {
+    auto rows = 8 * (i % num_signatures + 1);
+    batch.push_back(
+        {at::randn({rows, 128}, options),
+         at::randn({rows, 128}, options),
+         (double)i});
+  }
+  return batch;
+}
+
+} // namespace
+
+static void RunBatch_NoLaunch(
+    benchmark::State& benchmark_state,
+    bool use_batch) {
+  auto fec = makeBatchFusion();
+  auto batch = makeBatch(benchmark_state.range(0), benchmark_state.range(1));
+
+  // Compile the kernels of all the signatures
+  fec->runFusionWithInputsBatch(batch);
+  fec->disableKernelLaunch();
+
+  for (auto _ : benchmark_state) {
+    if (use_batch) {
+      fec->runFusionWithInputsBatch(batch);
+    } else {
+      for (const auto& inputs : batch) {
+        fec->runFusionWithInputs(inputs);
+      }
+    }
+  }
+  benchmark_state.SetItemsProcessed(
+      benchmark_state.iterations() * benchmark_state.range(0));
+}
+
+static void NvFuserScheduler_RunBatch_PerSet(
+    benchmark::State& benchmark_state) {
+  RunBatch_NoLaunch(benchmark_state, false);
+}
+
+static void NvFuserScheduler_RunBatch_Batch(
+    benchmark::State& benchmark_state) {
+  RunBatch_NoLaunch(benchmark_state, true);
+}
+
+BENCHMARK(NvFuserScheduler_RunBatch_PerSet)
+    ->Args({16, 1})
+    ->Args({64, 1})
+    ->Args({64, 4})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_RunBatch_Batch)
+    ->Args({16, 1})
+    ->Args({64, 1})
+    ->Args({64, 4})
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,88 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <fusion.h>
+#include <kernel_cache.h>
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <benchmark/utils.h>
+#include <test/utils.h>
+
+using namespace nvfuser;
+
+// Heap allocations of the host runtime. The global operator new is replaced
+// to count them, so these benchmarks are built as their own binary,
+// nvfuser_bench_allocs, instead of being part of nvfuser_bench.
+
+namespace {
+
+// Heap allocations of the binary, counted by the replacements of the global
+// operator new below
+std::atomic<int64_t> num_allocations{0};
+
+} // namespace
+
+void* operator new(size_t size) {
+  num_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+// Host time and heap allocations of FusionKernelRuntime::runWithInputs with
+// kernel launches disabled. The arguments are copied for each call, as the
+// runtime appends the outputs of the segments to them.
+static void NvFuserScheduler_RuntimeAllocations_NoLaunch(
+    benchmark::State& benchmark_state) {
+  auto fec = makeSegmentChain(benchmark_state.range(0));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<c10::IValue> aten_inputs = {at::randn({8, 128}, options)};
+
+  fec->runFusionWithInputs(aten_inputs);
+  fec->disableKernelLaunch();
+  auto runtime = fec->getMostRecentKernelRuntime();
+
+  // The executors cache their launch parameters and output sizes by the
+  // input id, so any fixed id works
+  auto args = KernelArgumentHolder::createKernelArgumentHolder(aten_inputs);
+  args.setCacheId(0);
+  {
+    auto warmup_args = args;
+    runtime->runWithInputs(warmup_args);
+  }
+
+  const auto allocations_before = num_allocations.load();
+  for (auto _ : benchmark_state) {
+    auto call_args = args;
+    runtime->runWithInputs(call_args);
+  }
+  benchmark_state.counters["allocs"] = benchmark::Counter(
+      (double)(num_allocations.load() - allocations_before),
+      benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(NvFuserScheduler_RuntimeAllocations_NoLaunch)
+    ->Arg(2)
+    ->Arg(8)
+    ->Arg(32)
+    ->Unit(benchmark::kNanosecond);
@@ -0,0 +1,145 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+#include <options.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cuda_runtime.h>
+
+#include <optional>
+
+#include <benchmark/utils.h>
+#include <test/utils.h>
+
+using namespace nvfuser;
+
+// Host overhead of launching the kernels of a segmented fusion. The
+// fusion is a chain of small pointwise segments, so the time of a call
+// is dominated by the host work of preparing and launching each segment.
+
+namespace {
+
+std::vector<c10::IValue> makeSegmentChainInputs() {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  return {at::randn({8, 128}, options)};
+}
+
+} // namespace
+
+// Host time of a call with kernel launches disabled, with the launches
+// prepared segment by segment or replayed from a recorded launch plan
+static void SegmentLaunch_NoLaunch(
+    benchmark::State& benchmark_state,
+    bool use_launch_plan) {
+  EnableOptionsGuard opt_guard;
+  if (use_launch_plan) {
+    EnableOptionsGuard::getCurOptions().set(EnableOption::LaunchPlan);
+  }
+  auto fec = makeSegmentChain(benchmark_state.range(0));
+  auto aten_inputs = makeSegmentChainInputs();
+
+  // Compile, and record the launch plan if enabled
+  fec->runFusionWithInputs(aten_inputs);
+  fec->disableKernelLaunch();
+
+  for (auto _ : benchmark_state) {
+    fec->runFusionWithInputs(aten_inputs);
+  }
+}
+
+static void NvFuserScheduler_SegmentLaunch_NoLaunch(
+    benchmark::State& benchmark_state) {
+  SegmentLaunch_NoLaunch(benchmark_state, false);
+}
+
+static void NvFuserScheduler_SegmentLaunch_NoLaunchPlan(
+    benchmark::State& benchmark_state) {
+  SegmentLaunch_NoLaunch(benchmark_state, true);
+}
+
+// Host time of a call with kernels launched one segment at a time,
+// replayed from a launch plan, or replayed as a CUDA graph, or with the
+// segment outputs placed in one workspace. Waiting for the kernels is not
+// measured.
+static void SegmentLaunch_HostTime(
+    benchmark::State& benchmark_state,
+    std::optional<EnableOption> option) {
+  EnableOptionsGuard opt_guard;
+  if (option.has_value()) {
+    EnableOptionsGuard::getCurOptions().set(option.value());
+  }
+  auto fec = makeSegmentChain(benchmark_state.range(0));
+  auto aten_inputs = makeSegmentChainInputs();
+
+  // Compile, and record the plans or graph if enabled
+  fec->runFusionWithInputs(aten_inputs);
+  C10_CUDA_CHECK(cudaDeviceSynchronize());
+
+  for (auto _ : benchmark_state) {
+    fec->runFusionWithInputs(aten_inputs);
+    benchmark_state.PauseTiming();
+    C10_CUDA_CHECK(cudaDeviceSynchronize());
+    benchmark_state.ResumeTiming();
+  }
+}
+
+static void NvFuserScheduler_SegmentLaunch_Eager(
+    benchmark::State& benchmark_state) {
+  SegmentLaunch_HostTime(benchmark_state, std::nullopt);
+}
+
+static void NvFuserScheduler_SegmentLaunch_Plan(
+    benchmark::State& benchmark_state) {
+  SegmentLaunch_HostTime(benchmark_state, EnableOption::LaunchPlan);
+}
+
+static void NvFuserScheduler_SegmentLaunch_Graph(
+    benchmark::State& benchmark_state) {
+  SegmentLaunch_HostTime(benchmark_state, EnableOption::SegmentGraph);
+}
+
+static void NvFuserScheduler_SegmentLaunch_MemoryPlan(
+    benchmark::State& benchmark_state) {
+  SegmentLaunch_HostTime(benchmark_state, EnableOption::MemoryPlan);
+}
+
+BENCHMARK(NvFuserScheduler_SegmentLaunch_NoLaunch)
+    ->Arg(2)
+    ->Arg(8)
+    ->Arg(32)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_SegmentLaunch_NoLaunchPlan)
+    ->Arg(2)
+    ->Arg(8)
+    ->Arg(32)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_SegmentLaunch_Eager)
+    ->Arg(2)
+    ->Arg(8)
+    ->Arg(32)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_SegmentLaunch_Plan)
+    ->Arg(2)
+    ->Arg(8)
+    ->Arg(32)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_SegmentLaunch_Graph)
+    ->Arg(2)
+    ->Arg(8)
+    ->Arg(32)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_SegmentLaunch_MemoryPlan)
+    ->Arg(2)
+    ->Arg(8)
+    ->Arg(32)
+    ->Unit(benchmark::kMicrosecond);
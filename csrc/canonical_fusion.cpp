@@ -0,0 +1,213 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <canonical_fusion.h>
+
+#include <instrumentation.h>
+#include <ir/all_nodes.h>
+#include <utils.h>
+
+#include <c10/util/irange.h>
+
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace nvfuser {
+
+namespace {
+
+class CanonicalFusionPrinter {
+ public:
+  CanonicalFusionPrinter(Fusion* fusion) {
+    for (auto input : fusion->inputs()) {
+      os_ << "input " << ref(input) << "\n";
+    }
+    for (auto expr : fusion->exprs()) {
+      handle(expr);
+    }
+    for (auto output : fusion->outputs()) {
+      os_ << "output " << ref(output) << "\n";
+    }
+    for (const auto& [output, input] : fusion->getOutputToInputAliasIndices()) {
+      os_ << "alias " << output << " " << input << "\n";
+    }
+    permutations("input", fusion->getPermutationInputMap());
+    permutations("output", fusion->getPermutationOutputMap());
+  }
+
+  std::string text() const {
+    return os_.str();
+  }
+
+  std::vector<PolymorphicValue>& constants() {
+    return constants_;
+  }
+
+ private:
+  // The map is unordered, so the permutations are sorted by index
+  void permutations(
+      const std::string& kind,
+      const Fusion::PermutationMap& permutation_map) {
+    std::map<int, std::vector<int64_t>> sorted(
+        permutation_map.begin(), permutation_map.end());
+    for (const auto& [index, permutation] : sorted) {
+      os_ << kind << "_permutation " << index << " "
+          << toDelimitedString(permutation) << "\n";
+    }
+  }
+
+  // Reference to val in the text. Vals are declared, by a line of the text,
+  // the first time they are referenced.
+  std::string ref(Val* val) {
+    // Constants are referenced by value
+    if (val->definition() == nullptr && val->value().hasValue()) {
+      std::stringstream ss;
+      ss << "const(" << val->dtype() << " "
+         << PolymorphicValue_functions::toString(val->value()) << ")";
+      constants_.push_back(val->value());
+      return ss.str();
+    }
+
+    auto it = ids_.find(val);
+    if (it != ids_.end()) {
+      return "%" + std::to_string(it->second);
+    }
+    const auto number = (int64_t)ids_.size();
+    ids_.emplace(val, number);
+    const auto name = "%" + std::to_string(number);
+
+    // The declaration is written after the declarations of the Vals it
+    // references
+    std::stringstream line;
+    line << name << " = " << val->vtype() << " " << val->dtype();
+    if (auto tv = dynamic_cast<TensorView*>(val)) {
+      line << " " << tv->getMemoryType() << (tv->isCpuScalar() ? " cpu" : "")
+           << " " << domain(tv->domain());
+    } else if (auto td = dynamic_cast<TensorDomain*>(val)) {
+      line << " " << domain(td);
+    } else if (auto id = dynamic_cast<IterDomain*>(val)) {
+      line << " " << id->getIterType() << " " << id->getParallelType()
+           << " extent " << ref(id->extent()) << " start " << ref(id->start())
+           << " stop_offset " << ref(id->stopOffset());
+      if (id->hasExpandedExtent()) {
+        line << " expanded " << ref(id->expandedExtent());
+      }
+    } else if (auto ns = dynamic_cast<NamedScalar*>(val)) {
+      line << " " << ns->name();
+    } else if (val->vtype() != ValType::Others) {
+      // Not expected in an unscheduled fusion, so only matches itself
+      line << " at " << (const void*)val;
+    }
+    os_ << line.str() << "\n";
+
+    // Expressions between IterDomains or scalars are not visited by the
+    // traversal of the fusion
+    if (val->definition() != nullptr && !val->isA<TensorView>()) {
+      handle(val->definition());
+    }
+    return name;
+  }
+
+  std::string domain(TensorDomain* td) {
+    std::stringstream ss;
+    auto refs = [&](const std::vector<IterDomain*>& ids) {
+      ss << "[";
+      for (auto id : ids) {
+        ss << " " << ref(id);
+      }
+      ss << " ]";
+    };
+    ss << "root ";
+    refs(td->root());
+    if (td->hasRFactor()) {
+      ss << " rfactor ";
+      refs(td->rfactor());
+    }
+    if (td->hasAllocation()) {
+      ss << " allocation ";
+      refs(td->allocation());
+    }
+    if (td->leaf() != td->maybeAllocation()) {
+      ss << " leaf ";
+      refs(td->leaf());
+    }
+    ss << " contiguity ";
+    for (const auto& contiguity : td->contiguity()) {
+      ss << (contiguity.has_value() ? (contiguity.value() ? "t" : "f") : "n");
+    }
+    return ss.str();
+  }
+
+  void handle(Expr* expr) {
+    if (!visited_.insert(expr).second) {
+      return;
+    }
+    std::stringstream line;
+    for (auto output : expr->outputs()) {
+      line << ref(output) << " ";
+    }
+    line << "= " << expr->getOpString() << "(";
+    for (auto input : expr->inputs()) {
+      line << " " << ref(input);
+    }
+    line << " ; ";
+    for (auto attribute : expr->attributes()) {
+      if (auto val = dynamic_cast<Val*>(attribute)) {
+        line << " " << ref(val);
+      } else {
+        line << " " << (const void*)attribute;
+      }
+    }
+    line << " )";
+    os_ << line.str() << "\n";
+  }
+
+ private:
+  std::stringstream os_;
+  std::unordered_map<Val*, int64_t> ids_;
+  std::unordered_set<Expr*> visited_;
+  std::vector<PolymorphicValue> constants_;
+};
+
+// Unlike isSame, 0.0 and -0.0 are different constants
+bool sameConstant(const PolymorphicValue& a, const PolymorphicValue& b) {
+  if (!PolymorphicValue_functions::isSame(a, b)) {
+    return false;
+  }
+  if (a.is<double>()) {
+    return std::signbit(a.as<double>()) == std::signbit(b.as<double>());
+  }
+  return true;
+}
+
+} // namespace
+
+CanonicalFusion::CanonicalFusion(Fusion* fusion) {
+  FUSER_PERF_SCOPE("CanonicalFusion::CanonicalFusion");
+  CanonicalFusionPrinter printer(fusion);
+  text_ = printer.text();
+  constants_ = std::move(printer.constants());
+  hash_ = std::hash<std::string>{}(text_);
+}
+
+bool CanonicalFusion::operator==(const CanonicalFusion& other) const {
+  if (hash_ != other.hash_ || text_ != other.text_) {
+    return false;
+  }
+  NVF_ERROR(constants_.size() == other.constants_.size());
+  for (auto i : c10::irange(constants_.size())) {
+    if (!sameConstant(constants_.at(i), other.constants_.at(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace nvfuser
@@ -0,0 +1,70 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <fusion.h>
+#include <polymorphic_value.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace nvfuser {
+
+//! Canonical form of the definition of an unscheduled Fusion, used to find
+//! fusions that are structurally the same even though they were defined
+//! separately, e.g., traced with another order of independent ops or with
+//! other names.
+//!
+//! The expressions are ordered by a traversal from the outputs, so the order
+//! only depends on the order of the inputs and outputs of the fusion and of
+//! each expression. The Vals are numbered in the order they are first used,
+//! ignoring their names. Constants are written by value, so two constants
+//! of the same value are interchangeable. Equality compares the text of the
+//! canonical form, then the values of the constants exactly, as the text
+//! only approximates them.
+//!
+//! Vals of a kind not expected in an unscheduled fusion, e.g., kir::Predicate,
+//! are identified by their address, so such fusions only match themselves.
+class CanonicalFusion {
+ public:
+  explicit CanonicalFusion(Fusion* fusion);
+
+  size_t hash() const {
+    return hash_;
+  }
+
+  bool operator==(const CanonicalFusion& other) const;
+
+  bool operator!=(const CanonicalFusion& other) const {
+    return !(*this == other);
+  }
+
+  //! Canonical form in text, one statement per line
+  const std::string& toString() const {
+    return text_;
+  }
+
+ private:
+  std::string text_;
+  //! Constants in the order they appear in text_
+  std::vector<PolymorphicValue> constants_;
+  size_t hash_ = 0;
+};
+
+} // namespace nvfuser
+
+namespace std {
+template <>
+struct hash<nvfuser::CanonicalFusion> {
+  size_t operator()(const nvfuser::CanonicalFusion& canonical_fusion) const {
+    return canonical_fusion.hash();
+  }
+};
+} // namespace std
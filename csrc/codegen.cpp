@@ -296,9 +296,9 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     const bool has_dynamic_smem =
         !kernel_summary.dynamic_smem_allocations.empty();
 
-    // Do we have any reductions?
+    // Do we have any reductions? Block scans use the same workspace.
     const bool has_reductions = kernel_summary.has_block_reductions ||
-        kernel_summary.has_grid_reductions;
+        kernel_summary.has_block_scans || kernel_summary.has_grid_reductions;
     const bool has_parallel_welford =
         kernel_summary.has_block_welford || kernel_summary.has_grid_welford;
 
@@ -1256,6 +1256,36 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     }
   }
 
+  void handle(const kir::BlockScan* bscan) final {
+    NVF_ERROR(bscan->out()->isA<kir::TensorIndex>());
+
+    const auto output = bscan->out()->as<kir::TensorIndex>();
+    const auto input = bscan->in()->as<kir::TensorIndex>();
+    const auto data_type = output->dtype();
+
+    ArgumentBuilder template_args;
+    template_args.arg(bscan->isExclusive());
+    template_args.arg(isAligned());
+
+    ArgumentBuilder func_args;
+    func_args.arg(gen(output));
+    func_args.arg(gen(input));
+    func_args.arg(gen(bscan->carry()));
+    func_args.arg(genReductionOp(bscan->getScanOpType(), data_type));
+    func_args.arg(genStaticCast(genPtrType(data_type), "shared_mem"));
+    // The threads out of the scanned extent read the initial value and don't
+    // write, but still take part in the scan
+    if (bscan->predicate() != nullptr) {
+      NVF_ERROR(bscan->predicate()->hasValue());
+      func_args.arg(genInline(bscan->predicate()));
+    } else {
+      func_args.arg(true);
+    }
+    func_args.arg(genCall(data_type, genInline(bscan->init())));
+
+    indent() << genCall("blockScan", template_args, func_args) << ";\n";
+  }
+
   void handle(const LoadStoreOp* ldst) final {
     auto optype = ldst->opType();
     if (ldst->out()->isA<kir::TensorIndex>()) {
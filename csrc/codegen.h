@@ -21,5 +21,22 @@ std::string generateCudaKernel(
     const kir::Kernel* kernel,
     const std::string& kernel_name = "CUDAGeneratedKernel");
 
+//! Generates a C++ kernel definition for the given kernel, to be
+//! compiled by the system compiler and run on the host. Each CUDA
+//! thread of the kernel becomes an iteration of a loop nest over the
+//! launch dimensions, where blocks are distributed over OpenMP threads
+//! and the threads of a block are SIMD lanes. Kernels with
+//! inter-thread communication, i.e., shared memory, synchronization,
+//! or parallel reductions and broadcasts, are not supported. The kernel
+//! is an extern "C" function of the form
+//!
+//!   void kernel_name(void** args, const int64_t* launch_dims);
+//!
+//! where args are laid out as for cuLaunchKernel and launch_dims are
+//! gdimx, gdimy, gdimz, bdimx, bdimy, bdimz.
+std::string generateCppKernel(
+    const kir::Kernel* kernel,
+    const std::string& kernel_name = "CppGeneratedKernel");
+
 } // namespace codegen
 } // namespace nvfuser
@@ -0,0 +1,848 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <codegen.h>
+#include <instrumentation.h>
+#include <ir/utils.h>
+#include <kernel_ir.h>
+#include <kernel_ir_dispatch.h>
+#include <options.h>
+#include <type.h>
+#include <utils.h>
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace nvfuser {
+namespace codegen {
+
+namespace {
+
+//! Data types that have the same representation on the host and in
+//! the C++ runtime
+bool isSupportedCppDataType(const DataType& dtype) {
+  if (!std::holds_alternative<PrimDataType>(dtype.type)) {
+    return false;
+  }
+  switch (std::get<PrimDataType>(dtype.type)) {
+    case DataType::Bool:
+    case DataType::Double:
+    case DataType::Float:
+    case DataType::Index:
+    case DataType::Int:
+    case DataType::Int32:
+    case DataType::UInt:
+    case DataType::UInt32:
+      return true;
+    default:
+      return false;
+  }
+}
+
+//! Generates a C++ kernel that simulates the CUDA threads of the kernel
+//! with loops. See generateCppKernel.
+class CppKernelGenerator : private kir::ConstIrVisitor {
+  static constexpr const char* kTab = "  ";
+
+ public:
+  static std::string generateKernelDefinition(
+      const kir::Kernel* kernel,
+      const std::string& kernel_name) {
+    CppKernelGenerator codegen(kernel);
+    codegen.validateKernelSummary();
+    codegen.genDeclaration(kernel_name);
+    codegen.startBlock(true);
+    codegen.genParameters();
+    codegen.genThreadLoops();
+    codegen.genBody();
+    codegen.endThreadLoops();
+    codegen.endBlock();
+    NVF_CHECK(codegen.block_nest_level_ == 0);
+    return codegen.code_.str();
+  }
+
+ private:
+  explicit CppKernelGenerator(const kir::Kernel* kernel) : kernel_(kernel) {
+    initStringStreamFormat(code_);
+  }
+
+  using kir::ConstIrVisitor::handle;
+
+  void initStringStreamFormat(std::stringstream& ss) {
+    ss.imbue(std::locale("C"));
+    ss << std::scientific;
+    // Set the default precision as Double
+    setPrecision(ss, DataType::Double);
+  }
+
+  void setPrecision(std::stringstream& ss, DataType dtype) {
+    NVF_ERROR(isFloatingPointType(dtype));
+    ss << std::setprecision(max_digits10(dtype));
+  }
+
+  std::string getLiteralSuffix(DataType dtype) {
+    switch (std::get<PrimDataType>(dtype.type)) {
+      case DataType::Float:
+        return "f";
+      case DataType::Int:
+        return "LL";
+      case DataType::Index:
+        return getLiteralSuffix(kernel_->indexType());
+      default:
+        return "";
+    }
+  }
+
+  //! Kernels that need communication between CUDA threads can't be run
+  //! by the sequential loops over threads
+  void validateKernelSummary() {
+    const auto& summary = kernel_->summary();
+    NVF_CHECK(
+        summary.dynamic_smem_allocations.empty() &&
+            summary.static_smem_allocations.empty(),
+        "The C++ backend does not support shared memory");
+    NVF_CHECK(
+        !summary.has_block_reductions && !summary.has_grid_reductions &&
+            !summary.has_block_welford && !summary.has_grid_welford,
+        "The C++ backend does not support parallel reductions");
+    NVF_CHECK(
+        !summary.has_block_scans,
+        "The C++ backend does not support parallel scans");
+    NVF_CHECK(
+        !summary.has_block_broadcasts && !summary.has_grid_broadcasts,
+        "The C++ backend does not support parallel broadcasts");
+    NVF_CHECK(
+        !summary.has_philox_op,
+        "The C++ backend does not support random number generation");
+  }
+
+  void checkDataType(const Val* val) {
+    NVF_CHECK(
+        isSupportedCppDataType(val->dtype()),
+        "The C++ backend does not support ",
+        val->dtype(),
+        ": ",
+        val->toString());
+  }
+
+  std::string genVariableName(const Val* v) {
+    if (auto ns = dynamic_cast<const NamedScalar*>(v)) {
+      // Parallel indices and dimensions are members of the Dim3
+      // variables of the thread loops
+      return ns->name();
+    }
+    if (v->isOneOf<kir::TensorIndex, TensorView>()) {
+      return ir_utils::varName(v);
+    }
+    if (isOptionDisabled(DisableOption::VarNameRemapping)) {
+      return ir_utils::varName(v);
+    }
+    if (val_to_name_.find(v) == val_to_name_.end()) {
+      val_to_name_[v] =
+          typePrefix(v->dtype()) + std::to_string(val_to_name_.size());
+    }
+    return val_to_name_.at(v);
+  }
+
+  void genDeclaration(const std::string& kernel_name) {
+    code_ << "extern \"C\" void " << kernel_name
+          << "(void** args, const int64_t* launch_dims) ";
+  }
+
+  //! Unpack the kernel arguments, which have the same layout as the
+  //! arguments of the CUDA kernel
+  void genParameters() {
+    std::unordered_set<Val*> unique_args;
+    unsigned int duplicate_counter = 0;
+    for (auto i : c10::irange(kernel_->parameters().size())) {
+      auto param = kernel_->parameters().at(i);
+      kernel_params_.insert(param);
+      checkDataType(param);
+
+      std::stringstream var_name_ss;
+      var_name_ss << genVariableName(param);
+      if (!unique_args.emplace(param).second) {
+        var_name_ss << "_duplicate_" << duplicate_counter++;
+      }
+
+      std::stringstream type_ss;
+      if (const auto tv = dynamic_cast<TensorView*>(param)) {
+        if (tv->isCpuScalar()) {
+          type_ss << "CpuScalarTensor<" << param->dtype() << ">";
+        } else {
+          type_ss
+              << "Tensor<" << param->dtype() << ", "
+              << TensorDomain::noReductions(tv->getMaybeRFactorDomain()).size()
+              << ", "
+              << TensorDomain::noReductions(tv->getMaybeAllocationDomain())
+                     .size()
+              << ">";
+        }
+      } else {
+        NVF_ERROR(param->isScalar()); // NOLINT (LLVM bug 48525)
+        type_ss << param->dtype();
+      }
+
+      indent() << type_ss.str() << " " << var_name_ss.str()
+               << " = *reinterpret_cast<" << type_ss.str() << "*>(args[" << i
+               << "]);\n";
+    }
+  }
+
+  //! Open the loops over blocks and threads. Blocks are independent and
+  //! are distributed over OpenMP threads. The threads of a block are
+  //! mapped to SIMD lanes, which is valid as they don't communicate.
+  void genThreadLoops() {
+    indent() << "const Dim3 gridDim{(nvfuser_index_t)launch_dims[0], "
+             << "(nvfuser_index_t)launch_dims[1], "
+             << "(nvfuser_index_t)launch_dims[2]};\n";
+    indent() << "const Dim3 blockDim{(nvfuser_index_t)launch_dims[3], "
+             << "(nvfuser_index_t)launch_dims[4], "
+             << "(nvfuser_index_t)launch_dims[5]};\n";
+    indent() << "#pragma omp parallel for collapse(3)\n";
+    genThreadLoop("bidz", "gridDim.z");
+    genThreadLoop("bidy", "gridDim.y");
+    genThreadLoop("bidx", "gridDim.x");
+    indent() << "const Dim3 blockIdx{bidx, bidy, bidz};\n";
+    genThreadLoop("tidz", "blockDim.z");
+    genThreadLoop("tidy", "blockDim.y");
+    indent() << "#pragma omp simd\n";
+    genThreadLoop("tidx", "blockDim.x");
+    indent() << "const Dim3 threadIdx{tidx, tidy, tidz};\n";
+  }
+
+  void genThreadLoop(const std::string& index, const std::string& stop) {
+    indent() << "for (nvfuser_index_t " << index << " = 0; " << index << " < "
+             << stop << "; ++" << index << ") ";
+    startBlock(true);
+  }
+
+  void endThreadLoops() {
+    // blockIdx and threadIdx loops
+    for (auto i : c10::irange(6)) {
+      (void)i; // Suppress unused variable warning
+      endBlock();
+    }
+  }
+
+  // Cannot just use ConstIrVisitor::handle as it expects a vector of
+  // const Expr*, whereas most of the IR API returns a vector of
+  // non-const Expr*.
+  void handle(const std::vector<Expr*>& exprs) {
+    for (Expr* expr : exprs) {
+      kir::ConstIrVisitor::dispatch(expr);
+    }
+  }
+
+  void genBody() {
+    handle(kernel_->topLevelExprs());
+  }
+
+  void startBlock(bool continuation = false) {
+    if (continuation) {
+      code_ << "{\n";
+    } else {
+      indent() << "{\n";
+    }
+    ++block_nest_level_;
+  }
+
+  void endBlock(const char* sep = "\n") {
+    --block_nest_level_;
+    NVF_CHECK(block_nest_level_ >= 0);
+    indent() << "}" << sep;
+  }
+
+  std::ostream& indent() {
+    for (const auto i : c10::irange(block_nest_level_)) {
+      (void)i; // Suppress unused variable warning
+      code_ << kTab;
+    }
+    return code_;
+  }
+
+  std::string gen(const Statement* stmt) {
+    if (stmt->isA<Expr>()) {
+      NVF_ERROR(
+          !stmt->isA<kir::IfThenElse>() && !stmt->isA<kir::ForLoop>(),
+          "Invalid expr: ",
+          stmt->toString());
+    } else {
+      NVF_ERROR(
+          stmt->isA<Val>(), "Unknown Statement IR type: ", stmt->toString());
+    }
+
+    std::stringstream tmp_code;
+    initStringStreamFormat(tmp_code);
+    std::swap(tmp_code, code_);
+    dispatch(stmt);
+    std::swap(tmp_code, code_);
+    return tmp_code.str();
+  }
+
+  std::string genInline(const Statement* stmt) {
+    const bool saved_inline = print_inline_;
+    print_inline_ = true;
+    auto result = gen(stmt);
+    print_inline_ = saved_inline;
+    // NOLINTNEXTLINE(performance-no-automatic-move)
+    return result;
+  }
+
+  void unhandled(const Statement* stmt) final {
+    NVF_CHECK(false, "The C++ backend does not support ", stmt->toString());
+  }
+
+  void handle(const kir::Predicate* pred) final {
+    NVF_ERROR(pred->hasValue());
+    code_ << gen(pred->value());
+  }
+
+  void handle(const Val* s) final {
+    const auto def = s->definition();
+    const bool has_alloc = alloc_map_.find(s) != alloc_map_.end();
+    const bool is_param = kernel_params_.find(s) != kernel_params_.end();
+    if (def != nullptr && !has_alloc && !is_param) {
+      if (def->isOneOf<GetAttr, GetItem, GetMetaData>() ||
+          (def->isA<UnaryOp>() &&
+           !inline_op_str(def->as<UnaryOp>()->getUnaryOpType()).has_value())) {
+        code_ << genInline(def);
+      } else {
+        code_ << "(" << genInline(def) << ")";
+      }
+    } else if (s->isConst()) {
+      auto value = s->value();
+      auto dtype = s->dtype();
+      if (value.is<bool>()) {
+        code_ << (value ? "true" : "false");
+      } else if (value.is<int64_t>()) {
+        code_ << value << getLiteralSuffix(dtype);
+      } else if (value.is<double>()) {
+        auto val = value.as<double>();
+        if (std::isinf(val)) {
+          if (val > 0) {
+            code_ << "POS_INFINITY";
+          } else {
+            code_ << "NEG_INFINITY";
+          }
+        } else if (std::isnan(val)) {
+          code_ << "NAN";
+        } else {
+          setPrecision(code_, dtype);
+          code_ << val << getLiteralSuffix(dtype);
+        }
+      } else {
+        NVF_CHECK(
+            false,
+            "The C++ backend does not support constants of ",
+            s->dtype(),
+            ": ",
+            value);
+      }
+    } else {
+      code_ << genVariableName(s);
+    }
+  }
+
+  void handle(const NamedScalar* ns) final {
+    if (ns->definition() != nullptr &&
+        alloc_map_.find(ns) == alloc_map_.end()) {
+      code_ << genInline(ns->definition());
+    } else {
+      code_ << genVariableName(ns);
+    }
+  }
+
+  void handle(const kir::TensorIndex* ti) final {
+    code_ << genVariableName(ti->view()) << "[" << genInline(ti->index())
+          << "]";
+  }
+
+  void handle(const IterDomain*) final {
+    NVF_ERROR(false, "Unreachable");
+  }
+
+  void handle(const TensorDomain*) final {
+    NVF_ERROR(false, "Unreachable");
+  }
+
+  void handle(const TensorView* tv) final {
+    code_ << genVariableName(tv);
+  }
+
+  void handle(const GetMetaData* gop) final {
+    if (print_inline_) {
+      code_ << gen(gop->in());
+    } else {
+      auto out_type = gop->output(0)->dtype();
+      std::visit(
+          [&](auto&& dtype) {
+            using T = std::decay_t<decltype(dtype)>;
+            if constexpr (std::is_same_v<T, StructType>) {
+              for (const auto& field : dtype.fields) {
+                if (!field.used_in_kernel) {
+                  continue;
+                }
+                indent() << gen(gop->output(0)) << "." << field.name << " = "
+                         << gen(gop->in()) << "." << field.name << ";\n";
+              }
+            } else {
+              indent() << gen(gop->output(0)) << " = " << gen(gop->in())
+                       << ";\n";
+            }
+          },
+          out_type.type);
+    }
+  }
+
+  void handle(const StructConstruct* sop) final {
+    if (!print_inline_) {
+      indent() << gen(sop->output(0)) << " = ";
+    }
+    auto dtype = std::get<StructType>(sop->output(0)->dtype().type);
+    code_ << dtype.name << "{ ";
+    for (auto i : c10::irange(sop->inputs().size())) {
+      if (i > 0) {
+        code_ << ", ";
+      }
+      code_ << gen(sop->input(i));
+    }
+    code_ << " }";
+    if (!print_inline_) {
+      code_ << ";\n";
+    }
+  }
+
+  void handle(const GetAttr* gop) final {
+    if (!print_inline_) {
+      indent() << gen(gop->output(0)) << " = ";
+    }
+    code_ << gen(gop->struct_()) << "." << gop->attr();
+    if (!print_inline_) {
+      code_ << ";\n";
+    }
+  }
+
+  void handle(const ArrayConstruct* aop) final {
+    if (!print_inline_) {
+      indent() << gen(aop->out()) << " = ";
+    }
+    code_ << aop->out()->dtype() << "{";
+    bool first = true;
+    for (auto in : aop->inputs()) {
+      if (!first) {
+        code_ << ", ";
+      }
+      first = false;
+      code_ << gen(in);
+    }
+    code_ << "}";
+    if (!print_inline_) {
+      code_ << ";\n";
+    }
+  }
+
+  void handle(const GetItem* gop) final {
+    if (!print_inline_) {
+      indent() << gen(gop->out()) << " = ";
+    }
+    code_ << gen(gop->array()) << "[" << gen(gop->index()) << "]";
+    if (!print_inline_) {
+      code_ << ";\n";
+    }
+  }
+
+  void handle(const UnaryOp* uop) final {
+    const auto op_type = uop->getUnaryOpType();
+
+    if (!print_inline_) {
+      indent() << gen(uop->out()) << " = ";
+    }
+
+    if (auto op = inline_op_str(op_type)) {
+      code_ << *op << gen(uop->in());
+    } else {
+      if (op_type == UnaryOpType::Cast) {
+        const auto cast_str =
+            cast_func_str({uop->in()->dtype(), uop->out()->dtype()});
+        NVF_CHECK(
+            cast_str.has_value() &&
+                isSupportedCppDataType(uop->in()->dtype()) &&
+                isSupportedCppDataType(uop->out()->dtype()),
+            "The C++ backend does not support the cast from ",
+            uop->in()->dtype(),
+            " to ",
+            uop->out()->dtype());
+        code_ << cast_str.value();
+      } else {
+        NVF_CHECK(
+            op_type != UnaryOpType::BitCast && op_type != UnaryOpType::Print &&
+                op_type != UnaryOpType::ToUnsignedSmemAddr,
+            "The C++ backend does not support ",
+            uop->toString());
+        code_ << op_type;
+        if (needFloatSuffix(op_type) &&
+            uop->out()->dtype() == DataType::Float) {
+          code_ << "f";
+        }
+      }
+      code_ << "(" << gen(uop->in()) << ")";
+    }
+
+    if (!print_inline_) {
+      code_ << ";\n";
+    }
+  }
+
+  std::string genBinaryOp(
+      BinaryOpType op_type,
+      DataType data_type,
+      const std::string& lhs,
+      const std::string& rhs) {
+    std::stringstream expr;
+    if (auto op = inline_op_str(op_type)) {
+      expr << lhs << " " << *op << " " << rhs;
+    } else {
+      if (integer_op_str(op_type) && isIntegralType(data_type)) {
+        expr << *integer_op_str(op_type);
+      } else if (bool_op_str(op_type) && isBooleanType(data_type)) {
+        expr << *bool_op_str(op_type);
+      } else {
+        expr << op_type;
+        if (needFloatSuffix(op_type) && data_type == DataType::Float) {
+          expr << "f";
+        }
+      }
+      expr << "(" << lhs << ", " << rhs << ")";
+    }
+    return expr.str();
+  }
+
+  // If one argument is a tensor and the other is a scalar of a different
+  // floating point or integer type, cast the scalar to the tensor type
+  // so that the overloads of the runtime functions are not ambiguous
+  std::string scalarCast(Val* lhs, Val* rhs) {
+    if (!((lhs->isScalar() || rhs->isScalar()) &&
+          (lhs->isA<kir::TensorIndex>() || rhs->isA<kir::TensorIndex>()))) {
+      return "";
+    }
+    auto lhs_t = lhs->dtype();
+    auto rhs_t = rhs->dtype();
+    if (lhs_t == rhs_t || lhs_t == DataType::Bool ||
+        rhs_t == DataType::Bool) {
+      return "";
+    }
+    if ((isFloatingPointType(lhs_t) != isFloatingPointType(rhs_t)) ||
+        (isIntegralType(lhs_t) != isIntegralType(rhs_t))) {
+      return "";
+    }
+    std::stringstream cast;
+    cast << "(" << (lhs->isA<kir::TensorIndex>() ? lhs_t : rhs_t) << ") ";
+    return cast.str();
+  }
+
+  void handle(const BinaryOp* bop) final {
+    const auto op_type = bop->getBinaryOpType();
+    NVF_CHECK(
+        op_type != BinaryOpType::Complex &&
+            op_type != BinaryOpType::OnlineSoftmax,
+        "The C++ backend does not support ",
+        bop->toString());
+    auto cast = scalarCast(bop->lhs(), bop->rhs());
+    auto lhs = (bop->lhs()->isScalar() ? cast : "") + gen(bop->lhs());
+    auto rhs = (bop->rhs()->isScalar() ? cast : "") + gen(bop->rhs());
+    if (print_inline_) {
+      code_ << genBinaryOp(op_type, bop->out()->dtype(), lhs, rhs);
+    } else {
+      indent() << gen(bop->out()) << " = "
+               << genBinaryOp(op_type, bop->out()->dtype(), lhs, rhs)
+               << ";\n";
+    }
+  }
+
+  void handle(const TernaryOp* top) final {
+    if (!print_inline_) {
+      indent() << gen(top->out()) << " = ";
+    }
+
+    // Only evaluate the operand picked by the condition, see
+    // CudaKernelGenerator
+    if (top->getTernaryOpType() == TernaryOpType::Where) {
+      code_ << gen(top->in1()) << " ? ";
+      auto cast = scalarCast(top->in2(), top->in3());
+      code_ << (top->in2()->isScalar() ? cast : "") << gen(top->in2()) << " : "
+            << (top->in3()->isScalar() ? cast : "") << gen(top->in3());
+    } else {
+      code_ << top->getTernaryOpType() << "(" << gen(top->in1()) << ", "
+            << gen(top->in2()) << ", " << gen(top->in3()) << ")";
+    }
+
+    if (!print_inline_) {
+      code_ << ";\n";
+    }
+  }
+
+  void handle(const BroadcastOp* stmt) final {
+    NVF_ERROR(stmt->out()->isA<kir::TensorIndex>());
+    NVF_CHECK(
+        kernel_->summary().broadcast_parallel_types.at(stmt).none(),
+        "The C++ backend does not support parallel broadcasts: ",
+        stmt->toString());
+    indent() << gen(stmt->out()) << " = " << gen(stmt->in()) << ";\n";
+  }
+
+  void handle(const ReductionOp* rop) final {
+    NVF_ERROR(rop->out()->isA<kir::TensorIndex>());
+    const auto output = rop->out()->as<kir::TensorIndex>();
+    const auto domain = output->view()->domain();
+    NVF_CHECK(
+        !domain->hasBlockReduction() && !domain->hasGridReduction(),
+        "The C++ backend does not support parallel reductions: ",
+        rop->toString());
+    const auto gen_out = gen(output);
+    indent() << gen_out << " = "
+             << genBinaryOp(
+                    rop->getReductionOpType(),
+                    output->dtype(),
+                    gen_out,
+                    gen(rop->in()))
+             << ";\n";
+  }
+
+  void handle(const LoadStoreOp* ldst) final {
+    NVF_CHECK(
+        ldst->opType() == LoadStoreOpType::Set,
+        "The C++ backend does not support ",
+        ldst->toString());
+
+    // Vectorized accesses are loops over the elements of the vector,
+    // which the host compiler can turn into SIMD instructions
+    int64_t vector_word_size = 1;
+    if (vectorize_scope_ && ldst->out()->isA<kir::TensorIndex>()) {
+      auto out_tv = ldst->out()->as<kir::TensorIndex>()->view();
+      for (auto id : out_tv->getLeafDomain()) {
+        if (isParallelTypeVectorize(id->getParallelType())) {
+          NVF_ERROR(
+              id->extent()->isConstInt(),
+              "Could not evaluate constant value bound to vectorized dim.");
+          vector_word_size = id->extent()->evaluateInt();
+          break;
+        }
+      }
+    }
+
+    if (vector_word_size > 1) {
+      indent() << "for (nvfuser_index_t i_vec = 0; i_vec < "
+               << vector_word_size << "; ++i_vec) ";
+      startBlock(true);
+      indent() << "(&" << gen(ldst->out()) << ")[i_vec] = ";
+      if (ldst->in()->isScalar()) {
+        code_ << "(" << ldst->out()->dtype() << ")" << gen(ldst->in());
+      } else {
+        code_ << "(&" << gen(ldst->in()) << ")[i_vec]";
+      }
+      code_ << ";\n";
+      endBlock();
+      return;
+    }
+
+    if (!print_inline_ &&
+        std::holds_alternative<StructType>(ldst->out()->dtype().type)) {
+      auto out_type = std::get<StructType>(ldst->out()->dtype().type);
+      for (const auto& field : out_type.fields) {
+        if (!field.used_in_kernel) {
+          continue;
+        }
+        indent() << gen(ldst->out()) << "." << field.name << " = "
+                 << gen(ldst->in()) << "." << field.name << ";\n";
+      }
+      return;
+    }
+
+    if (!print_inline_) {
+      indent() << gen(ldst->out()) << " = ";
+    }
+    code_ << gen(ldst->in());
+    if (!print_inline_) {
+      code_ << ";\n";
+    }
+  }
+
+  void handle(const CatOp* cat) final {
+    auto out = gen(cat->output(0));
+    for (const auto i : c10::irange(cat->inputs().size())) {
+      auto inp = cat->input(i)->as<kir::TensorIndex>();
+      if (i < cat->inputs().size() - 1) {
+        if (i == 0) {
+          indent() << "if (";
+        } else {
+          indent() << "} else if (";
+        }
+        code_ << gen(cat->getPred((int)i)) << ") {\n";
+      } else {
+        indent() << "} else {\n";
+      }
+      indent() << kTab << out << " = " << gen(inp) << ";\n";
+    }
+    indent() << "}\n";
+  }
+
+  void handle(const kir::ForLoop* loop) final {
+    NVF_CHECK(
+        !loop->isGroup(), "The C++ backend does not support grouped loops");
+
+    if (loop->isTrivial()) {
+      if (loop->vectorize()) {
+        vectorize_scope_ = true;
+      }
+      kir::ConstIrVisitor::handle(loop);
+      if (loop->vectorize()) {
+        vectorize_scope_ = false;
+      }
+      return;
+    }
+
+    const auto gen_index = gen(loop->index());
+    const auto gen_start = genInline(loop->start());
+    const auto gen_stop = genInline(loop->simplifiedStop());
+    const auto gen_step = genInline(loop->step());
+
+    std::stringstream step_code;
+    if (loop->step()->isOneInt()) {
+      step_code << "++" << gen_index;
+    } else {
+      step_code << gen_index << " += " << gen_step;
+    }
+
+    // Same as CudaKernelGenerator, serial loops start at 0
+    indent() << "for (nvfuser_index_t " << gen_index << " = "
+             << (loop->iter_domain()->isParallelized() ? gen_start : "0")
+             << "; " << gen_index << " < " << gen_stop << "; "
+             << step_code.str() << ") ";
+    startBlock(true);
+    kir::ConstIrVisitor::handle(loop);
+    endBlock();
+  }
+
+  void handle(const kir::IfThenElse* ite) final {
+    auto conditional = ite->predicate()->value();
+    if (conditional->isConst()) {
+      if (conditional->value()) {
+        handle(ite->thenBody().exprs());
+      } else {
+        handle(ite->elseBody().exprs());
+      }
+      return;
+    }
+
+    indent() << "if (" << genInline(conditional) << ") ";
+    startBlock(true);
+    handle(ite->thenBody().exprs());
+    if (ite->hasElse()) {
+      endBlock(" else ");
+      startBlock(true);
+      handle(ite->elseBody().exprs());
+    }
+    endBlock();
+  }
+
+  void handle(const kir::Allocate* alloc) final {
+    NVF_ERROR(alloc->buffer() != nullptr);
+    const auto buffer_dtype = alloc->buffer()->dtype();
+    alloc_map_.emplace(alloc->buffer(), alloc);
+
+    if (!alloc->buffer()->isA<TensorView>()) {
+      indent() << buffer_dtype << " " << gen(alloc->buffer()) << ";\n";
+      return;
+    }
+
+    const auto tv = alloc->buffer()->as<TensorView>();
+    checkDataType(tv);
+    const auto size = alloc->size();
+    NVF_ERROR(size != nullptr);
+
+    if (alloc->alias() != nullptr) {
+      const auto alias_tv = alloc->alias()->buffer()->as<TensorView>();
+      NVF_CHECK(
+          alias_tv->getDataType() == tv->getDataType(),
+          "The C++ backend does not support aliases of different types: ",
+          alloc->toString());
+      indent() << "// Alias Allocation - " << alloc->memoryType() << "\n";
+      indent() << "auto& " << genVariableName(tv) << " = "
+               << genVariableName(alias_tv) << ";\n";
+      return;
+    }
+
+    switch (tv->getMemoryType()) {
+      case MemoryType::Global:
+        indent() << "// Allocate global tensor " << genVariableName(tv)
+                 << "\n";
+        break;
+      case MemoryType::Local: {
+        auto va = kernel_->summary().vectorized_accesses;
+        if (va.find(tv) != va.end()) {
+          indent() << "Array<" << buffer_dtype << ", " << genInline(size)
+                   << ", " << va.at(tv) << "> " << genVariableName(tv)
+                   << ";\n";
+        } else if (size->isConstInt()) {
+          indent() << buffer_dtype << " " << genVariableName(tv) << "["
+                   << genInline(size) << "];\n";
+        } else {
+          // Unlike CUDA, local buffers of dynamic sizes are allowed
+          indent() << "std::unique_ptr<" << buffer_dtype << "[]> "
+                   << genVariableName(tv) << "(new " << buffer_dtype << "["
+                   << genInline(size) << "]);\n";
+        }
+      } break;
+      default:
+        NVF_CHECK(
+            false,
+            "The C++ backend does not support ",
+            tv->getMemoryType(),
+            " memory: ",
+            alloc->toString());
+    }
+  }
+
+  void handle(const kir::InitMagicZero*) final {
+    // There is no unrolling to protect from on the host
+    indent() << "constexpr int nvfuser_zero = 0;\n";
+  }
+
+  void handle(const kir::UpdateMagicZero*) final {}
+
+ private:
+  std::stringstream code_;
+  const kir::Kernel* kernel_;
+  int block_nest_level_ = 0;
+  bool print_inline_ = false;
+
+  // Mark when we are inside of a vectorized for-loop
+  bool vectorize_scope_ = false;
+  //! Keep track of Allocate node for Val. Used to determine if Val
+  //! should be inlined.
+  std::unordered_map<const Val*, const kir::Allocate*> alloc_map_;
+  //! Keep track of the Val* and its generated variable name
+  std::unordered_map<const Val*, std::string> val_to_name_;
+  //! basically kernel_->parameters(), but as a set so it's faster to lookup
+  std::unordered_set<const Val*> kernel_params_;
+};
+
+} // namespace
+
+std::string generateCppKernel(
+    const kir::Kernel* kernel,
+    const std::string& kernel_name) {
+  FUSER_PERF_SCOPE("generateCppKernel");
+  return CppKernelGenerator::generateKernelDefinition(kernel, kernel_name);
+}
+
+} // namespace codegen
+} // namespace nvfuser
@@ -0,0 +1,180 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <device_lower/analysis/register_pressure.h>
+
+#include <expr_evaluator.h>
+#include <ir/utils.h>
+#include <kernel_ir.h>
+#include <kernel_ir_dispatch.h>
+#include <type.h>
+#include <utils.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace nvfuser {
+
+namespace {
+
+// Registers taken by everything the estimate doesn't track. Same as
+// scheduler_utils::register_overhead.
+constexpr int64_t kRegisterOverhead = 40;
+
+// Maximum registers per thread allowed by ptxas
+constexpr int64_t kMaxRegisters = 255;
+
+constexpr int64_t kBytesPerRegister = 4;
+
+// Registers in use at a point of the kernel
+struct LiveRegisters {
+  int64_t buffers = 0;
+  int64_t vectorized = 0;
+  int64_t scalars = 0;
+
+  int64_t total() const {
+    return buffers + scalars;
+  }
+
+  void add(const LiveRegisters& other) {
+    buffers += other.buffers;
+    vectorized += other.vectorized;
+    scalars += other.scalars;
+  }
+
+  void subtract(const LiveRegisters& other) {
+    buffers -= other.buffers;
+    vectorized -= other.vectorized;
+    scalars -= other.scalars;
+  }
+};
+
+bool isVectorized(TensorView* tv) {
+  return std::any_of(
+      tv->getLeafDomain().begin(), tv->getLeafDomain().end(), [](auto id) {
+        return isParallelTypeVectorize(id->getParallelType());
+      });
+}
+
+class RegisterPressureEstimator : public kir::IrVisitor {
+ public:
+  static RegisterPressure get(const kir::Kernel* kernel) {
+    RegisterPressureEstimator estimator(kernel);
+    RegisterPressure pressure;
+    pressure.buffer_registers = estimator.peak_.buffers;
+    pressure.vectorized_registers = estimator.peak_.vectorized;
+    pressure.scalar_registers = estimator.peak_.scalars;
+    pressure.registers =
+        std::min(kMaxRegisters, kRegisterOverhead + estimator.peak_.total());
+    return pressure;
+  }
+
+ private:
+  RegisterPressureEstimator(const kir::Kernel* kernel)
+      : index_type_(kernel->indexType()) {
+    // Registers allocated at the top level of the kernel
+    scopes_.emplace_back();
+    handle(kernel->topLevelExprs());
+  }
+
+  using kir::IrVisitor::handle;
+
+  void handle(kir::ForLoop* loop) final {
+    // Loops that are not materialized don't start a scope of registers
+    if (loop->isTrivial() || loop->vectorize()) {
+      kir::IrVisitor::handle(loop);
+      return;
+    }
+
+    const bool unrolled = loop->isUnrolled();
+    int64_t unroll_factor = 1;
+    if (unrolled) {
+      auto extent = expr_eval_.evaluate(loop->iter_domain()->extent());
+      if (extent.hasValue()) {
+        unroll_factor = std::max<int64_t>(extent.as<int64_t>(), 1);
+      }
+    }
+    unroll_factors_.push_back(unroll_factor);
+    scopes_.emplace_back();
+
+    if (!unrolled) {
+      LiveRegisters index;
+      index.scalars = registers(loop->index()->dtype(), 1);
+      allocate(index);
+    }
+    kir::IrVisitor::handle(loop);
+
+    live_.subtract(scopes_.back());
+    scopes_.pop_back();
+    unroll_factors_.pop_back();
+  }
+
+  void handle(kir::Allocate* alloc) final {
+    if (alloc->memoryType() != MemoryType::Local || alloc->alias() != nullptr) {
+      return;
+    }
+    auto size = expr_eval_.evaluate(alloc->size());
+    if (!size.hasValue()) {
+      return;
+    }
+
+    LiveRegisters alloc_registers;
+    const auto num_registers =
+        registers(alloc->buffer()->dtype(), size.as<int64_t>());
+    if (auto tv = dynamic_cast<TensorView*>(alloc->buffer())) {
+      alloc_registers.buffers = num_registers;
+      if (isVectorized(tv)) {
+        alloc_registers.vectorized = num_registers;
+      }
+    } else {
+      // A scalar is computed in each iteration of the unrolled loops
+      int64_t replicas = 1;
+      for (auto factor : unroll_factors_) {
+        replicas *= factor;
+      }
+      alloc_registers.scalars = num_registers * replicas;
+    }
+    allocate(alloc_registers);
+  }
+
+  int64_t registers(DataType dtype, int64_t num_elements) const {
+    return ceilDiv(
+        num_elements * dataTypeSize(dtype, index_type_), kBytesPerRegister);
+  }
+
+  // Registers live until the end of the current scope
+  void allocate(const LiveRegisters& alloc_registers) {
+    scopes_.back().add(alloc_registers);
+    live_.add(alloc_registers);
+    if (live_.total() > peak_.total()) {
+      peak_ = live_;
+    }
+  }
+
+ private:
+  const PrimDataType index_type_;
+
+  ExpressionEvaluator expr_eval_;
+
+  // Registers allocated in each enclosing scope
+  std::vector<LiveRegisters> scopes_;
+
+  // Extents of the enclosing materialized loops that are unrolled, or 1
+  std::vector<int64_t> unroll_factors_;
+
+  LiveRegisters live_;
+
+  LiveRegisters peak_;
+};
+
+} // namespace
+
+RegisterPressure estimateRegisterPressure(const kir::Kernel* kernel) {
+  return RegisterPressureEstimator::get(kernel);
+}
+
+} // namespace nvfuser
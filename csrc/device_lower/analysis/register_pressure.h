@@ -0,0 +1,50 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <kernel.h>
+
+#include <cstdint>
+
+namespace nvfuser {
+
+//! Static estimate of the registers used by each thread of a lowered kernel.
+//! The exact count is only known after ptxas (see
+//! DebugDumpOption::PrintPtxasLog); this is meant to be cheap enough to be
+//! computed for every compiled kernel.
+//!
+//! The estimate assumes that:
+//!
+//!   1. Local allocations are kept in registers from the allocation to the
+//!      end of its scope. Allocations aliasing another allocation don't use
+//!      any register.
+//!   2. Each hoisted scalar (index, predicate, ...) takes registers for the
+//!      whole of its scope. A scalar allocated in an unrolled loop is
+//!      replicated for each iteration of the loop.
+//!   3. The index of a materialized loop that isn't unrolled takes
+//!      registers for the whole loop.
+//!   4. Everything else, e.g., addresses of the kernel arguments and
+//!      temporaries of the expressions, takes a fixed number of registers.
+//!
+//! Registers are 4 bytes, so 64-bit values take two registers.
+struct RegisterPressure {
+  //! Registers of the local buffers live at the peak
+  int64_t buffer_registers = 0;
+  //! Registers of the buffers of buffer_registers with vectorized accesses
+  int64_t vectorized_registers = 0;
+  //! Registers of the scalars and loop indices live at the peak
+  int64_t scalar_registers = 0;
+  //! Estimated registers per thread, including the fixed overhead. This is
+  //! capped at 255, the limit of ptxas.
+  int64_t registers = 0;
+};
+
+RegisterPressure estimateRegisterPressure(const kir::Kernel* kernel);
+
+} // namespace nvfuser
@@ -25,6 +25,7 @@
 #include <device_lower/pass/misaligned_vectorization.h>
 #include <device_lower/pass/predicate.h>
 #include <device_lower/pass/replace_size.h>
+#include <device_lower/pass/scan.h>
 #include <device_lower/pass/unroll.h>
 #include <device_lower/pass/vectorize_welford.h>
 #include <device_lower/pass/warp_reduce.h>
@@ -477,10 +478,13 @@ void GpuLower::lower(Fusion* fusion) {
       IndexLowering::getIndexedExprs(exprs_unrolled_mv_loops);
   dumpExprsIfEnabled(exprs_indexed_loops, "IndexLowering");
 
+  const auto exprs_scan_lowered = lowerScans(exprs_indexed_loops);
+  dumpExprsIfEnabled(exprs_scan_lowered, "lowerScans");
+
   // TODO: It seems this type of optimization would be far easier to implement
   // on fusion ir than kernel ir. We should likely refactor this to at least run
   // before allocation insertion.
-  const auto exprs_with_fused_broadcast = fuseWarpReduce(exprs_indexed_loops);
+  const auto exprs_with_fused_broadcast = fuseWarpReduce(exprs_scan_lowered);
   dumpExprsIfEnabled(exprs_with_fused_broadcast, "fuseWarpReduce");
 
   const auto exprs_conditional_loops =
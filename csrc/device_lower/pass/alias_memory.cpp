@@ -11,14 +11,20 @@
 #include <device_lower/lower2device.h>
 #include <device_lower/utils.h>
 #include <expr_evaluator.h>
+#include <expr_simplifier.h>
 #include <instrumentation.h>
 #include <ir/iostream.h>
 #include <ir/utils.h>
 #include <kernel_ir.h>
 #include <kernel_ir_dispatch.h>
+#include <memory_planner.h>
 #include <ops/arith.h>
 #include <options.h>
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <optional>
 #include <sstream>
 #include <unordered_map>
 #include <unordered_set>
@@ -1503,6 +1509,13 @@ Val* allocSizeBytes(kir::Allocate* alloc) {
   return size;
 }
 
+//! Addresses of the unaliased shared memory allocations
+struct SharedMemoryLayout {
+  std::unordered_map<AllocationInfo*, Val*> addresses;
+  //! Bytes used by the allocations, i.e., the end of the highest one
+  Val* size = nullptr;
+};
+
 //! Allocate differently-sized buffers using a single pass where we push
 //! allocations on a stack then pop them after their last read. This only does
 //! outer sharing: inner sharing is only valid for aliasing.
@@ -1651,7 +1664,7 @@ class StackBasedSharedMemAllocator : kir::IrVisitor {
   StackBasedSharedMemAllocator(const AllocationInfoMap& allocation_info_map)
       : allocation_info_map_(allocation_info_map) {}
 
-  void allocate(const std::vector<Expr*>& exprs) {
+  SharedMemoryLayout allocate(const std::vector<Expr*>& exprs) {
     recordEvents();
 
     // Traverse expressions: reclaim memory when we pass a blockSync, append to
@@ -1661,6 +1674,29 @@ class StackBasedSharedMemAllocator : kir::IrVisitor {
     // This is done whenever we pass a syncing op, but we need to do it again in
     // case there are some allocations waiting around to be allocated.
     sortPushAndAssignWaiting();
+
+    // The addresses are sorted by name so that the size expression is
+    // deterministic
+    std::vector<AllocationInfo*> alloc_infos;
+    for (const auto& [alloc_info, address] : layout_.addresses) {
+      alloc_infos.push_back(alloc_info);
+    }
+    std::sort(
+        alloc_infos.begin(),
+        alloc_infos.end(),
+        [](AllocationInfo* a, AllocationInfo* b) {
+          return a->alloc_expr->name() < b->alloc_expr->name();
+        });
+    Val* size = FusionGuard::getCurFusion()->zeroVal();
+    for (auto alloc_info : alloc_infos) {
+      size = SimplifyingIrBuilder::maxExpr(
+          size,
+          SimplifyingIrBuilder::addExpr(
+              layout_.addresses.at(alloc_info),
+              allocSizeBytes(alloc_info->alloc_expr)));
+    }
+    layout_.size = simplifyExpr(size);
+    return std::move(layout_);
   }
 
  private:
@@ -1732,19 +1768,20 @@ class StackBasedSharedMemAllocator : kir::IrVisitor {
 
   void assignNextAddress(AllocationInfo* alloc_info) {
     auto alloc = alloc_info->alloc_expr;
+    Val* address = nullptr;
     if (alloc_stack_.empty()) {
-      alloc->setAddress(FusionGuard::getCurFusion()->zeroVal());
+      address = FusionGuard::getCurFusion()->zeroVal();
     } else {
       auto top_alloc = alloc_stack_.back()->alloc_expr;
       auto top_size = allocSizeBytes(top_alloc);
-      auto unaligned_address =
-          SimplifyingIrBuilder::addExpr(top_alloc->address(), top_size);
-      auto aligned_address = alignExpr(unaligned_address);
+      auto unaligned_address = SimplifyingIrBuilder::addExpr(
+          layout_.addresses.at(alloc_stack_.back()), top_size);
       // TODO: hoisting of addresses using for_loops_ recorded at first write
-      alloc->setAddress(aligned_address);
+      address = alignExpr(unaligned_address);
     }
+    layout_.addresses[alloc_info] = address;
     if (isDebugDumpEnabled(DebugDumpOption::BufferReuseInfo)) {
-      debug() << "Assigned address " << alloc->address()->toInlineString()
+      debug() << "Assigned address " << address->toInlineString()
               << " for T" << alloc->buffer()->name() << " with size "
               << alloc->size()->toInlineString() << " * "
               << dataTypeSize(alloc->buffer()->dtype()) << " bytes"
@@ -1810,7 +1847,8 @@ class StackBasedSharedMemAllocator : kir::IrVisitor {
           auto alloc = alloc_stack_.back()->alloc_expr;
           debug() << "Popping allocation for T" << alloc->buffer()->name()
                   << " which has assigned address "
-                  << alloc->address()->toInlineString() << std::endl;
+                  << layout_.addresses.at(alloc_stack_.back())->toInlineString()
+                  << std::endl;
         }
         alloc_stack_.pop_back();
       } else {
@@ -1846,6 +1884,170 @@ class StackBasedSharedMemAllocator : kir::IrVisitor {
   // At the last moment, i.e. when one of them needs to be popped, we sort these
   // in descending order of their last read, and push them onto the stack.
   std::vector<AllocationInfo*> waiting_to_push_;
+
+  SharedMemoryLayout layout_;
+};
+
+//! Assign addresses to shared memory allocations by interval coloring, see
+//! planWorkspace. As with StackBasedSharedMemAllocator, the memory of an
+//! allocation can only be reused once a block synchronization follows its
+//! last read, so each allocation is live from its first write to the first
+//! block sync at or after its last (aliased) read. Unlike the stack, an
+//! allocation can be placed in any gap left between the live allocations,
+//! not only above the highest one, which avoids the fragmentation of kernels
+//! with many buffers of different lifetimes.
+//!
+//! planWorkspace works on constant sizes, so only the allocations whose
+//! sizes simplify to a constant are packed by it. The others are placed
+//! above them, see placeSymbolic.
+class BestFitSharedMemAllocator : kir::IrVisitor {
+ public:
+  BestFitSharedMemAllocator(const AllocationInfoMap& allocation_info_map)
+      : allocation_info_map_(allocation_info_map) {}
+
+  SharedMemoryLayout allocate(const std::vector<Expr*>& exprs) {
+    std::vector<AllocationInfo*> const_infos;
+    std::vector<BufferLifetime> const_buffers;
+    std::vector<AllocationInfo*> symbolic_infos;
+    std::vector<Val*> symbolic_sizes;
+    std::vector<BufferLifetime> symbolic_buffers;
+    for (auto& alloc_info : allocation_info_map_.allAllocationInfos()) {
+      if (alloc_info->mem_type != MemoryType::Shared || alloc_info->alias_to) {
+        continue;
+      }
+      auto size = simplifyExpr(allocSizeBytes(alloc_info->alloc_expr));
+      const auto first_write = alloc_info->outer_live_interval->firstWrite();
+      BufferLifetime buffer{
+          0,
+          first_write,
+          std::max(first_write, alloc_info->getAliasedOuterLastRead())};
+      if (size->isConstInt()) {
+        buffer.size = size->evaluateInt();
+        const_infos.push_back(alloc_info.get());
+        const_buffers.push_back(buffer);
+      } else {
+        symbolic_infos.push_back(alloc_info.get());
+        symbolic_sizes.push_back(size);
+        symbolic_buffers.push_back(buffer);
+      }
+    }
+
+    // Collect the positions of block syncs
+    handle(exprs);
+
+    // Memory is reclaimed at the first sync at or after the last read, or
+    // never if there is none
+    for (auto buffers : {&const_buffers, &symbolic_buffers}) {
+      for (auto& buffer : *buffers) {
+        buffer.last_step = reclaimPosition(buffer.last_step);
+      }
+    }
+
+    const auto workspace = planWorkspace(const_buffers, kAlignment);
+    SharedMemoryLayout layout;
+    int64_t const_size = 0;
+    for (auto i : c10::irange(const_infos.size())) {
+      const auto offset = workspace.offsets.at(i);
+      layout.addresses[const_infos.at(i)] =
+          IrBuilder::create<Val>(offset, DataType::Index);
+      const_size = std::max(const_size, offset + const_buffers.at(i).size);
+    }
+    layout.size = IrBuilder::create<Val>(const_size, DataType::Index);
+
+    placeSymbolic(symbolic_infos, symbolic_sizes, symbolic_buffers, layout);
+    return layout;
+  }
+
+ private:
+  void dispatch(Expr* expr) final {
+    if (lower_utils::hasBlockSync(expr, GpuLower::current()->threadPredMap())) {
+      auto position = allocation_info_map_.getScopeMap().getExprPos(expr);
+      // Positions are visited in increasing order
+      if (sync_positions_.empty() || sync_positions_.back() < position) {
+        sync_positions_.push_back(position);
+      }
+    }
+    kir::IrVisitor::dispatch(expr);
+  }
+
+  //! Position of the first block sync at or after last_read, or the end of
+  //! the kernel if there is none
+  int64_t reclaimPosition(int64_t last_read) const {
+    auto sync_it = std::lower_bound(
+        sync_positions_.begin(), sync_positions_.end(), last_read);
+    return sync_it == sync_positions_.end()
+        ? std::numeric_limits<int64_t>::max()
+        : *sync_it;
+  }
+
+  //! Place the allocations whose sizes are not constant above the highest
+  //! constant one. Their addresses are expressions of the sizes, so they are
+  //! placed in slots one after the other, in the order of their first
+  //! writes. An allocation reuses the slot of dead allocations if the slot
+  //! is proven at least as large with simplifyExpr, and takes a new slot
+  //! otherwise.
+  void placeSymbolic(
+      const std::vector<AllocationInfo*>& alloc_infos,
+      const std::vector<Val*>& sizes,
+      const std::vector<BufferLifetime>& buffers,
+      SharedMemoryLayout& layout) {
+    std::vector<size_t> order(alloc_infos.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      if (buffers.at(a).first_step != buffers.at(b).first_step) {
+        return buffers.at(a).first_step < buffers.at(b).first_step;
+      }
+      // break ties so that allocations will be deterministic
+      return alloc_infos.at(a)->alloc_expr->name() <
+          alloc_infos.at(b)->alloc_expr->name();
+    });
+
+    struct Slot {
+      Val* address = nullptr;
+      Val* size = nullptr;
+      //! Position at which the memory of the slot is reclaimed
+      int64_t last_step = 0;
+    };
+    std::vector<Slot> slots;
+    for (auto i : order) {
+      auto size = sizes.at(i);
+      const auto& buffer = buffers.at(i);
+      auto slot_it =
+          std::find_if(slots.begin(), slots.end(), [&](const Slot& slot) {
+            return slot.last_step < buffer.first_step &&
+                (slot.size->sameAs(size) ||
+                 simplifyExpr(SimplifyingIrBuilder::geExpr(slot.size, size))
+                     ->isTrue());
+          });
+      if (slot_it == slots.end()) {
+        auto address = slots.empty()
+            ? alignExpr(layout.size)
+            : alignExpr(SimplifyingIrBuilder::addExpr(
+                  slots.back().address, slots.back().size));
+        slots.push_back({simplifyExpr(address), size, buffer.last_step});
+        slot_it = std::prev(slots.end());
+        layout.size = simplifyExpr(
+            SimplifyingIrBuilder::addExpr(slot_it->address, size));
+      } else {
+        slot_it->last_step = buffer.last_step;
+      }
+      layout.addresses[alloc_infos.at(i)] = slot_it->address;
+      if (isDebugDumpEnabled(DebugDumpOption::BufferReuseInfo)) {
+        debug() << "Best-fit address " << slot_it->address->toInlineString()
+                << " for T" << alloc_infos.at(i)->alloc_expr->buffer()->name()
+                << " of non-constant size " << size->toInlineString()
+                << std::endl;
+      }
+    }
+  }
+
+  //! Same alignment as alignExpr
+  static constexpr int64_t kAlignment = 16;
+
+  const AllocationInfoMap& allocation_info_map_;
+
+  //! Sorted positions of the exprs synchronizing the block
+  std::vector<int64_t> sync_positions_;
 };
 
 } // namespace
@@ -2001,11 +2203,35 @@ std::pair<std::vector<Expr*>, bool> promoteReuseSyncs(
 
 // Assign addresses for dynamic shared memory allocations. This re-uses memory
 // by reclaiming memory that is unused when encountering a block
-// synchronization.
+// synchronization. With EnableOption::SmemBestFit, the layout of
+// BestFitSharedMemAllocator is used instead of the stack unless it is proven
+// to take as much memory or more.
 void assignSharedMemoryAllocations(
     const std::vector<Expr*>& exprs,
     AllocationInfoMap& allocation_info_map) {
-  StackBasedSharedMemAllocator(allocation_info_map).allocate(exprs);
+  auto layout =
+      StackBasedSharedMemAllocator(allocation_info_map).allocate(exprs);
+  if (isOptionEnabled(EnableOption::SmemBestFit)) {
+    auto best_fit_layout =
+        BestFitSharedMemAllocator(allocation_info_map).allocate(exprs);
+    // With constant sizes, the best-fit layout is used if it takes fewer
+    // bytes. Sizes that aren't constant can rarely be compared, so it is
+    // then used unless it is proven to take at least as many.
+    if (!simplifyExpr(
+             SimplifyingIrBuilder::geExpr(best_fit_layout.size, layout.size))
+             ->isTrue()) {
+      if (isDebugDumpEnabled(DebugDumpOption::BufferReuseInfo)) {
+        debug() << "Best-fit shared memory allocation takes "
+                << best_fit_layout.size->toInlineString()
+                << " bytes instead of " << layout.size->toInlineString()
+                << std::endl;
+      }
+      layout = std::move(best_fit_layout);
+    }
+  }
+  for (const auto& [alloc_info, address] : layout.addresses) {
+    alloc_info->alloc_expr->setAddress(address);
+  }
 
   // Verify that all smem allocations have a non-null address now
   for (auto& alloc_info : allocation_info_map.allAllocationInfos()) {
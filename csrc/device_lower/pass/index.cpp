@@ -582,6 +582,30 @@ void IndexLowering::handle(const ReductionOp* rop) {
   }
 }
 
+void IndexLowering::handle(const ScanOp* sop) {
+  NVF_ERROR(ir_utils::isTvOp(sop));
+
+  const auto out = lowerDstIndex(sop->out());
+  const auto in = lowerSrcIndex(sop->in(), sop->out());
+
+  // The accumulator is inserted by the scan lowering pass, which needs the
+  // loop structure that is not available here
+  Expr* indexed_sop = IrBuilder::create<ScanOp>(
+      sop->getScanOpType(),
+      sop->init(),
+      out,
+      in,
+      sop->dim(),
+      sop->isExclusive());
+  // Block scans are not put in an IfThenElse since all the threads of the
+  // block must take part in them
+  if (sop->predicate()) {
+    indexed_sop = indexed_sop->withPredicate(sop->predicate());
+  }
+  pushBack(indexed_sop);
+  GpuLower::current()->propagateExprInfo(sop, back());
+}
+
 void IndexLowering::handleBlockReduction(
     const ReductionOp* rop,
     Val* out,
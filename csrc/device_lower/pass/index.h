@@ -63,6 +63,7 @@ class IndexLowering : private OptOutConstDispatch {
   void handle(const ScatterOp*) final;
   void handle(const RNGOp*) final;
   void handle(const ReductionOp*) final;
+  void handle(const ScanOp*) final;
   void handle(const GroupedReductionOp*) final;
   void handle(const WelfordOp*) final;
   void handle(const GroupedWelfordOp*) final;
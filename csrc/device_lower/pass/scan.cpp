@@ -0,0 +1,186 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <device_lower/pass/scan.h>
+
+#include <device_lower/lower2device.h>
+#include <device_lower/utils.h>
+#include <instrumentation.h>
+#include <ir/builder.h>
+#include <kernel_ir.h>
+#include <kernel_ir_dispatch.h>
+
+#include <c10/util/irange.h>
+
+namespace nvfuser {
+
+namespace {
+
+class ScanLowering : public kir::ExprMutator {
+ public:
+  static std::vector<Expr*> lower(const std::vector<Expr*>& exprs) {
+    ScanLowering lowering(exprs);
+    return lowering.exprs_;
+  }
+
+ private:
+  ScanLowering(const std::vector<Expr*>& exprs) {
+    kir::ExprMutator::traverseAndInsert(exprs);
+  }
+
+  using kir::ExprMutator::handle;
+
+  void handle(ScanOp* sop) final {
+    NVF_ERROR(
+        sop->out()->isA<kir::TensorIndex>(),
+        "Scan operation is expected to be indexed: ",
+        sop->toString());
+
+    auto acc = IrBuilder::create<Val>(sop->out()->dtype());
+    auto alloc = IrBuilder::create<kir::Allocate>(
+        acc, MemoryType::Local, GpuLower::current()->kernel()->oneVal());
+    auto init =
+        IrBuilder::create<LoadStoreOp>(LoadStoreOpType::Set, acc, sop->init());
+
+    // Initialize the accumulator before the loop of the scanned axis. A
+    // scan of a broadcast axis has a single iteration, which may be
+    // expanded by the loop of a concretized domain, so it's initialized
+    // right before the scan.
+    const bool is_block_scan = lower_utils::isBlockScan(sop);
+    auto scan_loop = is_block_scan ? findBlockScanLoop(sop) : findScanLoop(sop);
+    if (scan_loop == nullptr) {
+      registerInsertBefore(sop, alloc);
+      registerInsertBefore(sop, init);
+    } else {
+      auto scope = scopeOf(scan_loop);
+      registerInsertBefore(scan_loop, alloc, scope);
+      registerInsertBefore(scan_loop, init, scope);
+    }
+
+    // The accumulator carries the scan across the iterations of the serial
+    // loop, and the threads of the block scan the elements of an iteration
+    if (is_block_scan) {
+      Expr* block_scan = IrBuilder::create<kir::BlockScan>(
+          sop->getScanOpType(),
+          sop->init(),
+          sop->out(),
+          sop->in(),
+          acc,
+          sop->dim(),
+          sop->isExclusive());
+      if (sop->predicate() != nullptr) {
+        block_scan = block_scan->withPredicate(sop->predicate());
+      }
+      registerReplace(sop, block_scan);
+      return;
+    }
+
+    auto update = IrBuilder::create<BinaryOp>(
+        sop->getScanOpType(), acc, acc, sop->in());
+    auto store =
+        IrBuilder::create<LoadStoreOp>(LoadStoreOpType::Set, sop->out(), acc);
+    if (sop->isExclusive()) {
+      registerInsertBefore(sop, store);
+      registerReplace(sop, update);
+    } else {
+      registerInsertBefore(sop, update);
+      registerReplace(sop, store);
+    }
+  }
+
+  // Returns the loop of the scanned axis, or nullptr if the scanned axis is
+  // a broadcast
+  kir::ForLoop* findScanLoop(ScanOp* sop) const {
+    auto scan_id = sop->getScanDomain();
+    if (scan_id->isBroadcast()) {
+      return nullptr;
+    }
+
+    const auto& leaf_domain =
+        sop->out()->as<kir::TensorIndex>()->view()->getLeafDomain();
+    NVF_ERROR(
+        std::find(leaf_domain.begin(), leaf_domain.end(), scan_id) !=
+            leaf_domain.end(),
+        "The scanned axis must not be transformed: ",
+        sop->toString());
+    NVF_ERROR(
+        !scan_id->isParallelized(),
+        "Scan along a parallelized axis is not supported: ",
+        sop->toString());
+
+    return findInnermostLoop(sop, scan_id);
+  }
+
+  // Returns the serial loop of a block scan. The scanned axis must be split
+  // into that loop and an inner TIDx domain.
+  kir::ForLoop* findBlockScanLoop(ScanOp* sop) const {
+    auto scan_id = sop->getScanDomain();
+    const auto& leaf_domain =
+        sop->out()->as<kir::TensorIndex>()->view()->getLeafDomain();
+    auto tidx_it = std::find_if(
+        leaf_domain.begin(), leaf_domain.end(), [](IterDomain* id) {
+          return id->getParallelType() == ParallelType::TIDx;
+        });
+    auto split = tidx_it == leaf_domain.end()
+        ? nullptr
+        : dynamic_cast<Split*>((*tidx_it)->definition());
+    NVF_ERROR(
+        split != nullptr && split->in() == scan_id &&
+            split->inner() == *tidx_it && !split->outer()->isParallelized() &&
+            std::find(leaf_domain.begin(), leaf_domain.end(), split->outer()) !=
+                leaf_domain.end(),
+        "A block scan must split the scanned axis into a serial domain and ",
+        "an inner TIDx domain: ",
+        sop->toString());
+
+    return findInnermostLoop(sop, split->outer());
+  }
+
+  // Returns the loop of id, which must be the innermost non-trivial loop
+  kir::ForLoop* findInnermostLoop(ScanOp* sop, IterDomain* id) const {
+    auto it = std::find_if(
+        for_loops_.begin(), for_loops_.end(), [&](kir::ForLoop* fl) {
+          return GpuLower::current()->caMap()->areMapped(
+              fl->iter_domain(), id, IdMappingMode::LOOP);
+        });
+    NVF_ERROR(
+        it != for_loops_.end(),
+        "Could not find the loop of the scanned axis: ",
+        sop->toString());
+
+    NVF_ERROR(
+        std::all_of(
+            it + 1,
+            for_loops_.end(),
+            [](kir::ForLoop* fl) { return fl->isTrivial(); }),
+        "The scanned axis must be the innermost non-trivial loop: ",
+        sop->toString());
+
+    return *it;
+  }
+
+  // Returns the scope that contains the given loop. nullptr means the
+  // top-level scope.
+  kir::Scope* scopeOf(kir::ForLoop* fl) const {
+    for (auto i : c10::irange(scope_.size())) {
+      if (scope_.at(i) == &fl->body()) {
+        return i == 0 ? nullptr : scope_.at(i - 1);
+      }
+    }
+    NVF_ERROR(false, "Scope of loop not found: ", fl->toString());
+    return nullptr;
+  }
+};
+
+} // namespace
+
+std::vector<Expr*> lowerScans(const std::vector<Expr*>& exprs) {
+  FUSER_PERF_SCOPE("GpuLower::Lower::lowerScans");
+  return ScanLowering::lower(exprs);
+}
+
+} // namespace nvfuser
@@ -0,0 +1,54 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <vector>
+
+namespace nvfuser {
+
+class Expr;
+
+// Lower indexed ScanOps to a serial scan carried by a scalar
+// accumulator. For example, an inclusive scan:
+//
+// for (i) {
+//   if (pred) {
+//     T1[i] = scan(T0[i]);
+//   }
+// }
+//
+// is transformed as:
+//
+// float acc;
+// acc = init;
+// for (i) {
+//   if (pred) {
+//     acc = op(acc, T0[i]);
+//     T1[i] = acc;
+//   }
+// }
+//
+// For exclusive scans, T1[i] is written before acc is updated. The loop
+// of the scanned axis must be serial and all the loops inside of it must
+// be trivial, i.e., the scanned axis needs to be the innermost
+// non-trivial axis of the scan output.
+//
+// When the scanned axis is split into a serial outer domain and an inner
+// TIDx domain, the ScanOp is replaced with a kir::BlockScan instead. The
+// accumulator is then initialized before the serial loop and carries the
+// scan of the previous iterations:
+//
+// float acc;
+// acc = init;
+// for (i) {
+//   blockScan(T1[i * bdimx + tidx], T0[i * bdimx + tidx], acc, pred);
+// }
+std::vector<Expr*> lowerScans(const std::vector<Expr*>& exprs);
+
+} // namespace nvfuser
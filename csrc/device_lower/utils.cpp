@@ -145,6 +145,7 @@ bool isTvOp(const Expr* expr) {
           IotaOp,
           EyeOp,
           ReductionOp,
+          ScanOp,
           GroupedReductionOp,
           WelfordOp,
           GroupedWelfordOp,
@@ -160,6 +161,7 @@ bool isTvOp(const Expr* expr) {
           PadOp,
           SliceOp,
           CatOp,
+          kir::BlockScan,
           kir::GridReduction,
           kir::GroupedGridReduction,
           kir::GridBroadcast,
@@ -658,6 +660,10 @@ bool hasBlockSync(const Expr* expr, const ThreadPredicateMap& pred_map) {
     return true;
   }
 
+  if (isBlockScan(expr)) {
+    return true;
+  }
+
   if (!ir_utils::isTvOp(expr)) {
     return false;
   }
@@ -682,6 +688,20 @@ bool hasBlockSync(const Expr* expr, const ThreadPredicateMap& pred_map) {
   return false;
 }
 
+bool isBlockScan(const Expr* expr) {
+  auto sop = dynamic_cast<const ScanOp*>(expr);
+  if (sop == nullptr) {
+    return false;
+  }
+  IterDomain* scan_id = sop->getScanDomain();
+  const auto& leaf_domain = ir_utils::getTvOutput(sop)->getLeafDomain();
+  return std::any_of(
+      leaf_domain.begin(), leaf_domain.end(), [scan_id](IterDomain* id) {
+        return id != scan_id && id->isThreadDim() &&
+            DependencyCheck::isDependencyOf(scan_id, id);
+      });
+}
+
 kir::Allocate* allocGlobalBufferForGridComm(
     Val* buffer_size,
     DataType dtype,
@@ -251,6 +251,10 @@ namespace lower_utils {
 
 bool hasBlockSync(const Expr* expr, const ThreadPredicateMap& pred_map);
 
+//! Returns true if expr is a ScanOp whose scanned axis is split into thread
+//!  parallel domains, i.e., the threads of a block scan it together
+bool isBlockScan(const Expr* expr);
+
 // Allocate global buffer for a grid communication calls, i.e. grid reduce, grid
 // welford reduce, grid broadcast.
 kir::Allocate* allocGlobalBufferForGridComm(
@@ -152,6 +152,10 @@ void Expr::dispatch(T handler, Expr* expr) {
     ptr(handler)->handle(expr->as<ScatterOp>());
     return;
   }
+  if (expr->isStrictlyA<ScanOp>()) {
+    ptr(handler)->handle(expr->as<ScanOp>());
+    return;
+  }
   if (expr->isStrictlyA<RNGOp>()) {
     ptr(handler)->handle(expr->as<RNGOp>());
     return;
@@ -300,6 +304,10 @@ void Expr::dispatch(T handler, Expr* expr) {
     ptr(handler)->handle(expr->as<kir::IfThenElse>());
     return;
   }
+  if (expr->isStrictlyA<kir::BlockScan>()) {
+    ptr(handler)->handle(expr->as<kir::BlockScan>());
+    return;
+  }
   if (expr->isStrictlyA<kir::GridReduction>()) {
     ptr(handler)->handle(expr->as<kir::GridReduction>());
     return;
@@ -464,6 +472,10 @@ void Expr::constDispatch(T handler, const Expr* expr) {
     ptr(handler)->handle(expr->as<ScatterOp>());
     return;
   }
+  if (expr->isStrictlyA<ScanOp>()) {
+    ptr(handler)->handle(expr->as<ScanOp>());
+    return;
+  }
   if (expr->isStrictlyA<RNGOp>()) {
     ptr(handler)->handle(expr->as<RNGOp>());
     return;
@@ -612,6 +624,10 @@ void Expr::constDispatch(T handler, const Expr* expr) {
     ptr(handler)->handle(expr->as<kir::IfThenElse>());
     return;
   }
+  if (expr->isStrictlyA<kir::BlockScan>()) {
+    ptr(handler)->handle(expr->as<kir::BlockScan>());
+    return;
+  }
   if (expr->isStrictlyA<kir::GridReduction>()) {
     ptr(handler)->handle(expr->as<kir::GridReduction>());
     return;
@@ -896,6 +912,9 @@ void OptOutConstDispatch::handle(const TorchGatherOp* stmt) {
 void OptOutConstDispatch::handle(const ScatterOp* stmt) {
   unhandled(stmt);
 }
+void OptOutConstDispatch::handle(const ScanOp* stmt) {
+  unhandled(stmt);
+}
 void OptOutConstDispatch::handle(const RNGOp* stmt) {
   unhandled(stmt);
 }
@@ -1009,6 +1028,9 @@ void OptOutConstDispatch::handle(const kir::ForLoop* stmt) {
 void OptOutConstDispatch::handle(const kir::IfThenElse* stmt) {
   unhandled(stmt);
 }
+void OptOutConstDispatch::handle(const kir::BlockScan* stmt) {
+  unhandled(stmt);
+}
 void OptOutConstDispatch::handle(const kir::GridReduction* stmt) {
   unhandled(stmt);
 }
@@ -1126,6 +1148,9 @@ void OptOutDispatch::handle(TorchGatherOp* stmt) {
 void OptOutDispatch::handle(ScatterOp* stmt) {
   unhandled(stmt);
 }
+void OptOutDispatch::handle(ScanOp* stmt) {
+  unhandled(stmt);
+}
 void OptOutDispatch::handle(RNGOp* stmt) {
   unhandled(stmt);
 }
@@ -1239,6 +1264,9 @@ void OptOutDispatch::handle(kir::ForLoop* stmt) {
 void OptOutDispatch::handle(kir::IfThenElse* stmt) {
   unhandled(stmt);
 }
+void OptOutDispatch::handle(kir::BlockScan* stmt) {
+  unhandled(stmt);
+}
 void OptOutDispatch::handle(kir::GridReduction* stmt) {
   unhandled(stmt);
 }
@@ -89,6 +89,7 @@ class SelectOp;
 class IndexSelectOp;
 class TorchGatherOp;
 class ScatterOp;
+class ScanOp;
 class RNGOp;
 class ReductionOp;
 class GroupedReductionOp;
@@ -134,6 +135,7 @@ class CpAsyncBulkS2GWait;
 class CpAsyncBulkS2GCommit;
 class ForLoop;
 class IfThenElse;
+class BlockScan;
 class GridReduction;
 class GroupedGridReduction;
 class GridBroadcast;
@@ -190,6 +192,7 @@ class OptOutConstDispatch : public PolymorphicBase {
   virtual void handle(const IndexSelectOp* stmt);
   virtual void handle(const TorchGatherOp* stmt);
   virtual void handle(const ScatterOp* stmt);
+  virtual void handle(const ScanOp* stmt);
   virtual void handle(const RNGOp* stmt);
   virtual void handle(const ReductionOp* stmt);
   virtual void handle(const GroupedReductionOp* stmt);
@@ -229,6 +232,7 @@ class OptOutConstDispatch : public PolymorphicBase {
   virtual void handle(const kir::UpdateMagicZero*);
   virtual void handle(const kir::ForLoop*);
   virtual void handle(const kir::IfThenElse*);
+  virtual void handle(const kir::BlockScan*);
   virtual void handle(const kir::GridReduction*);
   virtual void handle(const kir::GroupedGridReduction*);
   virtual void handle(const kir::GridBroadcast*);
@@ -283,6 +287,7 @@ class OptOutDispatch : public PolymorphicBase {
   virtual void handle(IndexSelectOp* stmt);
   virtual void handle(TorchGatherOp* stmt);
   virtual void handle(ScatterOp* stmt);
+  virtual void handle(ScanOp* stmt);
   virtual void handle(RNGOp* stmt);
   virtual void handle(ReductionOp* stmt);
   virtual void handle(GroupedReductionOp* stmt);
@@ -322,6 +327,7 @@ class OptOutDispatch : public PolymorphicBase {
   virtual void handle(kir::UpdateMagicZero* stmt);
   virtual void handle(kir::ForLoop* stmt);
   virtual void handle(kir::IfThenElse* stmt);
+  virtual void handle(kir::BlockScan* stmt);
   virtual void handle(kir::GridReduction* stmt);
   virtual void handle(kir::GroupedGridReduction* stmt);
   virtual void handle(kir::GridBroadcast* stmt);
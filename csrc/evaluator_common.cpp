@@ -14,6 +14,7 @@
 #include <instrumentation.h>
 #include <ir/utils.h>
 #include <tensor_metadata.h>
+#include <utils.h>
 
 #include <optional>
 
@@ -168,7 +169,7 @@ void PrecomputedValues::bindInputs(const KernelArgumentHolder& args) {
     NVF_ERROR(input != nullptr);
     if (auto tensor_input = dynamic_cast<TensorView*>(input)) {
       const auto& tensor = args[i]->as<at::Tensor>();
-      if (!tensor.is_cpu()) {
+      if (!is_cpu_scalar(tensor)) {
         bindTensorMetaData(tensor_input, tensor);
       }
     } else {
@@ -11,6 +11,7 @@
 #include <codegen.h>
 #include <debug.h>
 #include <device_lower/analysis/bank_conflict.h>
+#include <device_lower/analysis/register_pressure.h>
 #include <driver_api.h>
 #include <executor_kernel_arg.h>
 #include <executor_utils.h>
@@ -33,6 +34,8 @@
 #include <c10/cuda/CUDAStream.h>
 #include <c10/util/irange.h>
 
+#include <array>
+#include <chrono>
 #include <cmath>
 #include <fstream>
 
@@ -186,6 +189,36 @@ std::string FusionExecutor::getStructuredCode() const {
   return getStructuredCode(kernelString(), kernel()->indexType());
 }
 
+std::string FusionExecutor::getStructuredCppCode(
+    const std::string& kernel_str,
+    PrimDataType index_type) const {
+  // The host runtime relies on the standard headers, which can't be
+  // included inside the namespace
+  std::string code = R"ESCAPE(
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+)ESCAPE";
+  code += std::string("namespace ") + FusionExecutor::kernelNamespace() +
+      " {\n" + defineIndexType(index_type) +
+      executor_utils::cppKernelPreamble() + kernel_str + "}\n";
+
+  if (isDebugDumpEnabled(DebugDumpOption::CudaKernel)) {
+    debug() << "\n======= C++ codegen output for kernel: " << kernelName()
+            << " =======\n\n"
+            << kernel_str << "\n======================================\n\n";
+  } else if (isDebugDumpEnabled(DebugDumpOption::CudaFull)) {
+    debug() << "\n======= C++ codegen output for kernel: " << kernelName()
+            << " =======\n\n"
+            << code << "\n======================================\n\n";
+  }
+
+  return code;
+}
+
 // TODO: come up with a more user friendly interface
 void FusionExecutor::debugCompileFusionFromStr(
     Fusion* fusion,
@@ -313,6 +346,13 @@ void FusionExecutor::compileFusion(
     compile_params.index_type = arg_index_type;
   }
 
+  // The C++ backend is opt-in. Otherwise, CPU tensors are rejected as
+  // before, even if the fusion was scheduled for the GPU.
+  if (args.isHostResident() && isOptionEnabled(EnableOption::CppBackend)) {
+    compileFusionForCpu(fusion, compile_params);
+    return;
+  }
+
   c10::DeviceGuard dg(options_.device);
 
   NVF_ERROR(
@@ -366,7 +406,11 @@ void FusionExecutor::compileFusion(
   // The external_structured_code is moved to structured_code and explicitly
   // cleared to avoid use-after-move scenarios.
   auto structured_code = getStructuredCodeFromExternalFiles(fusion_id_);
-  if (structured_code.empty()) {
+  const bool external_code = !structured_code.empty();
+  // The kernel database is queried and filled one kernel at a time
+  const bool defer_compile = defer_nvrtc_compile_ && structured_code.empty() &&
+      !isOptionEnabled(EnableOption::KernelDb);
+  if (structured_code.empty() && !defer_compile) {
     structured_code = getStructuredCode();
   }
 
@@ -418,13 +462,29 @@ void FusionExecutor::compileFusion(
       (block_size.has_value() ? block_size.value() : 1),
       block_size_high_water_mark_);
   maxrregcount_high_water_mark_ = compile_params.maxrregcount;
-  compiled_kernel_ = executor_utils::getCompiledKernel(
-      kernel_code_,
-      structured_code,
-      getCanonicalKernelName(),
-      fusion_id_,
-      compile_params,
-      block_size);
+  compiled_cpp_kernel_.reset();
+  compiled_kernel_.reset();
+  deferred_compile_.reset();
+  // Printed next to the ptxas log to compare the estimate with the count
+  // of ptxas, see test_register_pressure.cpp
+  if (isDebugDumpEnabled(DebugDumpOption::PrintPtxasLog)) {
+    const auto pressure = estimateRegisterPressure(kernel());
+    debug() << "Estimated register usage of " << kernelName() << ": "
+            << pressure.registers << " (buffers " << pressure.buffer_registers
+            << ", vectorized " << pressure.vectorized_registers
+            << ", scalars " << pressure.scalar_registers << ")" << std::endl;
+  }
+  if (defer_compile) {
+    deferred_compile_ =
+        DeferredCompile{compile_params, block_size, dynamic_smem};
+    return;
+  }
+  compiled_kernel_ = compileKernelCode(
+      structured_code, compile_params, block_size, external_code);
+  finishCompile(dynamic_smem);
+}
+
+void FusionExecutor::finishCompile(std::optional<int64_t> dynamic_smem) {
   NVF_ERROR(fusion_id_ > 0, "failed to assign a fusion_id_ after compilation.");
 
   // These should be nullopt at this point, but reset just in case
@@ -441,6 +501,137 @@ void FusionExecutor::compileFusion(
   }
 }
 
+std::string FusionExecutor::deferredCompileKey() const {
+  NVF_ERROR(
+      deferred_compile_.has_value(), "No kernel is waiting to be compiled");
+  // The options depend on the architecture of the device
+  c10::DeviceGuard dg(options_.device);
+  std::stringstream ss;
+  ss << options_.device << " " << DataType(kernel()->indexType()) << " "
+     << executor_utils::getCompileArgs(
+            deferred_compile_->compile_params, deferred_compile_->block_size);
+  return ss.str();
+}
+
+void FusionExecutor::compileKernelBatch(
+    const std::vector<FusionExecutor*>& executors) {
+  FUSER_PERF_SCOPE("FusionExecutor::compileKernelBatch");
+  NVF_ERROR(!executors.empty(), "No kernel to compile");
+
+  auto first = executors.front();
+  const auto key = first->deferredCompileKey();
+  for (auto executor : executors) {
+    NVF_ERROR(
+        executor->deferredCompileKey() == key,
+        "Kernels compiled in one batch need the same compile options: ",
+        key,
+        " and ",
+        executor->deferredCompileKey());
+  }
+
+  auto finish = [](FusionExecutor* executor,
+                   std::unique_ptr<executor_utils::CompiledKernel> kernel) {
+    auto deferred = std::move(executor->deferred_compile_.value());
+    executor->deferred_compile_.reset();
+    executor->compiled_kernel_ = std::move(kernel);
+    executor->compiled_kernel_->block_size =
+        deferred.block_size.has_value() ? deferred.block_size.value() : -1;
+    executor->finishCompile(deferred.dynamic_smem);
+  };
+
+  c10::DeviceGuard dg(first->options_.device);
+  // With EnableOption::ModuleCache, kernels compiled before are taken from
+  // the cache, and the others are added to it once the batch is compiled
+  const bool use_cache = isOptionEnabled(EnableOption::ModuleCache);
+  auto& cache = executor_utils::CompiledKernelCache::get();
+  std::vector<FusionExecutor*> to_compile;
+  std::vector<std::string> cache_keys;
+  for (auto executor : executors) {
+    if (use_cache) {
+      auto cache_key = executor_utils::CompiledKernelCache::makeKey(
+          executor->kernel_code_,
+          executor->kernelName(),
+          executor->kernel()->indexType(),
+          executor->deferred_compile_->compile_params,
+          executor->deferred_compile_->block_size);
+      if (auto cached = cache.find(cache_key)) {
+        finish(executor, std::move(cached));
+        continue;
+      }
+      cache_keys.push_back(std::move(cache_key));
+    }
+    to_compile.push_back(executor);
+  }
+  if (to_compile.empty()) {
+    return;
+  }
+
+  std::string kernels;
+  std::vector<std::string> kernel_names;
+  for (auto executor : to_compile) {
+    kernels += executor->kernel_code_;
+    kernel_names.push_back(executor->getCanonicalKernelName());
+  }
+  // All the kernels are defined in the namespace of the first one, and
+  // share its preamble
+  auto batch_first = to_compile.front();
+  const auto structured_code = batch_first->getStructuredCode(
+      kernels, batch_first->kernel()->indexType());
+  auto compiled_kernels = executor_utils::getCompiledKernels(
+      structured_code,
+      kernel_names,
+      batch_first->fusion_id_,
+      batch_first->deferred_compile_->compile_params,
+      batch_first->deferred_compile_->block_size);
+
+  for (auto i : c10::irange(to_compile.size())) {
+    auto compiled_kernel = std::move(compiled_kernels.at(i));
+    if (use_cache) {
+      compiled_kernel =
+          cache.insert(cache_keys.at(i), std::move(compiled_kernel));
+    }
+    finish(to_compile.at(i), std::move(compiled_kernel));
+  }
+}
+
+void FusionExecutor::compileFusionForCpu(
+    Fusion* fusion,
+    CompileParams compile_params) {
+  FUSER_PERF_SCOPE("FusionExecutor::compileFusionForCpu");
+
+  options_.device = c10::Device(c10::DeviceType::CPU);
+  // Block dimensions are not padded to warps, and there is no shared memory
+  // on the host
+  warp_size_ = 32;
+  device_smem_limit_ = 0;
+
+  lowered_ = std::make_unique<GpuLower>(fusion, compile_params);
+
+  const auto kernel = lowered_->kernel();
+  for (const auto& hook : post_lowering_hooks_) {
+    hook(kernel);
+  }
+  fusion_ = lowered_->kernel()->as<Fusion>();
+
+  fusion_id_ = ++fusion_id_counter_;
+  setUsedTVs();
+
+  if (isDebugDumpEnabled(DebugDumpOption::KernelIr)) {
+    kernel->print();
+  }
+
+  kernel_code_ = codegen::generateCppKernel(kernel, kernelName());
+  const auto structured_code =
+      getStructuredCppCode(kernel_code_, kernel->indexType());
+
+  compiled_kernel_.reset();
+  compiled_cpp_kernel_ =
+      executor_utils::getCompiledCppKernel(structured_code, kernelName());
+  NVF_ERROR(fusion_id_ > 0, "failed to assign a fusion_id_ after compilation.");
+
+  resetCompiledKernelProperties();
+}
+
 namespace {
 
 void fillTensorWithNan(at::Tensor& t) {
@@ -955,13 +1146,18 @@ std::vector<at::Tensor> allocOutputs(
       outputs.emplace_back(
           at::empty(std::vector<int64_t>(alloc_dom.size(), 0), tensor_options));
     } else {
-      auto alloc_tensor = at::native::empty_strided_cuda(
-          buf_info.sizes,
-          buf_info.strides,
-          buf_info.type,
-          c10::nullopt,
-          device,
-          c10::nullopt);
+      auto alloc_tensor = device.is_cpu()
+          ? at::empty_strided(
+                buf_info.sizes,
+                buf_info.strides,
+                at::TensorOptions().dtype(buf_info.type).device(device))
+          : at::native::empty_strided_cuda(
+                buf_info.sizes,
+                buf_info.strides,
+                buf_info.type,
+                c10::nullopt,
+                device,
+                c10::nullopt);
       if (shouldFillAllocationWithNan()) {
         fillTensorWithNan(alloc_tensor);
       }
@@ -1140,7 +1336,7 @@ LaunchParams FusionExecutor::computeLaunchParams(
   // Add workspace for reduction and broadcast
   int64_t reduction_broadcast_workspace = 0;
   const bool has_workspace = kernel_summary.has_block_reductions ||
-      kernel_summary.has_grid_reductions ||
+      kernel_summary.has_block_scans || kernel_summary.has_grid_reductions ||
       kernel_summary.has_block_broadcasts || kernel_summary.has_grid_broadcasts;
   if (has_workspace &&
       kernel_summary.largest_smem_data_type != DataType::Null) {
@@ -1175,7 +1371,7 @@ LaunchParams FusionExecutor::computeLaunchParams(
   //  This check is only done once a kernel has been compiled, since
   //  maybe_available_dynamic_smem_ needs to be evaluated on
   //  a compiled kernel.
-  if (isCompiled()) {
+  if (isCompiled() && !isCompiledForCpu()) {
     validateDynamicSmemSize(dynamic_smem_size);
   }
 
@@ -1517,6 +1713,41 @@ void FusionExecutor::initializeExecutorEntry(
   executor_entry.init = true;
 }
 
+std::unique_ptr<executor_utils::CompiledKernel> FusionExecutor::
+    compileKernelCode(
+        const std::string& structured_code,
+        const CompileParams& compile_params,
+        std::optional<int64_t> block_size,
+        bool external_code) const {
+  auto compile = [&]() {
+    return executor_utils::getCompiledKernel(
+        kernel_code_,
+        structured_code,
+        getCanonicalKernelName(),
+        fusion_id_,
+        compile_params,
+        block_size);
+  };
+  if (external_code || !isOptionEnabled(EnableOption::ModuleCache)) {
+    return compile();
+  }
+
+  auto& cache = executor_utils::CompiledKernelCache::get();
+  auto compiled_kernel = cache.getOrCompile(
+      executor_utils::CompiledKernelCache::makeKey(
+          kernel_code_,
+          kernelName(),
+          kernel()->indexType(),
+          compile_params,
+          block_size),
+      compile);
+  // The cached kernel may have been compiled for another block size with
+  // the same NVRTC options
+  compiled_kernel->block_size =
+      block_size.has_value() ? block_size.value() : -1;
+  return compiled_kernel;
+}
+
 void FusionExecutor::recompileKernel(
     const LaunchParams& new_launch_params,
     const CompileParams& new_compile_params) {
@@ -1529,13 +1760,8 @@ void FusionExecutor::recompileKernel(
   block_size_high_water_mark_ = new_launch_params.nThreads();
   maxrregcount_high_water_mark_ = new_compile_params.maxrregcount;
 
-  compiled_kernel_ = executor_utils::getCompiledKernel(
-      kernel_code_,
-      structured_code,
-      getCanonicalKernelName(),
-      fusion_id_,
-      new_compile_params,
-      block_size_high_water_mark_);
+  compiled_kernel_ = compileKernelCode(
+      structured_code, new_compile_params, block_size_high_water_mark_);
 
   resetCompiledKernelProperties();
 
@@ -1597,6 +1823,12 @@ int64_t FusionExecutor::ensureAvailableDynamicSmemSize(
     int64_t dynamic_smem_size) {
   NVF_ERROR(
       isCompiled(), "Cannot set dynamic smem size unless kernel is compiled");
+  // The function may be shared with other executors, which may have raised
+  // its limit since it was queried
+  if (dynamic_smem_size > getAvailableDynamicSmemSize() &&
+      compiled_kernel_->shared_module != nullptr) {
+    available_dynamic_smem_size_.reset();
+  }
   if (dynamic_smem_size > getAvailableDynamicSmemSize()) {
     validateDynamicSmemSize(dynamic_smem_size);
     NVFUSER_CUDA_SAFE_CALL(cuFuncSetAttribute(
@@ -1621,9 +1853,6 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
   FUSER_PERF_SCOPE("FusionExecutor::runFusion");
   NVF_ERROR(isCompiled());
   NVF_ERROR(fusion_id_ > 0, "Cannot run fusion, it was not compiled.");
-  NVF_ERROR(
-      !args.getCacheId().has_value() || outputs.empty(),
-      "short cut input cache is not compatible with pre-allocated output");
 
   validateIndexType(kernel(), compile_params);
 
@@ -1635,8 +1864,9 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
   }
 
   c10::DeviceGuard dg(options_.device);
-  auto stream = at::cuda::getCurrentCUDAStream();
-  at::cuda::jit::initializeCudaContext();
+  if (!isCompiledForCpu()) {
+    at::cuda::jit::initializeCudaContext();
+  }
   NVF_ERROR(lowered_);
 
   // Placeholder for the case where parameter cache is not used
@@ -1647,6 +1877,14 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
       ? &executor_entry_lookup_[*args.getCacheId()]
       : &temporary_executor_entry;
 
+  // The output buffer info of a cached entry would be taken from the
+  // pre-allocated outputs, so they are only accepted once the entry was
+  // initialized by a run that allocated its outputs
+  NVF_ERROR(
+      executor_entry->init || executor_entry == &temporary_executor_entry ||
+          outputs.empty(),
+      "short cut input cache is not compatible with pre-allocated output");
+
   // Initialize the executor entry if not initlized
   if (!executor_entry->init) {
     initializeExecutorEntry(
@@ -1658,7 +1896,9 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
         kernel()->indexType());
   }
 
-  recompileKernel(executor_entry->launch_params, compile_params);
+  if (!isCompiledForCpu()) {
+    recompileKernel(executor_entry->launch_params, compile_params);
+  }
 
   // TODO: Why does this need to be stored in the class?
   launch_params_ = executor_entry->launch_params;
@@ -1714,6 +1954,13 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
         intermediate_buffer = at::zeros(
             buf_info.sizes,
             at::TensorOptions().dtype(buf_info.type).device(options_.device));
+      } else if (options_.device.is_cpu()) {
+        intermediate_buffer = at::empty(
+            buf_info.sizes,
+            at::TensorOptions().dtype(buf_info.type).device(options_.device));
+        if (shouldFillAllocationWithNan()) {
+          fillTensorWithNan(intermediate_buffer);
+        }
       } else {
         intermediate_buffer = at::native::empty_cuda(
             buf_info.sizes,
@@ -1746,6 +1993,11 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
     }
   }
 
+  if (record_launch_) {
+    last_launch_record_ = {
+        launch_params_, arg_buffers, executor_entry->intermediates};
+  }
+
   if (isDebugDumpEnabled(DebugDumpOption::LaunchParam)) {
     launch_params_.print();
   }
@@ -1768,6 +2020,26 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
       isDebugDumpEnabled(DebugDumpOption::EffectiveBandwidth) ||
       isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose);
 
+  if (isCompiledForCpu()) {
+    if (execute_kernel_) {
+      FUSER_PERF_SCOPE("ExecutorRunFusion::runCppKernel");
+      std::vector<void*> arg_buffer_ptrs;
+      arg_buffer_ptrs.reserve(arg_buffers.size());
+      for (auto& arg_buffer : arg_buffers) {
+        arg_buffer_ptrs.push_back(arg_buffer.data());
+      }
+      const auto start = std::chrono::steady_clock::now();
+      launchKernel(launch_params_, arg_buffer_ptrs.data());
+      if (measure_kernel_time) {
+        kernel_time_ms_ = std::chrono::duration<float, std::milli>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+      }
+    }
+    return outputs;
+  }
+
+  auto stream = at::cuda::getCurrentCUDAStream();
   executor_utils::CudaKernelTimer timer(stream);
 
   if (measure_kernel_time) {
@@ -1775,8 +2047,6 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
   }
 
   if (execute_kernel_) {
-    ensureAvailableDynamicSmemSize(executor_entry->launch_params.smem());
-
     std::vector<void*> arg_buffer_ptrs;
     arg_buffer_ptrs.reserve(arg_buffers.size());
     for (auto& arg_buffer : arg_buffers) {
@@ -1810,34 +2080,7 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
       timer.start();
     }
 
-    if (!kernel()->summary().has_cooperative_grid_reduction) {
-      FUSER_PERF_SCOPE("ExecutorRunFusion::cuLaunchKernel");
-      NVFUSER_CUDA_SAFE_CALL(cuLaunchKernel(
-          compiled_kernel_->function,
-          launch_params_.gdimx(),
-          launch_params_.gdimy(),
-          launch_params_.gdimz(),
-          launch_params_.bdimx(),
-          launch_params_.bdimy(),
-          launch_params_.bdimz(),
-          launch_params_.smem(),
-          stream,
-          arg_buffer_ptrs.data(),
-          nullptr));
-    } else {
-      FUSER_PERF_SCOPE("ExecutorRunFusion::cuLaunchCooperativeKernel");
-      NVFUSER_CUDA_SAFE_CALL(cuLaunchCooperativeKernel(
-          compiled_kernel_->function,
-          launch_params_.gdimx(),
-          launch_params_.gdimy(),
-          launch_params_.gdimz(),
-          launch_params_.bdimx(),
-          launch_params_.bdimy(),
-          launch_params_.bdimz(),
-          launch_params_.smem(),
-          stream,
-          arg_buffer_ptrs.data()));
-    }
+    launchKernel(launch_params_, arg_buffer_ptrs.data());
 
     if (measure_kernel_time) {
       kernel_time_ms_ = timer.elapsed();
@@ -1878,6 +2121,60 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
   return outputs;
 }
 
+void FusionExecutor::launchKernel(
+    const LaunchParams& launch_params,
+    void** args) {
+  NVF_ERROR(isCompiled(), "Cannot launch a kernel that is not compiled");
+  if (!execute_kernel_) {
+    return;
+  }
+
+  if (isCompiledForCpu()) {
+    FUSER_PERF_SCOPE("FusionExecutor::runCppKernel");
+    const std::array<int64_t, 6> launch_dims = {
+        launch_params.gdimx(),
+        launch_params.gdimy(),
+        launch_params.gdimz(),
+        launch_params.bdimx(),
+        launch_params.bdimy(),
+        launch_params.bdimz()};
+    compiled_cpp_kernel_->function(args, launch_dims.data());
+    return;
+  }
+
+  ensureAvailableDynamicSmemSize(launch_params.smem());
+  auto stream = at::cuda::getCurrentCUDAStream();
+
+  if (!kernel()->summary().has_cooperative_grid_reduction) {
+    FUSER_PERF_SCOPE("FusionExecutor::cuLaunchKernel");
+    NVFUSER_CUDA_SAFE_CALL(cuLaunchKernel(
+        compiled_kernel_->function,
+        launch_params.gdimx(),
+        launch_params.gdimy(),
+        launch_params.gdimz(),
+        launch_params.bdimx(),
+        launch_params.bdimy(),
+        launch_params.bdimz(),
+        launch_params.smem(),
+        stream,
+        args,
+        nullptr));
+  } else {
+    FUSER_PERF_SCOPE("FusionExecutor::cuLaunchCooperativeKernel");
+    NVFUSER_CUDA_SAFE_CALL(cuLaunchCooperativeKernel(
+        compiled_kernel_->function,
+        launch_params.gdimx(),
+        launch_params.gdimy(),
+        launch_params.gdimz(),
+        launch_params.bdimx(),
+        launch_params.bdimy(),
+        launch_params.bdimz(),
+        launch_params.smem(),
+        stream,
+        args));
+  }
+}
+
 void FusionExecutor::compileRtc(
     const std::string& code,
     const std::string& name,
@@ -43,6 +43,16 @@ class FusionExecutor : public NonCopyable {
     bool is_profile_buffer = false;
   };
 
+  //! The kernel arguments of the last launch of runFusion, kept if
+  //! enabled by setRecordLaunchFlag(true). Launches can be replayed with
+  //! other buffers by patching the arguments, see LaunchPlan.
+  struct LaunchRecord {
+    LaunchParams launch_params;
+    //! Arguments in the order of kernel()->parameters()
+    std::vector<std::vector<std::byte>> arg_buffers;
+    std::vector<GlobalBufferInfo> intermediates;
+  };
+
   // Unsafe compilation that's useful for debugging kernels, iterating over
   // slight modifications of a generated kernel
   void debugCompileFusionFromStr(
@@ -85,6 +95,30 @@ class FusionExecutor : public NonCopyable {
     compileFusion(fusion, args, launch_constraints, compile_params);
   }
 
+  //! Lower and generate the kernel in compileFusion, but leave its NVRTC
+  //! compilation to compileKernelBatch, so that the kernels of several
+  //! executors can share one NVRTC program. Kernels from external source
+  //! files or the kernel database are still compiled by compileFusion.
+  void setDeferNvrtcCompile(bool defer) {
+    defer_nvrtc_compile_ = defer;
+  }
+
+  //! True if compileFusion generated a kernel that is waiting for
+  //! compileKernelBatch
+  bool hasDeferredCompile() const {
+    return deferred_compile_.has_value();
+  }
+
+  //! Deferred kernels with the same key, i.e., the same device, index type
+  //! and NVRTC options, can be compiled by one compileKernelBatch
+  std::string deferredCompileKey() const;
+
+  //! Compile the deferred kernels of the executors in one NVRTC program,
+  //! see executor_utils::getCompiledKernels. With EnableOption::ModuleCache,
+  //! kernels found in executor_utils::CompiledKernelCache are not compiled
+  //! again, and the others are added to it.
+  static void compileKernelBatch(const std::vector<FusionExecutor*>& executors);
+
   std::vector<at::Tensor> runFusion(
       KernelArgumentHolder& args,
       const LaunchParams& launch_constraints = LaunchParams(),
@@ -125,13 +159,27 @@ class FusionExecutor : public NonCopyable {
     if (compiled_kernel_ != nullptr) {
       NVF_ERROR(compiled_kernel_->function != nullptr);
     }
-    return fusion_id_ != -1 && lowered_ && compiled_kernel_ != nullptr;
+    return fusion_id_ != -1 && lowered_ &&
+        (compiled_kernel_ != nullptr || compiled_cpp_kernel_ != nullptr);
   };
 
+  //! Returns true if the fusion was compiled by the C++ backend for
+  //! host-resident arguments, see codegen::generateCppKernel
+  bool isCompiledForCpu() const {
+    return isCompiled() && compiled_cpp_kernel_ != nullptr;
+  }
+
   void evictCache(size_t cache_id) {
     executor_entry_lookup_.erase(cache_id);
   }
 
+  //! Whether a run with the cache id initialized its executor entry, after
+  //! which runFusion accepts pre-allocated outputs for that id
+  bool isExecutorEntryInitialized(size_t cache_id) const {
+    auto it = executor_entry_lookup_.find(cache_id);
+    return it != executor_entry_lookup_.end() && it->second.init;
+  }
+
   // struct used to hold necessary information to launch compiled kernel on a
   // given input set.
   //
@@ -165,6 +213,26 @@ class FusionExecutor : public NonCopyable {
     execute_kernel_ = execute_kernel;
   }
 
+  //! Keep the kernel arguments of each launch, see lastLaunchRecord. The
+  //! record is dropped when recording stops.
+  void setRecordLaunchFlag(bool record_launch) {
+    record_launch_ = record_launch;
+    if (!record_launch_) {
+      last_launch_record_ = LaunchRecord();
+    }
+  }
+
+  //! Returns the kernel arguments of the last launch
+  const LaunchRecord& lastLaunchRecord() const {
+    NVF_ERROR(record_launch_, "Launches are not recorded");
+    return last_launch_record_;
+  }
+
+  //! Launch the compiled kernel on the current stream. args are laid out
+  //! as the arg_buffers of a LaunchRecord. Nothing is launched if kernel
+  //! execution is disabled by setExecuteKernelFlag(false).
+  void launchKernel(const LaunchParams& launch_params, void** args);
+
   //! Internal knob used for debugging/profiling only
   void setMeasureKernelTimeFlag(bool measure_kernel_time) {
     measure_kernel_time_ = measure_kernel_time;
@@ -219,6 +287,11 @@ class FusionExecutor : public NonCopyable {
 
   std::string getStructuredCode() const;
 
+  // Add host headers and runtime to a C++ kernel and wrap in namespace
+  std::string getStructuredCppCode(
+      const std::string& kernel,
+      PrimDataType index_type) const;
+
   //! Returns a const reference to the latest compiled kernel.
   const executor_utils::CompiledKernel& compiledKernel() const {
     return *compiled_kernel_;
@@ -269,6 +342,11 @@ class FusionExecutor : public NonCopyable {
     disable_parameter_cache_ = true;
   }
 
+  //! Whether launch params and output sizes are evaluated for each run
+  bool isLaunchParamCacheDisabled() const {
+    return disable_parameter_cache_;
+  }
+
   //! Serialize Fusion Executor using flatbuffers
   flatbuffers::Offset<serde::FusionExecutor> serialize(
       flatbuffers::FlatBufferBuilder& builder) const;
@@ -284,6 +362,11 @@ class FusionExecutor : public NonCopyable {
     return "CudaCodeGen";
   }
 
+  //! Lower the fusion and compile it with the C++ backend. Used by
+  //! compileFusion when all tensor arguments are on the CPU and
+  //! EnableOption::CppBackend is set.
+  void compileFusionForCpu(Fusion* fusion, CompileParams compile_params);
+
   LaunchParams computeLaunchParams(
       const LaunchParams& launch_constraints,
       ExpressionEvaluator& expr_eval,
@@ -333,6 +416,20 @@ class FusionExecutor : public NonCopyable {
 
   std::unique_ptr<PrecomputedValues>& evaluatorPrecomputedValues();
 
+  //! Set up the compiled kernel once it is loaded, either by compileFusion
+  //! or by compileKernelBatch
+  void finishCompile(std::optional<int64_t> dynamic_smem);
+
+  //! Compile kernel_code_, defined in structured_code, with NVRTC. With
+  //! EnableOption::ModuleCache, the module of an identical kernel compiled
+  //! before is used instead, see executor_utils::CompiledKernelCache.
+  //! Kernels of external source files are never taken from the cache.
+  std::unique_ptr<executor_utils::CompiledKernel> compileKernelCode(
+      const std::string& structured_code,
+      const CompileParams& compile_params,
+      std::optional<int64_t> block_size,
+      bool external_code = false) const;
+
   // Recompile the kernel if the number of threads in the block has increased
   // or maxrregcount has changed
   void recompileKernel(
@@ -406,6 +503,9 @@ class FusionExecutor : public NonCopyable {
 
   int64_t warp_size_ = 0;
   std::unique_ptr<executor_utils::CompiledKernel> compiled_kernel_;
+  //! Kernel compiled by the C++ backend. Only one of compiled_kernel_ and
+  //! compiled_cpp_kernel_ is set.
+  std::unique_ptr<executor_utils::CompiledCppKernel> compiled_cpp_kernel_;
 
   // TensorViews actually used in the kernel.
   std::vector<TensorView*> used_tvs_;
@@ -423,6 +523,19 @@ class FusionExecutor : public NonCopyable {
   int64_t block_size_high_water_mark_ = 1;
   int64_t maxrregcount_high_water_mark_ = 255;
 
+  //! Parameters of a kernel generated by compileFusion whose compilation
+  //! is left to compileKernelBatch
+  struct DeferredCompile {
+    CompileParams compile_params;
+    std::optional<int64_t> block_size;
+    std::optional<int64_t> dynamic_smem;
+  };
+
+  // See setDeferNvrtcCompile
+  bool defer_nvrtc_compile_ = false;
+
+  std::optional<DeferredCompile> deferred_compile_;
+
   // lookup table to take short cut to retrieve recorded information in order to
   // launch kernels without re-inference parameters.
   std::unordered_map<size_t, ExecutorEntry> executor_entry_lookup_;
@@ -440,6 +553,11 @@ class FusionExecutor : public NonCopyable {
   // kernel on the GPU or not
   bool execute_kernel_ = true;
 
+  // Keep the kernel arguments of each launch in last_launch_record_
+  bool record_launch_ = false;
+
+  LaunchRecord last_launch_record_;
+
   // Profiling support: knob to enable measuring kernel execution time
   bool measure_kernel_time_ = false;
 
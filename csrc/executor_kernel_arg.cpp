@@ -15,8 +15,55 @@
 #include <serde/polymorphic_value_serde.h>
 #include <tensor_metadata.h>
 
+#include <utility>
+
 namespace nvfuser {
 
+KernelArgumentHolder::KernelArgumentHolder(const KernelArgumentHolder& other)
+    : device_index_(other.device_index_), cache_id_(other.cache_id_) {
+  reserve(other.size());
+  for (auto arg : other.arguments_) {
+    push(*arg);
+  }
+}
+
+KernelArgumentHolder& KernelArgumentHolder::operator=(
+    const KernelArgumentHolder& other) {
+  if (this != &other) {
+    *this = KernelArgumentHolder(other);
+  }
+  return *this;
+}
+
+KernelArgumentHolder::KernelArgumentHolder(
+    KernelArgumentHolder&& other) noexcept {
+  *this = std::move(other);
+}
+
+KernelArgumentHolder& KernelArgumentHolder::operator=(
+    KernelArgumentHolder&& other) noexcept {
+  if (this != &other) {
+    // The slots are owned by the chunks, so the argument pointers stay valid
+    chunks_ = std::move(other.chunks_);
+    num_used_slots_ = std::exchange(other.num_used_slots_, 0);
+    free_slots_ = std::move(other.free_slots_);
+    arguments_ = std::move(other.arguments_);
+    device_index_ = other.device_index_;
+    cache_id_ = other.cache_id_;
+    other.chunks_.clear();
+    other.free_slots_.clear();
+    other.arguments_.clear();
+  }
+  return *this;
+}
+
+void KernelArgumentHolder::reserve(size_t num_args) {
+  arguments_.reserve(num_args);
+  while (chunks_.size() * kSlotsPerChunk < num_args) {
+    chunks_.push_back(std::make_unique<Chunk>());
+  }
+}
+
 KernelArgumentHolder KernelArgumentHolder::createKernelArgumentHolder(
     const c10::ArrayRef<c10::IValue>& inputs,
     std::optional<int8_t> selected_device) {
@@ -27,10 +74,14 @@ KernelArgumentHolder KernelArgumentHolder::createKernelArgumentHolder(
         selected_device.has_value() ? selected_device.value() : (int8_t)0);
     return args;
   }
-  auto device_index = getCommonDeviceCUDA(inputs, selected_device);
+  // Host-resident inputs are run on the CPU, where the device index is unused
+  auto device_index = hasHostResidentInputs(inputs)
+      ? (int8_t)0
+      : getCommonDeviceCUDA(inputs, selected_device);
 
   KernelArgumentHolder args;
   args.setDeviceIndex(device_index);
+  args.reserve(inputs.size());
   args.push(inputs);
 
   return args;
@@ -88,11 +139,14 @@ void KernelArgumentHolder::push(const std::vector<at::Tensor>& tensors) {
 }
 
 void KernelArgumentHolder::erase(const PolymorphicValue* arg_to_delete) {
-  auto iter = std::remove_if(
-      arguments_.begin(), arguments_.end(), [&](const auto& ref) {
-        return arg_to_delete == ref.get();
-      });
-  arguments_.erase(iter, arguments_.end());
+  auto iter = std::find(arguments_.begin(), arguments_.end(), arg_to_delete);
+  if (iter == arguments_.end()) {
+    return;
+  }
+  // Release the value, e.g., the memory of a tensor, and reuse the slot
+  **iter = PolymorphicValue();
+  free_slots_.push_back(*iter);
+  arguments_.erase(iter);
 }
 
 std::string KernelArgumentHolder::toString() const {
@@ -114,6 +168,21 @@ PrimDataType KernelArgumentHolder::getSmallestIndexTypeOfArguments() const {
   return PrimDataType::Int32;
 }
 
+bool KernelArgumentHolder::isHostResident() const {
+  bool found_host_tensor = false;
+  for (const auto& arg : arguments_) {
+    if (!arg->is<at::Tensor>()) {
+      continue;
+    }
+    const auto& tensor = arg->as<at::Tensor>();
+    if (!tensor.is_cpu()) {
+      return false;
+    }
+    found_host_tensor = found_host_tensor || !is_cpu_scalar(tensor);
+  }
+  return found_host_tensor;
+}
+
 void KernelArgumentHolder::pushTensorProxy(
     const std::vector<int64_t>& sizes,
     const std::vector<int64_t>& strides,
@@ -310,20 +379,17 @@ std::vector<std::byte> polymorphicValueToBytes(
             sizeof(int32_t) * alloc_stride.size());
         buffer.insert(
             buffer.end(), (std::byte*)&data, (std::byte*)&data + sizeof(void*));
-        std::vector<int32_t> logical_size32(
-            logical_size.begin(), logical_size.end());
-        buffer.insert(
-            buffer.end(),
-            (std::byte*)logical_size32.data(),
-            (std::byte*)logical_size32.data() +
-                sizeof(int32_t) * logical_size32.size());
-        std::vector<int32_t> alloc_stride32(
-            alloc_stride.begin(), alloc_stride.end());
-        buffer.insert(
-            buffer.end(),
-            (std::byte*)alloc_stride32.data(),
-            (std::byte*)alloc_stride32.data() +
-                sizeof(int32_t) * alloc_stride32.size());
+        // Narrow the sizes and strides in place instead of through
+        // temporary vectors
+        for (auto dims : {logical_size, alloc_stride}) {
+          for (auto dim : dims) {
+            auto dim32 = (int32_t)dim;
+            buffer.insert(
+                buffer.end(),
+                (std::byte*)&dim32,
+                (std::byte*)&dim32 + sizeof(int32_t));
+          }
+        }
       }
       return buffer;
     } else {
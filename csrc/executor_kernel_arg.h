@@ -9,6 +9,7 @@
 
 #include <ATen/core/ivalue.h>
 #include <c10/util/Exception.h>
+#include <c10/util/SmallVector.h>
 #include <exceptions.h>
 #include <expr_evaluator.h>
 #include <ir/all_nodes.h>
@@ -16,7 +17,9 @@
 #include <torch/csrc/jit/ir/ir.h>
 #include <type.h>
 
+#include <array>
 #include <cstddef>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -27,6 +30,11 @@ namespace nvfuser {
 //! for both compilation as well as kernel execution. The important thing is to
 //! strip ownership of tensor from KernelArgumentHolder, so that during async
 //! compilation, we are not unnecessarily holding memory that is not needed.
+//!
+//! Arguments are stored in chunks of slots owned by the holder, so pushing an
+//! argument only allocates when a chunk is full. The address of an argument
+//! is stable until it is erased, also when the holder is moved, and the slots
+//! of erased arguments are reused. Copies of a holder copy the arguments.
 class KernelArgumentHolder {
  public:
   static KernelArgumentHolder createKernelArgumentHolder(
@@ -35,12 +43,22 @@ class KernelArgumentHolder {
 
   KernelArgumentHolder() = default;
 
-  KernelArgumentHolder(const KernelArgumentHolder& self) = default;
+  KernelArgumentHolder(const KernelArgumentHolder& other);
+
+  KernelArgumentHolder& operator=(const KernelArgumentHolder& other);
+
+  KernelArgumentHolder(KernelArgumentHolder&& other) noexcept;
+
+  KernelArgumentHolder& operator=(KernelArgumentHolder&& other) noexcept;
 
   //! Computes the smallest index type for the currently held
   //! arguments. It does not consider any other tensors used in a kernel.
   PrimDataType getSmallestIndexTypeOfArguments() const;
 
+  //! Returns true if all tensor arguments are on the CPU and at least one of
+  //! them is not a CPU scalar, see hasHostResidentInputs
+  bool isHostResident() const;
+
   // Push a tensor proxy to the arguments
   void pushTensorProxy(
       const std::vector<int64_t>& sizes,
@@ -54,15 +72,21 @@ class KernelArgumentHolder {
   void erase(const PolymorphicValue* arg_to_delete);
 
   void push(PolymorphicValue val) {
-    arguments_.push_back(std::make_shared<PolymorphicValue>(std::move(val)));
+    auto slot = allocateSlot();
+    *slot = std::move(val);
+    arguments_.push_back(slot);
   }
 
+  //! Reserve slots for num_args arguments in total
+  void reserve(size_t num_args);
+
   PolymorphicValue* back() {
-    return arguments_.back().get();
+    return arguments_.back();
   }
 
   PolymorphicValue* operator[](size_t ind) const {
-    return arguments_.at(ind).get();
+    NVF_ERROR(ind < arguments_.size(), "Argument index out of range: ", ind);
+    return arguments_[ind];
   };
 
   auto cbegin() const {
@@ -73,10 +97,6 @@ class KernelArgumentHolder {
     return arguments_.cend();
   }
 
-  auto getBackInserter() {
-    return std::back_inserter(arguments_);
-  }
-
   size_t size() const {
     return arguments_.size();
   }
@@ -111,7 +131,30 @@ class KernelArgumentHolder {
   void deserialize(const serde::KernelArgumentHolder* buffer);
 
  private:
-  std::vector<std::shared_ptr<PolymorphicValue>> arguments_;
+  static constexpr size_t kSlotsPerChunk = 16;
+  using Chunk = std::array<PolymorphicValue, kSlotsPerChunk>;
+
+  //! Returns an empty slot for a new argument
+  PolymorphicValue* allocateSlot() {
+    if (!free_slots_.empty()) {
+      auto slot = free_slots_.back();
+      free_slots_.pop_back();
+      return slot;
+    }
+    if (num_used_slots_ == chunks_.size() * kSlotsPerChunk) {
+      chunks_.push_back(std::make_unique<Chunk>());
+    }
+    auto slot_in_chunk = num_used_slots_ % kSlotsPerChunk;
+    return &(*chunks_[num_used_slots_++ / kSlotsPerChunk])[slot_in_chunk];
+  }
+
+  c10::SmallVector<std::unique_ptr<Chunk>, 4> chunks_;
+  //! Slots of the chunks handed out so far, including erased ones
+  size_t num_used_slots_ = 0;
+  //! Slots of erased arguments
+  c10::SmallVector<PolymorphicValue*, kSlotsPerChunk> free_slots_;
+  //! The arguments in order
+  c10::SmallVector<PolymorphicValue*, kSlotsPerChunk> arguments_;
 
   int8_t device_index_ = 0;
   std::optional<size_t> cache_id_ = std::nullopt;
@@ -19,6 +19,7 @@
 #include <ir/all_nodes.h>
 #include <ir/iostream.h>
 #include <ir/utils.h>
+#include <kernel_db/cpp_kernel_db.h>
 #include <kernel_db/kernel_db.h>
 #include <options.h>
 #include <tensor_metadata.h>
@@ -31,11 +32,13 @@
 #include <nvfuser_resources/bf16_support.h>
 #include <nvfuser_resources/bit.h>
 #include <nvfuser_resources/block_reduction.h>
+#include <nvfuser_resources/block_scan.h>
 #include <nvfuser_resources/block_sync_atomic.h>
 #include <nvfuser_resources/block_sync_default.h>
 #include <nvfuser_resources/block_welford_outer.h>
 #include <nvfuser_resources/broadcast.h>
 #include <nvfuser_resources/complex_number.h>
+#include <nvfuser_resources/cpu_support.h>
 #include <nvfuser_resources/fp16_support.h>
 #include <nvfuser_resources/fused_reduction.h>
 #include <nvfuser_resources/fused_welford_helper.h>
@@ -56,6 +59,8 @@
 #include <nvfuser_resources/warp.h>
 #include <nvfuser_resources/welford.h>
 
+#include <dlfcn.h>
+
 #include <cstdlib>
 #include <fstream>
 #include <variant>
@@ -94,6 +99,7 @@ std::string kernelPreamble() {
 
   // Communication classes
   ss << nvfuser_resources::block_reduction_cu;
+  ss << nvfuser_resources::block_scan_cu;
   ss << nvfuser_resources::grid_reduction_cu;
   ss << nvfuser_resources::grid_broadcast_cu;
   ss << nvfuser_resources::broadcast_cu;
@@ -110,6 +116,41 @@ std::string kernelPreamble() {
   return ss.str();
 }
 
+std::string cppKernelPreamble() {
+  return nvfuser_resources::cpu_support_cu;
+}
+
+CompiledCppKernel::~CompiledCppKernel() {
+  if (library != nullptr) {
+    dlclose(library);
+  }
+}
+
+std::unique_ptr<CompiledCppKernel> getCompiledCppKernel(
+    const std::string& code,
+    const std::string& func_name) {
+  FUSER_PERF_SCOPE("executor_utils::getCompiledCppKernel");
+  auto compiled_kernel = std::make_unique<CompiledCppKernel>();
+  compiled_kernel->kernel_name = func_name;
+  compiled_kernel->library_filename = CppKernelDb::get().getLibrary(code);
+
+  compiled_kernel->library =
+      dlopen(compiled_kernel->library_filename.c_str(), RTLD_NOW | RTLD_LOCAL);
+  NVF_ERROR(
+      compiled_kernel->library != nullptr,
+      "Unable to load C++ kernel library: ",
+      dlerror());
+  compiled_kernel->function = reinterpret_cast<CompiledCppKernel::Function>(
+      dlsym(compiled_kernel->library, func_name.c_str()));
+  NVF_ERROR(
+      compiled_kernel->function != nullptr,
+      "Unable to find C++ kernel ",
+      func_name,
+      ": ",
+      dlerror());
+  return compiled_kernel;
+}
+
 namespace {
 
 // Query the target GPU version number NVRTC compiles CUDA kernels for
@@ -1105,13 +1146,17 @@ void createNvrtcProgram(
       &program, full_src_code.c_str(), name.c_str(), 0, nullptr, nullptr));
 }
 
-// Compile the given source code with the NVRTC compiler driver.
+// Compile the given source code with the NVRTC compiler driver. The
+// lowered names of func_names are appended to lowered_names if given. The
+// kernel name of the returned CompiledKernel is the first of them.
 std::unique_ptr<CompiledKernel> compileSource(
     const std::string& full_src_code,
-    const std::string& func_name,
+    const std::vector<std::string>& func_names,
     const int64_t id,
     const bool compile_to_sass,
-    NvrtcCompileDriver& nvrtc_compile) {
+    NvrtcCompileDriver& nvrtc_compile,
+    std::vector<std::string>* lowered_names = nullptr) {
+  NVF_ERROR(!func_names.empty(), "No kernel to compile");
   std::stringstream log;
 
   nvrtcProgram program; // NOLINT(cppcoreguidelines-init-variables)
@@ -1122,14 +1167,24 @@ std::unique_ptr<CompiledKernel> compileSource(
 
   createNvrtcProgram(program, id, full_src_code);
 
-  NVFUSER_NVRTC_SAFE_CALL(nvrtcAddNameExpression(program, func_name.c_str()));
+  for (const auto& func_name : func_names) {
+    NVFUSER_NVRTC_SAFE_CALL(
+        nvrtcAddNameExpression(program, func_name.c_str()));
+  }
   log << nvrtc_compile.invoke(program, full_src_code) << std::endl;
 
   auto compiled_kernel = std::make_unique<CompiledKernel>();
-  const char* lowered_kernel_name = nullptr;
-  NVFUSER_NVRTC_SAFE_CALL(
-      nvrtcGetLoweredName(program, func_name.c_str(), &lowered_kernel_name));
-  compiled_kernel->kernel_name = lowered_kernel_name;
+  for (const auto& func_name : func_names) {
+    const char* lowered_kernel_name = nullptr;
+    NVFUSER_NVRTC_SAFE_CALL(
+        nvrtcGetLoweredName(program, func_name.c_str(), &lowered_kernel_name));
+    if (compiled_kernel->kernel_name.empty()) {
+      compiled_kernel->kernel_name = lowered_kernel_name;
+    }
+    if (lowered_names != nullptr) {
+      lowered_names->emplace_back(lowered_kernel_name);
+    }
+  }
   compiled_kernel->compile_log = log.str();
 
   if (compile_to_sass) {
@@ -1151,24 +1206,13 @@ std::unique_ptr<CompiledKernel> compileSource(
   return compiled_kernel;
 }
 
-} // namespace
-
-CompiledKernel::~CompiledKernel() {
-  if (module != nullptr) {
-    NVFUSER_CUDA_SAFE_CALL(cuModuleUnload(module));
-  }
-}
-
-// Compile the source if no existing compiled binary is found in KernelDB
-std::unique_ptr<CompiledKernel> getCompiledKernel(
-    std::optional<std::reference_wrapper<const std::string>> kernel_code,
-    const std::string& full_src_code,
-    const std::string& func_name,
-    int64_t id,
+// Make sure a CUDA context exists and fill the options to compile for the
+// current device. Returns true if compiling to SASS.
+bool setUpCompilation(
+    NvrtcCompileDriver& nvrtc_compile_driver,
+    CuModuleLoadDataDriver& module_load_driver,
     const CompileParams& compile_params,
     std::optional<int64_t> opt_block_size) {
-  FUSER_PERF_SCOPE("executor_utils::NVRTC");
-
   at::cuda::jit::initializeCudaContext();
 
   // The above initialization works in some cases. However, it seems to
@@ -1198,9 +1242,6 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
     compile_to_sass = false;
   }
 
-  NvrtcCompileDriver nvrtc_compile_driver;
-  CuModuleLoadDataDriver module_load_driver;
-
   fillCompileOptions(
       nvrtc_compile_driver,
       module_load_driver,
@@ -1210,6 +1251,37 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
       compile_params,
       opt_block_size);
 
+  return compile_to_sass;
+}
+
+} // namespace
+
+CompiledKernel::~CompiledKernel() {
+  // A module shared by the kernels of a batch is unloaded by the deleter of
+  // shared_module
+  if (module != nullptr && shared_module == nullptr) {
+    NVFUSER_CUDA_SAFE_CALL(cuModuleUnload(module));
+  }
+}
+
+// Compile the source if no existing compiled binary is found in KernelDB
+std::unique_ptr<CompiledKernel> getCompiledKernel(
+    std::optional<std::reference_wrapper<const std::string>> kernel_code,
+    const std::string& full_src_code,
+    const std::string& func_name,
+    int64_t id,
+    const CompileParams& compile_params,
+    std::optional<int64_t> opt_block_size) {
+  FUSER_PERF_SCOPE("executor_utils::NVRTC");
+
+  NvrtcCompileDriver nvrtc_compile_driver;
+  CuModuleLoadDataDriver module_load_driver;
+  const bool compile_to_sass = setUpCompilation(
+      nvrtc_compile_driver,
+      module_load_driver,
+      compile_params,
+      opt_block_size);
+
   std::stringstream log;
 
   if (compile_to_sass) {
@@ -1238,7 +1310,7 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
             (compile_to_sass ? compiled_kernel->cubin
                              : compiled_kernel->ptx)))) {
     compiled_kernel = compileSource(
-        full_src_code, func_name, id, compile_to_sass, nvrtc_compile_driver);
+        full_src_code, {func_name}, id, compile_to_sass, nvrtc_compile_driver);
     log << compiled_kernel->compile_log << std::endl;
     if (use_kernel_db) {
       auto result = kernel_db.write(
@@ -1280,6 +1352,297 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
   return compiled_kernel;
 }
 
+std::string getCompileArgs(
+    const CompileParams& compile_params,
+    std::optional<int64_t> opt_block_size) {
+  NvrtcCompileDriver nvrtc_compile_driver;
+  CuModuleLoadDataDriver module_load_driver;
+  setUpCompilation(
+      nvrtc_compile_driver,
+      module_load_driver,
+      compile_params,
+      opt_block_size);
+  return toDelimitedString(nvrtc_compile_driver.options(), " ");
+}
+
+std::vector<std::unique_ptr<CompiledKernel>> getCompiledKernels(
+    const std::string& full_src_code,
+    const std::vector<std::string>& func_names,
+    int64_t id,
+    const CompileParams& compile_params,
+    std::optional<int64_t> opt_block_size) {
+  FUSER_PERF_SCOPE("executor_utils::NVRTC::Batch");
+
+  NvrtcCompileDriver nvrtc_compile_driver;
+  CuModuleLoadDataDriver module_load_driver;
+  const bool compile_to_sass = setUpCompilation(
+      nvrtc_compile_driver,
+      module_load_driver,
+      compile_params,
+      opt_block_size);
+  const auto compile_args =
+      toDelimitedString(nvrtc_compile_driver.options(), " ");
+
+  std::vector<std::string> lowered_names;
+  auto program = compileSource(
+      full_src_code,
+      func_names,
+      id,
+      compile_to_sass,
+      nvrtc_compile_driver,
+      &lowered_names);
+
+  std::stringstream log;
+  if (compile_to_sass) {
+    log << "\nCompile options: " << compile_args << "\n";
+  }
+  log << program->compile_log << std::endl;
+  log << module_load_driver.invoke(
+             program->module,
+             (compile_to_sass ? program->cubin.data() : program->ptx.data()))
+      << std::endl;
+
+  // The module is loaded once and unloaded with its last kernel
+  std::shared_ptr<CUmod_st> module(program->module, [](CUmodule module) {
+    NVFUSER_CUDA_SAFE_CALL(cuModuleUnload(module));
+  });
+  program->module = nullptr;
+
+  if (isOptionEnabled(EnableOption::WarnRegisterSpill) ||
+      compile_params.enable_ptxas_verbose) {
+    warnRegisterSpill(log.str());
+  }
+
+  std::vector<std::unique_ptr<CompiledKernel>> compiled_kernels;
+  compiled_kernels.reserve(func_names.size());
+  for (const auto& lowered_name : lowered_names) {
+    auto compiled_kernel = std::make_unique<CompiledKernel>();
+    compiled_kernel->module = module.get();
+    compiled_kernel->shared_module = module;
+    compiled_kernel->compile_log = log.str();
+    compiled_kernel->ptx = program->ptx;
+    compiled_kernel->ptx_filename = program->ptx_filename;
+    compiled_kernel->cubin = program->cubin;
+    compiled_kernel->cubin_filename = program->cubin_filename;
+    compiled_kernel->kernel_name = lowered_name;
+    compiled_kernel->compile_args = compile_args;
+    NVFUSER_CUDA_SAFE_CALL(cuModuleGetFunction(
+        &(compiled_kernel->function),
+        compiled_kernel->module,
+        compiled_kernel->kernel_name.c_str()));
+    if (opt_block_size.has_value()) {
+      compiled_kernel->block_size = opt_block_size.value();
+    }
+    compiled_kernels.push_back(std::move(compiled_kernel));
+  }
+  return compiled_kernels;
+}
+
+namespace {
+
+// Copy of kernel sharing its module
+std::unique_ptr<CompiledKernel> shareCompiledKernel(
+    const CompiledKernel& kernel) {
+  auto copy = std::make_unique<CompiledKernel>();
+  copy->module = kernel.module;
+  copy->function = kernel.function;
+  copy->compile_log = kernel.compile_log;
+  copy->ptx = kernel.ptx;
+  copy->ptx_filename = kernel.ptx_filename;
+  copy->cubin = kernel.cubin;
+  copy->cubin_filename = kernel.cubin_filename;
+  copy->kernel_name = kernel.kernel_name;
+  copy->compile_args = kernel.compile_args;
+  copy->block_size = kernel.block_size;
+  copy->shared_module = kernel.shared_module;
+  return copy;
+}
+
+// Make the module of kernel owned by its shared_module, so that copies of
+// the kernel can outlive it
+void shareModule(CompiledKernel& kernel) {
+  if (kernel.shared_module == nullptr && kernel.module != nullptr) {
+    kernel.shared_module =
+        std::shared_ptr<CUmod_st>(kernel.module, [](CUmodule module) {
+          NVFUSER_CUDA_SAFE_CALL(cuModuleUnload(module));
+        });
+  }
+}
+
+} // namespace
+
+CompiledKernelCache& CompiledKernelCache::get() {
+  // Never destroyed, as the modules can't be unloaded once the CUDA driver
+  // is shut down at exit
+  static CompiledKernelCache* cache = new CompiledKernelCache();
+  return *cache;
+}
+
+std::string CompiledKernelCache::makeKey(
+    const std::string& kernel_code,
+    const std::string& kernel_name,
+    PrimDataType index_type,
+    const CompileParams& compile_params,
+    std::optional<int64_t> opt_block_size) {
+  // See CudaKernelGenerator::genDeclaration
+  const std::string declaration = "__global__ void " + kernel_name + "(";
+  std::string code = kernel_code;
+  const auto pos = code.find(declaration);
+  NVF_ERROR(
+      pos != std::string::npos,
+      "Kernel ",
+      kernel_name,
+      " not found in its code");
+  code.replace(pos, declaration.size(), "__global__ void kernel(");
+
+  int device = 0;
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaGetDevice(&device));
+  std::stringstream ss;
+  ss << device << " " << DataType(index_type) << " "
+     << getCompileArgs(compile_params, opt_block_size) << "\n"
+     << code;
+  return ss.str();
+}
+
+std::unique_ptr<CompiledKernel> CompiledKernelCache::getOrCompile(
+    const std::string& key,
+    const CompileFunction& compile) {
+  std::shared_ptr<Entry> entry;
+  std::promise<std::shared_ptr<const CompiledKernel>> promise;
+  bool compiling = false;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      ++hits_;
+      entry = it->second;
+      lru_.splice(lru_.begin(), lru_, entry->lru_it);
+    } else {
+      ++misses_;
+      entry = std::make_shared<Entry>();
+      entry->kernel = promise.get_future().share();
+      addEntry(key, entry);
+      compiling = true;
+    }
+  }
+
+  // Compile without holding the lock, so that other kernels can be looked
+  // up and compiled in the meantime
+  if (compiling) {
+    try {
+      std::shared_ptr<CompiledKernel> kernel = compile();
+      NVF_ERROR(kernel != nullptr, "No kernel compiled for the cache");
+      shareModule(*kernel);
+      promise.set_value(std::move(kernel));
+    } catch (...) {
+      {
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end() && it->second == entry) {
+          lru_.erase(entry->lru_it);
+          entries_.erase(it);
+        }
+      }
+      promise.set_exception(std::current_exception());
+      throw;
+    }
+  }
+
+  // Rethrows the error of a failed compilation to its waiters
+  return shareCompiledKernel(*entry->kernel.get());
+}
+
+std::unique_ptr<CompiledKernel> CompiledKernelCache::find(
+    const std::string& key) {
+  std::shared_ptr<Entry> entry;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      return nullptr;
+    }
+    ++hits_;
+    entry = it->second;
+    lru_.splice(lru_.begin(), lru_, entry->lru_it);
+  }
+  try {
+    return shareCompiledKernel(*entry->kernel.get());
+  } catch (...) {
+    // The thread compiling it reports the error
+    return nullptr;
+  }
+}
+
+std::unique_ptr<CompiledKernel> CompiledKernelCache::insert(
+    const std::string& key,
+    std::unique_ptr<CompiledKernel> kernel) {
+  NVF_ERROR(kernel != nullptr, "No kernel to cache");
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (entries_.count(key) > 0) {
+    return kernel;
+  }
+  ++misses_;
+  shareModule(*kernel);
+  std::shared_ptr<const CompiledKernel> cached = std::move(kernel);
+  std::promise<std::shared_ptr<const CompiledKernel>> promise;
+  promise.set_value(cached);
+  auto entry = std::make_shared<Entry>();
+  entry->kernel = promise.get_future().share();
+  addEntry(key, entry);
+  return shareCompiledKernel(*cached);
+}
+
+void CompiledKernelCache::addEntry(
+    const std::string& key,
+    const std::shared_ptr<Entry>& entry) {
+  lru_.push_front(key);
+  entry->lru_it = lru_.begin();
+  entries_.emplace(key, entry);
+  evict();
+}
+
+void CompiledKernelCache::evict() {
+  // Threads waiting for an evicted kernel being compiled still get it
+  while (entries_.size() > max_size_) {
+    entries_.erase(lru_.back());
+    lru_.pop_back();
+  }
+}
+
+int64_t CompiledKernelCache::hits() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return hits_;
+}
+
+int64_t CompiledKernelCache::misses() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return misses_;
+}
+
+size_t CompiledKernelCache::size() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return entries_.size();
+}
+
+void CompiledKernelCache::clear() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  entries_.clear();
+  lru_.clear();
+  hits_ = 0;
+  misses_ = 0;
+}
+
+size_t CompiledKernelCache::maxSize() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return max_size_;
+}
+
+void CompiledKernelCache::setMaxSize(size_t max_size) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  max_size_ = max_size;
+  evict();
+}
+
 std::unique_ptr<CompiledKernel> getCompiledKernel(
     const serde::CudaKernel* buffer,
     const CompileParams& compile_params) {
@@ -25,7 +25,13 @@
 #include <ir/all_nodes.h>
 #include <kernel.h>
 
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace nvfuser {
@@ -34,6 +40,10 @@ namespace executor_utils {
 // Include all the functions we might need in generated code
 std::string kernelPreamble();
 
+// Host versions of the functions C++ kernels might need, see
+// codegen::generateCppKernel
+std::string cppKernelPreamble();
+
 //! Bind input values to runtime values
 ExpressionEvaluator bindInputs(
     const KernelArgumentHolder& args,
@@ -58,6 +68,9 @@ struct CompiledKernel : public NonCopyable {
   std::string kernel_name;
   std::string compile_args;
   long block_size = -1;
+  //! Owner of module when it is shared by the kernels compiled in one
+  //! batch, see getCompiledKernels
+  std::shared_ptr<CUmod_st> shared_module;
 };
 
 // Returns executable function and the ptxas log from compilation
@@ -69,11 +82,141 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
     const CompileParams& compile_params = CompileParams(),
     std::optional<int64_t> opt_block_size = std::nullopt);
 
+// Returns the options NVRTC would be given to compile a kernel with the
+// given parameters for the current device
+std::string getCompileArgs(
+    const CompileParams& compile_params,
+    std::optional<int64_t> opt_block_size = std::nullopt);
+
+// Compile the kernels func_names of code, a translation unit defining
+// several kernels, with one NVRTC program, and load them in one module.
+// This parses the runtime preamble once for all the kernels. The
+// CompiledKernels are returned in the order of func_names, and share the
+// module and the binary. The kernel database is not used.
+std::vector<std::unique_ptr<CompiledKernel>> getCompiledKernels(
+    const std::string& code,
+    const std::vector<std::string>& func_names,
+    int64_t id,
+    const CompileParams& compile_params = CompileParams(),
+    std::optional<int64_t> opt_block_size = std::nullopt);
+
+//! In-process cache of compiled kernels. FusionExecutors of different
+//! FusionExecutorCaches, or of input shapes mapped to the same schedule,
+//! often generate the same CUDA code. With EnableOption::ModuleCache, they
+//! share the module of the first of them instead of running NVRTC again.
+//!
+//! Kernels are looked up by the key given by makeKey. The kernels returned
+//! for a key are copies of the cached one sharing its module, see
+//! CompiledKernel::shared_module. A kernel being compiled by a thread is
+//! waited for by the other threads asking for it, so each key is compiled
+//! at most once. Failed compilations are not cached.
+//!
+//! At most maxSize() kernels are kept. The least recently used ones are
+//! dropped first; their modules stay loaded until the kernels returned for
+//! them are destroyed too.
+//!
+//! Kernels compiled together by FusionExecutor::compileKernelBatch are
+//! looked up with find before the batch is compiled, and added with insert
+//! after.
+class CompiledKernelCache {
+ public:
+  using CompileFunction = std::function<std::unique_ptr<CompiledKernel>()>;
+
+  static constexpr size_t kDefaultMaxSize = 1024;
+
+  //! Cache shared by the FusionExecutors of the process
+  static CompiledKernelCache& get();
+
+  //! Key of a kernel generated by codegen::generateCudaKernel with the
+  //! name kernel_name. The name is removed from the code, so kernels only
+  //! differing by the id of their FusionExecutor share a key. The key
+  //! includes the index type, defined in the preamble, and the device and
+  //! NVRTC options, which include the target architecture.
+  static std::string makeKey(
+      const std::string& kernel_code,
+      const std::string& kernel_name,
+      PrimDataType index_type,
+      const CompileParams& compile_params,
+      std::optional<int64_t> opt_block_size);
+
+  //! Returns the kernel of key, compiled with compile if not cached yet
+  std::unique_ptr<CompiledKernel> getOrCompile(
+      const std::string& key,
+      const CompileFunction& compile);
+
+  //! Returns the kernel of key, waiting for it if it's being compiled, or
+  //! nullptr if it's not cached or its compilation failed
+  std::unique_ptr<CompiledKernel> find(const std::string& key);
+
+  //! Cache kernel, compiled without getOrCompile, as the kernel of key and
+  //! return a copy sharing its module. A kernel already cached for key is
+  //! kept, and kernel is returned as is.
+  std::unique_ptr<CompiledKernel> insert(
+      const std::string& key,
+      std::unique_ptr<CompiledKernel> kernel);
+
+  int64_t hits() const;
+
+  int64_t misses() const;
+
+  size_t size() const;
+
+  //! Drop all the kernels. The modules are unloaded once the kernels
+  //! returned by getOrCompile are destroyed too.
+  void clear();
+
+  size_t maxSize() const;
+
+  //! Drops the least recently used kernels beyond max_size
+  void setMaxSize(size_t max_size);
+
+ private:
+  struct Entry {
+    std::shared_future<std::shared_ptr<const CompiledKernel>> kernel;
+    //! Position of the key in lru_
+    std::list<std::string>::iterator lru_it;
+  };
+
+  //! Add entry as the most recently used one, evicting the least recently
+  //! used ones beyond max_size_. mutex_ must be held.
+  void addEntry(const std::string& key, const std::shared_ptr<Entry>& entry);
+
+  //! Remove the entries beyond max_size_. mutex_ must be held.
+  void evict();
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<Entry>> entries_;
+  //! Keys from the most to the least recently used
+  std::list<std::string> lru_;
+  size_t max_size_ = kDefaultMaxSize;
+  int64_t hits_ = 0;
+  int64_t misses_ = 0;
+};
+
 // Returns executable function using flatbuffer object
 std::unique_ptr<CompiledKernel> getCompiledKernel(
     const serde::CudaKernel* buffer,
     const CompileParams& compile_params);
 
+//! A C++ kernel compiled into a shared library by the system compiler
+struct CompiledCppKernel : public NonCopyable {
+  //! Signature of kernels generated by codegen::generateCppKernel
+  using Function = void (*)(void**, const int64_t*);
+
+  ~CompiledCppKernel();
+
+  void* library = nullptr;
+  Function function = nullptr;
+  std::string library_filename;
+  std::string kernel_name;
+};
+
+// Returns executable function of a C++ kernel, compiling it with the system
+// compiler unless it's found in CppKernelDb
+std::unique_ptr<CompiledCppKernel> getCompiledCppKernel(
+    const std::string& code,
+    const std::string& func_name);
+
 namespace caching {
 // TODO: Could consider putting some of
 //  the logic in the common space and re-use
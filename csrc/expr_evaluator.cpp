@@ -66,10 +66,11 @@ void validateValWithConcreteValue(
           " elements");
     } else {
       NVF_CHECK(
-          t.is_cuda() || t.is_meta(),
+          t.is_cuda() || t.is_meta() || t.is_cpu(),
           "Expected ",
           tv->toString(),
-          " to be bound to a CUDA or meta tensor, but got a tensor on device ",
+          " to be bound to a CUDA, CPU or meta tensor, but got a tensor on ",
+          "device ",
           t.device());
     }
   } else {
@@ -56,6 +56,9 @@ void swap(Fusion& a, Fusion& b) noexcept {
   swap(a.io_alias_, b.io_alias_);
   swap(a.permuted_input_map_, b.permuted_input_map_);
   swap(a.permuted_output_map_, b.permuted_output_map_);
+
+  a.bumpVersion();
+  b.bumpVersion();
 }
 
 std::unique_ptr<SegmentedFusion> Fusion::segment(
@@ -89,6 +92,8 @@ IrCloner Fusion::copy(const Fusion* from, Fusion* to) {
     to->io_alias_[copied_output] = copied_input;
   }
 
+  to->bumpVersion();
+
   to->permuted_input_map_ = from->permuted_input_map_;
   to->permuted_output_map_ = from->permuted_output_map_;
 
@@ -115,11 +120,10 @@ IrCloner Fusion::copy(const Fusion* from, Fusion* to) {
   return ir_cloner;
 }
 
-// Clang tidy complains when using default constructor for IrContainer instead
-// of copy constructor. Fusion::copy has a call to IrContainer::copy, so it's
-// redundant to use the IrContainer copy constructor, but it is harmless since
-// Fusion::copy starts by calling clear().
-Fusion::Fusion(const Fusion& other) : IrContainer(other) {
+// Fusion::copy has a call to IrContainer::copy, so using the IrContainer copy
+// constructor here would clone the whole container twice.
+// NOLINTNEXTLINE(bugprone-copy-constructor-init)
+Fusion::Fusion(const Fusion& other) : IrContainer() {
   FUSER_PERF_SCOPE("Fusion copy");
   Fusion::copy(&other, this);
 }
@@ -168,6 +172,11 @@ void Fusion::clear() noexcept {
 
   all_tv_uses_valid_ = false;
   is_during_update_uses_ = false;
+
+  bumpVersion();
+  exprs_cache_.clear();
+  used_math_vals_cache_.clear();
+  dependency_cache_ = DependencyCache();
 }
 
 void Fusion::removeExpr(Expr* expr) {
@@ -187,6 +196,7 @@ void Fusion::removeExpr(Expr* expr) {
   }
 
   IrContainer::removeExpr(expr);
+  bumpVersion();
 }
 
 void Fusion::removeVal(Val* val) {
@@ -207,6 +217,7 @@ void Fusion::removeVal(Val* val) {
     removeExpr(use);
   }
   IrContainer::removeVal(val);
+  bumpVersion();
 }
 
 void Fusion::addInput(Val* input) {
@@ -225,6 +236,7 @@ void Fusion::addInput(Val* input) {
   input->setIsFusionInput(true);
 
   all_tv_uses_valid_ = false;
+  bumpVersion();
 }
 
 void Fusion::addOutput(Val* output) {
@@ -249,6 +261,7 @@ void Fusion::addOutput(Val* output) {
   output->setIsFusionOutput(true);
 
   all_tv_uses_valid_ = false;
+  bumpVersion();
 }
 
 void Fusion::removeInput(Val* input) {
@@ -258,6 +271,7 @@ void Fusion::removeInput(Val* input) {
   }
   input->setIsFusionInput(false);
   all_tv_uses_valid_ = false;
+  bumpVersion();
 }
 
 void Fusion::removeOutput(Val* output) {
@@ -267,6 +281,7 @@ void Fusion::removeOutput(Val* output) {
   }
   output->setIsFusionOutput(false);
   all_tv_uses_valid_ = false;
+  bumpVersion();
 }
 
 void Fusion::replaceOutput(Val* output, Val* replacement) {
@@ -290,6 +305,7 @@ void Fusion::replaceOutput(Val* output, Val* replacement) {
     }
     // Mark uses invalid so that they will be reset next time uses() is called
     invalidateTvUses();
+    bumpVersion();
   }
 
   // Temporary WAR for issue #1112
@@ -302,7 +318,17 @@ void Fusion::replaceOutput(Val* output, Val* replacement) {
 }
 
 std::vector<Expr*> Fusion::exprs() {
-  return StmtSort::getExprs(this);
+  if (exprs_cache_version_ == version_) {
+    return exprs_cache_;
+  }
+  auto exprs = StmtSort::getExprsTo(this, getTerminatingOutputs());
+  // While the uses are being rebuilt, the terminating outputs may be computed
+  // from stale uses, so don't keep that order
+  if (!is_during_update_uses_) {
+    exprs_cache_ = exprs;
+    exprs_cache_version_ = version_;
+  }
+  return exprs;
 }
 
 bool Fusion::isNoOp() {
@@ -565,6 +591,8 @@ void Fusion::registerExpr(Expr* expr) {
       }
     }
   }
+
+  bumpVersion();
 }
 
 void Fusion::resetTvUses() {
@@ -593,6 +621,9 @@ void Fusion::resetTvUses() {
 }
 
 std::vector<Val*> Fusion::usedMathVals() {
+  if (used_math_vals_cache_version_ == version_) {
+    return used_math_vals_cache_;
+  }
   // Note that using fusion->inputs() as the argument for the first
   // parameter of getAllValsBetween does not grab all used vals as
   // there can be vals that are created inside a fusion without using
@@ -627,6 +658,11 @@ std::vector<Val*> Fusion::usedMathVals() {
   used_math_vals.insert(
       used_math_vals.end(), vals_to_add.begin(), vals_to_add.end());
 
+  if (!is_during_update_uses_) {
+    used_math_vals_cache_ = used_math_vals;
+    used_math_vals_cache_version_ = version_;
+  }
+
   return used_math_vals;
 }
 
@@ -663,9 +699,25 @@ bool Fusion::isStochastic() {
   return false;
 }
 
+DependencyCache* Fusion::dependencyCache() const {
+  if (isA<kir::Kernel>() || is_during_update_uses_) {
+    return nullptr;
+  }
+  if (dependency_cache_.version != version_) {
+    dependency_cache_ = DependencyCache();
+    dependency_cache_.version = version_;
+  }
+  return &dependency_cache_;
+}
+
 std::vector<Val*> Fusion::getTerminatingOutputs() const {
   FUSER_PERF_SCOPE("getTerminatingOutputs");
 
+  auto cache = dependencyCache();
+  if (cache != nullptr && cache->terminating_outputs.has_value()) {
+    return cache->terminating_outputs.value();
+  }
+
   auto is_reachable_to_output = [](Val* val) {
     // traverse to consumers of val and see if there is an output
     std::deque<Val*> consumers;
@@ -707,6 +759,9 @@ std::vector<Val*> Fusion::getTerminatingOutputs() const {
     terminating_outputs.push_back(out);
   }
 
+  if (cache != nullptr) {
+    cache->terminating_outputs = terminating_outputs;
+  }
   return terminating_outputs;
 }
 
@@ -164,7 +164,8 @@ class Fusion : public IrContainer {
   bankConflictInfo(const CompileParams& compile_params = CompileParams());
 
   //! Return a list of topologically sorted expressions. This only includes
-  //! exprs required to genereate registered outputs.
+  //! exprs required to genereate registered outputs. The order is cached until
+  //! the next mutation of the fusion.
   std::vector<Expr*> exprs();
 
   //! Return a vector of fusion inputs that feed this Val
@@ -176,6 +177,8 @@ class Fusion : public IrContainer {
   //! outputs, however, when a multi-output expression exists, and only
   //! some of the outputs are used, the remaining unused outputs are
   //! also included as they must show up in the final code.
+  //!
+  //! Cached until the next mutation of the fusion.
   std::vector<Val*> usedMathVals();
 
   //! Returns all vals that are produced by used math expressions and
@@ -208,6 +211,8 @@ class Fusion : public IrContainer {
     return outputs_;
   }
 
+  //! Return the outputs that no other output depends on. Cached until the
+  //! next mutation of the fusion.
   std::vector<Val*> getTerminatingOutputs() const;
 
   // Aliasing output to input value, this is a WAR to allow inplace update on
@@ -258,6 +263,20 @@ class Fusion : public IrContainer {
     return is_during_update_uses_;
   }
 
+  //! Incremented each time the graph of the fusion is modified, i.e., when an
+  //! Expr is registered or removed, or when the inputs or outputs change.
+  //! Analyses depending only on the graph can be cached along with the
+  //! version they were computed at.
+  int64_t version() const {
+    return version_;
+  }
+
+  //! Results of the traversals of DependencyCheck computed at the current
+  //! version, emptied once the fusion is modified. Returns nullptr when they
+  //! can't be kept, i.e., for kernels and while the uses of the TensorViews
+  //! are being rebuilt.
+  DependencyCache* dependencyCache() const;
+
   const auto& ioAlias() const {
     return io_alias_;
   }
@@ -440,6 +459,11 @@ class Fusion : public IrContainer {
     all_tv_uses_valid_ = false;
   }
 
+  //! Declare that the graph has changed, invalidating the cached traversals
+  void bumpVersion() {
+    version_++;
+  }
+
  private:
   // Determine if the two values are compatible for aliasing
   // Same DataType, ValType, and number of dimensions
@@ -464,6 +488,20 @@ class Fusion : public IrContainer {
   bool all_tv_uses_valid_ = false;
   bool is_during_update_uses_ = false;
 
+  // See version(). Never reset, so that caches can't be confused by a fusion
+  // that was cleared and rebuilt.
+  int64_t version_ = 0;
+
+  // Results of exprs() and usedMathVals(), valid if their version matches
+  // version_
+  std::vector<Expr*> exprs_cache_;
+  int64_t exprs_cache_version_ = -1;
+  std::vector<Val*> used_math_vals_cache_;
+  int64_t used_math_vals_cache_version_ = -1;
+
+  // See dependencyCache()
+  mutable DependencyCache dependency_cache_;
+
   std::vector<std::pair<std::any, CloneFn>> managed_data_;
   std::unordered_map<std::string, std::pair<std::any, CloneFn>>
       managed_named_data_;
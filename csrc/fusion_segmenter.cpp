@@ -18,6 +18,7 @@
 #include <scheduler/debug_utils.h>
 #include <scheduler/normalization_utils.h>
 
+#include <limits>
 #include <sstream>
 
 namespace nvfuser {
@@ -1680,6 +1681,7 @@ void SegmentCandidateFinder::eraseGroups(
     std::unordered_set<SegmentedGroup*>& groups_to_erase) {
   std::unordered_set<SegmentedEdge*> edges_to_erase;
   for (auto group : groups_to_erase) {
+    group_times_.erase(group);
     auto disconnected_edges = disconnectGroup(group);
     edges_to_erase.insert(disconnected_edges.begin(), disconnected_edges.end());
   }
@@ -1719,6 +1721,8 @@ SegmentedGroup* SegmentCandidateFinder::mergeNodes() {
 
     clean_up_groups_.emplace(group1);
     clean_up_groups_.emplace(group2);
+    group_times_.erase(group1);
+    group_times_.erase(group2);
 
     // Make the new joined node
     auto joined_group = segmented_fusion_->newGroup();
@@ -1886,6 +1890,7 @@ SegmentedGroup* SegmentCandidateFinder::mergeAllGivenGroups(
 
   // Clean up original groups from segmented fusion
   for (auto group : groups_to_merge) {
+    group_times_.erase(group);
     auto disconnected_edges = disconnectGroup(group);
     clean_up_edges_.insert(
         disconnected_edges.begin(), disconnected_edges.end());
@@ -2152,6 +2157,30 @@ std::optional<ScheduleHeuristic> tryMerge(
       segmented_fusion->completeFusion(), runtime_info);
 }
 
+// Estimated time of running a and b, or a alone if b is nullptr, as a
+// single kernel. Infinite if no scheduler accepts the kernel.
+double estimateKernelTime(
+    SegmentedFusion* segmented_fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    const SegmentCostModel& cost_model,
+    SegmentedGroup* a,
+    SegmentedGroup* b = nullptr) {
+  FusionSegmentGuard fsg(segmented_fusion, a, b);
+  auto fusion = segmented_fusion->completeFusion();
+  if (tryingToMergeSegmenterSet(fusion)) {
+    return std::numeric_limits<double>::infinity();
+  }
+  auto heuristic = SchedulerEntry::proposeHeuristics(fusion, runtime_info);
+  if (!heuristic.has_value()) {
+    return std::numeric_limits<double>::infinity();
+  }
+  auto entry =
+      SchedulerEntry::makeEntry(heuristic.value(), fusion, runtime_info);
+  auto cost = cost_model.estimate(
+      fusion, runtime_info.expressionEvaluator(), entry->params().get());
+  return cost.time_us;
+}
+
 // This function is for cleanup and
 //  easier debugging. It shouldn't affect functionality
 //  since segmented fusions are compiled with fusion
@@ -3248,6 +3277,28 @@ bool SegmentCandidateFinder::codeGenSupportedMerge(
   return h.has_value();
 }
 
+double SegmentCandidateFinder::estimateMergeSavings(
+    SegmentedGroup* group1,
+    SegmentedGroup* group2) {
+  NVF_ERROR(options_.cost_model != nullptr, "No cost model is set");
+  auto time = [&](SegmentedGroup* a, SegmentedGroup* b = nullptr) {
+    return estimateKernelTime(
+        segmented_fusion_.get(), runtime_info_, *options_.cost_model, a, b);
+  };
+  // A group is compared against each of its neighbors, so its own time is
+  // estimated once and kept until it is merged or erased
+  auto group_time = [&](SegmentedGroup* group) {
+    auto it = group_times_.find(group);
+    if (it == group_times_.end()) {
+      it = group_times_.emplace(group, time(group)).first;
+    }
+    return it->second;
+  };
+  auto separate_time = group_time(group1) + group_time(group2);
+  auto merged_time = time(group1, group2);
+  return separate_time - merged_time;
+}
+
 // TODO: consider caching the heuristics value so tryMerge doesn't have to be
 //       called twice
 ScheduleHeuristic SegmentCandidateFinder::deriveHeuristic(
@@ -3265,6 +3316,11 @@ SegmentCandidateFinder::SegmentCandidateFinder(
     : options_(options),
       runtime_info_(fusion.get(), inputs),
       runtime_inputs_(inputs) {
+  if (options_.cost_model == nullptr &&
+      isOptionEnabled(EnableOption::SegmentCostModel)) {
+    options_.cost_model =
+        std::make_shared<AnalyticalCostModel>(DeviceModel::current());
+  }
   segmented_fusion_ = std::make_unique<SegmentedFusion>(std::move(fusion));
   findSegments();
 }
@@ -3352,9 +3408,26 @@ void SegmentCandidateFinder::trySetUpMerge(
   }
 
   auto candidate_it = candidates.begin();
-  while (candidate_it != candidates.end() &&
-         !codeGenSupportedMerge(group, candidate_it->group)) {
-    candidate_it++;
+  if (options_.cost_model == nullptr) {
+    while (candidate_it != candidates.end() &&
+           !codeGenSupportedMerge(group, candidate_it->group)) {
+      candidate_it++;
+    }
+  } else {
+    // Pick the feasible candidate saving the most time
+    auto best_it = candidates.end();
+    double best_savings = 0;
+    for (; candidate_it != candidates.end(); ++candidate_it) {
+      if (!codeGenSupportedMerge(group, candidate_it->group)) {
+        continue;
+      }
+      auto savings = estimateMergeSavings(group, candidate_it->group);
+      if (savings >= best_savings) {
+        best_it = candidate_it;
+        best_savings = savings;
+      }
+    }
+    candidate_it = best_it;
   }
   if (candidate_it == candidates.end()) {
     return;
@@ -3585,7 +3658,9 @@ void SegmentCandidateFinder::finalMerge() {
       for (auto consumer : all_consumers_of_producer_group) {
         if (!producer_check->isConsumerOfAny(
                 consumer, all_consumers_of_producer_group) &&
-            codeGenSupportedMerge(producer_group, consumer)) {
+            codeGenSupportedMerge(producer_group, consumer) &&
+            (options_.cost_model == nullptr ||
+             estimateMergeSavings(producer_group, consumer) >= 0)) {
           to_merge_.emplace_back(producer_group);
           to_merge_.emplace_back(consumer);
           producer_group->merged_ = true;
@@ -14,11 +14,13 @@
 #include <kernel_cache.h>
 #include <options.h>
 #include <scheduler/all_schedulers.h>
+#include <scheduler/cost_model.h>
 #include <scheduler/registry.h>
 #include <utils.h>
 
 #include <deque>
 #include <list>
+#include <memory>
 #include <unordered_set>
 #include <vector>
 
@@ -491,6 +493,11 @@ struct SegmentCandidateFinderOptions {
   bool run_combine_reductions = true;
   bool run_herrmann_merge = true;
   bool run_final_merge = true;
+  //! When set, merges are ranked by the estimated time saved and merges
+  //! estimated to be slower than the separate kernels are rejected. An
+  //! AnalyticalCostModel is used if EnableOption::SegmentCostModel is
+  //! set and no model is given.
+  std::shared_ptr<SegmentCostModel> cost_model = nullptr;
 };
 
 //!  SegmentCandidateFinder
@@ -573,6 +580,11 @@ class SegmentCandidateFinder {
 
   bool codeGenSupportedMerge(SegmentedGroup* group1, SegmentedGroup* group2);
 
+  //! Estimated time saved by merging group1 and group2 into one
+  //! kernel according to options_.cost_model. Negative if the merged
+  //! kernel is expected to be slower.
+  double estimateMergeSavings(SegmentedGroup* group1, SegmentedGroup* group2);
+
   void buildInitialSegments();
 
   void findSegments();
@@ -706,6 +718,10 @@ class SegmentCandidateFinder {
 
   std::vector<SegmentedGroup*> to_merge_;
 
+  //! Estimated kernel time of each group by options_.cost_model, filled
+  //! lazily by estimateMergeSavings
+  std::unordered_map<SegmentedGroup*, double> group_times_;
+
   std::unique_ptr<SegmentedFusion> segmented_fusion_;
 
   std::unique_ptr<SegmenterAnalysis> group_dependency_;
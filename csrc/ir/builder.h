@@ -12,6 +12,8 @@
 #include <ir/builder_passkey.h>
 #include <utils.h>
 
+#include <new>
+
 namespace nvfuser {
 
 namespace kir {
@@ -30,7 +32,10 @@ class IrBuilder {
     auto container = FusionGuard::getCurFusion();
     // return create<T>(container, std::forward<Args>(args)...);
     NVF_ERROR(container != nullptr, "Need an active container to build IR.");
-    T* node = new T(IrBuilderPasskey(container), std::forward<Args>(args)...);
+    void* memory =
+        container->allocate(IrBuilderPasskey(container), sizeof(T), alignof(T));
+    T* node = new (memory)
+        T(IrBuilderPasskey(container), std::forward<Args>(args)...);
 
     container->registerStmt(IrBuilderPasskey(container), node);
 
@@ -42,7 +47,10 @@ class IrBuilder {
   template <class T, class... Args>
   static T* create(IrContainer* container, Args&&... args) {
     NVF_ERROR(container != nullptr, "Need an active container to build IR.");
-    T* node = new T(IrBuilderPasskey(container), std::forward<Args>(args)...);
+    void* memory =
+        container->allocate(IrBuilderPasskey(container), sizeof(T), alignof(T));
+    T* node = new (memory)
+        T(IrBuilderPasskey(container), std::forward<Args>(args)...);
 
     container->registerStmt(IrBuilderPasskey(container), node);
 
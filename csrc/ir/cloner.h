@@ -143,11 +143,13 @@ T* IrBuilder::clone(const T* src, IrCloner* ir_cloner) {
       ir_cloner->container() != nullptr,
       "Cloner doesn't have a valid container to store cloned object.");
 
-  T* dest = new T(src, ir_cloner);
+  auto dest_container = ir_cloner->container();
+  void* memory = dest_container->allocate(
+      IrBuilderPasskey(dest_container), sizeof(T), alignof(T));
+  T* dest = new (memory) T(src, ir_cloner);
   const Statement* src_stmt = dynamic_cast<const Statement*>(src);
   Statement* dest_stmt = dynamic_cast<Statement*>(dest);
 
-  auto dest_container = ir_cloner->container();
   auto src_container = src_stmt->container();
 
   dest_container->registerStmt(IrBuilderPasskey(dest_container), dest_stmt);
@@ -10,41 +10,111 @@
 #include <ir/cloner.h>
 #include <ir/container.h>
 
+#include <algorithm>
+
 namespace nvfuser {
 
+namespace {
+
+char* alignUp(char* ptr, size_t alignment) {
+  auto addr = reinterpret_cast<uintptr_t>(ptr); // NOLINT
+  return ptr + (alignment - addr % alignment) % alignment;
+}
+
+} // namespace
+
+void* StatementArena::allocate(size_t size, size_t alignment) {
+  alignment = std::max(alignment, alignof(int64_t));
+  char* ptr = cursor_ == nullptr
+      ? nullptr
+      : alignUp(cursor_ + sizeof(int64_t), alignment);
+  if (ptr == nullptr || ptr + size > end_) {
+    addBlock(size + sizeof(int64_t) + alignment);
+    ptr = alignUp(cursor_ + sizeof(int64_t), alignment);
+  }
+  bytes_used_ += (ptr + size) - cursor_;
+  cursor_ = ptr + size;
+  indexOf(ptr) = -1;
+  return ptr;
+}
+
+void StatementArena::addBlock(size_t size) {
+  size = std::max(size, next_block_size_);
+  next_block_size_ = std::min(next_block_size_ * 2, kMaxBlockSize);
+  blocks_.emplace_back(new char[size]);
+  cursor_ = blocks_.back().get();
+  end_ = cursor_ + size;
+  block_ranges_.emplace(end_, cursor_);
+}
+
+void StatementArena::reserve(size_t size) {
+  if (cursor_ == nullptr || (size_t)(end_ - cursor_) < size) {
+    addBlock(size);
+  }
+}
+
+bool StatementArena::owns(const void* ptr) const {
+  auto p = static_cast<const char*>(ptr);
+  // First block ending after p
+  auto it = block_ranges_.upper_bound(p);
+  return it != block_ranges_.end() &&
+      !std::less<const char*>()(p, it->second);
+}
+
+void StatementArena::clear() noexcept {
+  blocks_.clear();
+  block_ranges_.clear();
+  cursor_ = nullptr;
+  end_ = nullptr;
+  next_block_size_ = kMinBlockSize;
+  bytes_used_ = 0;
+}
+
+void swap(StatementArena& a, StatementArena& b) noexcept {
+  using std::swap;
+  swap(a.blocks_, b.blocks_);
+  swap(a.block_ranges_, b.block_ranges_);
+  swap(a.cursor_, b.cursor_);
+  swap(a.end_, b.end_);
+  swap(a.next_block_size_, b.next_block_size_);
+  swap(a.bytes_used_, b.bytes_used_);
+}
+
 void swap(IrContainer& a, IrContainer& b) noexcept {
   FUSER_PERF_SCOPE("Fusion swap");
 
   using std::swap;
 
-  // Swap the content
-  swap(a.vals_up_, b.vals_up_);
+  // Swap the content. The Statements stay where they are in memory, only the
+  // ownership of the arenas changes.
+  swap(a.arena_, b.arena_);
+  swap(a.stmts_, b.stmts_);
   swap(a.vals_, b.vals_);
-
-  swap(a.exprs_up_, b.exprs_up_);
   swap(a.exprs_, b.exprs_);
 
-  swap(a.raw_ptrs_, b.raw_ptrs_);
-
   swap(a.val_type_name_map_, b.val_type_name_map_);
   swap(a.expr_name_counter_, b.expr_name_counter_);
 
+  swap(a.true_val_, b.true_val_);
+  swap(a.false_val_, b.false_val_);
+  swap(a.one_val_, b.one_val_);
+  swap(a.zero_val_, b.zero_val_);
+  swap(a.magic_zero_val_, b.magic_zero_val_);
+  swap(a.axioms_, b.axioms_);
   swap(a.metadata_, b.metadata_);
 
   // Fixup the Statement::fusion_ links for a
-  for (auto val : a.vals_) {
-    val->ir_container_ = &a;
-  }
-  for (auto expr : a.exprs_) {
-    expr->ir_container_ = &a;
+  for (auto stmt : a.stmts_) {
+    if (stmt != nullptr) {
+      stmt->ir_container_ = &a;
+    }
   }
 
   // Fixup the Statement::fusion_ links for b
-  for (auto val : b.vals_) {
-    val->ir_container_ = &a;
-  }
-  for (auto expr : b.exprs_) {
-    expr->ir_container_ = &a;
+  for (auto stmt : b.stmts_) {
+    if (stmt != nullptr) {
+      stmt->ir_container_ = &b;
+    }
   }
 }
 
@@ -52,12 +122,23 @@ IrCloner IrContainer::copy(const IrContainer* from, IrContainer* to) {
   to->clear();
   IrCloner ir_cloner(to);
 
-  for (auto val : from->vals_) {
-    to->vals_.insert(ir_cloner.clone(val));
+  // Size the arena and the lookup structures of the copy upfront
+  to->arena_.reserve(from->arena_.bytesUsed());
+  to->stmts_.reserve(from->stmts_.size());
+  to->vals_.reserve(from->vals_.size());
+  to->exprs_.reserve(from->exprs_.size());
+
+  // Clone in insertion order, so that the copy is deterministic
+  for (auto stmt : from->stmts_) {
+    if (stmt != nullptr && stmt->isVal()) {
+      ir_cloner.clone(stmt->asVal());
+    }
   }
 
-  for (auto expr : from->exprs_) {
-    to->exprs_.insert(ir_cloner.clone(expr));
+  for (auto stmt : from->stmts_) {
+    if (stmt != nullptr && stmt->isExpr()) {
+      ir_cloner.clone(stmt->asExpr());
+    }
   }
 
   to->val_type_name_map_ = from->val_type_name_map_;
@@ -106,6 +187,20 @@ IrContainer::~IrContainer() {
   clear();
 }
 
+const std::deque<Val*> IrContainer::deterministic_vals() const noexcept {
+  std::deque<Val*> vals_deque;
+  for (auto stmt : stmts_) {
+    if (stmt == nullptr || !stmt->isVal()) {
+      continue;
+    }
+    auto val = stmt->asVal();
+    if (!isShortcut(val)) {
+      vals_deque.push_back(val);
+    }
+  }
+  return vals_deque;
+}
+
 //! Register the Statement with this container
 void IrContainer::registerStmt(IrBuilderPasskey, Statement* stmt) {
   if (stmt->isVal()) {
@@ -125,49 +220,44 @@ void IrContainer::registerExpr(IrBuilderPasskey, Expr* expr) {
   registerExpr(expr);
 }
 
+void IrContainer::registerStmtIndex(Statement* stmt) {
+  NVF_ERROR(
+      arena_.owns(stmt),
+      "Statements must be allocated by the container they are registered with.");
+  StatementArena::indexOf(stmt) = (int64_t)stmts_.size();
+  stmts_.push_back(stmt);
+}
+
+void IrContainer::destroyStmt(Statement* stmt) {
+  auto& index = StatementArena::indexOf(stmt);
+  stmts_.at(index) = nullptr;
+  index = -1;
+  stmt->~Statement();
+}
+
 void IrContainer::removeExpr(Expr* expr) {
   NVF_ERROR(
       exprs_.find(expr) != exprs_.end(),
       "Wanted to remove an expression but it doesn't exist in this container.");
-  auto expr_in_deque = std::find_if(
-      exprs_up_.begin(),
-      exprs_up_.end(),
-      [expr](std::unique_ptr<Expr>& expr_up) { return expr_up.get() == expr; });
-
-  NVF_ERROR(
-      expr_in_deque != exprs_up_.end(),
-      "Wanted to remove an expression but its unique ptr is missing.");
 
   exprs_.erase(expr);
-  exprs_up_.erase(expr_in_deque);
-  raw_ptrs_.erase((void*)expr);
+  destroyStmt(expr);
 }
 
 //! Completely remove val from the fusion, break all dependencies associated
 //! with it
 void IrContainer::removeVal(Val* val) {
   // Don't remove shortcuts
-  if (val == true_val_.get() || val == false_val_.get() ||
-      val == one_val_.get() || val == zero_val_.get() ||
-      val == magic_zero_val_.get()) {
+  if (isShortcut(val)) {
     return;
   }
 
   NVF_ERROR(
       vals_.find(val) != vals_.end(),
       "Wanted to remove a value but it doesn't exist in this container.");
-  auto val_in_deque = std::find_if(
-      vals_up_.begin(), vals_up_.end(), [val](std::unique_ptr<Val>& val_up) {
-        return val_up.get() == val;
-      });
-
-  NVF_ERROR(
-      val_in_deque != vals_up_.end(),
-      "Wanted to remove a value but its unique ptr is missing.");
 
   vals_.erase(val);
-  vals_up_.erase(val_in_deque);
-  raw_ptrs_.erase((void*)val);
+  destroyStmt(val);
 }
 
 //! Register the Val with this container
@@ -176,10 +266,9 @@ void IrContainer::registerVal(Val* val) {
     return;
   }
 
-  vals_up_.emplace_back(std::unique_ptr<Val>(val));
-  vals_.emplace(vals_up_.back().get());
-  val->setName(IrContainerPasskey(), getValName(vals_up_.back()->vtype()));
-  raw_ptrs_.emplace((void*)vals_up_.back().get());
+  registerStmtIndex(val);
+  vals_.emplace(val);
+  val->setName(IrContainerPasskey(), getValName(val->vtype()));
 }
 
 //! Register expr with this container.
@@ -187,19 +276,34 @@ void IrContainer::registerExpr(Expr* expr) {
   if (inContainer(expr)) {
     return;
   }
-  exprs_up_.emplace_back(std::unique_ptr<Expr>(expr));
-  exprs_.emplace(exprs_up_.back().get());
+  registerStmtIndex(expr);
+  exprs_.emplace(expr);
   expr->setName(IrContainerPasskey(), getExprName());
-  raw_ptrs_.emplace((void*)exprs_up_.back().get());
 }
 
 void IrContainer::clear() noexcept {
   FUSER_PERF_SCOPE("IrContainer clear");
+  // Bulk destruction: run the destructors, vals first, then release the
+  // memory of the arena at once
+  for (auto stmt : stmts_) {
+    if (stmt != nullptr && stmt->isVal()) {
+      stmt->~Statement();
+    }
+  }
+  for (auto stmt : stmts_) {
+    if (stmt != nullptr && !stmt->isVal()) {
+      stmt->~Statement();
+    }
+  }
+  stmts_.clear();
+  arena_.clear();
   vals_.clear();
-  vals_up_.clear();
   exprs_.clear();
-  exprs_up_.clear();
-  raw_ptrs_.clear();
+  true_val_ = nullptr;
+  false_val_ = nullptr;
+  one_val_ = nullptr;
+  zero_val_ = nullptr;
+  magic_zero_val_ = nullptr;
   axioms_.reset();
   val_type_name_map_.clear();
   metadata_.clear();
@@ -207,9 +311,13 @@ void IrContainer::clear() noexcept {
 }
 
 bool IrContainer::inContainer(const Statement* stmt) const {
-  const void* const_void = (const void*)(stmt);
-  void* nonconst_void = const_cast<void*>(const_void); // NOLINT
-  if (raw_ptrs_.find(nonconst_void) == raw_ptrs_.end()) {
+  // Don't dereference stmt before making sure it lives in our arena
+  if (!arena_.owns(stmt)) {
+    return false;
+  }
+  auto index = StatementArena::indexOf(stmt);
+  if (index < 0 || (size_t)index >= stmts_.size() ||
+      stmts_[index] != stmt) {
     return false;
   }
 
@@ -235,12 +343,9 @@ bool IrContainer::inContainer(const Statement* stmt) const {
 // Shortcuts for frequently used vals
 Val* IrContainer::zeroVal() {
   if (!zero_val_) {
-    auto zero_val = IrBuilder::create<Val>(this, 0L, DataType::Index);
-    NVF_ERROR(vals_up_.back().get() == zero_val);
-    zero_val_ = std::unique_ptr<Val>(vals_up_.back().release());
-    vals_up_.pop_back();
+    zero_val_ = IrBuilder::create<Val>(this, 0L, DataType::Index);
   }
-  return zero_val_.get();
+  return zero_val_;
 }
 
 Val* IrContainer::zeroVal(DataType dtype) {
@@ -256,12 +361,9 @@ Val* IrContainer::zeroVal(DataType dtype) {
 
 Val* IrContainer::oneVal() {
   if (!one_val_) {
-    auto one_val = IrBuilder::create<Val>(this, 1L, DataType::Index);
-    NVF_ERROR(vals_up_.back().get() == one_val);
-    one_val_ = std::unique_ptr<Val>(vals_up_.back().release());
-    vals_up_.pop_back();
+    one_val_ = IrBuilder::create<Val>(this, 1L, DataType::Index);
   }
-  return one_val_.get();
+  return one_val_;
 }
 
 Val* IrContainer::oneVal(DataType dtype) {
@@ -277,34 +379,26 @@ Val* IrContainer::oneVal(DataType dtype) {
 
 Val* IrContainer::falseVal() {
   if (!false_val_) {
-    auto false_val = IrBuilder::create<Val>(this, false, DataType::Bool);
-    NVF_ERROR(vals_up_.back().get() == false_val);
-    false_val_ = std::unique_ptr<Val>(vals_up_.back().release());
-    vals_up_.pop_back();
+    false_val_ = IrBuilder::create<Val>(this, false, DataType::Bool);
   }
-  return false_val_.get();
+  return false_val_;
 }
 
 Val* IrContainer::trueVal() {
   if (!true_val_) {
-    auto true_val = IrBuilder::create<Val>(this, true, DataType::Bool);
-    NVF_ERROR(vals_up_.back().get() == true_val);
-    true_val_ = std::unique_ptr<Val>(vals_up_.back().release());
-    vals_up_.pop_back();
+    true_val_ = IrBuilder::create<Val>(this, true, DataType::Bool);
   }
-  return true_val_.get();
+  return true_val_;
 }
 
 NamedScalar* IrContainer::magicZeroVal() {
   if (!magic_zero_val_) {
     auto magic_zero =
         IrBuilder::create<NamedScalar>(kMagicZeroName, DataType::Index);
-    NVF_ERROR(vals_up_.back().get() == magic_zero);
-    magic_zero_val_ = std::unique_ptr<NamedScalar>(
-        vals_up_.back().release()->as<NamedScalar>());
-    vals_up_.pop_back();
+    NVF_ERROR(magic_zero->container() == this);
+    magic_zero_val_ = magic_zero;
   }
-  return magic_zero_val_.get();
+  return magic_zero_val_;
 }
 
 Val* IrContainer::metadataOf(Val* v) {
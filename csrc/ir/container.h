@@ -11,11 +11,15 @@
 #include <exceptions.h>
 
 #include <ir/base_nodes.h>
+#include <ir/builder_passkey.h>
 #include <utils.h>
 
 #include <deque>
+#include <map>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace nvfuser {
 
@@ -33,6 +37,72 @@ class IrContainerPasskey {
   explicit IrContainerPasskey() = default;
 };
 
+// Bump allocator owning the memory of the Statements of an IrContainer.
+//
+// Statements are created and cloned in large numbers by segmentation,
+// concretization and lowering, so instead of allocating each node separately
+// on the heap, the container carves them out of a few large blocks. Addresses
+// are stable: blocks are never moved nor reallocated, and memory is only
+// returned when the whole arena is cleared. Each allocation is preceded by a
+// slot where the container stores the dense index of the Statement, which
+// makes membership checks possible without hashing and without dereferencing
+// the Statement.
+class StatementArena {
+ public:
+  StatementArena() = default;
+
+  StatementArena(const StatementArena&) = delete;
+  StatementArena& operator=(const StatementArena&) = delete;
+
+  friend void swap(StatementArena& a, StatementArena& b) noexcept;
+
+  //! Returns uninitialized memory for an object of the given size and
+  //! alignment. The index slot of the allocation is set to -1.
+  void* allocate(size_t size, size_t alignment);
+
+  //! Returns whether ptr was handed out by this arena. ptr is not
+  //! dereferenced, so it can be a dangling pointer.
+  bool owns(const void* ptr) const;
+
+  //! Index slot preceding an allocation made by this arena
+  static int64_t& indexOf(const void* ptr) {
+    return *reinterpret_cast<int64_t*>( // NOLINT
+        const_cast<char*>(static_cast<const char*>(ptr)) - // NOLINT
+        sizeof(int64_t));
+  }
+
+  //! Makes sure the next allocations totalling up to size bytes don't need
+  //! another block
+  void reserve(size_t size);
+
+  //! Releases all the blocks. The objects allocated in the arena must have
+  //! been destroyed before.
+  void clear() noexcept;
+
+  //! Number of bytes handed out, including the index slots and padding
+  size_t bytesUsed() const {
+    return bytes_used_;
+  }
+
+ private:
+  void addBlock(size_t size);
+
+  // Size of the first block, doubled for each new block up to kMaxBlockSize
+  static constexpr size_t kMinBlockSize = 16 * 1024;
+  static constexpr size_t kMaxBlockSize = 1024 * 1024;
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+
+  // Maps the end address of each block to its begin address, to find the
+  // block containing a pointer with a single lookup
+  std::map<const char*, const char*> block_ranges_;
+
+  char* cursor_ = nullptr;
+  char* end_ = nullptr;
+  size_t next_block_size_ = kMinBlockSize;
+  size_t bytes_used_ = 0;
+};
+
 class IrContainer : public PolymorphicBase {
  public:
   IrContainer();
@@ -53,14 +123,12 @@ class IrContainer : public PolymorphicBase {
   }
 
   //! Return in insertion order
-  const std::deque<Val*> deterministic_vals() const noexcept {
-    std::deque<Val*> vals_deque;
-    std::transform(
-        vals_up_.begin(),
-        vals_up_.end(),
-        std::back_inserter(vals_deque),
-        [](const std::unique_ptr<Val>& val_up) { return val_up.get(); });
-    return vals_deque;
+  const std::deque<Val*> deterministic_vals() const noexcept;
+
+  //! Allocate memory for a Statement that will be registered with this
+  //! container. Used by IrBuilder, the memory is owned by the container.
+  void* allocate(IrBuilderPasskey, size_t size, size_t alignment) {
+    return arena_.allocate(size, alignment);
   }
 
   //! Register the Statement with this container
@@ -138,27 +206,39 @@ class IrContainer : public PolymorphicBase {
 
   void lazyInitAxioms();
 
-  // Deque of unique pointer is the memory owning data structure
-  std::deque<std::unique_ptr<Val>> vals_up_;
+  // Add stmt to stmts_ and record its index in its arena slot
+  void registerStmtIndex(Statement* stmt);
+
+  // Destroy stmt and free its index. Its memory is reclaimed when the arena
+  // is cleared.
+  void destroyStmt(Statement* stmt);
+
+  // Returns whether val is one of the persistent shortcut vals
+  bool isShortcut(const Val* val) const {
+    return val == true_val_ || val == false_val_ || val == one_val_ ||
+        val == zero_val_ || val == magic_zero_val_;
+  }
+
+  // The memory owning data structure. All the Statements registered with
+  // this container are allocated from it and destroyed by clear().
+  StatementArena arena_;
+
+  // Statements in insertion order, indexed by the dense index stored in their
+  // arena slot. Removed Statements leave a nullptr. This is used to implement
+  // a generic "inContainer" that can be passed an invalid pointer.
+  // Specifically a pointer to a Statement owned by another container that has
+  // been freed: the arena tells if the pointer is ours without dereferencing
+  // it, and the index slot if it is still alive.
+  std::vector<Statement*> stmts_;
 
   // A convenient set to return when we just need an unordered set to do
   // something like check if a Val is in this container
   std::unordered_set<Val*> vals_;
 
-  // Deque of unique pointer is the memory owning data structure
-  std::deque<std::unique_ptr<Expr>> exprs_up_;
-
   // A convenient set to return when we just need an unordered set to do
   // something like check if an Expr is in this container
   std::unordered_set<Expr*> exprs_;
 
-  // Used to implement a generic "inContainer" that can be passed an invalid
-  // pointer. Specifically a pointer to a Statement owned by another container
-  // that has been freed. We can't check normally with the unordered_sets we
-  // already have because it would require a const_cast from a constant
-  // expr/val, or a dynamic cast from a Statement.
-  std::unordered_set<void*> raw_ptrs_;
-
   // Values names counters
   std::unordered_map<ValType, StmtNameType> val_type_name_map_;
 
@@ -172,12 +252,13 @@ class IrContainer : public PolymorphicBase {
   // the node may have been removed then re-registered. It could also be tricky
   // to know when we're using a different container as in FusionCopy_test
   // demonstrates deleting then creating containers can result in the same
-  // pointer for the container.
-  std::unique_ptr<Val> true_val_;
-  std::unique_ptr<Val> false_val_;
-  std::unique_ptr<Val> one_val_;
-  std::unique_ptr<Val> zero_val_;
-  std::unique_ptr<NamedScalar> magic_zero_val_;
+  // pointer for the container. They are owned by the arena like the other
+  // Statements, but are not part of deterministic_vals() and can't be removed.
+  Val* true_val_ = nullptr;
+  Val* false_val_ = nullptr;
+  Val* one_val_ = nullptr;
+  Val* zero_val_ = nullptr;
+  NamedScalar* magic_zero_val_ = nullptr;
   std::unique_ptr<std::vector<Val*>> axioms_;
   std::unordered_map<Val*, std::pair<Val*, Expr*>> metadata_;
 };
@@ -237,6 +237,9 @@ class IotaOp : public Expr {
 
   std::string toString(int indent_size = 0) const override;
   std::string toInlineString(int indent_size = 0) const override;
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
 
   DataType dtype() const {
     return *start()->getDataType();
@@ -906,6 +909,67 @@ class ReductionOp : public Expr {
   }
 };
 
+//! Prefix scan operation along a single axis, e.g., cumsum. The output has
+//! the same domain as the input, and out[..., i, ...] is
+//! scan_op_type(init, in[..., 0, ...], ..., in[..., i, ...]) when inclusive,
+//! and scan_op_type(init, in[..., 0, ...], ..., in[..., i - 1, ...]) when
+//! exclusive.
+//!
+//! The scan is lowered to a scalar accumulator that is initialized to init
+//! before the loop of the scanned axis and updated in each iteration, so
+//! that axis must be a serial loop.
+class ScanOp : public Expr {
+ public:
+  using Expr::Expr;
+
+  ScanOp(
+      IrBuilderPasskey,
+      BinaryOpType scan_op_type,
+      Val* init,
+      Val* out,
+      Val* in,
+      int64_t dim,
+      bool is_exclusive = false);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "ScanOp";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
+
+  Val* out() const {
+    return output(0);
+  }
+  Val* in() const {
+    return input(0);
+  }
+  Val* init() const {
+    return attributeVal(0);
+  }
+
+  BinaryOpType getScanOpType() const {
+    return attribute<BinaryOpType>(1);
+  }
+
+  //! Position of the scanned axis in the root domain of the output
+  int64_t dim() const {
+    return attribute<int64_t>(2);
+  }
+
+  bool isExclusive() const {
+    return attribute<bool>(3);
+  }
+
+  //! Root IterDomain of the output that is scanned
+  IterDomain* getScanDomain() const;
+};
+
 //! Grouped reduction operation for horizontal fusions. It works like
 //! batched GEMMs in the sense that multiple independent reductions are
 //! performed together. The main benefit is when reducing tensors across thread
@@ -1596,6 +1660,10 @@ class ViewOp : public Expr {
     return "ViewOp";
   }
 
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
+
   std::string toString(int indent_size = 0) const override;
   std::string toInlineString(int indent_size = 0) const override;
 
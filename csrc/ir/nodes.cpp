@@ -22,6 +22,7 @@
 #include <transform_view.h>
 #include <type.h>
 
+#include <ATen/Context.h>
 #include <c10/util/irange.h>
 
 #include <complex>
@@ -294,6 +295,34 @@ std::string IotaOp::toInlineString(int indent_size) const {
   NVF_CHECK(false, "Tensor op can not be printed inline");
 }
 
+std::vector<PolymorphicValue> IotaOp::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  const auto length = inputs.at(0).as<int64_t>();
+  // iota has no tensor input, so the result is created on the device of the
+  // tensors the fusion is evaluated with. Without any, it goes to the current
+  // CUDA device when there is one.
+  std::optional<c10::Device> device;
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion()->inputs())) {
+    const auto value = ee.evaluate(tv);
+    if (!value.is<at::Tensor>() || tv->isCpuScalar()) {
+      continue;
+    }
+    device = value.as<at::Tensor>().device();
+    break;
+  }
+  if (!device.has_value()) {
+    device = at::hasCUDA() ? c10::Device(c10::DeviceType::CUDA)
+                           : c10::Device(c10::DeviceType::CPU);
+  }
+  auto options = at::TensorOptions()
+                     .dtype(data_type_to_aten(dtype()))
+                     .device(device.value());
+  PolymorphicValue indices =
+      at::arange(length, options.dtype(at::kLong)).to(options);
+  return {indices * inputs.at(2) + inputs.at(1)};
+}
+
 NVFUSER_DEFINE_CLONE_AND_CREATE(IotaOp)
 
 EyeOp::EyeOp(IrBuilderPasskey passkey, Val* out, DataType dtype)
@@ -367,6 +396,12 @@ std::vector<PolymorphicValue> UnaryOp::evaluate(
     case UnaryOpType::BitwiseNot:
       return {~in};
       break;
+    case UnaryOpType::BitCast:
+      NVF_CHECK(
+          in.is<at::Tensor>(),
+          "Bitcast of scalars is not supported in evaluator: ",
+          toString());
+      return {in.as<at::Tensor>().view(data_type_to_aten(out()->dtype()))};
     case UnaryOpType::Erf:
       return {erf(in)};
       break;
@@ -449,6 +484,50 @@ BinaryOp::BinaryOp(
   addDataAttribute(type);
 }
 
+namespace {
+
+// Evaluates binary ops of tensors that PolymorphicValue doesn't support
+// elementwise, e.g., comparisons, which are defined to return bool.
+// Returns std::nullopt for other ops.
+std::optional<at::Tensor> evaluateTensorBinaryOp(
+    BinaryOpType op_type,
+    const PolymorphicValue& lhs,
+    const PolymorphicValue& rhs) {
+  using namespace PolymorphicValue_functions;
+  const auto device =
+      (lhs.is<at::Tensor>() ? lhs : rhs).as<at::Tensor>().device();
+  const auto a =
+      toTensor(lhs, device.type(), device.index()).as<at::Tensor>();
+  const auto b =
+      toTensor(rhs, device.type(), device.index()).as<at::Tensor>();
+  switch (op_type) {
+    case BinaryOpType::Eq:
+      return at::eq(a, b);
+    case BinaryOpType::NE:
+      return at::ne(a, b);
+    case BinaryOpType::GT:
+      return at::gt(a, b);
+    case BinaryOpType::GE:
+      return at::ge(a, b);
+    case BinaryOpType::LT:
+      return at::lt(a, b);
+    case BinaryOpType::LE:
+      return at::le(a, b);
+    case BinaryOpType::Max:
+      return at::maximum(a, b);
+    case BinaryOpType::Min:
+      return at::minimum(a, b);
+    case BinaryOpType::Lshift:
+      return at::bitwise_left_shift(a, b);
+    case BinaryOpType::Rshift:
+      return at::bitwise_right_shift(a, b);
+    default:
+      return std::nullopt;
+  }
+}
+
+} // namespace
+
 std::vector<PolymorphicValue> BinaryOp::evaluate(
     const ExpressionEvaluator& ee,
     const std::vector<PolymorphicValue>& inputs) const {
@@ -456,6 +535,12 @@ std::vector<PolymorphicValue> BinaryOp::evaluate(
   const auto& lhs = inputs.at(0);
   const auto& rhs = inputs.at(1);
 
+  if (lhs.is<at::Tensor>() || rhs.is<at::Tensor>()) {
+    if (auto result = evaluateTensorBinaryOp(getBinaryOpType(), lhs, rhs)) {
+      return {result->to(data_type_to_aten(out()->dtype()))};
+    }
+  }
+
   switch (getBinaryOpType()) {
     case BinaryOpType::Add:
       return {lhs + rhs};
@@ -623,6 +708,16 @@ std::vector<PolymorphicValue> TernaryOp::evaluate(
       return {(a <= b) ? c : a};
       break;
     case TernaryOpType::Where:
+      if (a.is<at::Tensor>() || b.is<at::Tensor>() || c.is<at::Tensor>()) {
+        const auto& ref = a.is<at::Tensor>() ? a : (b.is<at::Tensor>() ? b : c);
+        const auto device = ref.as<at::Tensor>().device();
+        auto to_tensor = [&](const PolymorphicValue& x) {
+          return toTensor(x, device.type(), device.index()).as<at::Tensor>();
+        };
+        auto result =
+            at::where(to_tensor(a).to(at::kBool), to_tensor(b), to_tensor(c));
+        return {result.to(data_type_to_aten(out()->dtype()))};
+      }
       return {a.as<bool>() ? b : c};
       break;
     default:
@@ -1334,6 +1429,30 @@ std::string ReductionOp::toInlineString(int indent_size) const {
   NVF_CHECK(false, "Tensor op can not be printed inline");
 }
 
+namespace {
+
+// Reduction of packed partial results of online softmax. See onlineSoftmax
+// in runtime/helpers.cu for the packing.
+at::Tensor onlineSoftmaxReduce(
+    const at::Tensor& packed,
+    const std::vector<int64_t>& reduction_axes) {
+  constexpr int64_t lower_mask = 0xFFFFFFFFL;
+  auto max = at::bitwise_right_shift(packed, 32).to(at::kInt).view(at::kFloat);
+  auto sum = at::bitwise_and(packed, lower_mask).to(at::kInt).view(at::kFloat);
+  auto out_max = at::amax(max, reduction_axes, /*keepdim=*/true);
+  // All partial results are empty when the max is -inf
+  auto rescaled = at::where(
+      out_max == -std::numeric_limits<float>::infinity(),
+      sum,
+      sum * at::exp(max - out_max));
+  auto out_sum = at::sum(rescaled, reduction_axes);
+  out_max = at::amax(max, reduction_axes);
+  return out_max.view(at::kInt).to(at::kLong) * (lower_mask + 1) +
+      at::bitwise_and(out_sum.view(at::kInt).to(at::kLong), lower_mask);
+}
+
+} // namespace
+
 std::vector<PolymorphicValue> ReductionOp::evaluate(
     const ExpressionEvaluator& ee,
     const std::vector<PolymorphicValue>& inputs) const {
@@ -1358,6 +1477,12 @@ std::vector<PolymorphicValue> ReductionOp::evaluate(
     case BinaryOpType::Max:
       return {at::amax(input, reduction_axes)};
       break;
+    case BinaryOpType::Min:
+      return {at::amin(input, reduction_axes)};
+      break;
+    case BinaryOpType::OnlineSoftmax:
+      return {onlineSoftmaxReduce(input, reduction_axes)};
+      break;
     default:
       NVF_CHECK(
           false,
@@ -1370,6 +1495,125 @@ std::vector<PolymorphicValue> ReductionOp::evaluate(
 
 NVFUSER_DEFINE_CLONE_AND_CREATE(ReductionOp)
 
+ScanOp::ScanOp(
+    IrBuilderPasskey passkey,
+    BinaryOpType scan_op_type,
+    Val* init,
+    Val* out,
+    Val* in,
+    int64_t dim,
+    bool is_exclusive)
+    : Expr(passkey) {
+  NVF_ERROR(
+      (in->getValType() == ValType::TensorView &&
+       out->getValType() == ValType::TensorView) ||
+          (in->getValType() == ValType::TensorIndex &&
+           out->getValType() == ValType::TensorIndex),
+      "Scan operation was created that does not have tensor inputs and outputs.");
+
+  if (out->isA<TensorView>()) {
+    const auto out_ndims =
+        (int64_t)out->as<TensorView>()->getRootDomain().size();
+    NVF_ERROR(
+        TensorDomain::noReductions(
+            in->as<TensorView>()->getMaybeRFactorDomain())
+                .size() == (size_t)out_ndims,
+        "Scan operation created with mismatched domains.");
+    NVF_ERROR(
+        dim >= 0 && dim < out_ndims,
+        "Invalid scan dimension: ",
+        dim,
+        " for a tensor of ",
+        out_ndims,
+        " dimensions.");
+  }
+  NVF_ERROR(
+      init->isConstScalar(),
+      "Tried to create a scan operation with an initial value that isn't a constant.");
+
+  addOutput(out);
+  addInput(in);
+  addAttribute(init);
+  addDataAttribute(scan_op_type);
+  addDataAttribute(dim);
+  addDataAttribute(is_exclusive);
+}
+
+std::string ScanOp::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << out() << "\n";
+  indent(ss, indent_size) << "   = scan( " << in()->toString()
+                          << ", op = " << getScanOpType()
+                          << ", dim = " << dim()
+                          << ", initial value = " << init()->toString()
+                          << ", exclusive = "
+                          << (isExclusive() ? "true" : "false") << " )\n";
+  return ss.str();
+}
+
+std::string ScanOp::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Tensor op can not be printed inline");
+}
+
+std::vector<PolymorphicValue> ScanOp::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  const auto input = inputs.at(0).as<at::Tensor>().to(
+      data_type_to_aten(out()->getDataType().value()));
+  const auto init_value = ee.evaluate(init());
+  NVF_ERROR(
+      init_value.hasValue(), "Failed to evaluate ", init()->toString());
+  // Initial value as a 0-dim tensor of the output type. It is built with the
+  // actual type of the scalar, e.g., complex, before being converted.
+  const auto init_tensor =
+      PolymorphicValue_functions::toTensor(init_value, at::kCPU)
+          .as<at::Tensor>()
+          .to(input.options());
+
+  at::Tensor output;
+  switch (getScanOpType()) {
+    case BinaryOpType::Add:
+      output = at::cumsum(input, dim()) + init_tensor;
+      break;
+    case BinaryOpType::Mul:
+      output = at::cumprod(input, dim()) * init_tensor;
+      break;
+    case BinaryOpType::Max:
+      output = at::maximum(std::get<0>(at::cummax(input, dim())), init_tensor);
+      break;
+    case BinaryOpType::Min:
+      output = at::minimum(std::get<0>(at::cummin(input, dim())), init_tensor);
+      break;
+    default:
+      NVF_CHECK(
+          false,
+          "Unexpected operator type: ",
+          getScanOpType(),
+          " in ",
+          toString());
+  }
+
+  const auto scan_extent = output.size(dim());
+  if (isExclusive() && scan_extent > 0) {
+    // Shift the inclusive scan by one and start from the initial value
+    auto first = output.narrow(dim(), 0, 1);
+    output = at::cat(
+        {init_tensor.expand_as(first),
+         output.narrow(dim(), 0, scan_extent - 1)},
+        dim());
+  }
+  return {output};
+}
+
+IterDomain* ScanOp::getScanDomain() const {
+  auto out_tv = out()->isA<kir::TensorIndex>()
+      ? out()->as<kir::TensorIndex>()->view()
+      : out()->as<TensorView>();
+  return out_tv->getRootDomain().at(dim());
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(ScanOp)
+
 GroupedReductionOp::GroupedReductionOp(
     IrBuilderPasskey passkey,
     std::vector<BinaryOpType> reduction_op_types,
@@ -2320,6 +2564,30 @@ std::string ViewOp::toInlineString(int indent_size) const {
   NVF_CHECK(false, "Tensor op can not be printed inline");
 }
 
+std::vector<PolymorphicValue> ViewOp::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  NVF_ERROR(
+      inputs.size() == 1,
+      "ViewOp expects exactly 1 input, but received ",
+      inputs.size());
+  const auto& in = inputs.at(0).as<at::Tensor>();
+  std::vector<int64_t> out_shape;
+  for (auto id : TensorDomain::noReductions(
+           out()->as<TensorView>()->getMaybeRFactorDomain())) {
+    auto extent = ee.evaluate(id->getMaybeExpandedExtent());
+    NVF_ERROR(
+        extent.hasValue(),
+        "Could not evaluate the extent of ",
+        id->toString(),
+        " in ",
+        toString());
+    out_shape.push_back(extent.as<int64_t>());
+  }
+  // Returns an alias of the input whenever its strides allow it
+  return {in.reshape(out_shape)};
+}
+
 NVFUSER_DEFINE_CLONE_AND_CREATE(ViewOp)
 
 LoadStoreOp::LoadStoreOp(
@@ -2356,7 +2624,24 @@ LoadStoreOp::LoadStoreOp(
 std::vector<PolymorphicValue> LoadStoreOp::evaluate(
     const ExpressionEvaluator& ee,
     const std::vector<PolymorphicValue>& inputs) const {
-  return inputs;
+  // A set with an rfactor domain is a permute, see ops/alias.cpp
+  auto out_tv = dynamic_cast<TensorView*>(out());
+  if (out_tv == nullptr || !out_tv->hasRFactor()) {
+    return inputs;
+  }
+  const auto& in = inputs.at(0).as<at::Tensor>();
+  const auto& root = out_tv->getRootDomain();
+  std::vector<int64_t> new2old;
+  new2old.reserve(root.size());
+  for (auto id : out_tv->getRFactorDomain()) {
+    auto it = std::find(root.begin(), root.end(), id);
+    NVF_ERROR(
+        it != root.end(),
+        "Only permutations are supported in the rfactor domain of ",
+        out_tv->toString());
+    new2old.push_back(std::distance(root.begin(), it));
+  }
+  return {in.permute(new2old)};
 }
 
 std::string LoadStoreOp::toString(int indent_size) const {
@@ -12,6 +12,9 @@
 #include <ir/iostream.h>
 #include <ir/utils.h>
 #include <type.h>
+#include <utils.h>
+
+#include <algorithm>
 
 namespace nvfuser {
 
@@ -627,6 +630,55 @@ struct Dependencies : public IterVisitor {
     Dependencies deps(dependencies, of);
     return deps.exprs_;
   }
+
+  //! Returns the vals and exprs between dependencies and of, traversing only
+  //! if they are not in the cache yet
+  static const std::pair<std::vector<Val*>, std::vector<Expr*>>& getAllCached(
+      DependencyCache& cache,
+      const std::unordered_set<Val*>& dependencies,
+      const std::vector<Val*>& of) {
+    std::vector<Val*> key(dependencies.begin(), dependencies.end());
+    std::sort(key.begin(), key.end());
+    key.push_back(nullptr);
+    key.insert(key.end(), of.begin(), of.end());
+
+    if (auto it = cache.between.find(key); it != cache.between.end()) {
+      return it->second;
+    }
+    if (cache.between.size() >= DependencyCache::kMaxEntries) {
+      cache.between.clear();
+    }
+    Dependencies deps(dependencies, of);
+    return cache.between[std::move(key)] =
+               std::make_pair(std::move(deps.vals_), std::move(deps.exprs_));
+  }
+};
+
+// Collects all the vals a val depends on, including itself
+class AllDependencies : public IterVisitor {
+  std::unordered_set<Val*> vals_;
+
+  void dispatch(Val* val) override {
+    vals_.insert(val);
+  }
+
+  explicit AllDependencies(Val* of) {
+    traverseTo(of->fusion(), {of}, false);
+  }
+
+ public:
+  static const std::unordered_set<Val*>& getCached(
+      DependencyCache& cache,
+      Val* of) {
+    if (auto it = cache.dependencies.find(of); it != cache.dependencies.end()) {
+      return it->second;
+    }
+    if (cache.dependencies.size() >= DependencyCache::kMaxEntries) {
+      cache.dependencies.clear();
+    }
+    AllDependencies dependencies(of);
+    return cache.dependencies[of] = std::move(dependencies.vals_);
+  }
 };
 
 // Looks for and returns all output values with dependencies on `of`.
@@ -819,7 +871,19 @@ class DependencyChains : public IterVisitor {
 
 } // namespace
 
+size_t DependencyCache::KeyHash::operator()(
+    const std::vector<Val*>& key) const {
+  size_t hash = 0;
+  for (auto val : key) {
+    hashCombine(hash, std::hash<Val*>()(val));
+  }
+  return hash;
+}
+
 bool DependencyCheck::isDependencyOf(Val* dependency, Val* of) {
+  if (auto cache = of->fusion()->dependencyCache(); cache != nullptr) {
+    return AllDependencies::getCached(*cache, of).count(dependency) > 0;
+  }
   return !DependencyChains::getDependencyChain(dependency, of).empty();
 }
 
@@ -842,12 +906,24 @@ std::deque<std::deque<Val*>> DependencyCheck::getAllUseChains(Val* producer) {
 std::vector<Val*> DependencyCheck::getAllValsBetween(
     const std::unordered_set<Val*>& dependencies,
     const std::vector<Val*>& of) {
+  if (of.empty()) {
+    return {};
+  }
+  if (auto cache = of.front()->fusion()->dependencyCache(); cache != nullptr) {
+    return Dependencies::getAllCached(*cache, dependencies, of).first;
+  }
   return Dependencies::getAllVals(dependencies, of);
 }
 
 std::vector<Expr*> DependencyCheck::getAllExprsBetween(
     const std::unordered_set<Val*>& dependencies,
     const std::vector<Val*>& of) {
+  if (of.empty()) {
+    return {};
+  }
+  if (auto cache = of.front()->fusion()->dependencyCache(); cache != nullptr) {
+    return Dependencies::getAllCached(*cache, dependencies, of).second;
+  }
   return Dependencies::getAllExprs(dependencies, of);
 }
 
@@ -878,6 +954,10 @@ std::vector<Expr*> StmtSort::getExprs(
     bool traverse_members,
     bool traverse_attributes,
     bool traverse_siblings) {
+  // The plain topological order is cached by the fusion
+  if (!traverse_members && !traverse_attributes && !traverse_siblings) {
+    return fusion->exprs();
+  }
   auto terminating_outputs = fusion->getTerminatingOutputs();
   return StmtSort::getExprsTo(
       fusion,
@@ -15,7 +15,10 @@
 #include <type.h>
 
 #include <deque>
+#include <optional>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace nvfuser {
@@ -246,9 +249,38 @@ class BackwardVisitor : public OptOutDispatch {
   bool must_cover_all_expr_outputs_ = true;
 };
 
+//! Results of the traversals of DependencyCheck and of
+//! Fusion::getTerminatingOutputs, kept by a fusion until its graph is
+//! modified, see Fusion::version() and Fusion::dependencyCache()
+struct DependencyCache {
+  struct KeyHash {
+    size_t operator()(const std::vector<Val*>& key) const;
+  };
+
+  //! Number of traversals kept per kind before the oldest ones are dropped
+  static constexpr size_t kMaxEntries = 1024;
+
+  //! Version of the fusion the results were computed at
+  int64_t version = -1;
+
+  //! Results of getAllValsBetween and getAllExprsBetween, keyed by the
+  //! sorted dependencies, a nullptr and the vals of "of"
+  std::unordered_map<
+      std::vector<Val*>,
+      std::pair<std::vector<Val*>, std::vector<Expr*>>,
+      KeyHash>
+      between;
+
+  //! All the vals each val depends on, including itself, see isDependencyOf
+  std::unordered_map<Val*, std::unordered_set<Val*>> dependencies;
+
+  std::optional<std::vector<Val*>> terminating_outputs;
+};
+
 class DependencyCheck {
  public:
-  // Returns if "dependency" is a dependency of "of".
+  // Returns if "dependency" is a dependency of "of". The dependencies of "of"
+  // are cached by its fusion.
   static bool isDependencyOf(Val* dependency, Val* of);
 
   // Finds a Val* path from "of" to "dependency". Returns that path.
@@ -268,7 +300,8 @@ class DependencyCheck {
   static std::deque<std::deque<Val*>> getAllUseChains(Val* dependency);
 
   // Grab all values that exist between and including provided
-  // vals. Returned values are topologicaly ordered, and unique.
+  // vals. Returned values are topologicaly ordered, and unique. Cached by
+  // the fusion along with getAllExprsBetween.
   static std::vector<Val*> getAllValsBetween(
       const std::unordered_set<Val*>& dependencies,
       const std::vector<Val*>& of);
@@ -109,6 +109,17 @@ class KernelIrScanner : private IrVisitor {
     }
   }
 
+  void handle(BlockScan* block_scan) final {
+    summary_.has_block_scans = true;
+    // The scan of an iteration is done in shared memory
+    const auto data_type = block_scan->out()->dtype();
+    const size_t type_size = dataTypeSize(data_type, index_type_);
+    if (type_size > max_smem_type_size_) {
+      max_smem_type_size_ = type_size;
+      summary_.largest_smem_data_type = data_type;
+    }
+  }
+
   void handle(WelfordOp* welford_op) final {
     summary_.has_welford = true;
     NVF_ERROR(welford_op->outAvg()->isA<TensorIndex>());
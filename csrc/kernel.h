@@ -48,6 +48,9 @@ struct KernelSummary {
   //! Do we have any block reductions?
   bool has_block_reductions = false;
 
+  //! Do we have any block scans?
+  bool has_block_scans = false;
+
   //! Number of static grid reductions
   bool has_grid_reductions = false;
 
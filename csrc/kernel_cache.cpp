@@ -14,6 +14,8 @@
 #include <executor_utils.h>
 #include <instrumentation.h>
 #include <ir/utils.h>
+#include <memory_planner.h>
+#include <optimization/online_softmax.h>
 #include <optimization/pre_segmenter.h>
 #include <options.h>
 #include <parser.h>
@@ -24,27 +26,31 @@
 #include <utils.h>
 
 #include <c10/cuda/CUDAGuard.h>
+#include <c10/cuda/CUDAStream.h>
 #include <c10/util/irange.h>
 #include <torch/csrc/jit/jit_log.h>
 
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <unordered_set>
+
 namespace nvfuser {
 
 namespace {
 
 // Replace CUDA tensor with Meta tensor because storing tensors can cause
 // out-of-memory issues. Other arguments are returned as-is.
-std::shared_ptr<PolymorphicValue> convertMetadataArg(
-    std::shared_ptr<PolymorphicValue> arg) {
-  if (arg->is<at::Tensor>()) {
-    if (const auto& tensor = arg->as<at::Tensor>(); tensor.is_cuda()) {
-      auto meta_tensor = at::Tensor(at::detail::empty_strided_meta(
+PolymorphicValue convertMetadataArg(const PolymorphicValue& arg) {
+  if (arg.is<at::Tensor>()) {
+    if (const auto& tensor = arg.as<at::Tensor>(); tensor.is_cuda()) {
+      return at::Tensor(at::detail::empty_strided_meta(
           tensor.sizes(),
           tensor.strides(),
           tensor.scalar_type(),
           c10::nullopt,
           c10::Device(c10::DeviceType::Meta, 0),
           c10::nullopt));
-      return std::make_shared<PolymorphicValue>(std::move(meta_tensor));
     }
   }
   return arg;
@@ -61,30 +67,85 @@ void encodeBuffer(T value, std::string& buffer) {
   }
 }
 
+// Softmax with rows too large to be persistent would be segmented into
+// separate kernels for its max and sum reductions, each reading the whole
+// input. Rewrite it into the online formulation when the fusion can't be
+// scheduled as a single kernel.
+void maybeUseOnlineSoftmax(
+    Fusion* fusion,
+    const KernelArgumentHolder& args,
+    std::optional<PrimDataType> forced_index_type) {
+  using optimization::OnlineSoftmaxPass;
+  if (!OnlineSoftmaxPass::getEnabled() ||
+      !OnlineSoftmaxPass::hasCandidates(fusion)) {
+    return;
+  }
+  SchedulerRuntimeInfo runtime_info(
+      fusion, args, nullptr, {}, forced_index_type);
+  if (SchedulerEntry::proposeHeuristics(fusion, runtime_info).has_value()) {
+    return;
+  }
+  optimization::OptimizationPass<OnlineSoftmaxPass>::runPass(fusion);
+}
+
 // This ArgumentManager do two things
 // (1) add outputs from a segment to the global fusion args to pass it to next
 // segment (2) delete args no longer being used to save memory. For task (2), it
 // checks the input and output arguments of each segment and make a map from val
 // to the segment_id where the val is lastly used. The arguments representing
 // these vals are then deleted after the segment runs.
+//
+// Vals are looked up by the dense indices of RuntimeWorkSpace, which are built
+// once per runtime by indexArguments, so a run doesn't hash any Val.
 class ArgumentManager {
  public:
   ArgumentManager(
       KernelArgumentHolder& args,
       const RuntimeWorkSpace& runtime_workspace,
       const std::vector<Val*>& fusion_inputs)
-      : fusion_args_(args) {
+      : fusion_args_(args),
+        runtime_workspace_(runtime_workspace),
+        args_(runtime_workspace.num_arg_indices, nullptr) {
     // map from val to args
-    mapFusionInputsToArgs(
-        fusion_inputs, runtime_workspace.group_extent_binding_order);
-    setLastUsedSegmentID(runtime_workspace.group_run_order);
-  }
-  const std::unordered_map<Val*, const PolymorphicValue*>& getTensorMap() {
-    return tensor_map_;
+    mapFusionInputsToArgs(fusion_inputs);
   }
+
+  // Assign the dense indices of runtime_workspace, after its group run order
+  // is set
+  static void indexArguments(
+      RuntimeWorkSpace& runtime_workspace,
+      const std::vector<Val*>& fusion_inputs,
+      const std::vector<Val*>& fusion_outputs);
+
   const PolymorphicValue* checkTensorMap(Val* v) {
-    return tensor_map_.at(v);
+    auto arg = args_[runtime_workspace_.arg_indices.at(v)];
+    NVF_ERROR(arg != nullptr, "No argument for ", v->toString());
+    return arg;
   }
+
+  // Returns the argument of each fusion output, or nullptr for outputs not
+  // produced by any segment
+  std::vector<const PolymorphicValue*> getFusionOutputs() const {
+    std::vector<const PolymorphicValue*> outputs;
+    outputs.reserve(runtime_workspace_.fusion_output_arg_indices.size());
+    for (auto index : runtime_workspace_.fusion_output_arg_indices) {
+      outputs.push_back(index < 0 ? nullptr : args_[index]);
+    }
+    return outputs;
+  }
+
+  // Push the arguments of the inputs of a group to group_args
+  void pushGroupInputs(int64_t group_id, KernelArgumentHolder& group_args) {
+    const auto& indices =
+        runtime_workspace_.group_input_arg_indices.at(group_id);
+    group_args.reserve(indices.size());
+    for (auto index : indices) {
+      auto arg = args_[index];
+      NVF_ERROR(arg != nullptr, "Missing input argument of group ", group_id);
+      group_args.push(*arg);
+    }
+  }
+
   // T is assumed to be either std::vector<at::Tensro> or KernelArgumentHolder
   // (from dry run)
   // TODO: make the output type uniform no matter it's a real or dry run
@@ -93,25 +154,23 @@ class ArgumentManager {
       const std::vector<Val*>& group_outputs,
       const T& group_runtime_outputs,
       const int64_t group_id) {
-    addOutputsToArgsAndTensorMap(group_outputs, group_runtime_outputs);
+    addOutputsToArgsAndTensorMap(
+        group_outputs, group_runtime_outputs, group_id);
     deleteUnusedArgs(group_id);
   }
 
  private:
   KernelArgumentHolder& fusion_args_;
-  // map from val to args
-  std::unordered_map<Val*, const PolymorphicValue*> tensor_map_;
-  // map segment_id to vector of fusion vals lastly used at this segment
-  std::unordered_map<int64_t, std::vector<Val*>> vals_last_used_at_segment_;
+  const RuntimeWorkSpace& runtime_workspace_;
+  // map from the dense index of a val to args
+  c10::SmallVector<const PolymorphicValue*, 64> args_;
 
-  void mapFusionInputsToArgs(
-      const std::vector<Val*>& fusion_inputs,
-      const std::vector<Val*>& group_extent_binding_order) {
+  void mapFusionInputsToArgs(const std::vector<Val*>& fusion_inputs) {
     int extent_index = 0;
     auto original_args_size = fusion_args_.size();
     // Bind args in the tensor_map
     for (const auto i : c10::irange(original_args_size)) {
-      tensor_map_.emplace(fusion_inputs[i], fusion_args_[i]);
+      bindArg(i, fusion_args_[i]);
       // Bind tensorview inputs values in case some segmented group
       //  needs it down the road.
       // TODO: we probably have done this already up to this point
@@ -124,69 +183,38 @@ class ArgumentManager {
         for (const auto dim : c10::irange(rank)) {
           fusion_args_.push(
               PolymorphicValue(fusion_args_[i]->as<at::Tensor>().size(dim)));
-          tensor_map_.emplace(
-              group_extent_binding_order[extent_index++], fusion_args_.back());
+          bindArg(
+              runtime_workspace_.extent_arg_indices.at(extent_index++),
+              fusion_args_.back());
         }
       }
     }
   }
 
-  void setLastUsedSegmentID(
-      const std::vector<SegmentedGroup*>& group_run_order) {
-    // never delete global fusion inputs and outputs
-    auto isFusionInputOrOutput = [](Val* val) {
-      return val->isFusionInput() || val->isFusionOutput();
-    };
-    // map val to segment_id where arg is lastly used
-    std::unordered_map<Val*, int64_t> last_used_segment_map;
-    const int64_t num_groups = (int64_t)group_run_order.size();
-    // only need to set lifetime of vals if there are more than 3 groups
-    if (num_groups >= 3) {
-      // start from the 2nd group, since the input of the first group is always
-      // the global input and its outputs are always used by at least one of the
-      // following groups
-      for (auto group_id : c10::irange(1l, num_groups)) {
-        auto group_to_run = group_run_order.at(group_id);
-        // set/update life of vals in inputs of this group
-        for (auto val : group_to_run->inputs()) {
-          // skip fusion inputs and outputs, they may be used by other fusions
-          // or code
-          if (!isFusionInputOrOutput(val)) {
-            last_used_segment_map[val] = group_id;
-          }
-        }
-        // set/update life of vals in outputs of this group
-        // skip the last group since its outputs are always the global outputs
-        if (group_id < num_groups - 1) {
-          for (auto val : group_to_run->outputs()) {
-            // skip fusion inputs and outputs, they may be used by other fusions
-            // or code
-            if (!isFusionInputOrOutput(val)) {
-              last_used_segment_map[val] = group_id;
-            }
-          }
-        }
-      }
-      // convert to vals_last_used_at_segment_, so we don't need to iterate over
-      // all vals when erasing
-      for (auto item : last_used_segment_map) {
-        vals_last_used_at_segment_[item.second].push_back(item.first);
-      }
+  // The first argument bound to a val is kept
+  void bindArg(int64_t index, const PolymorphicValue* arg) {
+    if (args_[index] == nullptr) {
+      args_[index] = arg;
     }
   }
+
   void deleteUnusedArgs(int64_t group_id) {
     // erase args corresponding to vals lastly used in this segment
-    if (group_id >= 1 && vals_last_used_at_segment_.count(group_id)) {
-      for (auto val : vals_last_used_at_segment_[group_id]) {
-        fusion_args_.erase(tensor_map_.at(val));
-        tensor_map_.erase(val);
+    const auto& args_last_used_at_group =
+        runtime_workspace_.args_last_used_at_group;
+    if (group_id >= 1 && group_id < (int64_t)args_last_used_at_group.size()) {
+      for (auto index : args_last_used_at_group.at(group_id)) {
+        fusion_args_.erase(args_[index]);
+        args_[index] = nullptr;
       }
     }
   }
+
   template <typename T>
   void addOutputsToArgsAndTensorMap(
       const std::vector<Val*>& group_outputs,
-      const T& group_runtime_outputs) {
+      const T& group_runtime_outputs,
+      const int64_t group_id) {
     // Insert graph segment output to tensor map
     NVF_ERROR(
         group_outputs.size() == group_runtime_outputs.size(),
@@ -195,20 +223,172 @@ class ArgumentManager {
     // Trivial forwarding outputs an empty tensor to save bandwidth. We skip
     // updating the tensor_map because we want all future use of inputs on
     // the original tensor input. See note [Trivial Forwarding]
+    const auto& indices =
+        runtime_workspace_.group_output_arg_indices.at(group_id);
     for (const size_t group_out_i : c10::irange(group_outputs.size())) {
-      if (!group_outputs[group_out_i]->isFusionInput()) {
+      if (indices.at(group_out_i) >= 0) {
         if constexpr (std::is_pointer_v<
                           decltype(group_runtime_outputs[group_out_i])>) {
           fusion_args_.push(*group_runtime_outputs[group_out_i]);
         } else {
           fusion_args_.push(group_runtime_outputs[group_out_i]);
         }
-        tensor_map_.emplace(group_outputs[group_out_i], fusion_args_.back());
+        bindArg(indices.at(group_out_i), fusion_args_.back());
       }
     }
   }
 };
 
+void ArgumentManager::indexArguments(
+    RuntimeWorkSpace& runtime_workspace,
+    const std::vector<Val*>& fusion_inputs,
+    const std::vector<Val*>& fusion_outputs) {
+  auto& arg_indices = runtime_workspace.arg_indices;
+  auto index_of = [&arg_indices](Val* val) {
+    return arg_indices.emplace(val, (int64_t)arg_indices.size()).first->second;
+  };
+
+  // The fusion inputs come first, so their indices are their positions in
+  // the arguments, followed by the extents of their tensors
+  for (auto input : fusion_inputs) {
+    index_of(input);
+  }
+  int64_t extent_index = 0;
+  const auto& extents = runtime_workspace.group_extent_binding_order;
+  for (auto input : fusion_inputs) {
+    if (auto input_tv = dynamic_cast<TensorView*>(input)) {
+      auto rank = TensorDomain::noReductions(input_tv->getRootDomain()).size();
+      for (auto i : c10::irange(rank)) {
+        (void)i;
+        runtime_workspace.extent_arg_indices.push_back(
+            index_of(extents.at(extent_index++)));
+      }
+    }
+  }
+
+  const auto& group_run_order = runtime_workspace.group_run_order;
+  for (auto group : group_run_order) {
+    auto& output_indices =
+        runtime_workspace.group_output_arg_indices.emplace_back();
+    for (auto output : group->outputs()) {
+      output_indices.push_back(output->isFusionInput() ? -1 : index_of(output));
+    }
+  }
+  for (auto group : group_run_order) {
+    auto& input_indices =
+        runtime_workspace.group_input_arg_indices.emplace_back();
+    for (auto input : group->inputs()) {
+      input_indices.push_back(arg_indices.at(input));
+    }
+  }
+  for (auto output : fusion_outputs) {
+    auto it = arg_indices.find(output);
+    runtime_workspace.fusion_output_arg_indices.push_back(
+        it == arg_indices.end() ? -1 : it->second);
+  }
+  runtime_workspace.num_arg_indices = (int64_t)arg_indices.size();
+
+  // never delete global fusion inputs and outputs
+  auto isFusionInputOrOutput = [](Val* val) {
+    return val->isFusionInput() || val->isFusionOutput();
+  };
+  // map val to segment_id where arg is lastly used
+  std::unordered_map<Val*, int64_t> last_used_segment_map;
+  const int64_t num_groups = (int64_t)group_run_order.size();
+  // only need to set lifetime of vals if there are more than 3 groups
+  if (num_groups >= 3) {
+    // start from the 2nd group, since the input of the first group is always
+    // the global input and its outputs are always used by at least one of the
+    // following groups
+    for (auto group_id : c10::irange(1l, num_groups)) {
+      auto group_to_run = group_run_order.at(group_id);
+      // set/update life of vals in inputs of this group
+      for (auto val : group_to_run->inputs()) {
+        // skip fusion inputs and outputs, they may be used by other fusions
+        // or code
+        if (!isFusionInputOrOutput(val)) {
+          last_used_segment_map[val] = group_id;
+        }
+      }
+      // set/update life of vals in outputs of this group
+      // skip the last group since its outputs are always the global outputs
+      if (group_id < num_groups - 1) {
+        for (auto val : group_to_run->outputs()) {
+          // skip fusion inputs and outputs, they may be used by other fusions
+          // or code
+          if (!isFusionInputOrOutput(val)) {
+            last_used_segment_map[val] = group_id;
+          }
+        }
+      }
+    }
+    // convert to args_last_used_at_group, so we don't need to iterate over
+    // all vals when erasing
+    runtime_workspace.args_last_used_at_group.resize(num_groups);
+    for (auto item : last_used_segment_map) {
+      runtime_workspace.args_last_used_at_group.at(item.second).push_back(
+          arg_indices.at(item.first));
+    }
+  }
+}
+
+// Returns true if the scalars would be encoded the same by
+// InputsIdLookup::lookupId
+bool sameEncodedScalar(const c10::IValue& a, const c10::IValue& b) {
+  if (a.isInt() && b.isInt()) {
+    return a.toInt() == b.toInt();
+  }
+  if (a.isBool() && b.isBool()) {
+    return a.toBool() == b.toBool();
+  }
+  if (a.isDouble() && b.isDouble()) {
+    return a.toDouble() == b.toDouble();
+  }
+  if (a.isComplexDouble() && b.isComplexDouble()) {
+    return a.toComplexDouble() == b.toComplexDouble();
+  }
+  return false;
+}
+
+// Returns true if the two sets of inputs would get the same cache id from
+// InputsIdLookup::lookupId and the same device index, without encoding them.
+// The dtypes and devices of the tensors are compared as well, so a match
+// never depends on the fusion rejecting mismatched inputs later.
+bool sameSignature(
+    const at::ArrayRef<c10::IValue>& inputs,
+    const at::ArrayRef<c10::IValue>& other,
+    const std::unordered_set<size_t>& scalar_inputs_to_record) {
+  if (inputs.size() != other.size()) {
+    return false;
+  }
+  for (const auto i : c10::irange(inputs.size())) {
+    const auto& input = inputs[i];
+    const auto& other_input = other[i];
+    if (input.isTensor() != other_input.isTensor()) {
+      return false;
+    }
+    if (input.isTensor()) {
+      const auto& tensor = input.toTensor();
+      const auto& other_tensor = other_input.toTensor();
+      if (tensor.scalar_type() != other_tensor.scalar_type() ||
+          tensor.device() != other_tensor.device() ||
+          !tensor.sizes().equals(other_tensor.sizes()) ||
+          !tensor.strides().equals(other_tensor.strides()) ||
+          SchedulerRuntimeInfo::computeAlignmentSize(
+              (size_t)tensor.data_ptr()) !=
+              SchedulerRuntimeInfo::computeAlignmentSize(
+                  (size_t)other_tensor.data_ptr())) {
+        return false;
+      }
+    } else if (
+        scalar_inputs_to_record.count(i) &&
+        !sameEncodedScalar(input, other_input)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 } // namespace
 
 flatbuffers::Offset<serde::InputsIdLookup> InputsIdLookup::serialize(
@@ -440,6 +620,135 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
     std::optional<int8_t> selected_device) {
   FUSER_PERF_SCOPE("FusionExecutorCache::runFusionWithInputs");
 
+  KernelArgumentHolder args = permuteAndPrepareInputs(inputs, selected_device);
+  auto kernel_runtime = getKernelRuntimeFor(args, forced_index_type);
+
+  if (!kernel_runtime->isCompiled()) {
+    kernel_runtime->compileFusionParallel(args);
+  }
+
+  // Make sure the forced index type is indeed used
+  if (forced_index_type.has_value()) {
+    NVF_ERROR(
+        kernel_runtime->getIndexType() == forced_index_type.value(),
+        "Enforcing index type of ",
+        forced_index_type.value(),
+        " failed");
+  }
+
+  return runKernelRuntime(kernel_runtime, inputs, args);
+}
+
+std::vector<at::Tensor> FusionExecutorCache::runFusionWithOutputs(
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::vector<at::Tensor> outputs,
+    std::optional<int8_t> selected_device) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::runFusionWithOutputs");
+
+  KernelArgumentHolder args = permuteAndPrepareInputs(inputs, selected_device);
+  auto kernel_runtime = getKernelRuntimeFor(args);
+  if (!kernel_runtime->isCompiled()) {
+    kernel_runtime->compileFusionParallel(args);
+  }
+  return runKernelRuntime(kernel_runtime, inputs, args, std::move(outputs));
+}
+
+void FusionExecutorCache::compileFusionsBatch(
+    const std::vector<
+        std::pair<FusionExecutorCache*, std::vector<c10::IValue>>>& fusions) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::compileFusionsBatch");
+
+  // The deferred kernels of all the runtimes, per device
+  std::map<int8_t, std::vector<FusionExecutor*>> deferred;
+  // Runtimes compiled by this batch, whose kernels are not compiled until
+  // the end of it
+  std::unordered_set<FusionKernelRuntime*> compiled_runtimes;
+  for (const auto& [fec, inputs] : fusions) {
+    KernelArgumentHolder args =
+        fec->permuteAndPrepareInputs(inputs, std::nullopt);
+    auto kernel_runtime = fec->getKernelRuntimeFor(args);
+    if (kernel_runtime->isCompiled() ||
+        !compiled_runtimes.insert(kernel_runtime).second) {
+      continue;
+    }
+    kernel_runtime->compileFusionParallel(args, /*compile_deferred=*/false);
+    auto executors = kernel_runtime->takeDeferredExecutors();
+    auto& device_executors = deferred[args.getDeviceIndex()];
+    device_executors.insert(
+        device_executors.end(), executors.begin(), executors.end());
+  }
+
+  for (const auto& [device_index, executors] : deferred) {
+    FusionKernelRuntime::compileDeferredExecutors(executors, device_index);
+  }
+}
+
+std::vector<std::vector<at::Tensor>> FusionExecutorCache::
+    runFusionWithInputsBatch(
+        const std::vector<std::vector<c10::IValue>>& batch,
+        std::optional<int8_t> selected_device) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::runFusionWithInputsBatch");
+
+  // The first set of inputs of each signature in the batch. The later sets
+  // with the same signature skip the encoding of InputsIdLookup and the
+  // device checks, and reuse the device index, cache id and kernel runtime
+  // of the first set.
+  struct BatchSignature {
+    const std::vector<c10::IValue>* inputs;
+    //! Holds no arguments, only the device index and cache id of the set
+    KernelArgumentHolder layout;
+    FusionKernelRuntime* kernel_runtime;
+  };
+  std::vector<BatchSignature> signatures;
+  const auto& scalar_inputs_to_record =
+      initialInfo().scalarInputsAffectingConcretization();
+
+  std::vector<std::vector<at::Tensor>> outputs;
+  outputs.reserve(batch.size());
+  for (const auto& inputs : batch) {
+    // The permutation of the inputs only depends on their position, so the
+    // inputs are compared before they are permuted
+    auto signature_it = signatures.begin();
+    while (signature_it != signatures.end()) {
+      if (!sameSignature(
+              inputs, *signature_it->inputs, scalar_inputs_to_record)) {
+        ++signature_it;
+      } else if (!id_to_kernel_runtime_.count(
+                     signature_it->layout.getCacheId().value())) {
+        // The cache id was evicted by the lookup of a later signature
+        signature_it = signatures.erase(signature_it);
+      } else {
+        break;
+      }
+    }
+
+    if (signature_it != signatures.end()) {
+      KernelArgumentHolder args = permuteAndPrepareInputs(
+          inputs, selected_device, &signature_it->layout);
+      outputs.push_back(
+          runKernelRuntime(signature_it->kernel_runtime, inputs, args));
+      continue;
+    }
+
+    KernelArgumentHolder args =
+        permuteAndPrepareInputs(inputs, selected_device);
+    auto kernel_runtime = getKernelRuntimeFor(args);
+    if (!kernel_runtime->isCompiled()) {
+      kernel_runtime->compileFusionParallel(args);
+    }
+    KernelArgumentHolder layout;
+    layout.setDeviceIndex(args.getDeviceIndex());
+    layout.setCacheId(args.getCacheId().value());
+    signatures.push_back({&inputs, std::move(layout), kernel_runtime});
+    outputs.push_back(runKernelRuntime(kernel_runtime, inputs, args));
+  }
+  return outputs;
+}
+
+KernelArgumentHolder FusionExecutorCache::permuteAndPrepareInputs(
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::optional<int8_t> selected_device,
+    const KernelArgumentHolder* layout) {
   // Permute input tensor for kernel execution.
   // See Part_1 in Note [ Channels-Last support in nvfuser ]
   at::ArrayRef<c10::IValue> perm_inputs = inputs;
@@ -457,13 +766,20 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
     perm_inputs = inputs_vec;
   }
 
-  KernelArgumentHolder args = prepareInputs(perm_inputs, selected_device);
-  auto kernel_runtime = getKernelRuntimeFor(args, forced_index_type);
-
-  if (!kernel_runtime->isCompiled()) {
-    kernel_runtime->compileFusionParallel(args);
+  if (layout != nullptr) {
+    KernelArgumentHolder args = *layout;
+    args.reserve(perm_inputs.size());
+    args.push(perm_inputs);
+    return args;
   }
+  return prepareInputs(perm_inputs, selected_device);
+}
 
+std::vector<at::Tensor> FusionExecutorCache::runKernelRuntime(
+    FusionKernelRuntime* kernel_runtime,
+    const at::ArrayRef<c10::IValue>& inputs,
+    KernelArgumentHolder& args,
+    std::vector<at::Tensor> given_outputs) {
   if (measure_kernel_time_) {
     kernel_runtime->enableKernelTimeMeasurement();
   }
@@ -472,15 +788,6 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
 
   auto fusion = kernel_runtime->fusionSegments()->completeFusion();
 
-  // Make sure the forced index type is indeed used
-  if (forced_index_type.has_value()) {
-    NVF_ERROR(
-        kernel_runtime->getIndexType() == forced_index_type.value(),
-        "Enforcing index type of ",
-        forced_index_type.value(),
-        " failed");
-  }
-
   int seq_id = 0;
   // Record kernel input and output tensors so profiler can construct
   // the data flow graph
@@ -488,7 +795,9 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
       "run_fused_kernel",
       std::vector<c10::IValue>(inputs.begin(), inputs.end()),
       seq_id);
-  auto outputs = kernel_runtime->runWithInputs(args);
+  auto outputs = given_outputs.empty()
+      ? kernel_runtime->runWithInputs(args)
+      : kernel_runtime->runWithInputs(args, std::move(given_outputs));
   RECORD_OUTPUTS(outputs);
 
   // Kernel time measurement is off by default
@@ -516,6 +825,43 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
   return outputs;
 }
 
+std::vector<at::Tensor> FusionExecutorCache::allocOutputSpace(
+    const at::ArrayRef<c10::IValue>& inputs) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::allocOutputSpace");
+  // The output shapes of a dynamic Fusion are only known after
+  // concretization, and permutations are applied by the kernel runtime
+  if (fusion_->hasDynamicTransform() ||
+      !fusion_->getPermutationInputMap().empty() ||
+      !fusion_->getPermutationOutputMap().empty()) {
+    return runFusionWithInputs(inputs);
+  }
+
+  KernelArgumentHolder args =
+      KernelArgumentHolder::createKernelArgumentHolder(inputs);
+  FusionGuard fg(fusion_.get());
+  KernelArgumentHolder output_args =
+      FusionExecutor().inferOutputSizes(fusion_.get(), args);
+
+  const auto device = at::Device(at::kCUDA, args.getDeviceIndex());
+  const auto aliased_output_indices = fusion_->getIndicesOfAliasedOutputs();
+  std::vector<at::Tensor> outputs;
+  for (auto out_i : c10::irange(output_args.size())) {
+    // Aliased outputs are not returned, see runFusionWithInputs
+    if (aliased_output_indices.count((int)out_i)) {
+      continue;
+    }
+    const auto& output = output_args[out_i]->as<at::Tensor>();
+    if (output.is_meta()) {
+      outputs.push_back(at::empty_strided(
+          output.sizes(), output.strides(), output.options().device(device)));
+    } else {
+      // trivially forwarded input
+      outputs.push_back(output);
+    }
+  }
+  return outputs;
+}
+
 std::string FusionExecutorCache::getCode(
     FusionKernelRuntime* kernel_runtime,
     bool intrinsic_code) const {
@@ -525,6 +871,10 @@ std::string FusionExecutorCache::getCode(
 
   bool first_kernel = true;
   for (const auto& exec : kernel_runtime->executors()) {
+    // Segments evaluated on the host have no kernel
+    if (!exec.isCompiled()) {
+      continue;
+    }
     if (first_kernel) {
       first_kernel = false;
     } else {
@@ -535,11 +885,20 @@ std::string FusionExecutorCache::getCode(
 
   if (intrinsic_code) {
     const auto& execs = kernel_runtime->executors();
-    const FusionExecutor& fe = execs[0];
+    auto fe_it = std::find_if(execs.begin(), execs.end(), [](const auto& exec) {
+      return exec.isCompiled();
+    });
+    if (fe_it == execs.end()) {
+      return kernel_code;
+    }
+    const FusionExecutor& fe = *fe_it;
     auto index_type = fe.kernel()->indexType();
     // Make sure all the segment index types match. All segments currently
     // use the same index type but this code change in the future.
     for (const auto& exec : execs) {
+      if (!exec.isCompiled()) {
+        continue;
+      }
       NVF_CHECK(
           index_type == exec.kernel()->indexType(),
           "Index Type mismatch between Segment Executors: ",
@@ -580,6 +939,9 @@ std::string FusionExecutorCache::getScheduledIr(
     ss << fs << "\n";
   }
   for (auto& exec : kernel_runtime->executors()) {
+    if (!exec.isCompiled()) {
+      continue;
+    }
     auto sched_ir = exec.kernel()->as<Fusion>();
     sched_ir->print(ss, tensor_transforms);
   }
@@ -599,6 +961,22 @@ std::string FusionExecutorCache::getScheduledIrFor(
   return getScheduledIr(kernel_runtime, tensor_transforms);
 }
 
+size_t FusionExecutorCache::memoryFootprint() const {
+  size_t bytes = 0;
+  for (const auto& it : kernel_runtimes_) {
+    for (const auto& kernel_runtime : it.second) {
+      for (const auto& exec : kernel_runtime->executors()) {
+        if (!exec.isCompiled() || exec.isCompiledForCpu()) {
+          continue;
+        }
+        const auto& compiled_kernel = exec.compiledKernel();
+        bytes += compiled_kernel.ptx.size() + compiled_kernel.cubin.size();
+      }
+    }
+  }
+  return bytes;
+}
+
 void FusionExecutorCache::evictCache(size_t cache_id) {
   auto it = id_to_kernel_runtime_.find(cache_id);
   NVF_ERROR(it != id_to_kernel_runtime_.end());
@@ -887,14 +1265,14 @@ FusionKernelRuntime::FusionKernelRuntime(
       "Fusion must be concretized before constructing FusionKernelRuntime");
 
   // Store metadata copy of arguments for serialization
-  std::transform(
-      args.cbegin(),
-      args.cend(),
-      args_metadata_.getBackInserter(),
-      convertMetadataArg);
+  args_metadata_.reserve(args.size());
+  for (auto i : c10::irange(args.size())) {
+    args_metadata_.push(convertMetadataArg(*args[i]));
+  }
 
   optimization::OptimizationPass<optimization::PreSegmenter>::runPass(
       fusion.get());
+  maybeUseOnlineSoftmax(fusion.get(), args, forced_index_type);
 
   if (isDebugDumpEnabled(DebugDumpOption::FusionIrPreseg)) {
     debug() << "Fusion IR after pre-segmenter optimization passes:"
@@ -917,6 +1295,7 @@ FusionKernelRuntime::FusionKernelRuntime(
   heuristics_ = segmented_fusion_->makeInitialHeuristics(args, runtime_info);
 
   executors_ = std::vector<FusionExecutor>(segmented_fusion_->groups().size());
+  expr_eval_fusions_.resize(segmented_fusion_->groups().size());
   if (isDebugDumpEnabled(DebugDumpOption::FusionSegments)) {
     segmented_fusion_->print();
   }
@@ -929,6 +1308,10 @@ FusionKernelRuntime::FusionKernelRuntime(
   // Pre-compute the executor order so that the run time path
   //  would go directly to kernel launch.
   prepareRuntimeOrder();
+  ArgumentManager::indexArguments(
+      runtime_workspace_,
+      segmented_fusion_->inputs(),
+      segmented_fusion_->outputs());
 }
 
 flatbuffers::Offset<serde::FusionKernelRuntime> FusionKernelRuntime::serialize(
@@ -938,8 +1321,13 @@ flatbuffers::Offset<serde::FusionKernelRuntime> FusionKernelRuntime::serialize(
   // 1. Serialize FusionExecutor objects
   std::vector<flatbuffers::Offset<serde::FusionExecutor>> executors_fb;
   executors_fb.reserve(executors_.size());
-  for (auto& executor : executors_) {
-    executors_fb.push_back(executor.serialize(builder));
+  for (auto group_id : c10::irange(executors_.size())) {
+    // Segments evaluated on the host have no kernel to serialize
+    if (expr_eval_fusions_.at(group_id) != nullptr) {
+      executors_fb.push_back(serde::CreateFusionExecutor(builder));
+      continue;
+    }
+    executors_fb.push_back(executors_.at(group_id).serialize(builder));
   }
 
   return serde::CreateFusionKernelRuntimeDirect(
@@ -964,6 +1352,10 @@ void FusionKernelRuntime::deserialize(
         !sg || scheduler_entry->heuristic() == sg->heuristic(),
         "Heuristics do not match.");
     std::unique_ptr<Fusion> fusion_to_run = segmented_fusion_->makeFusion(sg);
+    if (scheduler_entry->heuristic() == ScheduleHeuristic::ExprEval) {
+      expr_eval_fusions_.at(group_id) = std::move(fusion_to_run);
+      continue;
+    }
     FusionGuard fg(fusion_to_run.get());
     scheduler_entry->schedule(fusion_to_run.get());
 
@@ -976,7 +1368,8 @@ void FusionKernelRuntime::deserialize(
 
 std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
     KernelArgumentHolder& args,
-    SegmentedGroup* sg) {
+    SegmentedGroup* sg,
+    std::vector<at::Tensor> outputs) {
   FUSER_PERF_SCOPE("FusionKernelRuntime::runKernelWithInput");
   std::lock_guard<std::mutex> guard(mutex_);
   // This function will be called once on un-segmented fusion,
@@ -986,6 +1379,9 @@ std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
   // In the case of complete fusion, sg = nullptr, and the original fusion
   // is complied and run.
   NVF_ERROR(sg, "runKernelWithInput: need valid group to run");
+  if (sg->heuristic() == ScheduleHeuristic::ExprEval) {
+    return runExprEvalSegment(args, sg);
+  }
   auto [launch_params, compile_params] = getKernelConfig(args, sg);
   auto group_id = sg->groupId();
   auto scheduler_entry = schedulers().at(group_id).get();
@@ -1001,7 +1397,8 @@ std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
     executor.setMeasureKernelTimeFlag(true);
   }
 
-  auto outputs = executor.runFusion(args, launch_params, compile_params);
+  outputs = executor.runFusion(
+      args, launch_params, compile_params, std::move(outputs));
 
   // Accumulate the kernel time of each segment
   kernel_time_ms_ += executor.kernelTimeMs();
@@ -1035,6 +1432,37 @@ std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
   return outputs;
 }
 
+std::vector<at::Tensor> FusionKernelRuntime::runExprEvalSegment(
+    KernelArgumentHolder& args,
+    SegmentedGroup* sg) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::runExprEvalSegment");
+  auto fusion_to_run = expr_eval_fusions_.at(sg->groupId()).get();
+  NVF_ERROR(
+      fusion_to_run != nullptr,
+      "Segment ",
+      sg->groupId(),
+      " was not prepared for evaluation");
+
+  auto outputs = evaluateFusionOutputs(fusion_to_run, args);
+
+  // The outputs are usually aliases of the inputs with arbitrary strides.
+  // Only the outputs of the complete fusion are returned as they are. The
+  // segments consuming the others are compiled for contiguous inputs.
+  for (auto i : c10::irange(outputs.size())) {
+    auto out = sg->outputs().at(i);
+    if (!out->isFusionOutput() || !out->uses().empty()) {
+      outputs[i] = outputs[i].contiguous();
+    }
+  }
+
+  if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+    debug() << "\nEvaluate segment with ATen:\n";
+    fusion_to_run->printMath();
+  }
+
+  return outputs;
+}
+
 void FusionKernelRuntime::prepareRuntimeOrder() {
   // Setup group run order:
   std::unordered_set<Val*> available_input;
@@ -1092,8 +1520,80 @@ void FusionKernelRuntime::prepareRuntimeOrder() {
   }
 }
 
+namespace {
+
+// Kernels compiled in one NVRTC program share the parsing of the runtime
+// preamble, but are compiled one after the other. Make as many batches as
+// there are threads to compile them, each of at most the number of kernels
+// given by NVFUSER_ENABLE=batch_compile(<size>).
+int64_t getBatchCompileSize(int64_t num_kernels, int64_t num_threads) {
+  int64_t max_batch_size = 16;
+  const auto& option_args =
+      getEnableOptionArguments(EnableOption::BatchCompile);
+  if (!option_args.empty()) {
+    try {
+      max_batch_size = std::stol(option_args[0]);
+    } catch (const std::exception& e) {
+      debug() << "skip invalid argument for BatchCompile, arg = "
+              << option_args[0] << std::endl;
+    }
+    NVF_CHECK(
+        max_batch_size > 0,
+        "Invalid batch size for BatchCompile: ",
+        max_batch_size);
+  }
+  return std::clamp(
+      ceilDiv(num_kernels, std::max<int64_t>(num_threads, 1)),
+      (int64_t)1,
+      max_batch_size);
+}
+
+} // namespace
+
+void FusionKernelRuntime::compileDeferredExecutors(
+    const std::vector<FusionExecutor*>& deferred,
+    int8_t device_index) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::compileDeferredExecutors");
+
+  // The map is ordered so that the batches don't depend on the hash of the
+  // keys
+  std::map<std::string, std::vector<FusionExecutor*>> deferred_executors;
+  for (auto executor : deferred) {
+    deferred_executors[executor->deferredCompileKey()].push_back(executor);
+  }
+
+  const bool parallel = !isOptionDisabled(DisableOption::ParallelCompile);
+  const auto batch_size = (size_t)getBatchCompileSize(
+      (int64_t)deferred.size(),
+      parallel ? (int64_t)getThreadPool()->size() : 1);
+  for (const auto& [key, executors] : deferred_executors) {
+    for (size_t begin = 0; begin < executors.size(); begin += batch_size) {
+      const auto end = std::min(executors.size(), begin + batch_size);
+      std::vector<FusionExecutor*> batch(
+          executors.begin() + (int64_t)begin,
+          executors.begin() + (int64_t)end);
+      if (parallel) {
+        getThreadPool()->run([batch, device_index]() {
+          FUSER_PERF_SCOPE("FusionKernelRuntime::compileDeferredExecutors");
+          c10::cuda::CUDAGuard dg(device_index);
+          FusionExecutor::compileKernelBatch(batch);
+        });
+      } else {
+        c10::cuda::CUDAGuard dg(device_index);
+        FusionExecutor::compileKernelBatch(batch);
+      }
+    }
+  }
+
+  if (parallel) {
+    getThreadPool()->waitWorkComplete();
+  }
+}
+
 // passing args by value because we will be modify this
-void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
+void FusionKernelRuntime::compileFusionParallel(
+    KernelArgumentHolder args,
+    bool compile_deferred) {
   std::lock_guard<std::mutex> guard(mutex_);
 
   NVF_ERROR(
@@ -1109,6 +1609,9 @@ void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
   // group should share cache id.
   auto group_cache_id = args.getCacheId();
 
+  // Kernels are lowered by the loop below, and compiled in batches after it
+  const bool batch_compile = isOptionEnabled(EnableOption::BatchCompile);
+
   const int64_t num_groups = (int64_t)runtime_workspace_.group_run_order.size();
   num_live_args_after_segment_runs_.reserve(num_groups);
   for (int64_t group_id = 0; group_id < num_groups; ++group_id) {
@@ -1121,10 +1624,9 @@ void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
     if (group_cache_id.has_value()) {
       group_runtime_inputs.setCacheId(group_cache_id.value());
     }
-    for (auto input : group_to_run->inputs()) {
-      group_runtime_inputs.push(*args_manager.checkTensorMap(input));
-    }
+    args_manager.pushGroupInputs(group_id, group_runtime_inputs);
 
+    executors_.at(group_to_run->groupId()).setDeferNvrtcCompile(batch_compile);
     if (num_groups == 1 || isOptionDisabled(DisableOption::ParallelCompile)) {
       FUSER_PERF_SCOPE("FusionKernelRuntime::compileFusionParallel");
       c10::cuda::CUDAGuard dg(args.getDeviceIndex());
@@ -1155,6 +1657,26 @@ void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
     // wait until all segments finish compiling
     getThreadPool()->waitWorkComplete();
   }
+
+  if (batch_compile && compile_deferred) {
+    compileDeferredKernels(args.getDeviceIndex());
+  }
+}
+
+std::vector<FusionExecutor*> FusionKernelRuntime::takeDeferredExecutors() {
+  std::vector<FusionExecutor*> deferred;
+  for (auto& executor : executors_) {
+    executor.setDeferNvrtcCompile(false);
+    if (executor.hasDeferredCompile()) {
+      deferred.push_back(&executor);
+    }
+  }
+  return deferred;
+}
+
+void FusionKernelRuntime::compileDeferredKernels(int8_t device_index) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::compileDeferredKernels");
+  compileDeferredExecutors(takeDeferredExecutors(), device_index);
 }
 
 void FusionKernelRuntime::compileKernel(
@@ -1171,6 +1693,13 @@ void FusionKernelRuntime::compileKernel(
   // Running a segment group as a single kernel,
   // make a fusion to run from segmented fusion
   auto fusion_to_run = segmented_fusion_->makeFusion(sg);
+
+  // Segments evaluated on the host are not compiled
+  if (scheduler_entry->heuristic() == ScheduleHeuristic::ExprEval) {
+    expr_eval_fusions_.at(group_id) = std::move(fusion_to_run);
+    return;
+  }
+
   FusionGuard fg(fusion_to_run.get());
   scheduler_entry->schedule(fusion_to_run.get());
   NVF_ERROR(
@@ -1201,6 +1730,676 @@ std::pair<LaunchParams, CompileParams> FusionKernelRuntime::getKernelConfig(
 std::vector<at::Tensor> FusionKernelRuntime::runWithInputs(
     KernelArgumentHolder& args) {
   FUSER_PERF_SCOPE("FusionKernelRuntime::runWithInputs");
+  if (canUseSegmentGraph(args)) {
+    return runWithSegmentGraph(args);
+  }
+  if (canUseLaunchPlan(args)) {
+    return runWithLaunchPlan(args);
+  }
+  if (canUseMemoryPlan(args)) {
+    return runWithMemoryPlan(args);
+  }
+  return runSegmentsAndGetOutputs(args);
+}
+
+std::vector<at::Tensor> FusionKernelRuntime::runWithInputs(
+    KernelArgumentHolder& args,
+    std::vector<at::Tensor> outputs) {
+  if (outputs.empty() || !canRunWithOutputs(args)) {
+    return runWithInputs(args);
+  }
+  FUSER_PERF_SCOPE("FusionKernelRuntime::runWithInputs");
+  return runSegmentsAndGetOutputs(args, nullptr, nullptr, std::move(outputs));
+}
+
+bool FusionKernelRuntime::canRunWithOutputs(
+    const KernelArgumentHolder& args) const {
+  if (is_segmented_ || !args.getCacheId().has_value()) {
+    return false;
+  }
+  auto group = runtime_workspace_.group_run_order.at(0);
+  if (group->heuristic() == ScheduleHeuristic::ExprEval) {
+    return false;
+  }
+  // The given outputs are passed to the kernel in the order of the fusion
+  // outputs, which the kernel must write
+  const auto& outputs = segmented_fusion_->outputs();
+  if (group->outputs() != outputs ||
+      std::any_of(outputs.begin(), outputs.end(), [](Val* output) {
+        return output->isFusionInput();
+      })) {
+    return false;
+  }
+  auto fusion = segmented_fusion_->completeFusion();
+  if (!fusion->getOutputToInputAliasIndices().empty() ||
+      !fusion->getPermutationOutputMap().empty()) {
+    return false;
+  }
+  return executors_.at(group->groupId())
+      .isExecutorEntryInitialized(args.getCacheId().value());
+}
+
+bool FusionKernelRuntime::canUseSegmentGraph(
+    const KernelArgumentHolder& args) const {
+  if (!isOptionEnabled(EnableOption::SegmentGraph) ||
+      !args.getCacheId().has_value()) {
+    return false;
+  }
+  // Kernel timing and profiling need to observe each launch
+  if (kernel_launch_disabled_ || measure_kernel_time_ || profiling_ ||
+      isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+    return false;
+  }
+  // Segments evaluated with ATen may synchronize with the host, which is
+  // not allowed while capturing
+  if (std::any_of(
+          expr_eval_fusions_.begin(),
+          expr_eval_fusions_.end(),
+          [](const auto& fusion) { return fusion != nullptr; })) {
+    return false;
+  }
+  // Outputs aliasing inputs are updated in place, so the graph would write
+  // to its static copies instead of the given inputs
+  if (!segmented_fusion_->completeFusion()
+           ->getOutputToInputAliasIndices()
+           .empty()) {
+    return false;
+  }
+  return std::all_of(args.cbegin(), args.cend(), [](const auto& arg) {
+    return !arg->template is<at::Tensor>() ||
+        arg->template as<at::Tensor>().is_cuda() ||
+        is_cpu_scalar(arg->template as<at::Tensor>());
+  });
+}
+
+std::vector<at::Tensor> FusionKernelRuntime::runWithSegmentGraph(
+    KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::runWithSegmentGraph");
+  const auto input_id = args.getCacheId().value();
+  auto graph_it = segment_graphs_.find(input_id);
+  if (graph_it == segment_graphs_.end()) {
+    // The executors are compiled and their launch parameters are computed
+    // by a regular run, as neither can be done while capturing
+    const auto num_inputs = args.size();
+    auto outputs = runSegmentsAndGetOutputs(args);
+    KernelArgumentHolder fusion_args;
+    fusion_args.setDeviceIndex(args.getDeviceIndex());
+    fusion_args.setCacheId(input_id);
+    for (auto i : c10::irange(num_inputs)) {
+      fusion_args.push(*args[i]);
+    }
+    segment_graphs_[input_id] = recordSegmentGraph(fusion_args);
+    return outputs;
+  }
+
+  SegmentGraph* segment_graph = graph_it->second.get();
+  if (segment_graph == nullptr) {
+    return runSegmentsAndGetOutputs(args);
+  }
+  // Scalars are baked into the graph
+  auto same_scalar = [](const PolymorphicValue& recorded,
+                        const PolymorphicValue& given) {
+    if (recorded.is<at::Tensor>()) {
+      return given.is<at::Tensor>() &&
+          at::equal(recorded.as<at::Tensor>(), given.as<at::Tensor>());
+    }
+    return PolymorphicValue_functions::isSame(recorded, given);
+  };
+  for (auto i : c10::irange(segment_graph->scalar_inputs.size())) {
+    if (!segment_graph->static_inputs.at(i).defined() &&
+        !same_scalar(segment_graph->scalar_inputs.at(i), *args[i])) {
+      return runSegmentsAndGetOutputs(args);
+    }
+  }
+
+  {
+    FUSER_PERF_SCOPE("FusionKernelRuntime::runWithSegmentGraph::replay");
+    for (auto i : c10::irange(segment_graph->static_inputs.size())) {
+      auto& static_input = segment_graph->static_inputs.at(i);
+      if (static_input.defined()) {
+        static_input.copy_(args[i]->as<at::Tensor>(), /*non_blocking=*/true);
+      }
+    }
+    segment_graph->graph.replay();
+  }
+
+  std::vector<at::Tensor> outputs;
+  outputs.reserve(segment_graph->static_outputs.size());
+  for (auto i : c10::irange(segment_graph->static_outputs.size())) {
+    const auto forwarded_input = segment_graph->forwarded_inputs.at(i);
+    if (forwarded_input >= 0) {
+      outputs.push_back(args[forwarded_input]->as<at::Tensor>());
+    } else {
+      // The static outputs are overwritten by the next replay
+      outputs.push_back(segment_graph->static_outputs.at(i).clone());
+    }
+  }
+  return outputs;
+}
+
+std::unique_ptr<SegmentGraph> FusionKernelRuntime::recordSegmentGraph(
+    const KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::recordSegmentGraph");
+  auto segment_graph = std::make_unique<SegmentGraph>();
+
+  // The graph reads from copies of the inputs that live as long as the
+  // graph. Strides are kept, as the kernels are compiled for them.
+  KernelArgumentHolder static_args;
+  static_args.setDeviceIndex(args.getDeviceIndex());
+  static_args.setCacheId(args.getCacheId().value());
+  for (auto i : c10::irange(args.size())) {
+    if (args[i]->is<at::Tensor>() && args[i]->as<at::Tensor>().is_cuda()) {
+      const auto& input = args[i]->as<at::Tensor>();
+      auto static_input =
+          at::empty_strided(input.sizes(), input.strides(), input.options());
+      segment_graph->static_inputs.push_back(static_input);
+      segment_graph->scalar_inputs.emplace_back();
+      static_args.push(static_input);
+    } else {
+      segment_graph->static_inputs.emplace_back();
+      segment_graph->scalar_inputs.push_back(
+          args[i]->is<at::Tensor>()
+              ? PolymorphicValue(args[i]->as<at::Tensor>().clone())
+              : *args[i]);
+      static_args.push(*args[i]);
+    }
+  }
+
+  std::vector<at::Tensor> static_outputs;
+  {
+    // Capturing is not allowed on the default stream
+    c10::cuda::CUDAStreamGuard stream_guard(
+        c10::cuda::getStreamFromPool(false, args.getDeviceIndex()));
+    segment_graph->graph.capture_begin();
+    static_outputs = runSegmentsAndGetOutputs(static_args);
+    segment_graph->graph.capture_end();
+  }
+
+  const auto& fusion_inputs = segmented_fusion_->inputs();
+  for (auto i : c10::irange(static_outputs.size())) {
+    auto output = segmented_fusion_->outputs().at(i);
+    auto input_it =
+        std::find(fusion_inputs.begin(), fusion_inputs.end(), output);
+    if (input_it != fusion_inputs.end()) {
+      segment_graph->forwarded_inputs.push_back(
+          std::distance(fusion_inputs.begin(), input_it));
+      segment_graph->static_outputs.emplace_back();
+      continue;
+    }
+    // Outputs with overlapping strides, e.g., expanded outputs, can't be
+    // copied out of the graph with the same strides
+    if (!static_outputs.at(i).is_non_overlapping_and_dense()) {
+      return nullptr;
+    }
+    segment_graph->forwarded_inputs.push_back(-1);
+    segment_graph->static_outputs.push_back(static_outputs.at(i));
+  }
+  return segment_graph;
+}
+
+LaunchPlan::LaunchPlan(const std::vector<Val*>& fusion_inputs)
+    : num_inputs_((int64_t)fusion_inputs.size()), num_slots_(num_inputs_) {
+  for (auto i : c10::irange(fusion_inputs.size())) {
+    val_to_slot_[fusion_inputs.at(i)] = (int64_t)i;
+  }
+}
+
+int64_t LaunchPlan::slotOf(Val* val) const {
+  auto it = val_to_slot_.find(val);
+  return it == val_to_slot_.end() ? -1 : it->second;
+}
+
+void LaunchPlan::addLaunch(
+    SegmentedGroup* group,
+    FusionExecutor& executor,
+    const KernelArgumentHolder& inputs,
+    const std::vector<at::Tensor>& outputs) {
+  if (!valid_) {
+    return;
+  }
+  const auto& record = executor.lastLaunchRecord();
+  const auto& parameters = executor.kernel()->parameters();
+  const auto index_type = executor.kernel()->indexType();
+  NVF_ERROR(
+      record.arg_buffers.size() == parameters.size(),
+      "Unexpected number of kernel arguments: ",
+      record.arg_buffers.size());
+  // The executor appends its outputs and intermediates to its arguments,
+  // so only the first entries of inputs are the segment inputs
+  const auto num_inputs = group->inputs().size();
+  // Random number generators get a new philox offset for each run, and
+  // extra parameters, e.g., TMA descriptors, are not patched, so these
+  // launches can't be replayed
+  if (executor.kernel()->summary().has_philox_op ||
+      parameters.size() !=
+          num_inputs + outputs.size() + record.intermediates.size()) {
+    valid_ = false;
+    return;
+  }
+
+  Launch launch;
+  launch.executor = &executor;
+  launch.launch_params = record.launch_params;
+  launch.arg_buffers = record.arg_buffers;
+
+  auto add_patch = [&](int64_t arg_index, int64_t slot) {
+    auto parameter = parameters.at(arg_index);
+    auto tv = dynamic_cast<TensorView*>(parameter);
+    launch.patches.push_back(
+        {arg_index,
+         slot,
+         tv != nullptr && !tv->isCpuScalar(),
+         parameter->dtype(),
+         index_type});
+  };
+
+  // Scalars without a slot, e.g., the extents of the fusion inputs, are
+  // fixed by the input id. Tensors are always fusion inputs or outputs of
+  // earlier launches.
+  for (auto i : c10::irange(num_inputs)) {
+    const auto slot = slotOf(group->inputs().at(i));
+    if (slot >= 0) {
+      add_patch((int64_t)i, slot);
+    } else if (parameters.at(i)->isA<TensorView>()) {
+      valid_ = false;
+    }
+  }
+
+  for (auto i : c10::irange(outputs.size())) {
+    const auto& output = outputs.at(i);
+    // Outputs aliasing an input are updated in place
+    int64_t slot = -1;
+    for (auto j : c10::irange(num_inputs)) {
+      if (inputs[j]->is<at::Tensor>() &&
+          inputs[j]->as<at::Tensor>().is_same(output)) {
+        slot = slotOf(group->inputs().at(j));
+        break;
+      }
+    }
+    if (slot < 0) {
+      slot = num_slots_++;
+      launch.allocations.push_back(
+          {slot,
+           output.sizes().vec(),
+           output.strides().vec(),
+           output.scalar_type(),
+           false});
+    }
+    val_to_slot_[group->outputs().at(i)] = slot;
+    add_patch((int64_t)(num_inputs + i), slot);
+  }
+
+  for (auto i : c10::irange(record.intermediates.size())) {
+    const auto& buf_info = record.intermediates.at(i);
+    const auto slot = num_slots_++;
+    launch.allocations.push_back(
+        {slot, buf_info.sizes, {}, buf_info.type, buf_info.zero_init});
+    add_patch((int64_t)(num_inputs + outputs.size() + i), slot);
+  }
+
+  launches_.push_back(std::move(launch));
+}
+
+bool LaunchPlan::finalize(const std::vector<Val*>& fusion_outputs) {
+  // Empty outputs are not produced by any launch
+  for (auto output : fusion_outputs) {
+    const auto slot = slotOf(output);
+    if (slot < 0) {
+      valid_ = false;
+      break;
+    }
+    output_slots_.push_back(slot);
+  }
+  val_to_slot_.clear();
+
+  for (auto& launch : launches_) {
+    launch.arg_ptrs.reserve(launch.arg_buffers.size());
+    for (auto& arg_buffer : launch.arg_buffers) {
+      launch.arg_ptrs.push_back(arg_buffer.data());
+    }
+  }
+  return valid_;
+}
+
+std::vector<at::Tensor> LaunchPlan::run(const KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("LaunchPlan::run");
+  NVF_ERROR(valid_, "Cannot run an invalid launch plan");
+  NVF_ERROR(
+      (int64_t)args.size() == num_inputs_,
+      "Expected ",
+      num_inputs_,
+      " inputs but received ",
+      args.size());
+
+  std::vector<PolymorphicValue> slots;
+  slots.reserve(num_slots_);
+  for (auto i : c10::irange(num_inputs_)) {
+    slots.push_back(*args[i]);
+  }
+  slots.resize(num_slots_);
+
+  c10::Device device(c10::DeviceType::CUDA, (int8_t)args.getDeviceIndex());
+  for (auto& launch : launches_) {
+    for (const auto& allocation : launch.allocations) {
+      const auto options =
+          at::TensorOptions().dtype(allocation.type).device(device);
+      if (allocation.zero_init) {
+        slots.at(allocation.slot) = at::zeros(allocation.sizes, options);
+      } else if (allocation.strides.empty()) {
+        slots.at(allocation.slot) = at::empty(allocation.sizes, options);
+      } else {
+        slots.at(allocation.slot) =
+            at::empty_strided(allocation.sizes, allocation.strides, options);
+      }
+    }
+
+    for (const auto& patch : launch.patches) {
+      const auto& value = slots.at(patch.slot);
+      auto& arg_buffer = launch.arg_buffers.at(patch.arg_index);
+      if (patch.data_ptr_only) {
+        // The data pointer is the first field of the tensor metadata
+        void* data = value.as<at::Tensor>().data_ptr();
+        NVF_ERROR(arg_buffer.size() >= sizeof(data));
+        std::memcpy(arg_buffer.data(), &data, sizeof(data));
+      } else {
+        auto bytes =
+            polymorphicValueToBytes(value, patch.dtype, patch.index_type);
+        NVF_ERROR(
+            bytes.size() == arg_buffer.size(),
+            "Size of kernel argument ",
+            patch.arg_index,
+            " changed from ",
+            arg_buffer.size(),
+            " to ",
+            bytes.size());
+        std::memcpy(arg_buffer.data(), bytes.data(), bytes.size());
+      }
+    }
+
+    launch.executor->launchKernel(launch.launch_params, launch.arg_ptrs.data());
+  }
+
+  std::vector<at::Tensor> outputs;
+  outputs.reserve(output_slots_.size());
+  for (auto slot : output_slots_) {
+    outputs.push_back(slots.at(slot).as<at::Tensor>());
+  }
+  return outputs;
+}
+
+namespace {
+
+// Bytes spanned by a tensor of the given sizes and strides
+int64_t storageBytes(
+    const std::vector<int64_t>& sizes,
+    const std::vector<int64_t>& strides,
+    at::ScalarType type) {
+  int64_t num_elements = 1;
+  for (auto i : c10::irange(sizes.size())) {
+    if (sizes.at(i) == 0) {
+      return 0;
+    }
+    num_elements += (sizes.at(i) - 1) * strides.at(i);
+  }
+  return num_elements * (int64_t)c10::elementSize(type);
+}
+
+} // namespace
+
+SegmentMemoryPlan::SegmentMemoryPlan(int64_t num_groups)
+    : group_outputs_(num_groups) {}
+
+void SegmentMemoryPlan::addSegment(
+    int64_t group_id,
+    SegmentedGroup* group,
+    const KernelArgumentHolder& inputs,
+    const std::vector<at::Tensor>& outputs) {
+  NVF_ERROR(!finalized_, "Cannot add a segment to a finalized memory plan");
+  // Forwarded fusion inputs are placeholders created by the executor
+  if (std::any_of(group->outputs().begin(), group->outputs().end(), [](Val* v) {
+        return v->isFusionInput();
+      })) {
+    return;
+  }
+
+  std::vector<PlannedOutput> planned_outputs;
+  planned_outputs.reserve(outputs.size());
+  for (const auto& output : outputs) {
+    // The executor appends the outputs to the segment arguments
+    for (auto i : c10::irange(group->inputs().size())) {
+      if (inputs[i]->is<at::Tensor>() &&
+          inputs[i]->as<at::Tensor>().is_alias_of(output)) {
+        valid_ = false;
+      }
+    }
+    planned_outputs.push_back(
+        {output.sizes().vec(),
+         output.strides().vec(),
+         output.scalar_type(),
+         -1});
+  }
+  group_outputs_.at(group_id) = std::move(planned_outputs);
+}
+
+bool SegmentMemoryPlan::finalize(const RuntimeWorkSpace& workspace) {
+  NVF_ERROR(!finalized_, "Memory plan is already finalized");
+  finalized_ = true;
+  if (!valid_) {
+    return false;
+  }
+
+  // Last group reading each argument
+  std::vector<int64_t> last_use(workspace.num_arg_indices, -1);
+  for (auto group_id : c10::irange(group_outputs_.size())) {
+    for (auto arg_index : workspace.group_input_arg_indices.at(group_id)) {
+      last_use.at(arg_index) = (int64_t)group_id;
+    }
+  }
+  std::vector<bool> is_fusion_output(workspace.num_arg_indices, false);
+  for (auto arg_index : workspace.fusion_output_arg_indices) {
+    if (arg_index >= 0) {
+      is_fusion_output.at(arg_index) = true;
+    }
+  }
+
+  std::vector<BufferLifetime> buffers;
+  std::vector<PlannedOutput*> buffer_outputs;
+  for (auto group_id : c10::irange(group_outputs_.size())) {
+    auto& outputs = group_outputs_.at(group_id);
+    if (!outputs.has_value()) {
+      continue;
+    }
+    const auto& arg_indices = workspace.group_output_arg_indices.at(group_id);
+    NVF_ERROR(arg_indices.size() == outputs->size());
+    for (auto i : c10::irange(outputs->size())) {
+      const auto arg_index = arg_indices.at(i);
+      if (arg_index < 0 || is_fusion_output.at(arg_index)) {
+        continue;
+      }
+      auto& output = outputs->at(i);
+      const auto first_step = (int64_t)group_id;
+      buffers.push_back(
+          {storageBytes(output.sizes, output.strides, output.type),
+           first_step,
+           std::max(first_step, last_use.at(arg_index))});
+      buffer_outputs.push_back(&output);
+    }
+  }
+  if (buffers.empty()) {
+    return false;
+  }
+
+  const auto layout = planWorkspace(buffers);
+  for (auto i : c10::irange(buffers.size())) {
+    buffer_outputs.at(i)->offset = layout.offsets.at(i);
+    planned_bytes_ += buffers.at(i).size;
+  }
+  workspace_size_ = layout.size;
+  return true;
+}
+
+at::Tensor SegmentMemoryPlan::allocateWorkspace(
+    const c10::Device& device) const {
+  NVF_ERROR(finalized_ && valid_, "Cannot run an invalid memory plan");
+  return at::empty(
+      {workspace_size_}, at::TensorOptions().dtype(at::kByte).device(device));
+}
+
+std::vector<at::Tensor> SegmentMemoryPlan::segmentOutputs(
+    int64_t group_id,
+    const at::Tensor& workspace) const {
+  const auto& outputs = group_outputs_.at(group_id);
+  if (!outputs.has_value()) {
+    return {};
+  }
+
+  std::vector<at::Tensor> tensors;
+  tensors.reserve(outputs->size());
+  for (const auto& output : *outputs) {
+    if (output.offset < 0) {
+      tensors.push_back(at::empty_strided(
+          output.sizes,
+          output.strides,
+          at::TensorOptions().dtype(output.type).device(workspace.device())));
+      continue;
+    }
+    // Offsets are aligned, so the bytes can be viewed as the output type
+    const auto num_bytes =
+        storageBytes(output.sizes, output.strides, output.type);
+    tensors.push_back(workspace.narrow(0, output.offset, num_bytes)
+                          .view(output.type)
+                          .as_strided(output.sizes, output.strides));
+  }
+  return tensors;
+}
+
+bool FusionKernelRuntime::canUseLaunchPlan(
+    const KernelArgumentHolder& args) const {
+  if (!isOptionEnabled(EnableOption::LaunchPlan) ||
+      !args.getCacheId().has_value()) {
+    return false;
+  }
+  // Kernel timing and profiling need to observe each launch, and the plan
+  // doesn't fill its allocations with NaNs
+  if (measure_kernel_time_ || profiling_ ||
+      isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose) ||
+      isOptionEnabled(EnableOption::KernelProfile) ||
+      shouldFillAllocationWithNan()) {
+    return false;
+  }
+  // Segments evaluated with ATen have no kernel to launch
+  if (std::any_of(
+          expr_eval_fusions_.begin(),
+          expr_eval_fusions_.end(),
+          [](const auto& fusion) { return fusion != nullptr; })) {
+    return false;
+  }
+  return std::all_of(args.cbegin(), args.cend(), [](const auto& arg) {
+    return !arg->template is<at::Tensor>() ||
+        arg->template as<at::Tensor>().is_cuda() ||
+        is_cpu_scalar(arg->template as<at::Tensor>());
+  });
+}
+
+std::vector<at::Tensor> FusionKernelRuntime::runWithLaunchPlan(
+    KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::runWithLaunchPlan");
+  const auto input_id = args.getCacheId().value();
+  auto plan_it = launch_plans_.find(input_id);
+  if (plan_it != launch_plans_.end()) {
+    if (plan_it->second == nullptr) {
+      return runSegmentsAndGetOutputs(args);
+    }
+    return plan_it->second->run(args);
+  }
+
+  auto launch_plan = std::make_unique<LaunchPlan>(segmented_fusion_->inputs());
+  auto set_record_launch_flags = [&](bool record_launch) {
+    for (auto& executor : executors_) {
+      executor.setRecordLaunchFlag(record_launch);
+    }
+  };
+  set_record_launch_flags(true);
+  std::vector<at::Tensor> outputs;
+  try {
+    outputs = runSegmentsAndGetOutputs(args, launch_plan.get());
+  } catch (...) {
+    // Later runs without a plan must not keep recording
+    set_record_launch_flags(false);
+    throw;
+  }
+  set_record_launch_flags(false);
+  // Executors that evaluate their launch parameters and output sizes for
+  // each run depend on values that are not part of the input id
+  const bool fixed_by_input_id =
+      std::none_of(executors_.begin(), executors_.end(), [](const auto& fe) {
+        return fe.isLaunchParamCacheDisabled();
+      });
+  if (!fixed_by_input_id ||
+      !launch_plan->finalize(segmented_fusion_->outputs())) {
+    launch_plan.reset();
+  }
+  launch_plans_[input_id] = std::move(launch_plan);
+  return outputs;
+}
+
+bool FusionKernelRuntime::canUseMemoryPlan(
+    const KernelArgumentHolder& args) const {
+  if (!isOptionEnabled(EnableOption::MemoryPlan) ||
+      !args.getCacheId().has_value() || !is_segmented_) {
+    return false;
+  }
+  // The planned outputs are not filled with NaNs
+  if (shouldFillAllocationWithNan()) {
+    return false;
+  }
+  // Segments evaluated with ATen return views of their inputs, which would
+  // keep planned tensors alive past their last use
+  if (std::any_of(
+          expr_eval_fusions_.begin(),
+          expr_eval_fusions_.end(),
+          [](const auto& fusion) { return fusion != nullptr; })) {
+    return false;
+  }
+  // The workspace is allocated on the device
+  return std::all_of(args.cbegin(), args.cend(), [](const auto& arg) {
+    return !arg->template is<at::Tensor>() ||
+        arg->template as<at::Tensor>().is_cuda() ||
+        is_cpu_scalar(arg->template as<at::Tensor>());
+  });
+}
+
+std::vector<at::Tensor> FusionKernelRuntime::runWithMemoryPlan(
+    KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::runWithMemoryPlan");
+  const auto input_id = args.getCacheId().value();
+  auto plan_it = memory_plans_.find(input_id);
+  if (plan_it != memory_plans_.end()) {
+    return runSegmentsAndGetOutputs(args, nullptr, plan_it->second.get());
+  }
+
+  auto memory_plan = std::make_unique<SegmentMemoryPlan>(
+      (int64_t)runtime_workspace_.group_run_order.size());
+  auto outputs = runSegmentsAndGetOutputs(args, nullptr, memory_plan.get());
+  // Executors that evaluate their output sizes for each run depend on
+  // values that are not part of the input id
+  const bool fixed_by_input_id =
+      std::none_of(executors_.begin(), executors_.end(), [](const auto& fe) {
+        return fe.isLaunchParamCacheDisabled();
+      });
+  if (!fixed_by_input_id || !memory_plan->finalize(runtime_workspace_)) {
+    memory_plan.reset();
+  }
+  memory_plans_[input_id] = std::move(memory_plan);
+  return outputs;
+}
+
+std::vector<at::Tensor> FusionKernelRuntime::runSegmentsAndGetOutputs(
+    KernelArgumentHolder& args,
+    LaunchPlan* launch_plan,
+    SegmentMemoryPlan* memory_plan,
+    std::vector<at::Tensor> outputs) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::runSegmentsAndGetOutputs");
 
   if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
     debug() << "=================RUNNING FUSION SEGMENTS================="
@@ -1208,7 +2407,8 @@ std::vector<at::Tensor> FusionKernelRuntime::runWithInputs(
   }
 
   c10::Device device(c10::DeviceType::CUDA, (int8_t)args.getDeviceIndex());
-  const auto& tensor_map = runSegmentsWithInputs(args);
+  const auto output_args =
+      runSegmentsWithInputs(args, launch_plan, memory_plan, std::move(outputs));
 
   if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
     debug() << "============= FINISHED RUNNING FUSION SEGMENTS ============"
@@ -1217,9 +2417,10 @@ std::vector<at::Tensor> FusionKernelRuntime::runWithInputs(
 
   // Produce final global output
   std::vector<at::Tensor> fusion_outputs;
-  for (auto output : segmented_fusion_->outputs()) {
-    const auto iter = tensor_map.find(output);
-    if (iter != tensor_map.end()) {
+  for (auto out_i : c10::irange(segmented_fusion_->outputs().size())) {
+    auto output = segmented_fusion_->outputs().at(out_i);
+    const auto output_arg = output_args.at(out_i);
+    if (output_arg != nullptr) {
       // Note [ trivial forwarding ]
       //
       // Background:
@@ -1240,8 +2441,8 @@ std::vector<at::Tensor> FusionKernelRuntime::runWithInputs(
       // 2) Integration handles the trivial forwarding of inputs. When we put
       // together `fusion_outputs` for a given fusion and the outputs are
       // fusion inputs, we directly return the input tensor.
-      NVF_ERROR(iter->second->is<at::Tensor>());
-      fusion_outputs.push_back(iter->second->as<at::Tensor>());
+      NVF_ERROR(output_arg->is<at::Tensor>());
+      fusion_outputs.push_back(output_arg->as<at::Tensor>());
     } else {
       bool empty_type_check = output->getDataType().has_value() &&
           output->getDataType().value() == DataType::Float;
@@ -1276,8 +2477,12 @@ std::vector<at::Tensor> FusionKernelRuntime::runWithInputs(
   return fusion_outputs;
 }
 
-std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
-    runSegmentsWithInputs(KernelArgumentHolder& args) {
+std::vector<const PolymorphicValue*> FusionKernelRuntime::
+    runSegmentsWithInputs(
+        KernelArgumentHolder& args,
+        LaunchPlan* launch_plan,
+        SegmentMemoryPlan* memory_plan,
+        std::vector<at::Tensor> outputs) {
   NVF_ERROR(
       args.size() == segmented_fusion_->inputs().size(),
       "Inputs were not set up correctly, received ",
@@ -1296,8 +2501,22 @@ std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
   // group should share cache id.
   auto group_cache_id = args.getCacheId();
   const int64_t num_groups = (int64_t)runtime_workspace_.group_run_order.size();
+  NVF_ERROR(
+      outputs.empty() || num_groups == 1,
+      "Only the outputs of an unsegmented fusion can be given");
   num_live_args_after_segment_runs_.reserve(num_groups);
   kernel_time_ms_ = 0;
+
+  // A finalized memory plan places the segment outputs in one workspace,
+  // otherwise the outputs are recorded by it
+  const bool use_memory_plan =
+      memory_plan != nullptr && memory_plan->isFinalized();
+  at::Tensor workspace;
+  if (use_memory_plan) {
+    workspace = memory_plan->allocateWorkspace(
+        c10::Device(c10::DeviceType::CUDA, (int8_t)args.getDeviceIndex()));
+  }
+
   for (auto group_id : c10::irange(num_groups)) {
     // TODO: index mode should be updated per segmented kernel
     // Prepare input vector
@@ -1307,16 +2526,28 @@ std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
     if (group_cache_id.has_value()) {
       group_runtime_inputs.setCacheId(group_cache_id.value());
     }
-    for (auto input : group_to_run->inputs()) {
-      group_runtime_inputs.push(*args_manager.checkTensorMap(input));
-    }
+    args_manager.pushGroupInputs(group_id, group_runtime_inputs);
 
     // TODO: currently we are still outputing PyTorch tensors, instead of
     // something abstract. This is quite unsatisfying.
 
     // Run graph segment
-    std::vector<at::Tensor> group_runtime_outputs =
-        runKernelWithInput(group_runtime_inputs, group_to_run);
+    std::vector<at::Tensor> group_runtime_outputs = runKernelWithInput(
+        group_runtime_inputs,
+        group_to_run,
+        use_memory_plan ? memory_plan->segmentOutputs(group_id, workspace)
+                        : std::move(outputs));
+    if (memory_plan != nullptr && !use_memory_plan) {
+      memory_plan->addSegment(
+          group_id, group_to_run, group_runtime_inputs, group_runtime_outputs);
+    }
+    if (launch_plan != nullptr) {
+      launch_plan->addLaunch(
+          group_to_run,
+          executors_.at(group_to_run->groupId()),
+          group_runtime_inputs,
+          group_runtime_outputs);
+    }
     args_manager.updateWithSegmentOutputs(
         group_to_run->outputs(), group_runtime_outputs, group_id);
     num_live_args_after_segment_runs_.push_back((int64_t)args.size());
@@ -1414,7 +2645,7 @@ std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
             << std::endl;
   }
 
-  return args_manager.getTensorMap();
+  return args_manager.getFusionOutputs();
 }
 
 const std::vector<FusionKernelRuntime::SchedulerEntryPtr>& FusionKernelRuntime::
@@ -1471,6 +2702,64 @@ std::optional<FusionKernelRuntime::HeuristicsPtr> FusionKernelRuntime::
   return ret;
 }
 
+FusionExecutorCacheRegistry& FusionExecutorCacheRegistry::get() {
+  static FusionExecutorCacheRegistry registry;
+  return registry;
+}
+
+std::shared_ptr<FusionExecutorCache> FusionExecutorCacheRegistry::
+    getOrRegister(std::shared_ptr<FusionExecutorCache> fusion_executor_cache) {
+  FUSER_PERF_SCOPE("FusionExecutorCacheRegistry::getOrRegister");
+  NVF_ERROR(fusion_executor_cache != nullptr, "No FusionExecutorCache given");
+  CanonicalFusion canonical_fusion(fusion_executor_cache->fusion());
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = caches_.find(canonical_fusion);
+  if (it != caches_.end()) {
+    if (auto registered = it->second.lock()) {
+      ++hits_;
+      return registered;
+    }
+    it->second = fusion_executor_cache;
+    return fusion_executor_cache;
+  }
+
+  if (caches_.size() >= cleanup_size_) {
+    removeExpired();
+    cleanup_size_ = std::max<size_t>(64, 2 * caches_.size());
+  }
+  caches_.emplace(std::move(canonical_fusion), fusion_executor_cache);
+  return fusion_executor_cache;
+}
+
+std::shared_ptr<FusionExecutorCache> FusionExecutorCacheRegistry::getOrCreate(
+    std::unique_ptr<Fusion> fusion) {
+  return getOrRegister(
+      std::make_shared<FusionExecutorCache>(std::move(fusion)));
+}
+
+size_t FusionExecutorCacheRegistry::size() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return std::count_if(caches_.begin(), caches_.end(), [](const auto& entry) {
+    return !entry.second.expired();
+  });
+}
+
+int64_t FusionExecutorCacheRegistry::hits() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return hits_;
+}
+
+void FusionExecutorCacheRegistry::removeExpired() {
+  for (auto it = caches_.begin(); it != caches_.end();) {
+    if (it->second.expired()) {
+      it = caches_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 void GraphCache::createFusion(const std::shared_ptr<torch::jit::Graph>& graph) {
   FUSER_PERF_SCOPE("GraphCache::createFusion");
 
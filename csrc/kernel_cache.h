@@ -7,6 +7,7 @@
 // clang-format on
 #pragma once
 
+#include <canonical_fusion.h>
 #include <dynamic_transform.h>
 #include <evaluator_common.h>
 #include <exceptions.h>
@@ -17,6 +18,7 @@
 #include <scheduler/registry.h>
 #include <serde/fusion_cache_generated.h>
 
+#include <ATen/cuda/CUDAGraph.h>
 #include <c10/macros/Export.h>
 #include <c10/util/ArrayRef.h>
 
@@ -42,7 +44,199 @@ struct RuntimeWorkSpace {
 
   //! Pre-determined order to bind tensor input meta data
   std::vector<Val*> group_extent_binding_order;
+
+  //! Dense index of each Val with an argument while running the segments:
+  //! the fusion inputs, the extents of group_extent_binding_order and the
+  //! segment outputs. The indices below are built once per runtime, so
+  //! looking up the arguments of a run doesn't hash any Val.
+  std::unordered_map<Val*, int64_t> arg_indices;
+  int64_t num_arg_indices = 0;
+
+  //! Index of each extent of group_extent_binding_order
+  std::vector<int64_t> extent_arg_indices;
+
+  //! Indices of the inputs and outputs of each group of group_run_order. -1
+  //! marks outputs that forward a fusion input.
+  std::vector<std::vector<int64_t>> group_input_arg_indices;
+  std::vector<std::vector<int64_t>> group_output_arg_indices;
+
+  //! Indices of the arguments erased after each group of group_run_order,
+  //! as it is their last use
+  std::vector<std::vector<int64_t>> args_last_used_at_group;
+
+  //! Index of each fusion output, or -1 if it's not produced by a segment
+  std::vector<int64_t> fusion_output_arg_indices;
+};
+//! The kernel launches of all segments of a FusionKernelRuntime recorded as a
+//! CUDA graph for an input signature, see EnableOption::SegmentGraph.
+//! Replaying the graph issues the kernels of all segments at once, skipping
+//! the host work of preparing and launching each segment. The kernels of the
+//! graph read and write fixed addresses, so the inputs are copied to static
+//! tensors before a replay and the outputs are copied out of the static
+//! outputs after it.
+struct SegmentGraph {
+  at::cuda::CUDAGraph graph;
+  //! Copies of the CUDA tensor inputs read by the graph. Undefined for other
+  //! inputs.
+  std::vector<at::Tensor> static_inputs;
+  //! Values of the scalar inputs and CPU scalar tensors, which are baked into
+  //! the graph. The graph can only be replayed for the same values.
+  std::vector<PolymorphicValue> scalar_inputs;
+  //! Fusion outputs written by the graph. Undefined for the outputs that
+  //! forward an input.
+  std::vector<at::Tensor> static_outputs;
+  //! Index of the input forwarded as each output, or -1
+  std::vector<int64_t> forwarded_inputs;
+};
+
+//! The kernel launches of all segments of a FusionKernelRuntime recorded for
+//! an input signature, see EnableOption::LaunchPlan. The first run of an
+//! input id records the arguments of each launch. Sizes, strides and launch
+//! parameters are fixed by the input id, so later runs skip the shape
+//! inference and argument evaluation of each segment. They only allocate
+//! the outputs and intermediates of each launch, patch the data pointers
+//! and the scalar inputs into the recorded arguments, and launch the kernel.
+//!
+//! Values are numbered by slots: the fusion inputs come first, followed by
+//! the tensors allocated for the launches.
+class LaunchPlan {
+ public:
+  explicit LaunchPlan(const std::vector<Val*>& fusion_inputs);
+
+  //! Record the launch of a segment by executor, which must record its
+  //! launches. inputs are the arguments of the segment and outputs the
+  //! tensors returned by the executor.
+  void addLaunch(
+      SegmentedGroup* group,
+      FusionExecutor& executor,
+      const KernelArgumentHolder& inputs,
+      const std::vector<at::Tensor>& outputs);
+
+  //! Called once all launches are added. Returns false if the plan can't
+  //! produce the fusion outputs.
+  bool finalize(const std::vector<Val*>& fusion_outputs);
+
+  //! Launch the kernels for args, which must have the recorded input id.
+  //! Returns the fusion outputs.
+  std::vector<at::Tensor> run(const KernelArgumentHolder& args);
+
+  int64_t numLaunches() const {
+    return (int64_t)launches_.size();
+  }
+
+ private:
+  //! A kernel argument updated by each run
+  struct ArgPatch {
+    //! Index of the argument in the parameters of the kernel
+    int64_t arg_index = 0;
+    int64_t slot = 0;
+    //! Only the data pointer of tensors is patched, otherwise the whole
+    //! argument is converted from the slot value
+    bool data_ptr_only = true;
+    DataType dtype = DataType::Null;
+    PrimDataType index_type = PrimDataType::Int;
+  };
+
+  //! A tensor allocated before a launch
+  struct Allocation {
+    int64_t slot = 0;
+    std::vector<int64_t> sizes;
+    std::vector<int64_t> strides;
+    at::ScalarType type = at::ScalarType::Undefined;
+    bool zero_init = false;
+  };
+
+  struct Launch {
+    FusionExecutor* executor = nullptr;
+    LaunchParams launch_params;
+    std::vector<std::vector<std::byte>> arg_buffers;
+    //! Pointers to arg_buffers, as taken by cuLaunchKernel
+    std::vector<void*> arg_ptrs;
+    std::vector<Allocation> allocations;
+    std::vector<ArgPatch> patches;
+  };
+
+  //! Returns the slot of val, or -1 if it's fixed by the input id
+  int64_t slotOf(Val* val) const;
+
+  int64_t num_inputs_ = 0;
+  int64_t num_slots_ = 0;
+  //! Only used while recording
+  std::unordered_map<Val*, int64_t> val_to_slot_;
+  //! Set when a launch can't be replayed by patching its arguments
+  bool valid_ = true;
+  std::vector<Launch> launches_;
+  std::vector<int64_t> output_slots_;
+};
+
+//! Placement of the tensors passed between the segments of a
+//! FusionKernelRuntime in one workspace, recorded for an input signature,
+//! see EnableOption::MemoryPlan. The first run of an input id records the
+//! sizes and strides of the outputs of each segment. The outputs that are
+//! only read by later segments are then placed by planWorkspace, so that
+//! tensors with disjoint lifetimes share memory. Later runs allocate the
+//! workspace once and pass views of it to the executors as preallocated
+//! outputs. Fusion outputs outlive the run and are allocated separately.
+class SegmentMemoryPlan {
+ public:
+  explicit SegmentMemoryPlan(int64_t num_groups);
+
+  //! Record the outputs of the group_id-th group of the run order. The
+  //! outputs of groups that forward a fusion input are not planned.
+  void addSegment(
+      int64_t group_id,
+      SegmentedGroup* group,
+      const KernelArgumentHolder& inputs,
+      const std::vector<at::Tensor>& outputs);
+
+  //! Called once all segments are added. Places the planned outputs in the
+  //! workspace using the lifetimes given by the argument indices of
+  //! workspace. Returns false if an output aliases a segment input, which
+  //! would keep a planned tensor alive past its last use.
+  bool finalize(const RuntimeWorkSpace& workspace);
+
+  //! Allocate the workspace of a run
+  at::Tensor allocateWorkspace(const c10::Device& device) const;
+
+  //! The outputs of the group_id-th group for a run using workspace. Empty
+  //! if the outputs of the group are not planned.
+  std::vector<at::Tensor> segmentOutputs(
+      int64_t group_id,
+      const at::Tensor& workspace) const;
+
+  bool isFinalized() const {
+    return finalized_;
+  }
+
+  //! Bytes of the workspace
+  int64_t workspaceSize() const {
+    return workspace_size_;
+  }
+
+  //! Bytes of the tensors placed in the workspace, which separate
+  //! allocations would take
+  int64_t plannedBytes() const {
+    return planned_bytes_;
+  }
+
+ private:
+  struct PlannedOutput {
+    std::vector<int64_t> sizes;
+    std::vector<int64_t> strides;
+    at::ScalarType type = at::ScalarType::Undefined;
+    //! Offset in the workspace, or -1 for a separate allocation
+    int64_t offset = -1;
+  };
+
+  //! Outputs of each group, or nullopt for groups that are not planned
+  std::vector<std::optional<std::vector<PlannedOutput>>> group_outputs_;
+  //! Set when an output aliases a segment input
+  bool valid_ = true;
+  bool finalized_ = false;
+  int64_t workspace_size_ = 0;
+  int64_t planned_bytes_ = 0;
 };
+
 //! Simple hasher for pair<T, const U*>. There is no default hasher for pairs,
 //! since there are a lot of options how to combine hashes. In a case where one
 //! element of the pair is unlikely to change much, the following hash is fast
@@ -104,15 +298,21 @@ class FusionKernelRuntime {
     for (auto& fe : executors_) {
       fe.evictCache(input_id);
     }
+    segment_graphs_.erase(input_id);
+    launch_plans_.erase(input_id);
+    memory_plans_.erase(input_id);
   }
 
   //! query if we already have a compiled kernel for execution
   bool isCompiled() {
     std::lock_guard<std::mutex> guard(mutex_);
-    return std::all_of(
-        executors_.begin(), executors_.end(), [](const auto& executor) {
-          return executor.isCompiled();
-        });
+    for (auto group_id : c10::irange(executors_.size())) {
+      if (!executors_.at(group_id).isCompiled() &&
+          expr_eval_fusions_.at(group_id) == nullptr) {
+        return false;
+      }
+    }
+    return true;
   }
 
   //! Serialize Fusion Kernel Runtime using flatbuffers
@@ -137,9 +337,38 @@ class FusionKernelRuntime {
   //! Unified interface to run the managed kernels with given input
   std::vector<at::Tensor> runWithInputs(KernelArgumentHolder& args);
 
+  //! Runs the kernels as runWithInputs, but writes the fusion outputs to the
+  //! given tensors if canRunWithOutputs. Otherwise, the outputs are
+  //! allocated as usual. Returns the outputs either way.
+  std::vector<at::Tensor> runWithInputs(
+      KernelArgumentHolder& args,
+      std::vector<at::Tensor> outputs);
+
+  //! Whether the outputs of a run with args can be given by the caller. The
+  //! fusion must not be segmented, its outputs must not be inputs, aliases
+  //! of inputs or permuted, and a previous run with the cache id of args
+  //! must have initialized the executor.
+  bool canRunWithOutputs(const KernelArgumentHolder& args) const;
+
   //! Compile a kernel executor for given inputs. Note: The compilation is
   //! multithreaded. The segments in the fusion are compiled independently.
-  void compileFusionParallel(KernelArgumentHolder args);
+  //! With EnableOption::BatchCompile, the kernels are left to
+  //! takeDeferredExecutors if compile_deferred is false.
+  void compileFusionParallel(
+      KernelArgumentHolder args,
+      bool compile_deferred = true);
+
+  //! Returns the executors whose kernels were left to a batch compilation by
+  //! compileFusionParallel, which the caller has to compile, see
+  //! compileDeferredExecutors
+  std::vector<FusionExecutor*> takeDeferredExecutors();
+
+  //! Compile the deferred kernels of executors, possibly of several
+  //! runtimes. Kernels with the same compile options are compiled in batches
+  //! sharing one NVRTC program, in parallel.
+  static void compileDeferredExecutors(
+      const std::vector<FusionExecutor*>& executors,
+      int8_t device_index);
 
   const std::vector<int64_t>& getArgsNumAfterSegmentRuns() {
     return num_live_args_after_segment_runs_;
@@ -177,6 +406,7 @@ class FusionKernelRuntime {
     for (auto& executor : executors_) {
       executor.setExecuteKernelFlag(false);
     }
+    kernel_launch_disabled_ = true;
   }
 
   //! Returns if this runtime is segmented
@@ -221,21 +451,101 @@ class FusionKernelRuntime {
     return executors_;
   }
 
+  //! Returns the number of input ids with a recorded CUDA graph, see
+  //! EnableOption::SegmentGraph
+  int64_t numSegmentGraphs() const {
+    return std::count_if(
+        segment_graphs_.begin(), segment_graphs_.end(), [](const auto& entry) {
+          return entry.second != nullptr;
+        });
+  }
+
+  //! Returns the number of input ids with a recorded launch plan, see
+  //! EnableOption::LaunchPlan
+  int64_t numLaunchPlans() const {
+    return std::count_if(
+        launch_plans_.begin(), launch_plans_.end(), [](const auto& entry) {
+          return entry.second != nullptr;
+        });
+  }
+
+  //! Returns the memory plan recorded for input_id, or nullptr, see
+  //! EnableOption::MemoryPlan
+  const SegmentMemoryPlan* memoryPlan(size_t input_id) const {
+    auto it = memory_plans_.find(input_id);
+    return it == memory_plans_.end() ? nullptr : it->second.get();
+  }
+
  private:
+  //! Runs the segments one by one and collects the fusion outputs. The
+  //! launches are added to launch_plan if given. The segment outputs are
+  //! recorded in memory_plan if given, or allocated by it once it is
+  //! finalized. The outputs of an unsegmented fusion are written to
+  //! outputs if given, see canRunWithOutputs.
+  std::vector<at::Tensor> runSegmentsAndGetOutputs(
+      KernelArgumentHolder& args,
+      LaunchPlan* launch_plan = nullptr,
+      SegmentMemoryPlan* memory_plan = nullptr,
+      std::vector<at::Tensor> outputs = {});
+
+  //! Whether the segments can be recorded as a CUDA graph for the given
+  //! arguments, see EnableOption::SegmentGraph
+  bool canUseSegmentGraph(const KernelArgumentHolder& args) const;
+
+  //! Replays the CUDA graph recorded for the input id of args. The first run
+  //! of an input id runs the segments one by one, which also compiles and
+  //! initializes the executors, and then records the graph.
+  std::vector<at::Tensor> runWithSegmentGraph(KernelArgumentHolder& args);
+
+  //! Capture the kernel launches of all segments for the inputs of args
+  std::unique_ptr<SegmentGraph> recordSegmentGraph(
+      const KernelArgumentHolder& args);
+
+  //! Whether the launches can be replayed by a LaunchPlan for the given
+  //! arguments, see EnableOption::LaunchPlan
+  bool canUseLaunchPlan(const KernelArgumentHolder& args) const;
+
+  //! Runs the launch plan recorded for the input id of args. The first run
+  //! of an input id runs the segments one by one and records the plan.
+  std::vector<at::Tensor> runWithLaunchPlan(KernelArgumentHolder& args);
+
+  //! Whether the segment outputs can be placed by a SegmentMemoryPlan for
+  //! the given arguments, see EnableOption::MemoryPlan
+  bool canUseMemoryPlan(const KernelArgumentHolder& args) const;
+
+  //! Runs the segments with their outputs placed by the memory plan
+  //! recorded for the input id of args. The first run of an input id
+  //! allocates the outputs separately and records the plan.
+  std::vector<at::Tensor> runWithMemoryPlan(KernelArgumentHolder& args);
+
   //! Runs each fusion segment given arguments. The outputs for a fusion are
   //! added back to the arguments, so they can be used as inputs to successive
-  //! segments. Returns a map that links each NvFuser Val to its corresponding
-  //! tensor.
-  std::unordered_map<Val*, const PolymorphicValue*> runSegmentsWithInputs(
-      KernelArgumentHolder& args);
+  //! segments. Returns the argument of each fusion output, or nullptr for
+  //! outputs that are not produced by any segment.
+  std::vector<const PolymorphicValue*> runSegmentsWithInputs(
+      KernelArgumentHolder& args,
+      LaunchPlan* launch_plan = nullptr,
+      SegmentMemoryPlan* memory_plan = nullptr,
+      std::vector<at::Tensor> outputs = {});
 
   //! Interface to run a single kernel, either one kernel for single-kernel
   //! fusions, or a kernel for a segmentedGrouup in a segmented fusion. Returns
-  //! the kernel outputs.
+  //! the kernel outputs, which are allocated by the executor unless given.
   std::vector<at::Tensor> runKernelWithInput(
+      KernelArgumentHolder& args,
+      SegmentedGroup* sg,
+      std::vector<at::Tensor> outputs = {});
+
+  //! Runs a segment scheduled with ExprEvalScheduler on the host, without
+  //! any kernel launch. Returns the segment outputs.
+  std::vector<at::Tensor> runExprEvalSegment(
       KernelArgumentHolder& args,
       SegmentedGroup* sg);
 
+  //! Compile the kernels that compileKernel left to a batch compilation with
+  //! EnableOption::BatchCompile, see compileDeferredExecutors
+  void compileDeferredKernels(int8_t device_index);
+
   //! Interface to compile a single kernel. It is either a single kernel for a
   //! fusion or a kernel for a segmentedGrouup in a segmented fusion. Returns
   //! launch and compile parameters for kernel.
@@ -255,6 +565,11 @@ class FusionKernelRuntime {
   //! Executors holding compiled kernels
   std::vector<FusionExecutor> executors_;
 
+  //! Entries indexed by groupID:
+  //! Fusions of the segments evaluated on the host with ATen, see
+  //! ExprEvalScheduler. nullptr for the segments run as CUDA kernels.
+  std::vector<std::unique_ptr<Fusion>> expr_eval_fusions_;
+
   // A metadata copy of initial arguments used to contruct this
   // FusionKernelRuntime. Used during deserialization to schedule the fusion
   // rather than storing the scheduled fusion directly.
@@ -295,6 +610,23 @@ class FusionKernelRuntime {
   //! The sum of the last kernel execution times
   float kernel_time_ms_ = 0;
 
+  //! Set by disableKernelLaunch. There is nothing to record in a CUDA graph
+  //! when kernels are not launched.
+  bool kernel_launch_disabled_ = false;
+
+  //! CUDA graphs recorded per input id, see EnableOption::SegmentGraph. A
+  //! nullptr entry marks an input id whose segments could not be recorded.
+  std::unordered_map<size_t, std::unique_ptr<SegmentGraph>> segment_graphs_;
+
+  //! Launch plans recorded per input id, see EnableOption::LaunchPlan. A
+  //! nullptr entry marks an input id whose launches could not be recorded.
+  std::unordered_map<size_t, std::unique_ptr<LaunchPlan>> launch_plans_;
+
+  //! Memory plans recorded per input id, see EnableOption::MemoryPlan. A
+  //! nullptr entry marks an input id whose outputs could not be planned.
+  std::unordered_map<size_t, std::unique_ptr<SegmentMemoryPlan>>
+      memory_plans_;
+
   std::mutex mutex_;
 
   // The heuristics and executor for most recent kernel launch
@@ -506,6 +838,37 @@ class FusionExecutorCache {
       std::optional<PrimDataType> forced_index_type = std::nullopt,
       std::optional<int8_t> selected_device = std::nullopt);
 
+  //! Execute fusion graph with given inputs as runFusionWithInputs, writing
+  //! the outputs to the given tensors, e.g., to buffers reused across runs,
+  //! when the kernel runtime allows it, see
+  //! FusionKernelRuntime::canRunWithOutputs. Returns the outputs, which are
+  //! newly allocated if the given tensors could not be used. The given
+  //! tensors must have the sizes and strides of the outputs.
+  std::vector<at::Tensor> runFusionWithOutputs(
+      const at::ArrayRef<c10::IValue>& inputs,
+      std::vector<at::Tensor> outputs,
+      std::optional<int8_t> selected_device = std::nullopt);
+
+  //! Execute fusion graph for each set of inputs of the batch, as
+  //! runFusionWithInputs would, and return the outputs of each set in order.
+  //! The sets of inputs with the same signature, i.e., cache id, are encoded,
+  //! looked up and compiled once.  The later sets of a signature only build
+  //! their arguments, and the kernels of all the sets are launched back to
+  //! back from one call.
+  std::vector<std::vector<at::Tensor>> runFusionWithInputsBatch(
+      const std::vector<std::vector<c10::IValue>>& batch,
+      std::optional<int8_t> selected_device = std::nullopt);
+
+  //! Compile the kernel runtimes of several fusions for the given inputs,
+  //! without running them. With EnableOption::BatchCompile, the kernels of
+  //! all the runtimes are compiled together, in batches sharing one NVRTC
+  //! program, instead of runtime by runtime. Meant for warming up many
+  //! fusions at once, e.g., the fusions of a FusionCache.
+  static void compileFusionsBatch(
+      const std::vector<
+          std::pair<FusionExecutorCache*, std::vector<c10::IValue>>>&
+          fusions);
+
   //! Converts inputs from IValue to KernelArgumentHolder, also handles cache
   //! lookup
   KernelArgumentHolder prepareInputs(
@@ -551,6 +914,10 @@ class FusionExecutorCache {
   std::string getScheduledIrFor(
       const at::ArrayRef<c10::IValue>& inputs,
       bool tensor_transforms = false);
+  //! Approximate memory held by the compiled kernels of all the runtimes, in
+  //! bytes: the size of their PTX and cubin. The modules loaded on the device
+  //! are about the size of the cubins.
+  size_t memoryFootprint() const;
 
   // TODO: in a follow up we need a global logging structure
   //  to capture runtime profiling info. We also need to define
@@ -645,18 +1012,36 @@ class FusionExecutorCache {
   //! Deserialize Fusion Executor Cache using flatbuffers
   void deserialize(const serde::FusionExecutorCache* buffer);
 
-  //! Allocate the outputs of the Fusion given inputs
-  //! TODO: re-implement
+  //! Allocate the outputs of the Fusion given inputs, without compiling nor
+  //! running the Fusion. The output shapes are inferred from the input
+  //! shapes on the unscheduled Fusion. Fusions with dynamic transforms or
+  //! permuted inputs fall back to runFusionWithInputs.
   std::vector<at::Tensor> allocOutputSpace(
-      const at::ArrayRef<c10::IValue>& inputs) {
-    return runFusionWithInputs(inputs);
-  }
+      const at::ArrayRef<c10::IValue>& inputs);
 
  private:
   //! evict cached short cut entry in `code_to_fe_lookup_` as well as cached
   //! entry in `FusionExecutor`
   void evictCache(size_t cache_id);
 
+  //! Permute the inputs as described by the permutation input map of the
+  //! fusion, then prepareInputs. If layout is given, its device index and
+  //! cache id are used for the inputs instead of being looked up.
+  KernelArgumentHolder permuteAndPrepareInputs(
+      const at::ArrayRef<c10::IValue>& inputs,
+      std::optional<int8_t> selected_device,
+      const KernelArgumentHolder* layout = nullptr);
+
+  //! Run a compiled kernel runtime with the prepared args of inputs, and
+  //! return the outputs of the fusion permuted back, without aliased outputs.
+  //! The outputs are written to the given ones if the runtime can, see
+  //! FusionKernelRuntime::canRunWithOutputs.
+  std::vector<at::Tensor> runKernelRuntime(
+      FusionKernelRuntime* kernel_runtime,
+      const at::ArrayRef<c10::IValue>& inputs,
+      KernelArgumentHolder& args,
+      std::vector<at::Tensor> outputs = {});
+
   //! The index type of forced_index_type is used to get a kernel
   //! runtime no matter what sizes inputs have
   FusionKernelRuntime* getKernelRuntimeFor(
@@ -719,6 +1104,47 @@ class FusionExecutorCache {
   std::optional<DynamicTransformInitialInfo> initial_info_ = std::nullopt;
 };
 
+//! Process-wide registry of FusionExecutorCaches, so that structurally equal
+//! fusions defined separately share one cache and the runtimes compiled by
+//! it. Fusions are compared by their CanonicalFusion.
+//!
+//! The registry only keeps weak references, so a cache is dropped from it
+//! once all of its users release it. A cache shared by several threads
+//! needs the same care as any FusionExecutorCache used from several threads.
+class FusionExecutorCacheRegistry {
+ public:
+  static FusionExecutorCacheRegistry& get();
+
+  //! Returns the registered cache of a fusion equal to the fusion of
+  //! fusion_executor_cache, or registers and returns fusion_executor_cache if
+  //! there is none. The fusion is canonicalized as it is, so this should be
+  //! called before the cache is run.
+  std::shared_ptr<FusionExecutorCache> getOrRegister(
+      std::shared_ptr<FusionExecutorCache> fusion_executor_cache);
+
+  //! Same as getOrRegister for a new cache of fusion
+  std::shared_ptr<FusionExecutorCache> getOrCreate(
+      std::unique_ptr<Fusion> fusion);
+
+  //! Number of registered caches still alive
+  size_t size() const;
+
+  //! Number of calls that returned a cache registered before
+  int64_t hits() const;
+
+ private:
+  //! Drop the entries of the caches that were destroyed
+  void removeExpired();
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<CanonicalFusion, std::weak_ptr<FusionExecutorCache>>
+      caches_;
+  //! Expired entries are removed when the map grows to this size
+  size_t cleanup_size_ = 64;
+  int64_t hits_ = 0;
+};
+
 //! [ Note -- 2 level cache implementation ]
 //!
 //! Compiling PyTorch IR requires an addition translation to Fusion IR, which is
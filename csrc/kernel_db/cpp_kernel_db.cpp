@@ -0,0 +1,248 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <instrumentation.h>
+#include <kernel_db/cpp_kernel_db.h>
+#include <kernel_db/utils.h>
+#include <utils.h>
+
+namespace nvfuser {
+
+static std::mutex cpp_kernel_db_lock;
+
+namespace {
+
+// A directory or file of the db is only trusted if it's owned by the
+// current user and can't be modified by others. Symbolic links are not
+// followed.
+bool isTrusted(const fs::path& path, bool directory) {
+  struct stat st {};
+  if (lstat(path.c_str(), &st) != 0) {
+    return false;
+  }
+  if (directory ? !S_ISDIR(st.st_mode) : !S_ISREG(st.st_mode)) {
+    return false;
+  }
+  // Others can't even list the directory, but libraries only need to be
+  // unwritable
+  const mode_t forbidden =
+      directory ? (S_IRWXG | S_IRWXO) : (S_IWGRP | S_IWOTH);
+  return st.st_uid == geteuid() && (st.st_mode & forbidden) == 0;
+}
+
+} // namespace
+
+CppKernelDb& CppKernelDb::get() {
+  return get("nvfuser_cpp_kernel_db", true, false);
+}
+
+CppKernelDb& CppKernelDb::get(
+    const std::string& kernel_db_dir,
+    bool use_cache_dir,
+    bool reset) {
+  std::lock_guard<std::mutex> guard(cpp_kernel_db_lock);
+
+  static CppKernelDb singleton;
+
+  if (reset) {
+    singleton.initialized_ = false;
+    singleton.library_map_.clear();
+    singleton.num_compilations_ = 0;
+    singleton.kernel_db_path_.clear();
+  }
+
+  if (!singleton.initialized_) {
+    auto success = false;
+    try {
+      success = singleton.open(kernel_db_dir, use_cache_dir);
+    } catch (const std::exception& e) {
+      TORCH_WARN(
+          "nvFuser's cpp_kernel_db had an unexpected exception while opening. Exception: ",
+          e.what());
+    }
+    singleton.initialized_ = success;
+  }
+  return singleton;
+}
+
+fs::path CppKernelDb::cacheDirectory() {
+  const char* xdg_cache_home = std::getenv("XDG_CACHE_HOME");
+  if (xdg_cache_home != nullptr && fs::path(xdg_cache_home).is_absolute()) {
+    return fs::path(xdg_cache_home);
+  }
+  const char* home = std::getenv("HOME");
+  if (home != nullptr && fs::path(home).is_absolute()) {
+    return fs::path(home) / ".cache";
+  }
+  return fs::temp_directory_path() /
+      ("nvfuser-" + std::to_string(geteuid()));
+}
+
+bool CppKernelDb::open(const std::string& kernel_db_dir, bool use_cache_dir) {
+  FUSER_PERF_SCOPE("CppKernelDb::open");
+  if (use_cache_dir) {
+    const auto cache_dir = cacheDirectory();
+    try {
+      fs::create_directories(cache_dir);
+    } catch (const std::exception& e) {
+      TORCH_WARN(
+          "Unable to create the cache directory of the nvFuser C++ Kernel DB! ",
+          cache_dir.string(),
+          e.what());
+      return false;
+    }
+    kernel_db_path_ = cache_dir / kernel_db_dir;
+  } else {
+    kernel_db_path_ = fs::path(kernel_db_dir);
+  }
+  if (mkdir(kernel_db_path_.c_str(), S_IRWXU) != 0 && errno != EEXIST) {
+    TORCH_WARN(
+        "Unable to create nvFuser C++ Kernel DB directory! ",
+        kernel_db_path_.string(),
+        std::strerror(errno));
+    return false;
+  }
+  if (!isTrusted(kernel_db_path_, /*directory=*/true)) {
+    TORCH_WARN(
+        "nvFuser C++ Kernel DB directory ",
+        kernel_db_path_.string(),
+        " is not a directory owned by the current user with mode 0700. ",
+        "C++ kernels are disabled.");
+    return false;
+  }
+
+  // Libraries compiled by previous processes are restored from the directory
+  for (const auto& entry : fs::directory_iterator(kernel_db_path_)) {
+    if (entry.path().extension() == ".so" &&
+        isTrusted(entry.path(), /*directory=*/false)) {
+      library_map_[entry.path().stem().string()] = entry.path();
+    }
+  }
+  return true;
+}
+
+std::string CppKernelDb::compileCommand() {
+  const char* compiler = getNvFuserEnv("CPP_COMPILER");
+  std::stringstream ss;
+  ss << (compiler != nullptr ? compiler : "c++")
+     << " -std=c++17 -O3 -march=native -fopenmp -fPIC -shared";
+  return ss.str();
+}
+
+const std::string& CppKernelDb::cpuSignature() {
+  // The model and the feature flags of the first processor determine the
+  // instructions -march=native may use
+  static const std::string signature = []() {
+    std::string model;
+    std::string flags;
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    for (std::string line; std::getline(cpuinfo, line);) {
+      if (model.empty() && line.rfind("model name", 0) == 0) {
+        model = line;
+      } else if (flags.empty() && line.rfind("flags", 0) == 0) {
+        flags = line;
+      }
+      if (!model.empty() && !flags.empty()) {
+        break;
+      }
+    }
+    return model + "\n" + flags;
+  }();
+  return signature;
+}
+
+std::string CppKernelDb::getLibrary(const std::string& kernel_code) {
+  FUSER_PERF_SCOPE("CppKernelDb::getLibrary");
+  const std::string command = compileCommand();
+  std::stringstream name_ss;
+  name_ss << std::hex << std::setfill('0') << std::setw(16)
+          << std::hash<std::string>{}(
+                 command + "\n" + cpuSignature() + "\n" + kernel_code);
+  const std::string name = name_ss.str();
+  const fs::path code_file = kernel_db_path_ / (name + ".cpp");
+  const fs::path library_file = kernel_db_path_ / (name + ".so");
+
+  int64_t compilation_id = 0;
+  {
+    std::lock_guard<std::mutex> guard(cpp_kernel_db_lock);
+    NVF_CHECK(
+        initialized_,
+        "Unable to compile C++ kernels as the C++ Kernel DB could not be opened");
+
+    auto it = library_map_.find(name);
+    if (it != library_map_.end()) {
+      std::string cached_code;
+      if (isTrusted(it->second, /*directory=*/false) &&
+          copy_from_text_file(code_file.string(), cached_code) &&
+          cached_code == kernel_code) {
+        return it->second.string();
+      }
+      // Hash collision, a partially written or an untrusted entry --
+      // Recompile
+      library_map_.erase(it);
+    }
+    compilation_id = num_compilations_++;
+  }
+
+  // The compiler runs without holding the lock so kernels of other threads
+  // can be looked up meanwhile. The code and the library are written to
+  // files unique to this compilation and renamed into place, so another
+  // thread or process never reads a partially written entry.
+  const std::string tmp_suffix = "." + std::to_string(getpid()) + "." +
+      std::to_string(compilation_id) + ".tmp";
+  const fs::path tmp_code_file = kernel_db_path_ / (name + tmp_suffix + ".cpp");
+  const fs::path tmp_library_file = kernel_db_path_ / (name + tmp_suffix);
+  const fs::path log_file = kernel_db_path_ / (name + tmp_suffix + ".log");
+  NVF_ERROR(
+      copy_to_text_file(tmp_code_file.string(), kernel_code),
+      "Unable to write C++ kernel to ",
+      tmp_code_file.string());
+
+  std::stringstream cmd_ss;
+  cmd_ss << command << " -o " << tmp_library_file << " " << tmp_code_file
+         << " > " << log_file << " 2>&1";
+  {
+    FUSER_PERF_SCOPE("CppKernelDb::getLibrary::compile");
+    const int status = std::system(cmd_ss.str().c_str());
+    if (status != 0) {
+      std::string log;
+      copy_from_text_file(log_file.string(), log);
+      fs::remove(tmp_code_file);
+      fs::remove(log_file);
+      NVF_ERROR(
+          false,
+          "C++ kernel compilation failed: ",
+          cmd_ss.str(),
+          "\n",
+          log);
+    }
+  }
+  fs::remove(log_file);
+  // The umask may leave the library writable by the group
+  fs::permissions(
+      tmp_library_file, fs::perms::owner_all, fs::perm_options::replace);
+
+  std::lock_guard<std::mutex> guard(cpp_kernel_db_lock);
+  fs::rename(tmp_code_file, code_file);
+  fs::rename(tmp_library_file, library_file);
+  library_map_[name] = library_file;
+  return library_file.string();
+}
+
+} // namespace nvfuser
@@ -0,0 +1,90 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <kernel_db/kernel_db.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace nvfuser {
+
+//! CppKernelDb is a singleton structure that compiles the C++ kernels of the
+//! CPU backend into shared libraries with the system compiler and caches them
+//! on disk. A library is named after the hash of the kernel code, the
+//! compile command and the host CPU, as kernels are compiled with
+//! -march=native, and the code is kept next to it to detect collisions, so
+//! the db can be restored by listing its directory.
+//!
+//! The libraries are loaded into the process, so the db lives in a per-user
+//! cache directory created with mode 0700. The directory and the libraries
+//! are only trusted if they are owned by the current user and not writable
+//! by others.
+//!
+//! The compiler is "c++" by default and can be set with the
+//! NVFUSER_CPP_COMPILER environment variable.
+class CppKernelDb {
+  CppKernelDb() = default;
+
+  //! Open is private because this method should only be called once by the
+  //! singleton upon creation to create a new db or restore an existing one.
+  bool open(const std::string& kernel_db_dir, bool use_cache_dir);
+
+ public:
+  // clang-tidy - deleted member function should be public
+  CppKernelDb(const CppKernelDb&) = delete;
+  CppKernelDb& operator=(const CppKernelDb&) = delete;
+
+  //! Thread-Safe method to get the Meyer's singleton -- Interface
+  static CppKernelDb& get();
+  //! Thread-Safe method to get the Meyer's singleton -- For testing
+  static CppKernelDb& get(
+      const std::string& kernel_db_dir,
+      bool use_cache_dir = true,
+      bool reset = false);
+
+  //! Per-user directory the db is created in: $XDG_CACHE_HOME, or
+  //! $HOME/.cache, or a directory named after the user id in the temporary
+  //! directory
+  static fs::path cacheDirectory();
+
+  bool enabled() const {
+    return initialized_;
+  }
+  //! Returns the number of libraries in the db
+  size_t size() const {
+    return library_map_.size();
+  }
+  //! Returns the number of invocations of the compiler since the db was
+  //! opened
+  int64_t numCompilations() const {
+    return num_compilations_;
+  }
+
+  //! Returns the path to a shared library built from kernel_code, compiling
+  //! it if it's not in the db yet
+  std::string getLibrary(const std::string& kernel_code);
+
+  //! Command used to compile a kernel, without the input and output files
+  static std::string compileCommand();
+
+  //! Identifies the host CPU that -march=native compiles for
+  static const std::string& cpuSignature();
+
+ private:
+  //! Db is only initialized after it is successfully open
+  bool initialized_ = false;
+  //! Hash Map of library name -> full path to the library
+  std::unordered_map<std::string, fs::path> library_map_;
+  int64_t num_compilations_ = 0;
+
+  //! Full path to the db directory
+  fs::path kernel_db_path_;
+};
+
+} // namespace nvfuser
@@ -874,6 +874,44 @@ std::string IfThenElse::toInlineString(int indent_size) const {
 
 NVFUSER_DEFINE_CLONE_AND_CREATE(IfThenElse)
 
+BlockScan::BlockScan(
+    IrBuilderPasskey passkey,
+    BinaryOpType scan_op_type,
+    Val* init,
+    Val* out,
+    Val* in,
+    Val* carry,
+    int64_t dim,
+    bool is_exclusive)
+    : ScanOp(passkey, scan_op_type, init, out, in, dim, is_exclusive) {
+  NVF_ERROR(passkey.ir_container_ != nullptr);
+  NVF_ERROR(
+      passkey.ir_container_->isA<kir::Kernel>(),
+      "IR type only valid for Kernel container.");
+  NVF_ERROR(
+      attributes().size() == num_scan_op_attr,
+      "The num_scan_op_attr does not match the number of attributes ScanOp has."
+      "If you changed ScanOp, please change num_scan_op_attr accordingly.");
+  addAttribute(carry);
+}
+
+std::string BlockScan::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << out()->toString() << " = block_scan( "
+                          << in()->toString() << ", op = " << getScanOpType()
+                          << ", initial value = " << init()->toString()
+                          << ", carry = " << carry()->toString()
+                          << ", exclusive = "
+                          << (isExclusive() ? "true" : "false") << " )\n";
+  return ss.str();
+}
+
+std::string BlockScan::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Tensor op can not be printed inline");
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(BlockScan)
+
 GridReduction::GridReduction(
     IrBuilderPasskey passkey,
     BinaryOpType reduction_op_type,
@@ -50,6 +50,7 @@ class InitMagicZero;
 class UpdateMagicZero;
 class ForLoop;
 class IfThenElse;
+class BlockScan;
 class GridReduction;
 class GroupedGridReduction;
 class GridBroadcast;
@@ -812,6 +813,43 @@ class IfThenElse final : public Expr {
   }
 };
 
+//! Block scan operation
+//!
+//! This node is used only after lowering a fusion to mark a scan whose axis
+//! is split into a serial loop and TIDx. At each iteration of the serial loop,
+//! the threads of the block scan one element each, starting from the carry,
+//! which accumulates the elements of all the previous iterations.
+class BlockScan final : public ScanOp {
+  static constexpr int num_scan_op_attr = 4;
+
+ public:
+  using ScanOp::ScanOp;
+
+  BlockScan(
+      IrBuilderPasskey passkey,
+      BinaryOpType scan_op_type,
+      Val* init,
+      Val* out,
+      Val* in,
+      Val* carry,
+      int64_t dim,
+      bool is_exclusive = false);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "BlockScan";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+
+  //! Local scalar that is read and updated by every thread of the block
+  Val* carry() const {
+    return attributeVal(num_scan_op_attr);
+  }
+};
+
 //! Grid reduction operation
 //!
 //! This node is used only after lowering a fusion to explicitly mark a grid
@@ -0,0 +1,128 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <memory_planner.h>
+
+#include <utils.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace nvfuser {
+
+namespace {
+
+int64_t alignedSize(int64_t size, int64_t alignment) {
+  return ceilDiv(size, alignment) * alignment;
+}
+
+bool overlapInTime(const BufferLifetime& a, const BufferLifetime& b) {
+  return a.first_step <= b.last_step && b.first_step <= a.last_step;
+}
+
+void validateBuffers(
+    const std::vector<BufferLifetime>& buffers,
+    int64_t alignment) {
+  NVF_ERROR(alignment > 0, "Invalid workspace alignment: ", alignment);
+  for (const auto& buffer : buffers) {
+    NVF_ERROR(
+        buffer.size >= 0 && buffer.first_step <= buffer.last_step,
+        "Invalid buffer of ",
+        buffer.size,
+        " bytes live from step ",
+        buffer.first_step,
+        " to step ",
+        buffer.last_step);
+  }
+}
+
+} // namespace
+
+WorkspaceLayout planWorkspace(
+    const std::vector<BufferLifetime>& buffers,
+    int64_t alignment) {
+  validateBuffers(buffers, alignment);
+
+  // Largest first. Ties are broken by the first step so that the layout
+  // doesn't depend on the sort implementation.
+  std::vector<size_t> order(buffers.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    if (buffers[a].size != buffers[b].size) {
+      return buffers[a].size > buffers[b].size;
+    }
+    return buffers[a].first_step < buffers[b].first_step;
+  });
+
+  WorkspaceLayout layout;
+  layout.offsets.resize(buffers.size(), 0);
+  std::vector<size_t> placed;
+  placed.reserve(buffers.size());
+  for (auto i : order) {
+    const auto& buffer = buffers[i];
+    const int64_t size = alignedSize(buffer.size, alignment);
+    if (size == 0) {
+      continue;
+    }
+
+    // Memory taken by the placed buffers live at the same time
+    std::vector<std::pair<int64_t, int64_t>> taken;
+    for (auto j : placed) {
+      if (overlapInTime(buffers[j], buffer)) {
+        const auto offset = layout.offsets[j];
+        taken.emplace_back(
+            offset, offset + alignedSize(buffers[j].size, alignment));
+      }
+    }
+    std::sort(taken.begin(), taken.end());
+
+    // Best fit among the gaps, or after the end of the taken memory
+    int64_t best_offset = -1;
+    int64_t best_gap = std::numeric_limits<int64_t>::max();
+    int64_t end = 0;
+    for (const auto& [taken_begin, taken_end] : taken) {
+      const int64_t gap = taken_begin - end;
+      if (gap >= size && gap < best_gap) {
+        best_offset = end;
+        best_gap = gap;
+      }
+      end = std::max(end, taken_end);
+    }
+    if (best_offset < 0) {
+      best_offset = end;
+    }
+
+    layout.offsets[i] = best_offset;
+    layout.size = std::max(layout.size, best_offset + size);
+    placed.push_back(i);
+  }
+  return layout;
+}
+
+int64_t peakLiveBytes(
+    const std::vector<BufferLifetime>& buffers,
+    int64_t alignment) {
+  validateBuffers(buffers, alignment);
+
+  // The live bytes only grow at the first step of a buffer
+  int64_t peak = 0;
+  for (const auto& step_buffer : buffers) {
+    const int64_t step = step_buffer.first_step;
+    int64_t live_bytes = 0;
+    for (const auto& buffer : buffers) {
+      if (buffer.first_step <= step && step <= buffer.last_step) {
+        live_bytes += alignedSize(buffer.size, alignment);
+      }
+    }
+    peak = std::max(peak, live_bytes);
+  }
+  return peak;
+}
+
+} // namespace nvfuser
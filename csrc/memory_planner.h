@@ -0,0 +1,51 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace nvfuser {
+
+//! A buffer to be placed in a workspace. It is live from the step it is
+//! defined in to the step of its last use, both inclusive, so a buffer
+//! never shares memory with the buffers read by the step defining it.
+struct BufferLifetime {
+  //! Size in bytes
+  int64_t size = 0;
+  int64_t first_step = 0;
+  int64_t last_step = 0;
+};
+
+//! Offsets of buffers in a workspace
+struct WorkspaceLayout {
+  //! Byte offset of each buffer, in the order the buffers were given
+  std::vector<int64_t> offsets;
+  //! Bytes needed by the workspace
+  int64_t size = 0;
+};
+
+//! Place the buffers in one workspace so that buffers with overlapping
+//! lifetimes don't overlap in memory. This is an interval coloring with
+//! the greedy by size heuristic: buffers are placed from the largest to
+//! the smallest, each in the smallest gap left between the buffers
+//! already placed that it overlaps in time, or after the last of them.
+//! Offsets are multiples of alignment.
+WorkspaceLayout planWorkspace(
+    const std::vector<BufferLifetime>& buffers,
+    int64_t alignment = 256);
+
+//! The largest sum of the aligned sizes of the buffers live at a step,
+//! which is a lower bound of the size of any workspace layout
+int64_t peakLiveBytes(
+    const std::vector<BufferLifetime>& buffers,
+    int64_t alignment = 256);
+
+} // namespace nvfuser
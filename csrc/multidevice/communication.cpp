@@ -132,6 +132,10 @@ c10::intrusive_ptr<c10d::Work> Broadcast::post(Communicator& comm) {
           {.rootRank = root_relative_index_});
 }
 
+std::shared_ptr<Communication> Broadcast::withParams(CommParams params) const {
+  return std::make_shared<Broadcast>(std::move(params));
+}
+
 Gather::Gather(CommParams params) : Communication(params, "gather") {
   assertBufferCount(params_.src_bufs, 1);
   NVF_ERROR(params_.team.size() > 1, "the team size must be greater than 1");
@@ -158,6 +162,10 @@ c10::intrusive_ptr<c10d::Work> Gather::post(Communicator& comm) {
   return work;
 }
 
+std::shared_ptr<Communication> Gather::withParams(CommParams params) const {
+  return std::make_shared<Gather>(std::move(params));
+}
+
 Allgather::Allgather(CommParams params)
     : Communication(params, "allgather", false) {
   assertBufferCount(params_.src_bufs, 1);
@@ -177,6 +185,10 @@ c10::intrusive_ptr<c10d::Work> Allgather::post(Communicator& comm) {
   return work;
 }
 
+std::shared_ptr<Communication> Allgather::withParams(CommParams params) const {
+  return std::make_shared<Allgather>(std::move(params));
+}
+
 Scatter::Scatter(CommParams params) : Communication(params, "scatter") {
   assertBufferCount(params_.dst_bufs, 1);
   NVF_ERROR(params_.team.size() > 1, "the team size must be greater than 1");
@@ -203,6 +215,10 @@ c10::intrusive_ptr<c10d::Work> Scatter::post(Communicator& comm) {
   return work;
 }
 
+std::shared_ptr<Communication> Scatter::withParams(CommParams params) const {
+  return std::make_shared<Scatter>(std::move(params));
+}
+
 SendRecv::SendRecv(CommParams params) : Communication(params, "send/recv") {
   NVF_ERROR(
       params_.team.size() == 1 || params_.team.size() == 2,
@@ -233,6 +249,10 @@ c10::intrusive_ptr<c10d::Work> SendRecv::post(Communicator& comm) {
       params_.dst_bufs.empty() ? params_.src_bufs : params_.dst_bufs);
 }
 
+std::shared_ptr<Communication> SendRecv::withParams(CommParams params) const {
+  return std::make_shared<SendRecv>(std::move(params));
+}
+
 } // namespace nvfuser
 
 #endif
@@ -66,6 +66,11 @@ class Communication {
   // The communication can be posted multiple times
   virtual c10::intrusive_ptr<c10d::Work> post(Communicator& comm) = 0;
 
+  // Returns a communication of the same type with other parameters, e.g.,
+  // with buffers pointing to the data of another run
+  virtual std::shared_ptr<Communication> withParams(
+      CommParams params) const = 0;
+
  protected:
   // argument "name" is only used for printing
   // argument "has_root" indicates if the communication is rooted
@@ -96,6 +101,7 @@ class Broadcast : public Communication {
  public:
   Broadcast(CommParams params);
   c10::intrusive_ptr<c10d::Work> post(Communicator& comm) override;
+  std::shared_ptr<Communication> withParams(CommParams params) const override;
 };
 
 /*
@@ -113,6 +119,7 @@ class Gather : public Communication {
  public:
   Gather(CommParams params);
   c10::intrusive_ptr<c10d::Work> post(Communicator& comm) override;
+  std::shared_ptr<Communication> withParams(CommParams params) const override;
 };
 
 /*
@@ -128,6 +135,7 @@ class Allgather : public Communication {
  public:
   Allgather(CommParams params);
   c10::intrusive_ptr<c10d::Work> post(Communicator& comm) override;
+  std::shared_ptr<Communication> withParams(CommParams params) const override;
 };
 
 /*
@@ -144,6 +152,7 @@ class Scatter : public Communication {
  public:
   Scatter(CommParams params);
   c10::intrusive_ptr<c10d::Work> post(Communicator& comm) override;
+  std::shared_ptr<Communication> withParams(CommParams params) const override;
 };
 
 /*
@@ -165,6 +174,7 @@ class SendRecv : public Communication {
  public:
   SendRecv(CommParams params);
   c10::intrusive_ptr<c10d::Work> post(Communicator& comm) override;
+  std::shared_ptr<Communication> withParams(CommParams params) const override;
 };
 
 } // namespace nvfuser
@@ -159,6 +159,8 @@ Communicator::Communicator(
     return;
   }
 
+  topology_ = DeviceTopology::fromEnv(size_, local_size_);
+
   c10d::TCPStoreOptions store_opts;
   {
     char hostname[HOST_NAME_MAX]; // NOLINT (modernize-avoid-c-arrays)
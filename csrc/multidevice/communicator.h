@@ -10,6 +10,7 @@
 
 #include <exceptions.h>
 #include <multidevice/multidevice.h>
+#include <multidevice/topology.h>
 #include <torch/csrc/distributed/c10d/ProcessGroup.hpp>
 #include <torch/csrc/distributed/c10d/Store.hpp>
 #include <torch/csrc/distributed/c10d/TCPStore.hpp>
@@ -88,6 +89,17 @@ class Communicator {
     return rankToDiD(rank_);
   }
 
+  // returns the physical topology of the devices, used to lower the
+  // communications. See multidevice/topology.h
+  const DeviceTopology& topology() const {
+    return topology_;
+  }
+
+  // overrides the topology read from the environment at initialization
+  void setTopology(DeviceTopology topology) {
+    topology_ = std::move(topology);
+  }
+
  private:
   // returns the rank corresponding to a device index
   RankType dIdToRank(DeviceIdxType d_id) const {
@@ -107,6 +119,7 @@ class Communicator {
   int64_t local_size_;
   std::string master_addr_;
   int master_port_;
+  DeviceTopology topology_;
   // stores the world's store used for the backend init
   c10::intrusive_ptr<c10d::TCPStore> store_;
   // stores the world's backend
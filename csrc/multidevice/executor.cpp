@@ -6,9 +6,20 @@
  */
 // clang-format on
 #ifdef USE_DISTRIBUTED
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <debug.h>
 #include <ir/utils.h>
 #include <multidevice/executor.h>
+#include <multidevice/lower_communication.h>
 #include <multidevice/pipeline.h>
+#include <options.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <optional>
+#include <unordered_set>
 
 namespace nvfuser {
 
@@ -24,13 +35,222 @@ bool PipelineExecutor::shouldRun(PipelineStage* stage) {
   return should_run_[stage];
 }
 
-void PipelineExecutor::handle(PipelineStage* stage) {
+c10::IValue PipelineExecutor::getIValue(Val* val) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return val_to_IValue_.at(val);
+}
+
+void PipelineExecutor::setIValue(Val* val, c10::IValue value) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  val_to_IValue_[val] = std::move(value);
+}
+
+void PipelineExecutor::recordTiming(
+    Expr* expr,
+    std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point end,
+    std::shared_ptr<at::cuda::CUDAEvent> start_event,
+    std::shared_ptr<at::cuda::CUDAEvent> end_event,
+    std::optional<c10::cuda::CUDAStream> stream,
+    std::vector<Val*> recorded_inputs) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  timings_.push_back(
+      {expr,
+       start,
+       end,
+       std::this_thread::get_id(),
+       std::move(start_event),
+       std::move(end_event),
+       stream,
+       std::move(recorded_inputs)});
+}
+
+void PipelineExecutor::runStage(PipelineStage* stage) {
   // get the IValues corresponding to the stage's input
   std::vector<c10::IValue> stage_input_IValues;
   for (auto& input_val : stage->inputs()) {
-    stage_input_IValues.push_back(val_to_IValue_[input_val]);
+    stage_input_IValues.push_back(getIValue(input_val));
   }
 
+  // Run the stage to get concrete outputs or placeholders
+  std::vector<at::Tensor> outputs;
+  if (!shouldRun(stage)) {
+    outputs = getPlaceholders(stage, stage_input_IValues);
+  } else if (!reusesOutputs(stage)) {
+    outputs = fec_.at(stage)->runFusionWithInputs(stage_input_IValues);
+  } else {
+    // The outputs of the previous run with the same signature are
+    // overwritten. The consumers of that run are done with them, since this
+    // run's streams wait for the caller's stream, which waited for all of
+    // the previous run.
+    std::vector<at::Tensor> previous_outputs;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      auto& stage_outputs = stage_outputs_[input_id_];
+      if (auto it = stage_outputs.find(stage); it != stage_outputs.end()) {
+        previous_outputs = it->second;
+      }
+    }
+    outputs = previous_outputs.empty()
+        ? fec_.at(stage)->runFusionWithInputs(stage_input_IValues)
+        : fec_.at(stage)->runFusionWithOutputs(
+              stage_input_IValues, std::move(previous_outputs));
+    std::lock_guard<std::mutex> guard(mutex_);
+    stage_outputs_[input_id_][stage] = outputs;
+  }
+
+  // Store the outputs or placeholders in the context
+  for (auto output_idx : c10::irange(stage->outputs().size())) {
+    setIValue(stage->outputs().at(output_idx), outputs.at(output_idx));
+  }
+}
+
+std::vector<at::Tensor> PipelineExecutor::getPlaceholders(
+    PipelineStage* stage,
+    const std::vector<c10::IValue>& stage_inputs) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto& placeholders = placeholders_[input_id_];
+    if (auto it = placeholders.find(stage); it != placeholders.end()) {
+      return it->second;
+    }
+  }
+  auto outputs = fec_.at(stage)->allocOutputSpace(stage_inputs);
+  std::lock_guard<std::mutex> guard(mutex_);
+  placeholders_[input_id_][stage] = outputs;
+  return outputs;
+}
+
+bool PipelineExecutor::reusesOutputs(PipelineStage* stage) {
+  const auto& global_outputs = runtime_.pipeline_->outputs();
+  return std::none_of(
+      stage->outputs().begin(), stage->outputs().end(), [&](Val* output) {
+        return std::find(
+                   global_outputs.begin(), global_outputs.end(), output) !=
+            global_outputs.end();
+      });
+}
+
+namespace {
+
+// Maximum number of input locations whose communications are kept per plan
+constexpr size_t kMaxBoundLocations = 8;
+
+// Returns the communications of a plan rebuilt so that their send buffers,
+// which are views of plan.input, point to the same locations in 'input'. The
+// lowered buffers are left untouched since they may be shared.
+std::vector<std::shared_ptr<Communication>> rebindInput(
+    const CommunicationPlan& plan,
+    const at::Tensor& input) {
+  const auto old_offset = plan.input.storage_offset();
+  auto rebind = [&](const std::vector<at::Tensor>& bufs) {
+    std::vector<at::Tensor> rebound;
+    rebound.reserve(bufs.size());
+    for (const auto& buf : bufs) {
+      if (buf.is_alias_of(plan.input)) {
+        rebound.push_back(input.as_strided(
+            buf.sizes(),
+            buf.strides(),
+            buf.storage_offset() - old_offset + input.storage_offset()));
+      } else {
+        rebound.push_back(buf);
+      }
+    }
+    return rebound;
+  };
+  std::vector<std::shared_ptr<Communication>> communications;
+  communications.reserve(plan.communications.size());
+  for (const auto& communication : plan.communications) {
+    const CommParams& params = communication->params();
+    CommParams rebound_params{
+        .root = params.root,
+        .src_bufs = rebind(params.src_bufs),
+        .dst_bufs = rebind(params.dst_bufs),
+        .team = params.team};
+    communications.push_back(
+        communication->withParams(std::move(rebound_params)));
+  }
+  return communications;
+}
+
+} // namespace
+
+const std::vector<std::shared_ptr<Communication>>& PipelineExecutor::
+    getBoundCommunications(
+        CommunicationPlan& plan,
+        const at::Tensor& input_tensor) {
+  if (plan.input.data_ptr() == input_tensor.data_ptr()) {
+    return plan.communications;
+  }
+  // A plan is only used by the worker of its communication
+  auto& bound = plan.bound_communications;
+  if (auto it = bound.find(input_tensor.data_ptr()); it != bound.end()) {
+    return it->second;
+  }
+  if (bound.size() >= kMaxBoundLocations) {
+    bound.clear();
+  }
+  return bound[input_tensor.data_ptr()] = rebindInput(plan, input_tensor);
+}
+
+CommunicationPlan& PipelineExecutor::getCommunicationPlan(
+    PipelineCommunication* c,
+    const at::Tensor& input_tensor) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto& plans = plans_[input_id_];
+    if (auto it = plans.find(c); it != plans.end() &&
+        it->second.input.strides() == input_tensor.strides()) {
+      return it->second;
+    }
+  }
+
+  CommunicationPlan plan;
+  // The communications are lowered with an alias of the input, which tells
+  // where their send buffers are located when they are rebuilt
+  plan.input = input_tensor.alias();
+  plan.output = at::empty_like(input_tensor);
+
+  /* Lower the communication into a series of Communications, taking the
+     topology into account so that the data is fetched from the closest
+     senders. Each process only gets the communications it is involved in. */
+  plan.communications = lowerCommunication(
+      runtime_.comm_.deviceId(),
+      c,
+      plan.input,
+      plan.output,
+      runtime_.comm_.topology());
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  return plans_[input_id_][c] = std::move(plan);
+}
+
+std::vector<c10::intrusive_ptr<c10d::Work>> PipelineExecutor::
+    postCommunication(PipelineCommunication* c) {
+  auto input_tensor = getIValue(c->in()).toTensor();
+  auto& plan = getCommunicationPlan(c, input_tensor);
+  const auto& communications = getBoundCommunications(plan, input_tensor);
+
+  // The communications may depend on each other (e.g., in a hierarchical
+  // broadcast, a node leader forwards what it received), so only the last
+  // one is left pending
+  std::vector<c10::intrusive_ptr<c10d::Work>> pending;
+  for (const auto& communication : communications) {
+    for (auto& work : pending) {
+      work->wait();
+    }
+    pending.clear();
+    auto work = communication->post(runtime_.comm_);
+    if (work) {
+      pending.push_back(work);
+    }
+  }
+  setIValue(c->out(), plan.output);
+  return pending;
+}
+
+void PipelineExecutor::handle(PipelineStage* stage) {
+  auto start = std::chrono::steady_clock::now();
   // Create the stage executor
   if (!fec_.count(stage)) {
     fec_.emplace(
@@ -38,82 +258,241 @@ void PipelineExecutor::handle(PipelineStage* stage) {
         std::make_unique<FusionExecutorCache>(
             runtime_.pipeline_->stageToFusion(stage)));
   }
-  // Run the stage to get concrete outputs or placeholders
-  // TODO: reimplement allocOutputSpace
-  // TODO: allocate output space only if strictly necessary
-  std::vector<at::Tensor> outputs = shouldRun(stage)
-      ? fec_[stage]->runFusionWithInputs(stage_input_IValues)
-      : fec_[stage]->allocOutputSpace(stage_input_IValues);
+  runStage(stage);
+  recordTiming(stage, start, std::chrono::steady_clock::now());
+}
 
-  // Store the outputs or placeholders in the context
-  for (auto output_idx : c10::irange(stage->outputs().size())) {
-    val_to_IValue_[stage->outputs().at(output_idx)] = outputs.at(output_idx);
+void PipelineExecutor::handle(PipelineCommunication* c) {
+  auto start = std::chrono::steady_clock::now();
+  for (auto& work : postCommunication(c)) {
+    work->wait();
   }
+  recordTiming(c, start, std::chrono::steady_clock::now());
 }
 
-struct SendRecvDescriptor {
-  Team team;
-  DeviceIdxType root = 0;
-};
-
-void PipelineExecutor::handle(PipelineCommunication* c) {
-  /* Lower the communication into several SendRecvDescriptor
-     The idea is to evenly split the destinations accross the sources
-     TODO: ensure that the srcs send to the receivers that are the closest in
-     the topology. */
-  std::vector<SendRecvDescriptor> communications;
+std::vector<Val*> PipelineExecutor::waitForInputs(Expr* expr) {
+  std::vector<std::shared_ptr<at::cuda::CUDAEvent>> events;
+  std::vector<c10::intrusive_ptr<c10d::Work>> works;
+  std::vector<std::pair<Val*, at::Tensor>> tensors;
   {
-    Team senders;
-    for (auto& d_id :
-         c->in()->as<PipelineVal>()->getStage()->descriptor()->mesh.vector()) {
-      senders.push_back(d_id);
-    }
-
-    Team receivers;
-    for (auto& d_id :
-         c->out()->as<PipelineVal>()->getStage()->descriptor()->mesh.vector()) {
-      receivers.push_back(d_id);
-    }
-
-    auto nbr_srcs = senders.size();
-    auto nbr_dests_per_comm = receivers.size() / nbr_srcs;
-    auto remainder = receivers.size() % nbr_srcs;
-    auto j = 0;
-    for (size_t i : c10::irange(nbr_srcs)) {
-      SendRecvDescriptor communication;
-      auto src = senders.at(i);
-      communication.team = {src};
-      communication.root = src;
-      for (size_t counter = 0; counter < nbr_dests_per_comm + (i < remainder);
-           counter++, j++) {
-        auto dst = receivers.at(j);
-        communication.team.push_back(dst);
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (auto input : expr->inputs()) {
+      if (auto it = ready_events_.find(input); it != ready_events_.end()) {
+        events.push_back(it->second);
+      }
+      if (auto it = pending_works_.find(input); it != pending_works_.end()) {
+        works.insert(works.end(), it->second.begin(), it->second.end());
+      }
+      if (auto it = val_to_IValue_.find(input);
+          it != val_to_IValue_.end() && it->second.isTensor()) {
+        tensors.emplace_back(input, it->second.toTensor());
+      }
+    }
+  }
+  auto stream = c10::cuda::getCurrentCUDAStream();
+  for (auto& event : events) {
+    event->block(stream);
+  }
+  // For stream-based backends (nccl), this makes the current stream wait for
+  // the communication. Other backends (e.g., gloo) block the thread.
+  for (auto& work : works) {
+    work->wait();
+  }
+  // The inputs were allocated on the stream of their producer. Without this,
+  // their memory could be handed out again on that stream once they are
+  // released, while the current stream still reads them.
+  std::vector<Val*> recorded_inputs;
+  for (auto& [input, tensor] : tensors) {
+    if (tensor.is_cuda() && tensor.has_storage()) {
+      c10::cuda::CUDACachingAllocator::recordStream(
+          tensor.storage().data_ptr(), stream);
+      recorded_inputs.push_back(input);
+    }
+  }
+  return recorded_inputs;
+}
+
+void PipelineExecutor::runConcurrently() {
+  const auto exprs = runtime_.pipeline_->exprs();
+  if (exprs.empty()) {
+    return;
+  }
+
+  // Everything that is not thread-safe is set up before launching the workers
+  std::unordered_map<Expr*, size_t> expr_to_index;
+  for (auto i : c10::irange(exprs.size())) {
+    expr_to_index.emplace(exprs.at(i), i);
+  }
+  const auto device_index = runtime_.comm_.device().index();
+  for (auto expr : exprs) {
+    if (auto stage = dynamic_cast<PipelineStage*>(expr)) {
+      shouldRun(stage);
+      if (!fec_.count(stage)) {
+        fec_.emplace(
+            stage,
+            std::make_unique<FusionExecutorCache>(
+                runtime_.pipeline_->stageToFusion(stage)));
+      }
+    }
+    if (!streams_.count(expr)) {
+      streams_.emplace(
+          expr,
+          c10::cuda::getStreamFromPool(/*isHighPriority=*/false, device_index));
+    }
+  }
+  if (workers_ == nullptr || workers_->size() < exprs.size()) {
+    workers_ = std::make_unique<c10::ThreadPool>(
+        static_cast<int>(exprs.size()));
+  }
+
+  // The global inputs are produced on the caller's stream, which also carries
+  // the completion of the previous run
+  auto inputs_ready = std::make_shared<at::cuda::CUDAEvent>();
+  inputs_ready->record(c10::cuda::getCurrentCUDAStream(device_index));
+  for (auto input : runtime_.pipeline_->inputs()) {
+    ready_events_[input] = inputs_ready;
+  }
+
+  // Builds the dependency graph. The communications are additionally chained
+  // in the traversal order, which is identical on all the processes, so that
+  // they are posted in the same order everywhere.
+  std::vector<std::vector<size_t>> consumers(exprs.size());
+  std::vector<int64_t> remaining_deps(exprs.size(), 0);
+  std::optional<size_t> previous_communication;
+  for (auto i : c10::irange(exprs.size())) {
+    std::unordered_set<size_t> deps;
+    for (auto input : exprs.at(i)->inputs()) {
+      if (input->definition() != nullptr) {
+        deps.insert(expr_to_index.at(input->definition()));
+      }
+    }
+    if (exprs.at(i)->isA<PipelineCommunication>()) {
+      if (previous_communication.has_value()) {
+        deps.insert(previous_communication.value());
+      }
+      previous_communication = i;
+    }
+    for (auto dep : deps) {
+      consumers.at(dep).push_back(i);
+    }
+    remaining_deps.at(i) = (int64_t)deps.size();
+  }
+
+  std::mutex scheduling_mutex;
+  std::condition_variable all_done;
+  size_t done_count = 0;
+  size_t launched_count = 0;
+  std::exception_ptr error = nullptr;
+
+  // Forward declared so that a task can schedule its consumers
+  std::function<void(size_t)> launch;
+  auto run_task = [&](size_t i) {
+    Expr* expr = exprs.at(i);
+    std::vector<size_t> ready;
+    try {
+      c10::cuda::CUDAStreamGuard stream_guard(streams_.at(expr));
+      auto start = std::chrono::steady_clock::now();
+      // Orders this run after the previous work of the caller's stream
+      inputs_ready->block(streams_.at(expr));
+      auto recorded_inputs = waitForInputs(expr);
+      auto start_event =
+          std::make_shared<at::cuda::CUDAEvent>(cudaEventDefault);
+      start_event->record(streams_.at(expr));
+      if (auto stage = dynamic_cast<PipelineStage*>(expr)) {
+        runStage(stage);
+      } else if (auto c = dynamic_cast<PipelineCommunication*>(expr)) {
+        auto works = postCommunication(c);
+        std::lock_guard<std::mutex> guard(mutex_);
+        pending_works_[c->out()] = std::move(works);
+      } else {
+        NVF_ERROR(false, "unexpected expr in pipeline: ", expr->toString());
+      }
+      // Local copies and kernels were enqueued on the expr's stream
+      auto event = std::make_shared<at::cuda::CUDAEvent>(cudaEventDefault);
+      event->record(streams_.at(expr));
+      {
+        std::lock_guard<std::mutex> guard(mutex_);
+        for (auto output : expr->outputs()) {
+          ready_events_[output] = event;
+        }
       }
-      communications.push_back(communication);
-    }
-  }
-
-  auto input_val = c->in();
-  auto output_val = c->out();
-  std::vector<at::Tensor> tensor = {val_to_IValue_.at(input_val).toTensor()};
-
-  /* perform the needed communications. For now everything is translated as
-     send/recv.
-     TODO: sending from one src to multiple dsts could be lowered as a
-     broadcast, in which case we should create a new communictor backend (and
-     cache it)*/
-  for (auto& communication : communications) {
-    auto sender_rank = communication.root;
-    for (auto receiver_rank : communication.team) {
-      if ((sender_rank == receiver_rank) ||
-          !(runtime_.comm_.deviceId() == sender_rank ||
-            runtime_.comm_.deviceId() == receiver_rank)) {
-        continue;
+      recordTiming(
+          expr,
+          start,
+          std::chrono::steady_clock::now(),
+          start_event,
+          event,
+          streams_.at(expr),
+          std::move(recorded_inputs));
+    } catch (...) {
+      std::lock_guard<std::mutex> guard(scheduling_mutex);
+      if (error == nullptr) {
+        error = std::current_exception();
+      }
+    }
+
+    std::lock_guard<std::mutex> guard(scheduling_mutex);
+    if (error == nullptr) {
+      for (auto consumer : consumers.at(i)) {
+        if (--remaining_deps.at(consumer) == 0) {
+          ready.push_back(consumer);
+        }
       }
-      runtime_.comm_.sendRecv(receiver_rank, sender_rank, tensor);
     }
+    for (auto consumer : ready) {
+      launch(consumer);
+    }
+    done_count++;
+    all_done.notify_all();
+  };
+  // must be called with scheduling_mutex held
+  launch = [&](size_t i) {
+    launched_count++;
+    workers_->run([&run_task, i]() { run_task(i); });
+  };
+
+  {
+    std::lock_guard<std::mutex> guard(scheduling_mutex);
+    for (auto i : c10::irange(exprs.size())) {
+      if (remaining_deps.at(i) == 0) {
+        launch(i);
+      }
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(scheduling_mutex);
+  all_done.wait(lock, [&]() { return done_count == launched_count; });
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+  NVF_ERROR(
+      done_count == exprs.size(),
+      "only ",
+      done_count,
+      " exprs out of ",
+      exprs.size(),
+      " were executed");
+}
+
+void PipelineExecutor::printTimings() const {
+  if (timings_.empty()) {
+    return;
+  }
+  auto origin = timings_.front().start;
+  for (const auto& timing : timings_) {
+    origin = std::min(origin, timing.start);
+  }
+  auto to_us = [&origin](std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(t - origin)
+        .count();
+  };
+  debug() << "Pipeline timeline on device " << runtime_.comm_.deviceId()
+          << " (us):" << std::endl;
+  for (const auto& timing : timings_) {
+    debug() << "  [" << to_us(timing.start) << ", " << to_us(timing.end)
+            << "] thread " << timing.thread << ": "
+            << timing.expr->toInlineString() << std::endl;
   }
-  val_to_IValue_[output_val] = (c10::IValue)(tensor[0]);
 }
 
 std::vector<at::Tensor> PipelineExecutor::runWithInput(
@@ -123,19 +502,67 @@ std::vector<at::Tensor> PipelineExecutor::runWithInput(
       inputs.size() == runtime_.pipeline_->inputs().size(),
       "Wrong number of inputs");
 
+  timings_.clear();
+  ready_events_.clear();
+  pending_works_.clear();
+
+  auto id_lookup = inputs_id_lookup_.lookupId(inputs);
+  if (id_lookup.eviction) {
+    plans_.erase(id_lookup.evict_id);
+    placeholders_.erase(id_lookup.evict_id);
+    stage_outputs_.erase(id_lookup.evict_id);
+  }
+  input_id_ = id_lookup.id;
+
   // process input values input values:
   for (auto input_idx : c10::irange(inputs.size())) {
     val_to_IValue_[runtime_.pipeline_->inputs().at(input_idx)] =
         inputs.at(input_idx);
   }
 
-  // Run through the stages to launch kernel
-  traverseTo(runtime_.pipeline_, runtime_.pipeline_->outputs());
+  if (isOptionDisabled(DisableOption::ParallelPipeline)) {
+    // Run through the stages to launch kernel
+    traverseTo(runtime_.pipeline_, runtime_.pipeline_->outputs());
+  } else {
+    runConcurrently();
+  }
 
-  // Collect global outputs from context
+  // The caller's stream waits for all the work of this run. This makes the
+  // outputs ready for the caller, and also orders the next run, which reuses
+  // the receive buffers, after this one.
+  auto stream = c10::cuda::getCurrentCUDAStream();
+  for (auto& [val, event] : ready_events_) {
+    event->block(stream);
+  }
+  for (auto& [val, works] : pending_works_) {
+    for (auto& work : works) {
+      work->wait();
+    }
+  }
+
+  // Collect global outputs from context. In concurrent mode, they were
+  // allocated on the workers' streams and are handed over to the caller's.
+  // The receive buffers and the placeholders are cached and overwritten by
+  // the next runs, so the caller gets a copy of them.
   std::vector<at::Tensor> outputs;
   for (auto output_val : runtime_.pipeline_->outputs()) {
     outputs.push_back(val_to_IValue_[output_val].toTensor());
+    Expr* def = output_val->definition();
+    if (def != nullptr &&
+        (def->isA<PipelineCommunication>() ||
+         !shouldRun(def->as<PipelineStage>()))) {
+      outputs.back() = outputs.back().clone();
+      continue;
+    }
+    if (!isOptionDisabled(DisableOption::ParallelPipeline) &&
+        outputs.back().is_cuda() && outputs.back().has_storage()) {
+      c10::cuda::CUDACachingAllocator::recordStream(
+          outputs.back().storage().data_ptr(), stream);
+    }
+  }
+
+  if (isDebugDumpEnabled(DebugDumpOption::PipelineTimeline)) {
+    printTimings();
   }
 
   return outputs;
@@ -8,17 +8,77 @@
 #ifdef USE_DISTRIBUTED
 #pragma once
 
+#include <ATen/cuda/CUDAEvent.h>
+#include <c10/core/thread_pool.h>
+#include <c10/cuda/CUDAStream.h>
 #include <exceptions.h>
 #include <iter_visitor.h>
 #include <kernel_cache.h>
+#include <multidevice/communication.h>
 #include <multidevice/pipeline_ir.h>
 #include <multidevice/runtime.h>
 
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <thread>
+
 namespace nvfuser {
 
+// Host timestamps of the execution of a PipelineStage or a
+// PipelineCommunication. For stages, the end timestamp is taken once the
+// kernels are enqueued. For communications, it is taken once the
+// communications are posted.
+//
+// In concurrent mode, the execution on the device is also bracketed by two
+// timing events recorded on the expr's stream, once its inputs are ready and
+// once its work is done. They can be compared with elapsed_time after the run
+// has completed. The stream of the expr and the inputs whose use was recorded
+// on it with the caching allocator are kept as well.
+struct PipelineExprTiming {
+  Expr* expr = nullptr;
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::time_point end;
+  std::thread::id thread;
+  std::shared_ptr<at::cuda::CUDAEvent> start_event;
+  std::shared_ptr<at::cuda::CUDAEvent> end_event;
+  std::optional<c10::cuda::CUDAStream> stream;
+  std::vector<Val*> recorded_inputs;
+};
+
+// Communications lowered from a PipelineCommunication for a given input
+// signature, together with their persistent receive buffer. The send buffers
+// are views of 'input'. When the data of a run is elsewhere, the
+// communications are rebuilt once with views at the same locations in it,
+// and kept for the next runs with data at that location.
+struct CommunicationPlan {
+  // Alias of the input the communications were lowered with
+  at::Tensor input;
+  // Persistent receive buffer
+  at::Tensor output;
+  std::vector<std::shared_ptr<Communication>> communications;
+  // Communications rebuilt for other locations of the input data, keyed by
+  // its data pointer
+  std::unordered_map<const void*, std::vector<std::shared_ptr<Communication>>>
+      bound_communications;
+};
+
 // Runtime Executor for Pipelines
 // This class inherits from IterVisitor because the execution
 // is ordered by the traversal of the Pipeline seen as a DAG
+//
+// By default, the PipelineStages and PipelineCommunications are executed
+// concurrently, as soon as their producers are done. Each of them runs on a
+// worker thread and enqueues its work on its own CUDA stream. The dependencies
+// are enforced by CUDA events for the stages and by the c10d::Work of the
+// communications. The communications are posted in the same order on all the
+// processes, as required by the process groups. The sequential traversal can
+// be recovered with NVFUSER_DISABLE=parallel_pipeline.
+//
+// The lowered communications, their receive buffers, the placeholders of
+// the stages that the current process does not run and the outputs of the
+// stages that it runs are cached per input signature, so that repeated runs
+// do no planning and no allocation besides the global outputs.
 class PipelineExecutor : public IterVisitor {
  public:
   explicit PipelineExecutor(MultiDeviceRuntime& runtime)
@@ -27,6 +87,11 @@ class PipelineExecutor : public IterVisitor {
   // Run the Pipelined Fusion with the given global inputs
   std::vector<at::Tensor> runWithInput(const std::vector<c10::IValue>& inputs);
 
+  // Returns the timestamps of the stages and communications of the last run
+  const std::vector<PipelineExprTiming>& timings() const {
+    return timings_;
+  }
+
  private:
   // Implement the execution of exprs of the Pipeline
   // Each PipelineStage will be compiled and executed on a GPU
@@ -36,9 +101,67 @@ class PipelineExecutor : public IterVisitor {
   void handle(PipelineStage* pipelineStage) override;
   void handle(PipelineCommunication* sr) override;
 
+  // Executes the exprs of the pipeline concurrently on worker threads
+  void runConcurrently();
+
+  // Runs a stage on the current stream
+  void runStage(PipelineStage* stage);
+
+  // Posts the communications lowered from a PipelineCommunication. Returns
+  // the pending Work that the consumers of the output need to wait for.
+  std::vector<c10::intrusive_ptr<c10d::Work>> postCommunication(
+      PipelineCommunication* c);
+
+  // Returns the cached plan of a communication for the current input
+  // signature, lowering it on the first call
+  CommunicationPlan& getCommunicationPlan(
+      PipelineCommunication* c,
+      const at::Tensor& input_tensor);
+
+  // Returns the communications of a plan that send from the data of
+  // input_tensor, rebuilding them on the first use of its location
+  const std::vector<std::shared_ptr<Communication>>& getBoundCommunications(
+      CommunicationPlan& plan,
+      const at::Tensor& input_tensor);
+
+  // Returns whether the outputs of a stage that the current process runs can
+  // be kept for the next runs, i.e., none of them is a global output
+  bool reusesOutputs(PipelineStage* stage);
+
+  // Returns the cached outputs of a stage that the current process does not
+  // run, allocating them on the first call
+  std::vector<at::Tensor> getPlaceholders(
+      PipelineStage* stage,
+      const std::vector<c10::IValue>& stage_inputs);
+
+  // Makes the current stream wait for the inputs of expr to be ready, and
+  // records their use on it so that the caching allocator does not reuse
+  // their memory before the current stream is done with them. Returns the
+  // inputs whose use was recorded.
+  std::vector<Val*> waitForInputs(Expr* expr);
+
   // Returns whether the current process should run the stage
   bool shouldRun(PipelineStage* stage);
 
+  // Returns the concrete value of a Val. Thread-safe.
+  c10::IValue getIValue(Val* val);
+
+  // Sets the concrete value of a Val. Thread-safe.
+  void setIValue(Val* val, c10::IValue value);
+
+  // Records the timing of an expr. Thread-safe.
+  void recordTiming(
+      Expr* expr,
+      std::chrono::steady_clock::time_point start,
+      std::chrono::steady_clock::time_point end,
+      std::shared_ptr<at::cuda::CUDAEvent> start_event = nullptr,
+      std::shared_ptr<at::cuda::CUDAEvent> end_event = nullptr,
+      std::optional<c10::cuda::CUDAStream> stream = std::nullopt,
+      std::vector<Val*> recorded_inputs = {});
+
+  // Prints the timings of the last run
+  void printTimings() const;
+
   // Stores concrete computed values,
   std::unordered_map<Val*, c10::IValue> val_to_IValue_;
 
@@ -48,6 +171,52 @@ class PipelineExecutor : public IterVisitor {
   // Cache results of shouldRun method
   std::unordered_map<PipelineStage*, bool> should_run_;
 
+  // In concurrent mode, stores the stream on which each expr is executed
+  std::unordered_map<Expr*, c10::cuda::CUDAStream> streams_;
+
+  // In concurrent mode, stores the event recorded once a Val is produced on
+  // the stream of its definition. The global inputs are associated with an
+  // event recorded on the caller's stream.
+  std::unordered_map<Val*, std::shared_ptr<at::cuda::CUDAEvent>> ready_events_;
+
+  // In concurrent mode, stores the communications' Work to wait for before
+  // reading a Val
+  std::unordered_map<Val*, std::vector<c10::intrusive_ptr<c10d::Work>>>
+      pending_works_;
+
+  // Encodes the signature of the global inputs into an id
+  InputsIdLookup inputs_id_lookup_;
+
+  // Id of the signature of the current run's global inputs
+  size_t input_id_ = 0;
+
+  // Cached communication plans, per input id
+  std::unordered_map<
+      size_t,
+      std::unordered_map<PipelineCommunication*, CommunicationPlan>>
+      plans_;
+
+  // Cached outputs of the stages that are not run, per input id
+  std::unordered_map<
+      size_t,
+      std::unordered_map<PipelineStage*, std::vector<at::Tensor>>>
+      placeholders_;
+
+  // Cached outputs of the stages that are run and reuse them, per input id
+  std::unordered_map<
+      size_t,
+      std::unordered_map<PipelineStage*, std::vector<at::Tensor>>>
+      stage_outputs_;
+
+  // Worker threads of the concurrent mode, sized to the number of exprs
+  std::unique_ptr<c10::ThreadPool> workers_;
+
+  // Timestamps of the last run
+  std::vector<PipelineExprTiming> timings_;
+
+  // Protects the members accessed from the worker threads
+  std::mutex mutex_;
+
   // MultiDeviceRuntime to be executed
   MultiDeviceRuntime& runtime_;
 };
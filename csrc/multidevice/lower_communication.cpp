@@ -95,6 +95,29 @@ CommParams createParamsForGatherScatter(
   return params;
 }
 
+// Returns the sender which shares a node with the largest number of receivers.
+// Ties are broken by the order of the sender mesh.
+DeviceIdxType chooseRoot(
+    const DeviceMesh& sender_mesh,
+    const DeviceMesh& receiver_mesh,
+    const DeviceTopology& topology) {
+  DeviceIdxType root = sender_mesh.vector().at(0);
+  int64_t max_local_receivers = -1;
+  for (auto sender : sender_mesh.vector()) {
+    int64_t local_receivers = std::count_if(
+        receiver_mesh.vector().begin(),
+        receiver_mesh.vector().end(),
+        [&](DeviceIdxType receiver) {
+          return topology.isSameNode(sender, receiver);
+        });
+    if (local_receivers > max_local_receivers) {
+      max_local_receivers = local_receivers;
+      root = sender;
+    }
+  }
+  return root;
+}
+
 // Adds one or zero Scatter communication to the vector 'comms'
 void lowerToScatter(
     DeviceIdxType my_device_index,
@@ -102,9 +125,9 @@ void lowerToScatter(
     const DeviceMesh& receiver_mesh,
     at::Tensor input_tensor,
     at::Tensor output_tensor,
+    const DeviceTopology& topology,
     std::vector<std::shared_ptr<Communication>>& comms) {
-  // we arbitrarily choose the first device of the sender mesh to be the root
-  auto root = sender_mesh.vector().at(0);
+  auto root = chooseRoot(sender_mesh, receiver_mesh, topology);
   if (!isDeviceInvolved(my_device_index, root, receiver_mesh)) {
     return;
   }
@@ -137,17 +160,150 @@ void lowerToGather(
   }
 }
 
-// Add one or zero Allgather communication to the vector 'comms'
+// Forward declaration, see below
+void lowerToBroadcastOrP2P(
+    DeviceIdxType my_device_index,
+    DeviceIdxType root,
+    const DeviceMesh& mesh,
+    at::Tensor input_tensor,
+    at::Tensor output_tensor,
+    std::vector<std::shared_ptr<Communication>>& comms);
+
+// Returns whether the devices of each node group are contiguous in the mesh,
+// so that the slices of a node form one block of the gathered tensor
+bool areNodeGroupsContiguous(
+    const DeviceMesh& mesh,
+    const std::vector<Team>& node_groups) {
+  return std::all_of(
+      node_groups.begin(), node_groups.end(), [&mesh](const Team& group) {
+        auto start = mesh.findIndex(group.at(0));
+        for (auto i : c10::irange(group.size())) {
+          if (mesh.vector().at(start + i) != group.at(i)) {
+            return false;
+          }
+        }
+        return true;
+      });
+}
+
+/*
+Adds the Communications of an Allgather spanning several nodes, decomposed into
+three steps so that the data of a node crosses the network only once per
+other node:
+1) an Allgather among the devices of each node,
+2) a Broadcast of the block of slices of each node from its leader to the
+   leaders of the other nodes,
+3) a Broadcast of each block received at step 2) from each leader to the
+   other devices of its node.
+The leader of a node is its first device in the mesh. The devices of each node
+must be contiguous in the mesh, see areNodeGroupsContiguous.
+*/
+void lowerToHierarchicalAllgather(
+    DeviceIdxType my_device_index,
+    const DeviceMesh& mesh,
+    const std::vector<Team>& node_groups,
+    at::Tensor input_tensor,
+    at::Tensor output_tensor,
+    std::vector<std::shared_ptr<Communication>>& comms) {
+  auto slice = [&mesh](at::Tensor tensor, DeviceIdxType device) {
+    return tensor.index({static_cast<int>(mesh.findIndex(device)), "..."});
+  };
+  // The slices of the devices of a node, as a view of the output
+  auto block = [&mesh, &output_tensor](const Team& group) {
+    return output_tensor.narrow(
+        0, mesh.findIndex(group.at(0)), (int64_t)group.size());
+  };
+
+  // 1) intra-node allgather
+  for (const auto& group : node_groups) {
+    if (group.size() == 1) {
+      auto device = group.at(0);
+      lowerToBroadcastOrP2P(
+          my_device_index,
+          device,
+          DeviceMesh({device}),
+          slice(input_tensor, device),
+          slice(output_tensor, device),
+          comms);
+      continue;
+    }
+    if (std::find(group.begin(), group.end(), my_device_index) ==
+        group.end()) {
+      continue;
+    }
+    CommParams params;
+    params.team = group;
+    for (auto device : group) {
+      params.dst_bufs.push_back(slice(output_tensor, device));
+    }
+    params.src_bufs = {slice(input_tensor, my_device_index)};
+    comms.push_back(std::make_shared<Allgather>(std::move(params)));
+  }
+
+  // 2) inter-node exchange between the leaders
+  for (const auto& group : node_groups) {
+    Team other_leaders;
+    for (const auto& other_group : node_groups) {
+      if (other_group.at(0) != group.at(0)) {
+        other_leaders.push_back(other_group.at(0));
+      }
+    }
+    lowerToBroadcastOrP2P(
+        my_device_index,
+        group.at(0),
+        DeviceMesh(other_leaders),
+        block(group),
+        block(group),
+        comms);
+  }
+
+  // 3) intra-node broadcast of the slices coming from the other nodes
+  for (const auto& group : node_groups) {
+    if (group.size() == 1) {
+      continue;
+    }
+    DeviceMesh peers(Team(group.begin() + 1, group.end()));
+    for (const auto& other_group : node_groups) {
+      if (other_group.at(0) == group.at(0)) {
+        continue;
+      }
+      lowerToBroadcastOrP2P(
+          my_device_index,
+          group.at(0),
+          peers,
+          block(other_group),
+          block(other_group),
+          comms);
+    }
+  }
+}
+
+// Add one or several Allgather communications to the vector 'comms'
 void lowerToAllgather(
     DeviceIdxType my_device_index,
     const DeviceMesh& mesh,
     at::Tensor input_tensor,
     at::Tensor output_tensor,
+    const DeviceTopology& topology,
     std::vector<std::shared_ptr<Communication>>& comms) {
   if (!mesh.has(my_device_index)) {
     return;
   }
 
+  // The hierarchical decomposition only pays off if the mesh spans several
+  // nodes, one of them holding at least two devices
+  auto node_groups = topology.groupByNode(mesh.vector());
+  if (node_groups.size() > 1 &&
+      std::any_of(
+          node_groups.begin(),
+          node_groups.end(),
+          [](const Team& g) { return g.size() > 1; }) &&
+      areNodeGroupsContiguous(mesh, node_groups)) {
+    lowerToHierarchicalAllgather(
+        my_device_index, mesh, node_groups, input_tensor, output_tensor, comms);
+    return;
+  }
+
   CommParams params;
   params.team = mesh.vector();
   for (auto i : c10::irange(mesh.vector().size())) {
@@ -206,6 +362,65 @@ void lowerToBroadcastOrP2P(
   comms.push_back(comm);
 }
 
+/*
+Adds the Broadcast or Send/Recv communications transferring the data of 'root'
+to the 'receivers'. The data crosses the network once per remote node, towards
+the first receiver of that node (its "leader"), which then forwards it to the
+other receivers of its node. The receivers on the root's node are served
+directly by the root.
+*/
+void lowerToHierarchicalBroadcast(
+    DeviceIdxType my_device_index,
+    DeviceIdxType root,
+    const Team& receivers,
+    const DeviceTopology& topology,
+    at::Tensor input_tensor,
+    at::Tensor output_tensor,
+    std::vector<std::shared_ptr<Communication>>& comms) {
+  Team local_receivers;
+  Team leaders;
+  std::vector<Team> remote_groups;
+  for (auto& group : topology.groupByNode(receivers)) {
+    if (topology.isSameNode(root, group.at(0))) {
+      local_receivers = std::move(group);
+    } else {
+      leaders.push_back(group.at(0));
+      remote_groups.push_back(std::move(group));
+    }
+  }
+
+  if (!leaders.empty()) {
+    lowerToBroadcastOrP2P(
+        my_device_index,
+        root,
+        DeviceMesh(leaders),
+        input_tensor,
+        output_tensor,
+        comms);
+  }
+  if (!local_receivers.empty()) {
+    lowerToBroadcastOrP2P(
+        my_device_index,
+        root,
+        DeviceMesh(local_receivers),
+        input_tensor,
+        output_tensor,
+        comms);
+  }
+  for (const auto& group : remote_groups) {
+    if (group.size() == 1) {
+      continue;
+    }
+    lowerToBroadcastOrP2P(
+        my_device_index,
+        group.at(0),
+        DeviceMesh(Team(group.begin() + 1, group.end())),
+        output_tensor,
+        output_tensor,
+        comms);
+  }
+}
+
 // Adds several Broadcast or Send/Recv communications to the vector 'comms'
 // For now, we assume that this function is called only if
 // the input and output have the same parallelization (given by
@@ -217,6 +432,7 @@ void lowerToBroadcastOrP2P(
     at::Tensor input_tensor,
     at::Tensor output_tensor,
     bool is_parallelized,
+    const DeviceTopology& topology,
     std::vector<std::shared_ptr<Communication>>& comms) {
   if (is_parallelized) {
     // if the inputs and ouputs are parallelized,
@@ -234,33 +450,100 @@ void lowerToBroadcastOrP2P(
           comms);
     }
   } else {
-    // we arbitrarily choose the first device of the sender mesh to be the root
-    lowerToBroadcastOrP2P(
-        my_device_index,
-        sender_mesh.vector().at(0),
-        receiver_mesh,
-        input_tensor,
-        output_tensor,
-        comms);
+    // the data is replicated on all the senders, so each receiver can fetch
+    // it from the closest one
+    for (const auto& assignment : assignReceiversToSenders(
+             sender_mesh.vector(), receiver_mesh.vector(), topology)) {
+      lowerToHierarchicalBroadcast(
+          my_device_index,
+          assignment.sender,
+          assignment.receivers,
+          topology,
+          input_tensor,
+          output_tensor,
+          comms);
+    }
   }
 }
 
 } // namespace
 
+std::vector<SenderAssignment> assignReceiversToSenders(
+    const Team& senders,
+    const Team& receivers,
+    const DeviceTopology& topology) {
+  NVF_ERROR(!senders.empty(), "there must be at least one sender");
+  std::vector<Team> assigned(senders.size());
+  // number of transfers issued by each sender, local copies excluded
+  std::vector<int64_t> load(senders.size(), 0);
+
+  auto least_loaded = [&](const std::vector<size_t>& candidates) {
+    return *std::min_element(
+        candidates.begin(), candidates.end(), [&](size_t a, size_t b) {
+          return load.at(a) < load.at(b);
+        });
+  };
+
+  // Receivers which share no node with any sender
+  Team remote_receivers;
+  for (auto receiver : receivers) {
+    auto self_it = std::find(senders.begin(), senders.end(), receiver);
+    if (self_it != senders.end()) {
+      assigned.at(std::distance(senders.begin(), self_it)).push_back(receiver);
+      continue;
+    }
+    auto best_level = TopologyLevel::Network;
+    std::vector<size_t> candidates;
+    for (auto i : c10::irange(senders.size())) {
+      auto level = topology.level(senders.at(i), receiver);
+      if (level < best_level) {
+        best_level = level;
+        candidates.clear();
+      }
+      if (level == best_level) {
+        candidates.push_back(i);
+      }
+    }
+    if (best_level == TopologyLevel::Network) {
+      remote_receivers.push_back(receiver);
+      continue;
+    }
+    auto chosen = least_loaded(candidates);
+    assigned.at(chosen).push_back(receiver);
+    load.at(chosen)++;
+  }
+
+  // Receivers on nodes without any sender. They are served together so that
+  // the data enters their node only once.
+  std::vector<size_t> all_senders(senders.size());
+  std::iota(all_senders.begin(), all_senders.end(), 0);
+  for (const auto& group : topology.groupByNode(remote_receivers)) {
+    auto chosen = least_loaded(all_senders);
+    auto& team = assigned.at(chosen);
+    team.insert(team.end(), group.begin(), group.end());
+    load.at(chosen)++;
+  }
+
+  std::vector<SenderAssignment> assignments;
+  for (auto i : c10::irange(senders.size())) {
+    if (!assigned.at(i).empty()) {
+      assignments.push_back({senders.at(i), std::move(assigned.at(i))});
+    }
+  }
+  return assignments;
+}
+
 /*
 TODO:
 *) Propose several lowering paths for each given communication
    and provide a logic to decide which path to take
-*) Leverage replication in the source to create several communications handled
-   in parallel. The idea would be to evenly split the destinations accross the
-   sources
-*) Leverage the topology to ensure that the senders and recerivers are close
 */
 std::vector<std::shared_ptr<Communication>> lowerCommunication(
     DeviceIdxType my_device_index,
     PipelineCommunication* c,
     at::Tensor input_tensor,
-    at::Tensor output_tensor) {
+    at::Tensor output_tensor,
+    const DeviceTopology& topology) {
   std::vector<std::shared_ptr<Communication>> comms;
   TensorView* input_tv =
       c->in()->as<PipelineVal>()->getOriginalVal()->as<TensorView>();
@@ -307,11 +590,17 @@ std::vector<std::shared_ptr<Communication>> lowerCommunication(
         receiver_mesh,
         input_tensor,
         output_tensor,
+        topology,
         comms);
   } else if (is_input_parallel_d && !is_output_parallel_d) {
     if (receiver_mesh.vector() == sender_mesh.vector()) {
       lowerToAllgather(
-          my_device_index, sender_mesh, input_tensor, output_tensor, comms);
+          my_device_index,
+          sender_mesh,
+          input_tensor,
+          output_tensor,
+          topology,
+          comms);
     } else {
       lowerToGather(
           my_device_index,
@@ -329,6 +618,7 @@ std::vector<std::shared_ptr<Communication>> lowerCommunication(
         input_tensor,
         output_tensor,
         is_input_parallel_d,
+        topology,
         comms);
   }
   return comms;
@@ -11,16 +11,38 @@
 #include <multidevice/communication.h>
 #include <multidevice/multidevice.h>
 #include <multidevice/pipeline_ir.h>
+#include <multidevice/topology.h>
 
 namespace nvfuser {
 
+// Describes a set of receivers fetching a replicated data from the same sender
+struct SenderAssignment {
+  DeviceIdxType sender = 0;
+  Team receivers;
+};
+
+// Assigns each receiver to one of the senders, all of them holding a replica
+// of the data. A receiver which is also a sender is assigned to itself. The
+// other receivers are assigned to the closest sender in the topology, ties
+// being broken by balancing the load among the senders. Receivers of a node
+// holding no sender are assigned together to the same sender so that the data
+// only crosses the network once per node. Senders with no receiver are
+// omitted from the result.
+std::vector<SenderAssignment> assignReceiversToSenders(
+    const Team& senders,
+    const Team& receivers,
+    const DeviceTopology& topology);
+
 // Lower a PipelineCommunication into a series of Communication, given a
-// device_index.
+// device_index. The topology is used to choose the sources of the transfers
+// and to build hierarchical (node-aware) broadcast and allgather trees.
+// The returned Communications must be posted in order.
 std::vector<std::shared_ptr<Communication>> lowerCommunication(
     DeviceIdxType device_index,
     PipelineCommunication* c,
     at::Tensor input_tensor,
-    at::Tensor output_tensor);
+    at::Tensor output_tensor,
+    const DeviceTopology& topology = DeviceTopology());
 
 } // namespace nvfuser
 
@@ -15,10 +15,21 @@
 
 namespace nvfuser {
 
+MultiDeviceRuntime::MultiDeviceRuntime(Pipeline* pipeline, Communicator& comm)
+    : pipeline_(pipeline), comm_(comm) {
+  validate();
+  executor_ = std::make_unique<PipelineExecutor>(*this);
+}
+
+MultiDeviceRuntime::~MultiDeviceRuntime() = default;
+
 std::vector<at::Tensor> MultiDeviceRuntime::runWithInput(
     std::vector<c10::IValue> inputs) {
-  PipelineExecutor executor(*this);
-  return executor.runWithInput(inputs);
+  return executor_->runWithInput(inputs);
+}
+
+const std::vector<PipelineExprTiming>& MultiDeviceRuntime::timings() const {
+  return executor_->timings();
 }
 
 void MultiDeviceRuntime::validate() const {
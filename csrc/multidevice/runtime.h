@@ -16,6 +16,9 @@
 
 namespace nvfuser {
 
+class PipelineExecutor;
+struct PipelineExprTiming;
+
 /*
   The MultiDeviceRuntime class gather all what is needed for executing a
   Pipeline on a multi-device setting. It is instantiated from a Pipeline and a
@@ -24,14 +27,17 @@ namespace nvfuser {
 */
 class MultiDeviceRuntime {
  public:
-  explicit MultiDeviceRuntime(Pipeline* pipeline, Communicator& comm)
-      : pipeline_(pipeline), comm_(comm) {
-    validate();
-  }
+  explicit MultiDeviceRuntime(Pipeline* pipeline, Communicator& comm);
+
+  ~MultiDeviceRuntime();
 
   // Run the multidevice fusion with the given global inputs
   std::vector<at::Tensor> runWithInput(std::vector<c10::IValue> inputs);
 
+  // Returns the host timestamps of the stages and communications executed by
+  // the last call to runWithInput
+  const std::vector<PipelineExprTiming>& timings() const;
+
   // Returns the Communicator
   auto& comm() {
     return comm_;
@@ -50,6 +56,9 @@ class MultiDeviceRuntime {
 
   Pipeline* pipeline_;
   Communicator& comm_;
+  // The executor is kept across runs so that the compiled stages, the
+  // streams and the worker threads are reused
+  std::unique_ptr<PipelineExecutor> executor_;
 };
 
 } // namespace nvfuser
@@ -0,0 +1,141 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <multidevice/topology.h>
+#include <utils.h>
+
+#include <sstream>
+
+namespace nvfuser {
+
+namespace {
+
+std::vector<std::string> split(const std::string& str, char delimiter) {
+  std::vector<std::string> tokens;
+  std::stringstream ss(str);
+  std::string token;
+  while (std::getline(ss, token, delimiter)) {
+    tokens.push_back(token);
+  }
+  return tokens;
+}
+
+} // namespace
+
+DeviceTopology DeviceTopology::fromString(const std::string& description) {
+  DeviceTopology topology;
+  auto entries = split(description, ';');
+  for (auto device : c10::irange(entries.size())) {
+    auto fields = split(entries.at(device), ':');
+    NVF_CHECK(
+        !fields.empty() && fields.size() <= 3,
+        "invalid topology entry \"",
+        entries.at(device),
+        "\" for device ",
+        device,
+        ", expected \"node[:socket[:island]]\"");
+    DeviceLocation location;
+    try {
+      location.node = std::stoll(fields.at(0));
+      location.socket = fields.size() > 1 ? std::stoll(fields.at(1)) : 0;
+      location.island = fields.size() > 2 ? std::stoll(fields.at(2)) : 0;
+    } catch (const std::logic_error&) {
+      NVF_CHECK(
+          false,
+          "invalid topology entry \"",
+          entries.at(device),
+          "\" for device ",
+          device);
+    }
+    topology.setLocation((DeviceIdxType)device, location);
+  }
+  return topology;
+}
+
+DeviceTopology DeviceTopology::fromEnv(int64_t size, int64_t local_size) {
+  if (auto env = getNvFuserEnv("DEVICE_TOPOLOGY")) {
+    return fromString(env);
+  }
+  DeviceTopology topology;
+  if (local_size <= 0 || local_size >= size) {
+    return topology;
+  }
+  for (auto device : c10::irange(size)) {
+    topology.setLocation(
+        (DeviceIdxType)device,
+        {.node = device / local_size, .socket = 0, .island = 0});
+  }
+  return topology;
+}
+
+DeviceLocation DeviceTopology::location(DeviceIdxType device) const {
+  if (is_flat_) {
+    return {};
+  }
+  auto it = locations_.find(device);
+  if (it == locations_.end()) {
+    // unknown devices are each considered on their own node
+    return {.node = -1 - device, .socket = 0, .island = 0};
+  }
+  return it->second;
+}
+
+TopologyLevel DeviceTopology::level(DeviceIdxType a, DeviceIdxType b) const {
+  if (a == b) {
+    return TopologyLevel::Self;
+  }
+  auto loc_a = location(a);
+  auto loc_b = location(b);
+  if (loc_a.node != loc_b.node) {
+    return TopologyLevel::Network;
+  }
+  if (loc_a.socket != loc_b.socket) {
+    return TopologyLevel::Node;
+  }
+  if (loc_a.island != loc_b.island) {
+    return TopologyLevel::Socket;
+  }
+  return TopologyLevel::NVLinkIsland;
+}
+
+std::vector<Team> DeviceTopology::groupByNode(const Team& team) const {
+  std::vector<Team> groups;
+  std::unordered_map<int64_t, size_t> node_to_group;
+  for (auto device : team) {
+    auto node = location(device).node;
+    auto it = node_to_group.find(node);
+    if (it == node_to_group.end()) {
+      node_to_group.emplace(node, groups.size());
+      groups.push_back({device});
+    } else {
+      groups.at(it->second).push_back(device);
+    }
+  }
+  return groups;
+}
+
+std::string DeviceTopology::toString() const {
+  if (is_flat_) {
+    return "DeviceTopology{flat}";
+  }
+  std::vector<DeviceIdxType> devices;
+  for (auto& [device, _] : locations_) {
+    devices.push_back(device);
+  }
+  std::sort(devices.begin(), devices.end());
+  std::stringstream ss;
+  ss << "DeviceTopology{";
+  for (auto device : devices) {
+    const auto& loc = locations_.at(device);
+    ss << device << "->" << loc.node << ":" << loc.socket << ":" << loc.island
+       << (device == devices.back() ? "" : ", ");
+  }
+  ss << "}";
+  return ss.str();
+}
+
+} // namespace nvfuser
@@ -0,0 +1,88 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <multidevice/multidevice.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nvfuser {
+
+/*
+   The class DeviceTopology describes how the devices are physically grouped,
+   so that the communication lowering can keep the traffic on the fastest
+   links. Each device is located by a triple (node, socket, nvlink island):
+   two devices are "close" if they share an nvlink island, a bit farther if
+   they share a socket, and farther still if they only share a node. Devices
+   on different nodes communicate through the network, which is what we try to
+   avoid.
+
+   The socket and island identifiers are relative to the node, i.e., socket 0
+   of node 0 and socket 0 of node 1 are different sockets.
+
+   A topology can be built programmatically, parsed from a string, or read
+   from the environment variable NVFUSER_DEVICE_TOPOLOGY. The string format
+   lists the devices in increasing device index order, separated by ';', each
+   entry being "node[:socket[:island]]". For example, two nodes of two GPUs:
+     NVFUSER_DEVICE_TOPOLOGY="0:0:0;0:0:0;1:0:0;1:0:0"
+   Devices that are not described are considered to be each on their own node.
+*/
+
+// Ordered from the closest to the farthest
+enum class TopologyLevel { Self, NVLinkIsland, Socket, Node, Network };
+
+struct DeviceLocation {
+  int64_t node = 0;
+  int64_t socket = 0;
+  int64_t island = 0;
+};
+
+class DeviceTopology {
+ public:
+  // Builds a topology where every device is on the same node, socket and
+  // island. This is the behavior of the lowering when no topology is known.
+  DeviceTopology() = default;
+
+  // Parses a topology from the format described above
+  static DeviceTopology fromString(const std::string& description);
+
+  // Reads NVFUSER_DEVICE_TOPOLOGY if it is set. Otherwise, assumes that the
+  // ranks are placed by contiguous blocks of local_size on each node.
+  static DeviceTopology fromEnv(int64_t size, int64_t local_size);
+
+  void setLocation(DeviceIdxType device, DeviceLocation location) {
+    is_flat_ = false;
+    locations_[device] = location;
+  }
+
+  DeviceLocation location(DeviceIdxType device) const;
+
+  // returns the level at which the two devices are connected
+  TopologyLevel level(DeviceIdxType a, DeviceIdxType b) const;
+
+  bool isSameNode(DeviceIdxType a, DeviceIdxType b) const {
+    return level(a, b) < TopologyLevel::Network;
+  }
+
+  // Splits a team into groups of devices sharing the same node. The groups
+  // are ordered by their first appearance in the team, and the relative order
+  // of the devices within each group is preserved.
+  std::vector<Team> groupByNode(const Team& team) const;
+
+  std::string toString() const;
+
+ private:
+  // if true, all the devices are considered at the same location
+  bool is_flat_ = true;
+  std::unordered_map<DeviceIdxType, DeviceLocation> locations_;
+};
+
+} // namespace nvfuser
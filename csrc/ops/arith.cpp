@@ -1388,6 +1388,93 @@ TensorView* min(
   return reductionOp(BinaryOpType::Min, axes, init, v1, keep_dim);
 }
 
+TensorView* scanOp(
+    BinaryOpType scan_op_type,
+    int64_t dim,
+    Val* init,
+    TensorView* v1,
+    bool is_exclusive) {
+  NVF_CHECK(
+      init->isConstScalar(),
+      "Cannot create a scan operation where the initial value is not a const scalar.");
+
+  const auto ndims =
+      (int64_t)TensorDomain::noReductions(v1->getMaybeRFactorDomain()).size();
+  if (dim < 0) {
+    dim += ndims;
+  }
+  NVF_CHECK(
+      dim >= 0 && dim < ndims,
+      "Scan on invalid axis, received: ",
+      dim,
+      " however tensor view only has ",
+      ndims,
+      " non-reduction dims.");
+
+  const auto dtype = v1->getDataType().value();
+  if (init->getDataType().value() != dtype) {
+    init = castOp(dtype, init);
+  }
+
+  auto out = ops::newValLike(v1, dtype)->as<TensorView>();
+  IrBuilder::create<ScanOp>(scan_op_type, init, out, v1, dim, is_exclusive);
+  return out;
+}
+
+TensorView* cumsum(
+    TensorView* v1,
+    int64_t dim,
+    bool is_exclusive /*=false*/,
+    DataType dtype /* DataType::Null */) {
+  if (dtype == DataType::Null) {
+    auto initial_v1_dtype = v1->getDataType().value();
+    if (isBooleanType(initial_v1_dtype) || isIntegralType(initial_v1_dtype)) {
+      dtype = DataType::Int;
+    }
+  }
+
+  // Cast input tensor to dtype before the operation is performed
+  if (dtype != DataType::Null) {
+    v1 = optionalCastStrict(dtype, v1)->as<TensorView>();
+  }
+
+  auto init = FusionGuard::getCurFusion()->zeroVal(v1->getDataType().value());
+  return scanOp(BinaryOpType::Add, dim, init, v1, is_exclusive);
+}
+
+TensorView* cumprod(
+    TensorView* v1,
+    int64_t dim,
+    bool is_exclusive /*=false*/,
+    DataType dtype /* DataType::Null */) {
+  if (dtype == DataType::Null) {
+    auto initial_v1_dtype = v1->getDataType().value();
+    if (isBooleanType(initial_v1_dtype) || isIntegralType(initial_v1_dtype)) {
+      dtype = DataType::Int;
+    }
+  }
+
+  // Cast input tensor to dtype before the operation is performed
+  if (dtype != DataType::Null) {
+    v1 = optionalCastStrict(dtype, v1)->as<TensorView>();
+  }
+
+  auto init = FusionGuard::getCurFusion()->oneVal(v1->getDataType().value());
+  return scanOp(BinaryOpType::Mul, dim, init, v1, is_exclusive);
+}
+
+TensorView* cummax(TensorView* v1, int64_t dim, bool is_exclusive /*=false*/) {
+  Val* init = ops::getMinimumValue(v1->getDataType().value());
+  NVF_CHECK(init != nullptr, "Missing initial value");
+  return scanOp(BinaryOpType::Max, dim, init, v1, is_exclusive);
+}
+
+TensorView* cummin(TensorView* v1, int64_t dim, bool is_exclusive /*=false*/) {
+  Val* init = ops::getMaximumValue(v1->getDataType().value());
+  NVF_CHECK(init != nullptr, "Missing initial value");
+  return scanOp(BinaryOpType::Min, dim, init, v1, is_exclusive);
+}
+
 TensorView* broadcast(
     TensorView* inp,
     const std::vector<bool>& is_broadcast_dim) {
@@ -584,6 +584,33 @@ TensorView* min(
     bool keep_dim = false,
     DataType dtype = DataType::Null);
 
+// SCAN OPERATIONS
+// Perform an inclusive or exclusive prefix scan of v1 along dim with the
+// binary operation scan_op_type starting from init. The output has the same
+// shape as v1.
+TensorView* scanOp(
+    BinaryOpType scan_op_type,
+    int64_t dim,
+    Val* init,
+    TensorView* v1,
+    bool is_exclusive = false);
+
+TensorView* cumsum(
+    TensorView* v1,
+    int64_t dim,
+    bool is_exclusive = false,
+    DataType dtype = DataType::Null);
+
+TensorView* cumprod(
+    TensorView* v1,
+    int64_t dim,
+    bool is_exclusive = false,
+    DataType dtype = DataType::Null);
+
+TensorView* cummax(TensorView* v1, int64_t dim, bool is_exclusive = false);
+
+TensorView* cummin(TensorView* v1, int64_t dim, bool is_exclusive = false);
+
 // COMPOUND OPERATIONS
 // add_alpha
 Val* add_alpha(Val* v1, Val* v2, Val* s);
@@ -6,8 +6,10 @@
  */
 // clang-format on
 #include <ATen/cuda/CUDAContext.h>
+#include <c10/util/irange.h>
 #include <ir/builder.h>
 #include <ops/all_ops.h>
+#include <ops/utils.h>
 #include <transform_view.h>
 
 namespace nvfuser {
@@ -278,4 +280,192 @@ TensorView* view_as_real(TensorView* x) {
   return viewAsScalar(tv_vector);
 }
 
+namespace {
+
+int64_t wrapReductionDim(TensorView* x, int64_t dim) {
+  const auto ndims =
+      (int64_t)TensorDomain::noReductions(x->getMaybeRFactorDomain()).size();
+  if (dim < 0) {
+    dim += ndims;
+  }
+  NVF_CHECK(
+      dim >= 0 && dim < ndims,
+      "Reduction on invalid axis, received: ",
+      dim,
+      " however tensor view only has ",
+      ndims,
+      " non-reduction dims.");
+  return dim;
+}
+
+// Broadcast flags of all the axes but dim
+std::vector<bool> broadcastFlagsExcept(TensorView* x, int64_t dim) {
+  std::vector<bool> flags(
+      TensorDomain::noReductions(x->getMaybeRFactorDomain()).size(), true);
+  flags.at(dim) = false;
+  return flags;
+}
+
+// Indices along dim broadcast to the shape of x
+TensorView* indicesAlong(TensorView* x, int64_t dim) {
+  auto extent =
+      TensorDomain::noReductions(x->getMaybeRFactorDomain()).at(dim)->extent();
+  return broadcast(iota(extent), broadcastFlagsExcept(x, dim));
+}
+
+// Flips the magnitude bits of negative Int32 values. Applied to the bit
+// pattern of a float, the result has the same signed order as the float,
+// i.e., -inf < ... < -0 < 0 < ... < inf. The mapping is its own inverse.
+TensorView* flipNegativeMagnitude(TensorView* bits) {
+  auto flipped = bitwise_xor(
+      bits, IrBuilder::create<Val>(0x7FFFFFFFL, DataType::Int32));
+  auto is_negative = lt(bits, IrBuilder::create<Val>(0L, DataType::Int32));
+  return where(is_negative, flipped, bits);
+}
+
+// Int32 key whose order matches the order of x
+TensorView* toOrderedKey(TensorView* x) {
+  if (!isFloatingPointType(x->dtype())) {
+    return castOp(DataType::Int32, x);
+  }
+  auto bits = bitCastOp(DataType::Int32, maybeCastOp(DataType::Float, x));
+  return flipNegativeMagnitude(bits);
+}
+
+TensorView* fromOrderedKey(TensorView* key, DataType dtype) {
+  if (!isFloatingPointType(dtype)) {
+    return castOp(dtype, key);
+  }
+  auto value = bitCastOp(DataType::Float, flipNegativeMagnitude(key));
+  return maybeCastOp(dtype, value);
+}
+
+constexpr int64_t kIndexMask = 0xFFFFFFFFL;
+
+// Packs the key into the upper 32 bits and the index into the lower 32
+// bits. The index is stored such that the max or min of the packed values
+// picks the smallest index among equal keys.
+TensorView* packKeyAndIndex(TensorView* key, TensorView* index, bool largest) {
+  auto upper =
+      mul(castOp(DataType::Int, key), IrBuilder::create<Val>(kIndexMask + 1));
+  auto lower =
+      largest ? sub(IrBuilder::create<Val>(kIndexMask), index) : index;
+  return add(upper, lower);
+}
+
+ValuesAndIndices unpackKeyAndIndex(
+    TensorView* packed,
+    bool largest,
+    DataType dtype) {
+  auto lower = bitwise_and(packed, IrBuilder::create<Val>(kIndexMask));
+  auto index =
+      largest ? sub(IrBuilder::create<Val>(kIndexMask), lower) : lower;
+  auto key = castOp(
+      DataType::Int32,
+      bitwise_right_shift(packed, IrBuilder::create<Val>(32L)));
+  return {fromOrderedKey(key, dtype), index};
+}
+
+bool canPackKeyAndIndex(TensorView* x) {
+  return dataTypeSize(x->dtype()) <= 4;
+}
+
+TensorView* maxOrMin(
+    TensorView* x,
+    int64_t dim,
+    bool keep_dim,
+    bool largest) {
+  return largest ? max(x, {(int)dim}, keep_dim) : min(x, {(int)dim}, keep_dim);
+}
+
+ValuesAndIndices reduceWithIndex(
+    TensorView* x,
+    int64_t dim,
+    bool keep_dim,
+    bool largest) {
+  NVF_CHECK(
+      !isComplexType(x->dtype()),
+      "Complex values are not ordered: ",
+      x->toString());
+  dim = wrapReductionDim(x, dim);
+  auto index = indicesAlong(x, dim);
+
+  if (canPackKeyAndIndex(x)) {
+    auto packed = packKeyAndIndex(toOrderedKey(x), index, largest);
+    return unpackKeyAndIndex(
+        maxOrMin(packed, dim, keep_dim, largest), largest, x->dtype());
+  }
+
+  // 64-bit values don't fit in the packed Int along with the index, so the
+  // smallest index of the max or min is found by a second reduction
+  auto values = maxOrMin(x, dim, false, largest);
+  auto values_bcast = broadcast(values, broadcastFlagsExcept(x, dim));
+  auto extent = castOp(
+      DataType::Int,
+      TensorDomain::noReductions(x->getMaybeRFactorDomain()).at(dim)->extent());
+  // A NaN is the max and the min of the values it is reduced with, and
+  // doesn't compare equal to itself
+  auto matches = eq(x, values_bcast);
+  if (isFloatingPointType(x->dtype())) {
+    matches = logical_or(matches, logical_and(isnan(x), isnan(values_bcast)));
+  }
+  auto indices = min(where(matches, index, extent), {(int)dim}, keep_dim);
+  return {keep_dim ? values_bcast : values, indices};
+}
+
+} // namespace
+
+ValuesAndIndices max_and_argmax(TensorView* x, int64_t dim, bool keep_dim) {
+  return reduceWithIndex(x, dim, keep_dim, /*largest=*/true);
+}
+
+ValuesAndIndices min_and_argmin(TensorView* x, int64_t dim, bool keep_dim) {
+  return reduceWithIndex(x, dim, keep_dim, /*largest=*/false);
+}
+
+TensorView* argmax(TensorView* x, int64_t dim, bool keep_dim) {
+  return max_and_argmax(x, dim, keep_dim).indices;
+}
+
+TensorView* argmin(TensorView* x, int64_t dim, bool keep_dim) {
+  return min_and_argmin(x, dim, keep_dim).indices;
+}
+
+ValuesAndIndices topk(TensorView* x, int64_t k, int64_t dim, bool largest) {
+  NVF_CHECK(k > 0, "topk requires a positive k, but got ", k);
+  NVF_CHECK(
+      canPackKeyAndIndex(x) && !isComplexType(x->dtype()),
+      "topk only supports non-complex data types of up to 32 bits, but got ",
+      x->dtype());
+  dim = wrapReductionDim(x, dim);
+
+  // Each round picks the best remaining element and removes it from the
+  // candidates, which stay in registers or shared memory when scheduled as
+  // a persistent kernel.
+  auto packed = packKeyAndIndex(toOrderedKey(x), indicesAlong(x, dim), largest);
+  Val* removed = largest ? ops::getMinimumValue(DataType::Int)
+                         : ops::getMaximumValue(DataType::Int);
+  std::vector<ValuesAndIndices> rounds;
+  rounds.reserve(k);
+  for (auto i : c10::irange(k)) {
+    auto best = maxOrMin(packed, dim, /*keep_dim=*/true, largest);
+    rounds.push_back(unpackKeyAndIndex(best, largest, x->dtype()));
+    if (i + 1 < k) {
+      packed = where(eq(packed, best), removed, packed);
+    }
+  }
+
+  // Place the result of the i-th round at position i along dim
+  auto position = broadcast(
+      iota(IrBuilder::create<Val>(k, DataType::Index)),
+      broadcastFlagsExcept(x, dim));
+  ValuesAndIndices result = rounds.back();
+  for (int64_t i = k - 2; i >= 0; --i) {
+    auto is_i = eq(position, IrBuilder::create<Val>(i));
+    result.values = where(is_i, rounds.at(i).values, result.values);
+    result.indices = where(is_i, rounds.at(i).indices, result.indices);
+  }
+  return result;
+}
+
 } // namespace nvfuser
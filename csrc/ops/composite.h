@@ -67,4 +67,36 @@ TensorView* leaky_relu(TensorView* x, Val* negative_slope);
 
 TensorView* view_as_real(TensorView* x);
 
+struct ValuesAndIndices {
+  TensorView* values = nullptr;
+  TensorView* indices = nullptr;
+};
+
+// Maximum or minimum values along dim and their indices, as torch.max and
+// torch.min with dim. Data types of up to 32 bits are reduced with a single
+// reduction of the value and the index packed in an Int, so they can be
+// scheduled as any other max or min reduction. Ties are resolved to the
+// smallest index. NaNs are ordered by their bit patterns, so they're not
+// always selected as in PyTorch.
+ValuesAndIndices max_and_argmax(
+    TensorView* x,
+    int64_t dim,
+    bool keep_dim = false);
+ValuesAndIndices min_and_argmin(
+    TensorView* x,
+    int64_t dim,
+    bool keep_dim = false);
+TensorView* argmax(TensorView* x, int64_t dim, bool keep_dim = false);
+TensorView* argmin(TensorView* x, int64_t dim, bool keep_dim = false);
+
+// The k largest or smallest values along dim in sorted order and their
+// indices, as torch.topk. Each of the k values is found by a reduction of
+// the packed values of argmax/argmin, so this is intended for small k. The
+// result along dim is undefined when k is larger than the extent of dim.
+ValuesAndIndices topk(
+    TensorView* x,
+    int64_t k,
+    int64_t dim,
+    bool largest = true);
+
 } // namespace nvfuser
@@ -225,6 +225,72 @@ TensorView* log_softmax_backward(TensorView* dy, TensorView* y, int dim) {
   return dx;
 }
 
+OnlineSoftmaxStats online_softmax_stats(
+    TensorView* x,
+    const std::vector<int>& dims,
+    bool keepdim) {
+  NVF_ERROR(x != nullptr, "Input is invalid.");
+  NVF_CHECK(
+      x->dtype() == DataType::Float || x->dtype() == DataType::Half ||
+          x->dtype() == DataType::BFloat16,
+      "Online softmax statistics are computed in Float, but got ",
+      x->dtype());
+  x = maybeCastOp(DataType::Float, x);
+
+  // A partial result packs the bits of the max in the upper 32 bits and the
+  // bits of the sum in the lower 32 bits of an Int. See onlineSoftmax in
+  // runtime/helpers.cu.
+  constexpr int64_t kUpper = 0x100000000L;
+  constexpr int64_t kOneBits = 0x3F800000L;
+  constexpr int64_t kNegInfBits = -0x800000L;
+
+  // Each element is a partial result with max x and sum exp(x - x) = 1
+  auto max_bits = castOp(DataType::Int, bitCastOp(DataType::Int32, x));
+  auto packed = add(
+      mul(max_bits, IrBuilder::create<Val>(kUpper)),
+      IrBuilder::create<Val>(kOneBits));
+
+  // The empty partial result is -inf max and zero sum
+  auto init = IrBuilder::create<Val>(kNegInfBits * kUpper);
+  auto reduced =
+      reductionOp(BinaryOpType::OnlineSoftmax, dims, init, packed, keepdim);
+
+  auto max_val = bitCastOp(
+      DataType::Float,
+      castOp(
+          DataType::Int32,
+          bitwise_right_shift(reduced, IrBuilder::create<Val>(32L))));
+  auto sum_val = bitCastOp(
+      DataType::Float,
+      castOp(
+          DataType::Int32,
+          bitwise_and(reduced, IrBuilder::create<Val>(kUpper - 1))));
+  return {max_val, sum_val};
+}
+
+TensorView* online_softmax(TensorView* x, int dim) {
+  NVF_ERROR(x != nullptr, "Input is invalid.");
+
+  const size_t kNumberOfDims =
+      TensorDomain::noReductions(x->getMaybeRFactorDomain()).size();
+  const int kReductionAxis = (dim < 0) ? dim + (int)kNumberOfDims : dim;
+  NVF_ERROR(kReductionAxis >= 0 && kReductionAxis < (int)kNumberOfDims);
+
+  auto stats = online_softmax_stats(x, {kReductionAxis}, true /* keepdim */);
+  auto exp_val = exp(sub(x, stats.max));
+  auto y = mul(exp_val, reciprocal(stats.sum));
+
+  return y;
+}
+
+TensorView* logsumexp(
+    TensorView* x,
+    const std::vector<int>& dims,
+    bool keepdim) {
+  auto stats = online_softmax_stats(x, dims, keepdim);
+  return add(stats.max, log(stats.sum));
+}
+
 ForwardNormResult layer_norm(
     TensorView* x,
     const std::vector<int64_t>& norm_shape,
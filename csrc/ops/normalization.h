@@ -51,6 +51,12 @@ struct VarMeanResult {
   TensorView* mean = nullptr;
 };
 
+struct OnlineSoftmaxStats {
+  TensorView* max = nullptr;
+  // Sum of exp(x - max)
+  TensorView* sum = nullptr;
+};
+
 } // namespace nvfuser
 
 namespace std {
@@ -60,6 +66,7 @@ using nvfuser::BackwardNormResult;
 using nvfuser::BackwardRMSNormResult;
 using nvfuser::ForwardNormResult;
 using nvfuser::ForwardRMSNormResult;
+using nvfuser::OnlineSoftmaxStats;
 using nvfuser::TensorView;
 using nvfuser::VarMeanResult;
 
@@ -124,6 +131,17 @@ constexpr TensorView* get(const VarMeanResult& results) {
   return nullptr;
 }
 
+template <int i>
+constexpr TensorView* get(const OnlineSoftmaxStats& results) {
+  if (i == 0) {
+    return results.max;
+  }
+  if (i == 1) {
+    return results.sum;
+  }
+  return nullptr;
+}
+
 } // namespace std
 
 namespace nvfuser {
@@ -162,6 +180,26 @@ TensorView* log_softmax(TensorView* x, int dim);
 
 TensorView* log_softmax_backward(TensorView* dy, TensorView* y, const int dim);
 
+//! Computes the max and the sum of exp(x - max) over dims in a single pass
+//! with a combined OnlineSoftmax reduction, which rescales the running sum
+//! whenever the running max changes. Unlike softmax, x doesn't need to be
+//! persistent, so rows too large to fit in registers or shared memory are
+//! read only once for the statistics. The statistics are computed in Float.
+OnlineSoftmaxStats online_softmax_stats(
+    TensorView* x,
+    const std::vector<int>& dims,
+    bool keepdim = false);
+
+//! Softmax normalized with online_softmax_stats
+TensorView* online_softmax(TensorView* x, int dim);
+
+//! log(sum(exp(x))) over dims computed with online_softmax_stats, e.g., for
+//! cross entropy
+TensorView* logsumexp(
+    TensorView* x,
+    const std::vector<int>& dims,
+    bool keepdim);
+
 ForwardNormResult layer_norm(
     TensorView* x,
     const std::vector<int64_t>& norm_shape,
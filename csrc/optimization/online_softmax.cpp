@@ -0,0 +1,135 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <optimization/online_softmax.h>
+
+#include <ir/utils.h>
+#include <ops/normalization.h>
+
+#include <c10/util/irange.h>
+
+#include <optional>
+#include <vector>
+
+namespace nvfuser::optimization {
+
+namespace {
+
+struct SoftmaxReductions {
+  TensorView* x = nullptr;
+  TensorView* max = nullptr;
+  TensorView* sum = nullptr;
+  std::vector<int> axes;
+};
+
+std::vector<int> reductionAxes(TensorView* tv) {
+  std::vector<int> axes;
+  const auto& root = tv->getRootDomain();
+  for (auto i : c10::irange(root.size())) {
+    if (root.at(i)->isReduction()) {
+      axes.push_back((int)i);
+    }
+  }
+  return axes;
+}
+
+ReductionOp* reductionOfType(Val* val, BinaryOpType op_type) {
+  auto rop = dynamic_cast<ReductionOp*>(val->definition());
+  if (rop == nullptr || rop->getReductionOpType() != op_type) {
+    return nullptr;
+  }
+  return rop;
+}
+
+// Matches sum(exp(x - broadcast(max(x)))) starting from the sum
+std::optional<SoftmaxReductions> matchSoftmax(ReductionOp* sum_rop) {
+  if (sum_rop->getReductionOpType() != BinaryOpType::Add ||
+      sum_rop->out()->dtype() != DataType::Float) {
+    return std::nullopt;
+  }
+
+  auto exp_op = dynamic_cast<UnaryOp*>(sum_rop->in()->definition());
+  if (exp_op == nullptr || exp_op->getUnaryOpType() != UnaryOpType::Exp) {
+    return std::nullopt;
+  }
+
+  auto sub_op = dynamic_cast<BinaryOp*>(exp_op->in()->definition());
+  if (sub_op == nullptr || sub_op->getBinaryOpType() != BinaryOpType::Sub) {
+    return std::nullopt;
+  }
+
+  auto bcast_op = dynamic_cast<BroadcastOp*>(sub_op->rhs()->definition());
+  if (bcast_op == nullptr) {
+    return std::nullopt;
+  }
+
+  auto max_rop = reductionOfType(bcast_op->in(), BinaryOpType::Max);
+  if (max_rop == nullptr || max_rop->in() != sub_op->lhs() ||
+      max_rop->in()->dtype() != DataType::Float) {
+    return std::nullopt;
+  }
+
+  SoftmaxReductions softmax;
+  softmax.x = max_rop->in()->as<TensorView>();
+  softmax.max = max_rop->out()->as<TensorView>();
+  softmax.sum = sum_rop->out()->as<TensorView>();
+  softmax.axes = reductionAxes(softmax.max);
+
+  // The broadcast must restore the reduced axes of max
+  std::vector<int> bcast_axes;
+  for (auto i : c10::irange(bcast_op->getBroadcastDimFlags().size())) {
+    if (bcast_op->isBroadcastDim(i)) {
+      bcast_axes.push_back((int)i);
+    }
+  }
+  if (bcast_axes != softmax.axes ||
+      reductionAxes(softmax.sum) != softmax.axes) {
+    return std::nullopt;
+  }
+
+  return softmax;
+}
+
+std::vector<SoftmaxReductions> findSoftmax(Fusion* fusion) {
+  std::vector<SoftmaxReductions> found;
+  for (auto expr : fusion->exprs()) {
+    if (auto sum_rop = dynamic_cast<ReductionOp*>(expr)) {
+      if (auto softmax = matchSoftmax(sum_rop)) {
+        found.push_back(*softmax);
+      }
+    }
+  }
+  return found;
+}
+
+void replaceAllUsesWith(Fusion* fusion, Val* old_val, Val* new_val) {
+  // Copy the uses as they are modified by the replacement
+  const std::vector<Expr*> uses = old_val->uses();
+  for (auto use : uses) {
+    ir_utils::replaceValInExprInputs(use, old_val, new_val);
+  }
+  if (old_val->isFusionOutput()) {
+    fusion->replaceOutput(old_val, new_val);
+  }
+}
+
+} // namespace
+
+bool OnlineSoftmaxPass::hasCandidates(Fusion* fusion) {
+  return !findSoftmax(fusion).empty();
+}
+
+void OnlineSoftmaxPass::runPass(Fusion* fusion) {
+  FusionGuard fg(fusion);
+  for (const auto& softmax : findSoftmax(fusion)) {
+    auto stats = online_softmax_stats(softmax.x, softmax.axes);
+    replaceAllUsesWith(fusion, softmax.max, stats.max);
+    replaceAllUsesWith(fusion, softmax.sum, stats.sum);
+  }
+}
+
+} // namespace nvfuser::optimization
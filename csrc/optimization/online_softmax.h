@@ -0,0 +1,33 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <optimization/optimization_pass.h>
+
+namespace nvfuser::optimization {
+
+//! OnlineSoftmaxPass rewrites the max and sum reductions of softmax, i.e.,
+//! max(x) and sum(exp(x - max(x))), into online_softmax_stats, which
+//! computes both in a single pass. The original form is preferable when x
+//! can be persistent as exp is evaluated only once per element, so this
+//! pass is not part of PreSegmenter. FusionKernelRuntime applies it when
+//! the fusion can't be scheduled as a single kernel, e.g., when rows are too
+//! large to be persistent, which would otherwise result in separate kernels
+//! for the two reductions.
+class OnlineSoftmaxPass : public OptimizationPass<OnlineSoftmaxPass> {
+  friend class OptimizationPass<OnlineSoftmaxPass>;
+
+ public:
+  //! Returns true if there's any softmax to rewrite
+  static bool hasCandidates(Fusion* fusion);
+
+ protected:
+  static void runPass(Fusion* fusion);
+};
+
+} // namespace nvfuser::optimization
@@ -131,6 +131,7 @@ std::unordered_map<DebugDumpOption, std::vector<std::string>> Options<
       {"occupancy", DebugDumpOption::Occupancy},
       {"parallel_dimensions", DebugDumpOption::ParallelDimensions},
       {"perf_debug_verbose", DebugDumpOption::PerfDebugVerbose},
+      {"pipeline_timeline", DebugDumpOption::PipelineTimeline},
       {"ptx", DebugDumpOption::Ptx},
       {"ptxas_verbose", DebugDumpOption::PrintPtxasLog},
       {"python_definition", DebugDumpOption::PythonDefinition},
@@ -150,13 +151,27 @@ template <>
 std::unordered_map<EnableOption, std::vector<std::string>> Options<
     EnableOption>::getOptionsFromEnv() {
   const std::unordered_map<std::string, EnableOption> available_options = {
+      {"batch_compile", EnableOption::BatchCompile},
       {"complex", EnableOption::Complex},
       {"conv_decomposition", EnableOption::ConvDecomposition},
+      {"cpp_backend", EnableOption::CppBackend},
+      {"definition_hash_lookup", EnableOption::DefinitionHashLookup},
+      {"expr_eval_segments", EnableOption::ExprEvalSegments},
       {"graph_op_fusion", EnableOption::GraphOp},
+      {"heuristic_db", EnableOption::HeuristicDb},
       {"kernel_db", EnableOption::KernelDb},
       {"kernel_profile", EnableOption::KernelProfile},
+      {"launch_plan", EnableOption::LaunchPlan},
       {"linear_decomposition", EnableOption::LinearDecomposition},
+      {"matmul_split_k", EnableOption::MatmulSplitK},
+      {"memory_plan", EnableOption::MemoryPlan},
       {"memory_promotion", EnableOption::MemoryPromotion},
+      {"module_cache", EnableOption::ModuleCache},
+      {"register_estimate", EnableOption::RegisterEstimate},
+      {"segment_cost_model", EnableOption::SegmentCostModel},
+      {"segment_graph", EnableOption::SegmentGraph},
+      {"smem_best_fit", EnableOption::SmemBestFit},
+      {"structural_fusion_cache", EnableOption::StructuralFusionCache},
       {"warn_register_spill", EnableOption::WarnRegisterSpill}};
 
   return parseEnvOptions("ENABLE", available_options);
@@ -176,6 +191,7 @@ std::unordered_map<DisableOption, std::vector<std::string>> Options<
       {"magic_zero", DisableOption::MagicZero},
       {"nvtx", DisableOption::Nvtx},
       {"parallel_compile", DisableOption::ParallelCompile},
+      {"parallel_pipeline", DisableOption::ParallelPipeline},
       {"parallel_serde", DisableOption::ParallelSerde},
       {"predicate_elimination", DisableOption::PredicateElimination},
       {"kernel_reuse", DisableOption::KernelReuse},
@@ -68,6 +68,8 @@ enum class DebugDumpOption {
   LoopRotation, //! Print loop rotation log
   Occupancy, // Dump occupancy
   IndexType, //! Print the index type of the launched kernel
+  PipelineTimeline, //! Print the host timestamps of the stages and
+                    //! communications of a multidevice pipeline
   EndOfOption //! Placeholder for counting the number of elements
 };
 
@@ -76,13 +78,32 @@ enum class DebugDumpOption {
 //! These can be set through the `NVFUSER_ENABLE` environment variable
 //!
 enum class EnableOption {
+  BatchCompile, //! Enable compiling the kernels of a fusion in batches of one
+                //! NVRTC program
   Complex, //! Enable complex support on python
   ConvDecomposition, //! Enable conv-bias decomposition
+  CppBackend, //! Enable compiling fusions with only CPU tensor arguments to
+              //! C++ for the host
+  DefinitionHashLookup, //! Enable looking up python definitions by the hash
+                        //! of all their records
+  ExprEvalSegments, //! Enable segments evaluated on the host with ATen
   GraphOp, //! Enable graphOps(index_select/gather/scatter)
+  HeuristicDb, //! Enable the database of tuned heuristic parameters
   KernelDb, //! Enable Kernel Database
   KernelProfile, //! Enable intra-kernel performance profiling
+  LaunchPlan, //! Enable replay of the recorded kernel launches of a fusion
   LinearDecomposition, //! Enable linear-bias decomposition
+  MatmulSplitK, //! Enable splitting K across CTAs in the matmul heuristics
+  MemoryPlan, //! Enable planning of the memory passed between segments
   MemoryPromotion, //! Enable promotion of memory types for non-pointwise ops
+  ModuleCache, //! Enable sharing the modules of identical kernels in-process
+  RegisterEstimate, //! Enable fitting the unroll and persistent batch factors
+                    //! of reduction heuristics to estimated register usage
+  SegmentCostModel, //! Enable cost-based ranking of segmentation merges
+  SegmentGraph, //! Enable replay of the segments of a fusion as a CUDA graph
+  SmemBestFit, //! Enable best-fit placement of shared memory allocations
+  StructuralFusionCache, //! Enable sharing the FusionExecutorCache of
+                         //! structurally equal fusion definitions
   WarnRegisterSpill, //! Enable warnings of register spill
   EndOfOption //! Placeholder for counting the number of elements
 };
@@ -103,6 +124,8 @@ enum class DisableOption {
   MagicZero, //! Disable nvfuser_zero
   Nvtx, //! Disable NVTX instrumentation
   ParallelCompile, //! Disable compiling Fusion segments in parallel
+  ParallelPipeline, //! Disable the concurrent execution of the independent
+                    //! stages and communications of a multidevice pipeline
   ParallelSerde, //! Disable deserializing FusionExecutorCache in parallel
   PredicateElimination, //! Disable predicate elimination
   KernelReuse, //! Disable re-using cached FusionKernelRuntimes with different
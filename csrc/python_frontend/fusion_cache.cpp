@@ -12,6 +12,7 @@
 #include <serde/fusion_record_serde.h>
 #include <utils.h>
 
+#include <algorithm>
 #include <filesystem>
 namespace fs = std::filesystem;
 
@@ -31,7 +32,9 @@ FusionSchedules::FusionSchedules()
       user_def_schedules(),
       last_user_def_scheduled_ir(nullptr),
       last_user_def_executor(nullptr),
-      scheds_lock() {
+      scheds_lock(),
+      footprint(0),
+      lru_iter() {
   auto_gen_schedules =
       std::make_unique<FusionExecutorCache>(std::make_unique<Fusion>());
 }
@@ -75,21 +78,37 @@ flatbuffers::Offset<serde::TrieNode> TrieNode::serialize(
       isTerminal());
 }
 
-FusionCache* FusionCache::get(size_t max_fusions) {
+FusionCache* FusionCache::get(std::optional<size_t> max_fusions) {
   FUSER_PERF_SCOPE("FusionCache::get");
   std::lock_guard<std::mutex> guard(singleton_lock_);
   if (singleton_ == nullptr) {
-    singleton_ = new FusionCache(max_fusions);
+    singleton_ = new FusionCache(8192);
+  }
+  if (max_fusions.has_value()) {
+    singleton_->setMaxFusions(max_fusions.value());
   }
-  NVF_CHECK(
-      max_fusions >= singleton_->fusions_.size(),
-      "The max fusions is set less than the number of fusions in the cache.");
-  singleton_->max_fusions_ = max_fusions;
   return singleton_;
 }
 
 size_t FusionCache::numFusions() const {
-  return fusions_.size();
+  return lru_fusions_.size();
+}
+
+void FusionCache::setMaxFusions(size_t max_fusions) {
+  NVF_CHECK(max_fusions > 0, "The FusionCache must hold at least 1 fusion.");
+  std::lock_guard<std::mutex> guard(lru_lock_);
+  max_fusions_ = max_fusions;
+  evictOverBounds();
+}
+
+void FusionCache::setMaxFootprint(size_t max_footprint) {
+  std::lock_guard<std::mutex> guard(lru_lock_);
+  max_footprint_ = max_footprint;
+  evictOverBounds();
+}
+
+size_t FusionCache::footprint() const {
+  return footprint_;
 }
 
 void FusionCache::print(std::ostream& os) const {
@@ -129,17 +148,19 @@ void FusionCache::print(std::ostream& os) const {
 }
 
 void FusionCache::stats(std::ostream& os) const {
-  os << "Total Fusions: " << fusions_.size() << "\n";
+  os << "Total Fusions: " << numFusions() << "\n";
+  os << "Evicted Fusions: " << num_evictions_ << "\n";
+  os << "Footprint: " << footprint_ << " bytes\n";
 
   // Does not make sense to print stats if the cache is disabled.
-  if (!fusions_.empty()) {
+  if (!terminal_nodes_.empty()) {
     os << "Cache Hits by Fusion Id:\n";
     size_t total_cache_hits = 0;
-    for (size_t i = 0; i < terminal_nodes_.size(); ++i) {
+    for (auto node : terminal_nodes_) {
       // The first visit is a miss!
-      auto visits = terminal_nodes_[i]->visits - 1;
+      auto visits = node->visits - 1;
       total_cache_hits += visits;
-      os << "\t" << i << " -> " << visits << " hits\n";
+      os << "\t" << node->fusion_id << " -> " << visits << " hits\n";
     }
 
     auto hit_rate = static_cast<float>(total_cache_hits) /
@@ -154,16 +175,24 @@ void FusionCache::reset() {
   std::lock_guard<std::mutex> guard(singleton_lock_);
   if (singleton_ != nullptr) {
     auto max_fusions = singleton_->max_fusions_;
+    auto max_footprint = singleton_->max_footprint_;
     delete singleton_;
     singleton_ = new FusionCache(max_fusions);
+    singleton_->max_footprint_ = max_footprint;
   }
 }
 
 FusionCache::FusionCache(size_t max_fusions)
     : max_fusions_(max_fusions),
+      max_footprint_(0),
+      footprint_(0),
+      num_evictions_(0),
+      lru_fusions_(),
+      lru_lock_(),
       root_(nullptr),
       fusions_(),
       terminal_nodes_(),
+      definitions_(),
       user_def_input_encodings_() {
   RecordFunctor* start = new StartRecord();
   root_ = std::make_unique<TrieNode>(start);
@@ -187,15 +216,45 @@ std::optional<TrieNode*> FusionCache::queryChildren(
     return std::optional<TrieNode*>(trie_node->second.get());
   }
 }
+std::optional<TrieNode*> FusionCache::queryDefinition(
+    size_t definition_hash,
+    const std::vector<std::unique_ptr<RecordFunctor>>& records) {
+  FUSER_PERF_SCOPE("FusionCache::queryDefinition");
+  std::lock_guard<std::mutex> guard(lru_lock_);
+  auto [begin, end] = definitions_.equal_range(definition_hash);
+  for (auto it = begin; it != end; ++it) {
+    TrieNode* terminal_node = it->second;
+    // Compare the records from the last one, up to the root
+    TrieNode* node = terminal_node->parent;
+    auto rec = records.rbegin();
+    while (node->parent != nullptr && rec != records.rend() &&
+           *node->record == **rec) {
+      node = node->parent;
+      ++rec;
+    }
+    if (node->parent == nullptr && rec == records.rend()) {
+      ++(terminal_node->visits);
+      return terminal_node;
+    }
+  }
+  return std::nullopt;
+}
 FusionSchedules* FusionCache::queryFusionSchedules(size_t fusion_id) const {
   NVF_CHECK(
       fusion_id < fusions_.size(),
       "Invalid scheduler query for id:",
       fusion_id);
   FusionSchedules* ptr = fusions_.at(fusion_id).get();
-  NVF_CHECK(ptr != nullptr, "Unexpected null FusionSchedules object.");
+  NVF_CHECK(
+      ptr != nullptr,
+      "The fusion with id ",
+      fusion_id,
+      " was evicted from the FusionCache.");
   return ptr;
 }
+bool FusionCache::isCached(size_t fusion_id) const {
+  return fusion_id < fusions_.size() && fusions_.at(fusion_id) != nullptr;
+}
 std::optional<size_t> FusionCache::queryUserScheduleId(
     const FusionSchedules* scheds,
     const at::ArrayRef<c10::IValue>& inputs) {
@@ -242,12 +301,6 @@ TrieNode* FusionCache::createChild(TrieNode* node, RecordFunctor* rec) {
   } else {
     size_t fusion_id = 0;
     if (rec->recordType() == serde::RecordType_End) {
-      NVF_CHECK(
-          (fusions_.size() + 1) <= max_fusions_,
-          "The number of fusions in nvfuser has exceeded ",
-          max_fusions_,
-          "fusions.  The max_fusions for the FusionCache might need to be ",
-          "increased if the max number is not being exceeded due to an error.");
       fusions_.emplace_back(std::make_unique<FusionSchedules>());
       fusion_id = fusions_.size() - 1;
     }
@@ -264,6 +317,14 @@ TrieNode* FusionCache::createChild(TrieNode* node, RecordFunctor* rec) {
     ++(child->visits);
     if (rec->recordType() == serde::RecordType_End) {
       terminal_nodes_.push_back(node->children[new_rec].get());
+      // The new terminal node is added before evicting, so it is the most
+      // recently used fusion and is never evicted, and node is not removed
+      // with the branch of an evicted fusion.
+      std::lock_guard<std::mutex> lru_guard(lru_lock_);
+      definitions_.emplace(definitionHash(child), child);
+      lru_fusions_.push_front(fusion_id);
+      fusions_.at(fusion_id)->lru_iter = lru_fusions_.begin();
+      evictOverBounds();
     }
     if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
       std::stringstream ss;
@@ -275,6 +336,102 @@ TrieNode* FusionCache::createChild(TrieNode* node, RecordFunctor* rec) {
   return child;
 }
 
+void FusionCache::shareAutoGenSchedules(size_t fusion_id) {
+  if (!isOptionEnabled(EnableOption::StructuralFusionCache)) {
+    return;
+  }
+  FUSER_PERF_SCOPE("FusionCache::shareAutoGenSchedules");
+  auto scheds = queryFusionSchedules(fusion_id);
+  std::lock_guard<std::mutex> guard(scheds->scheds_lock);
+  auto shared = FusionExecutorCacheRegistry::get().getOrRegister(
+      scheds->auto_gen_schedules);
+  if (shared != scheds->auto_gen_schedules &&
+      isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
+    debug() << "\nFusionDefinition: Sharing the schedules of an equal fusion."
+            << "\n";
+  }
+  scheds->auto_gen_schedules = std::move(shared);
+}
+
+void FusionCache::recordUse(size_t fusion_id) {
+  FUSER_PERF_SCOPE("FusionCache::recordUse");
+  auto scheds = queryFusionSchedules(fusion_id);
+  std::lock_guard<std::mutex> guard(lru_lock_);
+  lru_fusions_.splice(lru_fusions_.begin(), lru_fusions_, scheds->lru_iter);
+}
+
+void FusionCache::updateFootprint(size_t fusion_id) {
+  FUSER_PERF_SCOPE("FusionCache::updateFootprint");
+  auto scheds = queryFusionSchedules(fusion_id);
+  std::lock_guard<std::mutex> guard(lru_lock_);
+  auto footprint = scheds->auto_gen_schedules->memoryFootprint();
+  footprint_ = footprint_ - scheds->footprint + footprint;
+  scheds->footprint = footprint;
+  evictOverBounds();
+}
+
+void FusionCache::evictOverBounds() {
+  while (lru_fusions_.size() > 1 &&
+         (lru_fusions_.size() > max_fusions_ ||
+          (max_footprint_ > 0 && footprint_ > max_footprint_))) {
+    evict(lru_fusions_.back());
+  }
+}
+
+void FusionCache::evict(size_t fusion_id) {
+  FUSER_PERF_SCOPE("FusionCache::evict");
+  auto scheds = queryFusionSchedules(fusion_id);
+  lru_fusions_.erase(scheds->lru_iter);
+  footprint_ -= scheds->footprint;
+  ++num_evictions_;
+
+  auto terminal_node = std::find_if(
+      terminal_nodes_.begin(), terminal_nodes_.end(), [&](TrieNode* node) {
+        return node->fusion_id == fusion_id;
+      });
+  NVF_ERROR(
+      terminal_node != terminal_nodes_.end(),
+      "Terminal node not found for fusion id: ",
+      fusion_id);
+  TrieNode* node = *terminal_node;
+  terminal_nodes_.erase(terminal_node);
+  auto [begin, end] = definitions_.equal_range(definitionHash(node));
+  for (auto it = begin; it != end; ++it) {
+    if (it->second == node) {
+      definitions_.erase(it);
+      break;
+    }
+  }
+
+  // The ancestors left without children only lead to the evicted fusion.
+  // definitions_ only holds terminal nodes, so none of them is indexed.  The
+  // root is never removed.
+  while (node->parent != nullptr && node->children.empty()) {
+    TrieNode* parent = node->parent;
+    parent->children.erase(node->record.get());
+    node = parent;
+  }
+  fusions_.at(fusion_id).reset();
+
+  if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
+    debug() << "\nFusionCache: Evicted the fusion with id " << fusion_id
+            << "\n";
+  }
+}
+
+size_t FusionCache::definitionHash(TrieNode* terminal_node) {
+  std::vector<RecordFunctor*> records;
+  for (TrieNode* node = terminal_node->parent; node->parent != nullptr;
+       node = node->parent) {
+    records.push_back(node->record.get());
+  }
+  size_t definition_hash = 0;
+  for (auto rec = records.rbegin(); rec != records.rend(); ++rec) {
+    definition_hash = combineDefinitionHash(definition_hash, *rec);
+  }
+  return definition_hash;
+}
+
 UserSchedule* FusionCache::createUserSchedule(
     FusionSchedules* scheds,
     const at::ArrayRef<c10::IValue>& inputs,
@@ -433,10 +590,16 @@ void FusionCache::deserialize(std::string filename) {
   max_fusions_ = fusion_cache_buffer->max_fusions();
 
   // 2. Deserialize fusions: (Fusion) and structure: (TrieNode) fields
-  std::generate_n(
-      std::back_inserter(fusions_),
-      fusion_cache_buffer->terminal_nodes()->size(),
-      [] { return std::make_unique<FusionSchedules>(); });
+  // NOTE: The fusion ids are sparse if fusions were evicted before
+  // serialization
+  for (auto node_idx : *fusion_cache_buffer->terminal_nodes()) {
+    auto fusion_id =
+        fusion_cache_buffer->structure()->Get(node_idx)->fusion_id();
+    if (fusion_id >= fusions_.size()) {
+      fusions_.resize(fusion_id + 1);
+    }
+    fusions_.at(fusion_id) = std::make_unique<FusionSchedules>();
+  }
 
   serde::RecordFunctorFactory record_functor_factory;
 
@@ -522,7 +685,7 @@ void FusionCache::deserialize(std::string filename) {
   }
 
   // Deserialize terminal_nodes field in the FusionCache table
-  for (auto idx : c10::irange(fusions_.size())) {
+  for (auto idx : c10::irange(fusion_cache_buffer->terminal_nodes()->size())) {
     auto node_idx = fusion_cache_buffer->terminal_nodes()->Get(idx);
     auto trie_node = bfs_order.at(node_idx);
     terminal_nodes_.push_back(trie_node);
@@ -546,6 +709,18 @@ void FusionCache::deserialize(std::string filename) {
     // Wait until all fusion executor caches are deserialized
     getThreadPool()->waitWorkComplete();
   }
+
+  // The fusions are used in the order they were created
+  std::lock_guard<std::mutex> guard(lru_lock_);
+  for (auto node : terminal_nodes_) {
+    auto scheds = queryFusionSchedules(node->fusion_id);
+    definitions_.emplace(definitionHash(node), node);
+    lru_fusions_.push_front(node->fusion_id);
+    scheds->lru_iter = lru_fusions_.begin();
+    scheds->footprint = scheds->auto_gen_schedules->memoryFootprint();
+    footprint_ += scheds->footprint;
+  }
+  evictOverBounds();
 }
 
 } // namespace nvfuser::python_frontend
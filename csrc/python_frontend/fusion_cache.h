@@ -11,9 +11,13 @@
 
 #include <kernel_cache.h>
 #include <python_frontend/fusion_record.h>
+#include <utils.h>
 
+#include <list>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <unordered_map>
 
 namespace nvfuser::python_frontend {
 
@@ -38,7 +42,9 @@ struct FusionSchedules {
 
   //! Schedules Automatically generated by nvFuser for dynamic inputs. (default)
   //! NOTE: The FusionExecutorCache also holds the Unscheduled Fusion IR
-  std::unique_ptr<FusionExecutorCache> auto_gen_schedules;
+  //! NOTE: The FusionExecutorCache is shared by structurally equal fusions
+  //! with EnableOption::StructuralFusionCache
+  std::shared_ptr<FusionExecutorCache> auto_gen_schedules;
   //! Schedules defined by the user for specific input sizes.
   //! They are also generated per device as all devices may not be the same.
   //! Key:   Input Encoding hash of Fusion inputs as is created by the
@@ -51,6 +57,12 @@ struct FusionSchedules {
   FusionExecutor* last_user_def_executor;
   //! For thread-Safe locking of Fusion Schedules
   std::mutex scheds_lock;
+  //! Memory footprint of auto_gen_schedules when the fusion was last used
+  //! NOTE: A FusionExecutorCache shared by several fusions is counted once
+  //! per fusion
+  size_t footprint;
+  //! Position of the fusion in the FusionCache's list of recently used fusions
+  std::list<size_t>::iterator lru_iter;
 };
 
 //! \struct TrieNode
@@ -98,16 +110,21 @@ struct TrieNode {
 //! cache fusions.  A leaf of the tree with a terminal node contains a
 //! container for caching the kernels generated for specific fusions.
 //!
-//! \todo
-//! Add the ability to evict a fusion.  There is currently a max number
-//! of fusions that is checked to prevent a runaway case.
+//! The number of fusions and, optionally, the memory footprint of their
+//! compiled kernels are bounded.  Past a bound, the least recently used
+//! fusions are evicted along with their schedules and the branch of the trie
+//! only leading to them.  The ids of evicted fusions are not reused, so a
+//! stale id is reported rather than aliasing another fusion, and a
+//! FusionDefinition redefines its fusion if it was evicted.
 //!
 //! \note
 //! Thread-Safety is assured by the Python GIL.  If a no-GIL python is used
 //! then further scrutiny needs to be applied to the mutexes used to limit
 //! acccess to the singleton pointer, node creation, and user schedule
 //! creation.  Otherwise, the Python GIL provides a natural thread based mutex
-//! that does not allow for multiple threads to interact.
+//! that does not allow for multiple threads to interact.  Eviction deletes
+//! trie nodes, so definitions must not be recorded while another definition
+//! is finalized or executed.
 
 class FusionCache {
   //! The constructor is private given the FusionCache is only constructed
@@ -122,10 +139,18 @@ class FusionCache {
 
   //! The next 4 public methods are the python interface methods
 
-  //! Gets a pointer to the singleton and creates a new one if necessary
-  static FusionCache* get(size_t max_fusions = 8192);
+  //! Gets a pointer to the singleton and creates a new one if necessary.
+  //! The max number of fusions is only changed if it is given.
+  static FusionCache* get(std::optional<size_t> max_fusions = std::nullopt);
   //! Number of fusions cached
   size_t numFusions() const;
+  //! Bound the number of fusions cached
+  void setMaxFusions(size_t max_fusions);
+  //! Bound the memory footprint of the fusions cached, in bytes, see
+  //! FusionExecutorCache::memoryFootprint.  Zero means no bound.
+  void setMaxFootprint(size_t max_footprint);
+  //! Memory footprint of the fusions cached when they were last used
+  size_t footprint() const;
   //! print cache contents
   void print(std::ostream& os) const;
   //! print cache stats
@@ -143,8 +168,23 @@ class FusionCache {
   //! one of its children
   std::optional<TrieNode*> queryChildren(TrieNode* node, RecordFunctor* rec)
       const;
+  //! Thread-Safe: Queries the terminal node of the fusion defined by records
+  //! directly, given the hash of the records, instead of walking the trie a
+  //! record at a time.  The records are compared to the ones of the cache.
+  std::optional<TrieNode*> queryDefinition(
+      size_t definition_hash,
+      const std::vector<std::unique_ptr<RecordFunctor>>& records);
+  //! Hash of the records of a definition, combined a record at a time
+  static size_t combineDefinitionHash(
+      size_t definition_hash,
+      const RecordFunctor* record) {
+    hashCombine(definition_hash, record->hash());
+    return definition_hash;
+  }
   //! Query a Fusion's Schedules based on fusion id or cache id
   FusionSchedules* queryFusionSchedules(size_t fusion_id) const;
+  //! Queries whether the fusion is cached, i.e., it was not evicted
+  bool isCached(size_t fusion_id) const;
   //! Lookup the User Schedule Id and return null if one does not exist.
   //! NOTE: this method cannot be const because the InputsIdLookup can
   //! cause a modification to that data member for cache eviction.
@@ -159,6 +199,16 @@ class FusionCache {
   //! Thread-Safe: Creates a child node for the current cache entry and an
   //! optional fusion_id is returned if the new entry is terminal
   TrieNode* createChild(TrieNode* node, RecordFunctor* rec);
+  //! Thread-Safe: With EnableOption::StructuralFusionCache, replace the
+  //! FusionExecutorCache of a new fusion by the one of a structurally equal
+  //! fusion defined by other records, see FusionExecutorCacheRegistry
+  void shareAutoGenSchedules(size_t fusion_id);
+  //! Thread-Safe: Marks a fusion as the most recently used
+  void recordUse(size_t fusion_id);
+  //! Thread-Safe: Updates the memory footprint of a fusion, e.g., after its
+  //! schedules compiled a new kernel runtime, and evicts the least recently
+  //! used fusions over the bounds of the cache
+  void updateFootprint(size_t fusion_id);
   //! Lookup the User Schedule based on Id
   UserSchedule* createUserSchedule(
       FusionSchedules* scheds,
@@ -168,6 +218,17 @@ class FusionCache {
   TrieNode* rootTriePtr();
 
  private:
+  //! Evicts the least recently used fusions until the cache is within its
+  //! bounds, but never the most recently used one.  lru_lock_ must be held.
+  void evictOverBounds();
+  //! Removes a fusion, its schedules and its terminal node from the cache,
+  //! as well as the ancestors of the node left without children.  lru_lock_
+  //! must be held.
+  void evict(size_t fusion_id);
+  //! Hash of the records leading to a terminal node, see
+  //! combineDefinitionHash
+  static size_t definitionHash(TrieNode* terminal_node);
+
   //! The static pointer to the FusionCache
   static FusionCache* singleton_;
   //! Lock for accessing the singleton by multiple threads
@@ -175,13 +236,28 @@ class FusionCache {
 
   //! The max allowed number of fusions in the cache
   size_t max_fusions_;
+  //! The max memory footprint of the fusions in the cache, or zero
+  size_t max_footprint_;
+  //! Sum of the footprints of the fusions in the cache
+  size_t footprint_;
+  //! Number of fusions evicted for stats collection
+  size_t num_evictions_;
+  //! The ids of the fusions in the cache, most recently used first
+  std::list<size_t> lru_fusions_;
+  //! For thread-Safe updates of the recently used fusions, the terminal
+  //! nodes by definition hash, and eviction
+  std::mutex lru_lock_;
   //! The root (start) of the prefix tree to start a cache look up of a given
   //! fusion definition.
   std::unique_ptr<TrieNode> root_;
-  //! A vector of nvFuser Fusion IR fusions.
+  //! A vector of nvFuser Fusion IR fusions indexed by fusion id.  The
+  //! entries of evicted fusions are null.
   std::vector<std::unique_ptr<FusionSchedules>> fusions_;
   //! A vector of Terminal trie nodes for Stats collection
   std::vector<TrieNode*> terminal_nodes_;
+  //! Terminal trie nodes by the hash of the records leading to them, see
+  //! queryDefinition
+  std::unordered_multimap<size_t, TrieNode*> definitions_;
 
   //! Items specifically to aid user defined schedules these data members
   //! are for the mechanics of user schedule usage and don't make sense as
@@ -46,12 +46,29 @@ const char* dtypeToPyString(PrimDataType t) {
   return nullptr;
 }
 
+DefinitionHandle::DefinitionHandle(
+    size_t fusion_id,
+    std::shared_ptr<FusionExecutorCache> auto_gen_schedules)
+    : fusion_id_(fusion_id),
+      auto_gen_schedules_(std::move(auto_gen_schedules)) {
+  NVF_ERROR(auto_gen_schedules_ != nullptr, "FusionExecutorCache is null!");
+}
+
+std::vector<at::Tensor> DefinitionHandle::execute(
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::optional<int8_t> selected_device) const {
+  FUSER_PERF_SCOPE("DefinitionHandle::execute");
+  return auto_gen_schedules_->runFusionWithInputs(
+      inputs, std::nullopt, selected_device);
+}
+
 FusionDefinition::FusionDefinition(std::optional<size_t> id, size_t max_length)
     : FusionState(),
       max_length_(max_length),
       fusion_id_(id),
       fusion_cache_(FusionCache::get()),
       trie_node_(nullptr),
+      definition_hash_(std::nullopt),
       prev_fusion_(nullptr),
       user_sched_(nullptr),
       ops(this),
@@ -66,11 +83,31 @@ FusionDefinition* FusionDefinition::setupDefinition() {
   NVF_CHECK(max_length_ > 0, "Can't make a FusionDefinition with 0 records!");
   NVF_CHECK(!id().has_value(), "Fusion Schedule is already found!");
   trie_node_ = fusionCache()->rootTriePtr();
+  definition_hash_ = isOptionEnabled(EnableOption::DefinitionHashLookup)
+      ? std::optional<size_t>(0)
+      : std::nullopt;
   return this;
 }
 
 void FusionDefinition::finalizeDefinition() {
   FUSER_PERF_SCOPE("FusionDefinition::finalizeDefinition");
+  if (definition_hash_.has_value()) {
+    auto terminal_node =
+        fusionCache()->queryDefinition(definition_hash_.value(), recording_);
+    if (terminal_node.has_value()) {
+      if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
+        debug() << "\nFusionDefinition: Definition (hash: 0x" << std::hex
+                << definition_hash_.value() << ") hit in Fusion Cache.\n";
+      }
+      trie_node_ = terminal_node.value();
+      fusion_id_ = std::optional<size_t>(trie_node_->fusion_id);
+      fusionCache()->recordUse(id().value());
+      return;
+    }
+    // The records were not added to the trie as they were defined
+    walkTrie();
+  }
+
   auto child_node = fusionCache()->queryChildren(trie_node_, end_record_.get());
   if (!child_node.has_value()) {
     if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
@@ -85,6 +122,7 @@ void FusionDefinition::finalizeDefinition() {
     }
 
     buildFusionIr(preschedFusion());
+    fusionCache()->shareAutoGenSchedules(id().value());
 
     if (isDebugDumpEnabled(DebugDumpOption::FusionIrPresched)) {
       printIr();
@@ -95,9 +133,49 @@ void FusionDefinition::finalizeDefinition() {
     }
     trie_node_ = child_node.value();
     fusion_id_ = std::optional<size_t>(trie_node_->fusion_id);
+    fusionCache()->recordUse(id().value());
+  }
+}
+
+void FusionDefinition::redefine() {
+  FUSER_PERF_SCOPE("FusionDefinition::redefine");
+  NVF_CHECK(
+      !recording_.empty(),
+      "The fusion with id ",
+      id().value(),
+      " was evicted from the FusionCache and has no records to redefine it.");
+  if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
+    debug() << "\nFusionDefinition: Redefining the evicted fusion with id "
+            << id().value() << "\n";
+  }
+  fusion_id_ = std::nullopt;
+  trie_node_ = fusionCache()->rootTriePtr();
+  // With a definition hash, finalizeDefinition walks the trie on a miss
+  if (!definition_hash_.has_value()) {
+    walkTrie();
+  }
+  finalizeDefinition();
+}
+
+void FusionDefinition::walkTrie() {
+  for (auto& record : recording_) {
+    auto child_node = fusionCache()->queryChildren(trie_node_, record.get());
+    trie_node_ = child_node.has_value()
+        ? child_node.value()
+        : fusionCache()->createChild(trie_node_, record.get());
   }
 }
 
+DefinitionHandle FusionDefinition::handle() {
+  NVF_CHECK(id().has_value(), "Invalid fusion definition!");
+  if (!fusionCache()->isCached(id().value())) {
+    redefine();
+  }
+  return DefinitionHandle(
+      id().value(),
+      fusionCache()->queryFusionSchedules(id().value())->auto_gen_schedules);
+}
+
 void FusionDefinition::setupSchedule(const at::ArrayRef<c10::IValue>& inputs) {
   FUSER_PERF_SCOPE("FusionDefinition::setupSchedule");
   NVF_CHECK(id().has_value(), "FusionDefinition definition does not exist!");
@@ -151,12 +229,15 @@ std::vector<at::Tensor> FusionDefinition::execute(
     const at::ArrayRef<c10::IValue>& inputs,
     bool override_user_schedule,
     bool capture_debug_output,
-    std::optional<int8_t> selected_device) const {
+    std::optional<int8_t> selected_device) {
   debug_output_ = std::nullopt;
   std::stringstream debug_ss;
   DebugStreamGuard dsg(capture_debug_output ? debug_ss : std::cout);
 
   NVF_CHECK(id().has_value(), "Valid fusion schedule is not available!");
+  if (!fusionCache()->isCached(id().value())) {
+    redefine();
+  }
 
   auto scheds = fusionCache()->queryFusionSchedules(id().value());
 
@@ -177,8 +258,14 @@ std::vector<at::Tensor> FusionDefinition::execute(
     }
   }
 
+  const auto num_runtimes = scheds->auto_gen_schedules->countRuntimes();
   outputs = scheds->auto_gen_schedules->runFusionWithInputs(
       inputs, std::nullopt, selected_device);
+  fusionCache()->recordUse(id().value());
+  // The footprint only grows when a new kernel runtime is compiled
+  if (scheds->auto_gen_schedules->countRuntimes() != num_runtimes) {
+    fusionCache()->updateFootprint(id().value());
+  }
 
   if (capture_debug_output) {
     debug_output_ = debug_ss.str();
@@ -187,6 +274,26 @@ std::vector<at::Tensor> FusionDefinition::execute(
   return outputs;
 }
 
+std::vector<std::vector<at::Tensor>> FusionDefinition::executeBatch(
+    const std::vector<std::vector<c10::IValue>>& batch,
+    std::optional<int8_t> selected_device) {
+  FUSER_PERF_SCOPE("FusionDefinition::executeBatch");
+  NVF_CHECK(id().has_value(), "Valid fusion schedule is not available!");
+  if (!fusionCache()->isCached(id().value())) {
+    redefine();
+  }
+
+  auto scheds = fusionCache()->queryFusionSchedules(id().value());
+  const auto num_runtimes = scheds->auto_gen_schedules->countRuntimes();
+  auto outputs = scheds->auto_gen_schedules->runFusionWithInputsBatch(
+      batch, selected_device);
+  fusionCache()->recordUse(id().value());
+  if (scheds->auto_gen_schedules->countRuntimes() != num_runtimes) {
+    fusionCache()->updateFootprint(id().value());
+  }
+  return outputs;
+}
+
 std::string FusionDefinition::fusionIr() {
   NVF_CHECK(id().has_value(), "Invalid fusion definition!");
   std::stringstream ss;
@@ -322,6 +429,12 @@ void FusionDefinition::defineRecord(RecordFunctor* record) {
       "operations.  The max_length for FusionDefintion's might need to be ",
       "increased if the definition is created as expected.");
   addRecord(record);
+  // The trie is only walked by finalizeDefinition, on a miss
+  if (definition_hash_.has_value()) {
+    definition_hash_ = FusionCache::combineDefinitionHash(
+        definition_hash_.value(), recording_.back().get());
+    return;
+  }
   auto child_node =
       fusionCache()->queryChildren(trie_node_, recording_.back().get());
   // If the Record is found in the cache, the FusionDefinition and the Cache
@@ -88,6 +88,33 @@ struct Vector {
   FusionDefinition* fusion_definition;
 };
 
+//! DefinitionHandle executes the fusion of a completed FusionDefinition
+//! without recording the definition again, e.g., for a model that would
+//! otherwise rebuild the same definition at every step.
+//!
+//! The handle shares the FusionExecutorCache of the fusion, so it stays valid
+//! after the fusion is evicted from the FusionCache.  The memory held by
+//! handles is not bounded by the FusionCache.  User schedules are not used.
+class DefinitionHandle {
+ public:
+  DefinitionHandle(
+      size_t fusion_id,
+      std::shared_ptr<FusionExecutorCache> auto_gen_schedules);
+
+  //! Executes the fusion with the automatically generated schedules
+  std::vector<at::Tensor> execute(
+      const at::ArrayRef<c10::IValue>& inputs,
+      std::optional<int8_t> device = std::nullopt) const;
+  //! Fusion id of the FusionDefinition when the handle was created
+  size_t id() const {
+    return fusion_id_;
+  }
+
+ private:
+  size_t fusion_id_;
+  std::shared_ptr<FusionExecutorCache> auto_gen_schedules_;
+};
+
 //! FusionDefinition defines the C++ side of a Python Context manager to
 //! encapsulate the definition of fusion operations.
 //!
@@ -96,6 +123,11 @@ struct Vector {
 //! in a cache and the recorded records are used to build an nvFuser Fusion
 //! object if the definition missed in the cache.
 //!
+//! The records are queried in the trie of the cache as they are defined.
+//! With EnableOption::DefinitionHashLookup, only a hash of the records is
+//! updated as they are defined, and the whole definition is looked up by
+//! its hash upon exit, see FusionCache::queryDefinition.
+//!
 //! The nested Operators class was designed to allow the user to query all the
 //! available Operators in the FusionDefinition via python help.
 //!
@@ -125,11 +157,18 @@ class FusionDefinition : public FusionState {
   //! Prints a python function representing the definition
   void print(std::ostream& os) const;
   //! Executes a fusion if a valid definition or cache lookup occurred prior
+  //! NOTE: The fusion is redefined if it was evicted from the FusionCache
   std::vector<at::Tensor> execute(
       const at::ArrayRef<c10::IValue>& inputs,
       bool override_user_schedule,
       bool capture_debug_output,
-      std::optional<int8_t> device) const;
+      std::optional<int8_t> device);
+  //! Executes the fusion for each set of inputs of the batch with the
+  //! automatically generated schedules, see
+  //! FusionExecutorCache::runFusionWithInputsBatch
+  std::vector<std::vector<at::Tensor>> executeBatch(
+      const std::vector<std::vector<c10::IValue>>& batch,
+      std::optional<int8_t> device);
   //! Return debugging output captured through exeuction with
   //! capture_debug_output=true
   std::optional<std::string> getDebugOutput() const {
@@ -156,6 +195,8 @@ class FusionDefinition : public FusionState {
       bool override_user_schedule) const;
   //! Return fusion id of defined FusionDefinition
   std::optional<size_t> id() const;
+  //! Return a handle to execute the fusion without this FusionDefinition
+  DefinitionHandle handle();
   //! Prints the Prescheduled Fusion IR representation
   void printMathIr();
 
@@ -182,6 +223,12 @@ class FusionDefinition : public FusionState {
   FusionCache* fusionCache() const;
   //! Return a prescheduled Fusion object
   Fusion* preschedFusion();
+  //! Adds the records of a fusion evicted from the FusionCache to the cache
+  //! again, under a new fusion id
+  void redefine();
+  //! Walks the trie from trie_node_ through the recorded records, creating
+  //! the nodes missing from the cache
+  void walkTrie();
 
   //! Holds the defined maximum length of a FusionDefinition in order to
   //! prevent a run away error. The user should feel free to increase this
@@ -193,6 +240,9 @@ class FusionDefinition : public FusionState {
   FusionCache* fusion_cache_;
   //! Current pointer to node in FusionCache.
   TrieNode* trie_node_;
+  //! Hash of the records defined so far, when the definition is looked up
+  //! by its hash
+  std::optional<size_t> definition_hash_;
 
   // Book keeping data members for user created schedules
 
@@ -320,9 +320,18 @@ void initNvFuserPythonBindings(PyObject* module) {
       .def_static(
           "get",
           &FusionCache::get,
-          py::arg("max_fusions") = int(8192),
+          py::arg("max_fusions") = py::none(),
           py::return_value_policy::reference)
       .def("num_fusions", &FusionCache::numFusions)
+      .def(
+          "set_max_fusions",
+          &FusionCache::setMaxFusions,
+          py::arg("max_fusions"))
+      .def(
+          "set_max_footprint",
+          &FusionCache::setMaxFootprint,
+          py::arg("max_footprint"))
+      .def("footprint", &FusionCache::footprint)
       .def_static(
           "reset", &FusionCache::reset, py::return_value_policy::reference)
       .def(
@@ -382,6 +391,38 @@ void initNvFuserPythonBindings(PyObject* module) {
   vector_class.def_property_readonly(
       "size", [](Vector& self) { return self.size; });
 
+  //! A handle executes the fusion of a FusionDefinition without recording it
+  py::class_<DefinitionHandle> definition_handle(nvfuser, "DefinitionHandle");
+  definition_handle.def("id", &DefinitionHandle::id)
+      .def(
+          "execute",
+          [](DefinitionHandle& self,
+             const py::iterable& iter,
+             std::optional<int64_t> device) {
+            std::vector<c10::IValue> inputs;
+            for (py::handle obj : iter) {
+              // Allows for a Vector of Sizes to be inputed as a list
+              if (py::isinstance<py::list>(obj)) {
+                for (py::handle item : obj) {
+                  inputs.push_back(
+                      torch::jit::toIValue(item, c10::AnyType::get()));
+                }
+              } else {
+                inputs.push_back(
+                    torch::jit::toIValue(obj, c10::AnyType::get()));
+              }
+            }
+            std::optional<int8_t> int8_device = std::nullopt;
+            if (device.has_value()) {
+              NVF_CHECK(device.value() < 256, "Maximum device index is 255");
+              int8_device = (int8_t)device.value();
+            }
+            return self.execute(inputs, int8_device);
+          },
+          py::arg("inputs"),
+          py::kw_only(),
+          py::arg("device") = py::none());
+
   //! The FusionDefinition is a context manager in Python where the user will
   //! define the set the operations and connections between operations for
   //! nvFuser to create.
@@ -473,6 +514,39 @@ void initNvFuserPythonBindings(PyObject* module) {
           py::arg("device") = py::none(),
           py::arg("capture_debug_output") = false,
           py::return_value_policy::reference)
+      .def(
+          "_execute_batch",
+          [](FusionDefinition& self,
+             const py::iterable& batch_iter,
+             std::optional<int64_t> device) {
+            std::vector<std::vector<c10::IValue>> batch;
+            for (py::handle iter : batch_iter) {
+              std::vector<c10::IValue>& inputs = batch.emplace_back();
+              for (py::handle obj : iter) {
+                // Allows for a Vector of Sizes to be inputed as a list
+                if (py::isinstance<py::list>(obj)) {
+                  for (py::handle item : obj) {
+                    inputs.push_back(
+                        torch::jit::toIValue(item, c10::AnyType::get()));
+                  }
+                } else {
+                  inputs.push_back(
+                      torch::jit::toIValue(obj, c10::AnyType::get()));
+                }
+              }
+            }
+            std::optional<int8_t> int8_device = std::nullopt;
+            if (device.has_value()) {
+              NVF_CHECK(device.value() < 256, "Maximum device index is 255");
+              int8_device = (int8_t)device.value();
+            }
+            return self.executeBatch(batch, int8_device);
+          },
+          py::arg("batch"),
+          py::kw_only(),
+          py::arg("device") = py::none(),
+          py::return_value_policy::reference)
+      .def("handle", &FusionDefinition::handle)
       .def(
           "_debug_output",
           [](FusionDefinition& self) { return self.getDebugOutput(); },
@@ -10,7 +10,9 @@
 
 #include <torch/torch.h>
 
+#include <options.h>
 #include <python_frontend/fusion_cache.h>
+#include <python_frontend/fusion_definition.h>
 #include <test/utils.h>
 #include <test/validator.h>
 
@@ -148,7 +150,19 @@ TEST_F(NVFuserTest, PyFusionCache_CUDA) {
     std::unique_ptr<RecordFunctor> end_record(new EndRecord());
     try {
       fc->createChild(node, end_record.get());
-      FAIL() << "Expected the cache to assert because it is full!";
+      SUCCEED();
+    } catch (const std::exception& e) {
+      FAIL() << "An unexpected assert on Terminal Cache Entry creation!"
+             << e.what();
+    }
+
+    // The cache is full, so the least recently used fusion is evicted
+    ASSERT_TRUE(fc->numFusions() == 1);
+    ASSERT_FALSE(fc->isCached(0));
+    ASSERT_TRUE(fc->isCached(1));
+    try {
+      fc->queryFusionSchedules(0);
+      FAIL() << "Expected an assert when querying an evicted fusion!";
     } catch (...) {
       SUCCEED();
     }
@@ -183,4 +197,115 @@ TEST_F(NVFuserTest, PyFusionCache_CUDA) {
   }
 }
 
+namespace {
+
+// Records the definition of op(t0) with a 1D input t0
+void defineUnaryOp(
+    FusionDefinition& fd,
+    const std::string& name,
+    TensorView* (*op)(TensorView*)) {
+  fd.setupDefinition();
+  auto t0 = fd.defineTensor(1);
+  fd.defineRecord(new TensorRecord(
+      {fd.recordingState(t0())}, {-1}, {true}, DataType::Float));
+  auto t1 = fd.defineTensor(1);
+  fd.defineRecord(new OpRecord<TensorView*, TensorView*>(
+      {fd.recordingState(t0())},
+      {fd.recordingState(t1())},
+      name,
+      serde::RecordType_Unary_TV,
+      op));
+  fd.defineRecord(new OutputRecord<TensorView>(
+      {fd.recordingState(t1())}, serde::RecordType_OutputTv));
+  fd.finalizeDefinition();
+}
+
+} // namespace
+
+// RUN CMD: bin/test_jit --gtest_filter="NVFuserTest*PyFusionCacheEviction*"
+TEST_F(NVFuserTest, PyFusionCacheEviction_CUDA) {
+  FusionCache::reset();
+  FusionCache* fc = FusionCache::get();
+  fc->setMaxFusions(1);
+  // Constructing a FusionDefinition doesn't change the bound of the cache
+  FusionDefinition fd_neg(std::nullopt);
+  FusionDefinition fd_abs(std::nullopt);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<c10::IValue> inputs = {at::randn({32}, options)};
+  auto t0 = inputs.at(0).toTensor();
+
+  defineUnaryOp(fd_neg, "ops.neg", neg);
+  auto outputs = fd_neg.execute(inputs, false, false, std::nullopt);
+  EXPECT_TRUE(outputs.at(0).equal(-t0));
+  EXPECT_GT(fc->footprint(), 0);
+
+  defineUnaryOp(fd_abs, "ops.abs", abs);
+  EXPECT_EQ(fc->numFusions(), 1);
+  EXPECT_FALSE(fc->isCached(fd_neg.id().value()));
+  EXPECT_TRUE(fc->isCached(fd_abs.id().value()));
+  // The branch of the evicted fusion is removed from the trie, but not the
+  // input record it shares with the other fusion
+  ASSERT_EQ(fc->rootTriePtr()->children.size(), 1);
+  EXPECT_EQ(fc->rootTriePtr()->children.begin()->second->children.size(), 1);
+
+  // An evicted definition is redefined when it is executed
+  const auto evicted_id = fd_neg.id().value();
+  outputs = fd_neg.execute(inputs, false, false, std::nullopt);
+  EXPECT_TRUE(outputs.at(0).equal(-t0));
+  EXPECT_NE(fd_neg.id().value(), evicted_id);
+  EXPECT_TRUE(fc->isCached(fd_neg.id().value()));
+  EXPECT_FALSE(fc->isCached(fd_abs.id().value()));
+
+  fc->setMaxFusions(8192);
+  outputs = fd_abs.execute(inputs, false, false, std::nullopt);
+  EXPECT_TRUE(outputs.at(0).equal(t0.abs()));
+  EXPECT_EQ(fc->numFusions(), 2);
+
+  // Only the most recently used fusion fits in a footprint of 1 byte
+  fc->setMaxFootprint(1);
+  EXPECT_EQ(fc->numFusions(), 1);
+  EXPECT_TRUE(fc->isCached(fd_abs.id().value()));
+  fc->setMaxFootprint(0);
+}
+
+// RUN CMD: bin/test_jit --gtest_filter="NVFuserTest*PyFusionCacheHash*"
+TEST_F(NVFuserTest, PyFusionCacheHashLookup_CUDA) {
+  FusionCache::reset();
+  FusionDefinition fd_neg(std::nullopt);
+  FusionDefinition fd_neg_hashed(std::nullopt);
+  FusionDefinition fd_abs_hashed(std::nullopt);
+  FusionDefinition fd_abs(std::nullopt);
+  FusionCache* fc = FusionCache::get();
+
+  // Records the definition in the trie
+  defineUnaryOp(fd_neg, "ops.neg", neg);
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::DefinitionHashLookup);
+
+  // The definition is found by the hash of its records
+  defineUnaryOp(fd_neg_hashed, "ops.neg", neg);
+  EXPECT_EQ(fd_neg_hashed.id(), fd_neg.id());
+  EXPECT_EQ(fc->numFusions(), 1);
+
+  // A definition missing from the cache is added to the trie
+  defineUnaryOp(fd_abs_hashed, "ops.abs", abs);
+  EXPECT_EQ(fc->numFusions(), 2);
+  EnableOptionsGuard::getCurOptions().unset(
+      EnableOption::DefinitionHashLookup);
+  defineUnaryOp(fd_abs, "ops.abs", abs);
+  EXPECT_EQ(fd_abs.id(), fd_abs_hashed.id());
+
+  // A handle outlives the eviction of its fusion
+  auto handle = fd_neg.handle();
+  fc->setMaxFusions(1);
+  EXPECT_FALSE(fc->isCached(handle.id()));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({32}, options);
+  auto outputs = handle.execute({t0});
+  EXPECT_TRUE(outputs.at(0).equal(-t0));
+}
+
 } // namespace nvfuser
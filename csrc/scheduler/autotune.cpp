@@ -0,0 +1,462 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <scheduler/autotune.h>
+
+#include <debug.h>
+#include <executor.h>
+#include <fusion.h>
+#include <options.h>
+#include <scheduler/registry.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace nvfuser {
+
+namespace {
+
+int64_t getKnob(const TuningKnobs& knobs, const std::string& name) {
+  auto it = knobs.find(name);
+  NVF_ERROR(it != knobs.end(), "Missing tuning knob: ", name);
+  return it->second;
+}
+
+// Candidate (vectorize, factor) pairs of a vectorized or unrolled
+// domain, starting with the current ones. Vectorization factors can
+// only be lowered as larger ones may not be supported by the
+// alignment of the tensors.
+std::vector<TuningKnobs> vectorizeOrUnrollCandidates(
+    const std::string& vectorize_name,
+    const std::string& factor_name,
+    bool vectorize,
+    int64_t factor) {
+  std::vector<TuningKnobs> candidates = {
+      {{vectorize_name, vectorize}, {factor_name, factor}}};
+  if (vectorize) {
+    for (int64_t f = factor / 2; f > 1; f /= 2) {
+      if (factor % f == 0) {
+        candidates.push_back({{vectorize_name, 1}, {factor_name, f}});
+      }
+    }
+    candidates.push_back({{vectorize_name, 0}, {factor_name, 1}});
+  } else {
+    for (int64_t f : {1, 2, 4, 8}) {
+      if (f != factor) {
+        candidates.push_back({{vectorize_name, 0}, {factor_name, f}});
+      }
+    }
+  }
+  return candidates;
+}
+
+// Limit a tuned (vectorize, factor) pair to the vectorization allowed
+// by the heuristic. Vectorization factors are powers of two, so the
+// smaller one divides the larger.
+void clampVectorizeOrUnroll(
+    TuningKnobs& knobs,
+    const std::string& vectorize_name,
+    const std::string& factor_name,
+    bool vectorize,
+    int64_t factor) {
+  if (getKnob(knobs, vectorize_name) == 0) {
+    return;
+  }
+  if (!vectorize) {
+    knobs[vectorize_name] = 0;
+    return;
+  }
+  knobs[factor_name] = std::min(getKnob(knobs, factor_name), factor);
+}
+
+// Powers of two dividing factor, starting with factor itself
+std::vector<int64_t> lowerVectorizeFactors(int64_t factor) {
+  std::vector<int64_t> factors = {factor};
+  for (int64_t f = factor / 2; f >= 1; f /= 2) {
+    if (factor % f == 0) {
+      factors.push_back(f);
+    }
+  }
+  return factors;
+}
+
+std::vector<TuningKnobs> singleKnobCandidates(
+    const std::string& name,
+    const std::vector<int64_t>& values) {
+  std::vector<TuningKnobs> candidates;
+  candidates.reserve(values.size());
+  for (auto value : values) {
+    candidates.push_back({{name, value}});
+  }
+  return candidates;
+}
+
+// Cartesian product of groups of knobs. Knobs that depend on each
+// other are in the same group. The first candidate of each group is
+// the current value, so the first candidate of the product is too.
+std::vector<TuningKnobs> knobProduct(
+    const std::vector<std::vector<TuningKnobs>>& groups) {
+  std::vector<TuningKnobs> product = {{}};
+  for (const auto& group : groups) {
+    std::vector<TuningKnobs> next;
+    next.reserve(product.size() * group.size());
+    for (const auto& partial : product) {
+      for (const auto& option : group) {
+        auto combined = partial;
+        combined.insert(option.begin(), option.end());
+        next.push_back(std::move(combined));
+      }
+    }
+    product = std::move(next);
+  }
+  return product;
+}
+
+// Move the first occurrence of value to the front, adding it if missing
+std::vector<int64_t> currentFirst(std::vector<int64_t> values, int64_t value) {
+  values.erase(std::remove(values.begin(), values.end(), value), values.end());
+  values.insert(values.begin(), value);
+  return values;
+}
+
+bool isTunableReduction(const ReductionParams& rparams) {
+  return !rparams.persistent_kernel && !rparams.cross_grid_inner_reduction &&
+      !rparams.cross_grid_outer_reduction;
+}
+
+// Keep the block dimensions and shared memory, and let the grid
+// dimensions be inferred from the schedule
+LaunchParams withoutGridDims(const LaunchParams& lparams) {
+  auto block_dim = [&](ParallelType pt) {
+    return lparams.hasDim(pt) ? lparams.getDim(pt)
+                              : LaunchParams::UNINITIALIZED_VAL;
+  };
+  LaunchParams new_lparams(
+      LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL,
+      block_dim(ParallelType::TIDx),
+      block_dim(ParallelType::TIDy),
+      block_dim(ParallelType::TIDz));
+  new_lparams.setSmem(lparams.smem());
+  return new_lparams;
+}
+
+} // namespace
+
+TuningKnobs getTuningKnobs(const HeuristicParams& params) {
+  if (auto pparams = dynamic_cast<const PointwiseParams*>(&params)) {
+    return {
+        {"vectorize", pparams->vectorize},
+        {"unroll_factor", (int64_t)pparams->unroll_factor}};
+  }
+  if (auto rparams = dynamic_cast<const ReductionParams*>(&params)) {
+    if (!isTunableReduction(*rparams)) {
+      return {};
+    }
+    return {
+        {"vectorize_inner_reduction", rparams->vectorize_inner_reduction},
+        {"unroll_factor_inner_reduction",
+         rparams->unroll_factor_inner_reduction},
+        {"vectorize_iter_dom", rparams->vectorize_iter_dom},
+        {"unroll_factor_iter_dom", rparams->unroll_factor_iter_dom}};
+  }
+  if (auto tparams = dynamic_cast<const TransposeParams*>(&params)) {
+    return {
+        {"vectorize_factor1", (int64_t)tparams->vectorize_factor1},
+        {"vectorize_factor2", (int64_t)tparams->vectorize_factor2}};
+  }
+  if (auto mparams = dynamic_cast<const MatmulParams*>(&params)) {
+    return {
+        {"cta_tile_m", mparams->tile_sizes.cta_tile.m},
+        {"cta_tile_n", mparams->tile_sizes.cta_tile.n},
+        {"cta_order", (int64_t)mparams->cta_order},
+        {"grid_swizzle_factor", mparams->grid_swizzle_factor},
+        {"smem_double_buffer_stage",
+         mparams->double_buffer_options.smem_double_buffer_stage}};
+  }
+  return {};
+}
+
+void applyTuningKnobs(HeuristicParams& params, const TuningKnobs& knobs) {
+  if (knobs.empty()) {
+    return;
+  }
+  if (auto pparams = dynamic_cast<PointwiseParams*>(&params)) {
+    pparams->vectorize = getKnob(knobs, "vectorize") != 0;
+    pparams->unroll_factor = (size_t)getKnob(knobs, "unroll_factor");
+    return;
+  }
+  if (auto rparams = dynamic_cast<ReductionParams*>(&params)) {
+    NVF_ERROR(
+        isTunableReduction(*rparams),
+        "Persistent and cross-grid reductions are not tunable");
+    if (getTuningKnobs(*rparams) == knobs) {
+      return;
+    }
+    rparams->vectorize_inner_reduction =
+        getKnob(knobs, "vectorize_inner_reduction") != 0;
+    rparams->unroll_factor_inner_reduction =
+        getKnob(knobs, "unroll_factor_inner_reduction");
+    rparams->vectorize_iter_dom = getKnob(knobs, "vectorize_iter_dom") != 0;
+    rparams->unroll_factor_iter_dom = getKnob(knobs, "unroll_factor_iter_dom");
+    // The grid dimensions computed by the heuristic assume the default
+    // unroll factors
+    rparams->lparams = withoutGridDims(rparams->lparams);
+    return;
+  }
+  if (auto tparams = dynamic_cast<TransposeParams*>(&params)) {
+    if (getTuningKnobs(*tparams) == knobs) {
+      return;
+    }
+    tparams->vectorize_factor1 = (size_t)getKnob(knobs, "vectorize_factor1");
+    tparams->vectorize_factor2 = (size_t)getKnob(knobs, "vectorize_factor2");
+    // The number of threads depends on the vectorization factors
+    tparams->lparams = LaunchParams();
+    tparams->lparams.bind(tparams->getThreadsPerBlock(), ParallelType::TIDx);
+    return;
+  }
+  if (auto mparams = dynamic_cast<MatmulParams*>(&params)) {
+    auto& cta_tile = mparams->tile_sizes.cta_tile;
+    auto& stages = mparams->double_buffer_options.smem_double_buffer_stage;
+    const auto cta_tile_m = (int)getKnob(knobs, "cta_tile_m");
+    const auto cta_tile_n = (int)getKnob(knobs, "cta_tile_n");
+    const auto new_stages = (int)getKnob(knobs, "smem_double_buffer_stage");
+    if (cta_tile.m != cta_tile_m || cta_tile.n != cta_tile_n ||
+        stages != new_stages) {
+      mparams->use_smem_epilogue = false;
+      mparams->promote_prologue_smem_reuse = false;
+    }
+    cta_tile.m = cta_tile_m;
+    cta_tile.n = cta_tile_n;
+    stages = new_stages;
+    mparams->cta_order =
+        (MatmulParams::TileRasterizationOrder)getKnob(knobs, "cta_order");
+    mparams->grid_swizzle_factor = (int)getKnob(knobs, "grid_swizzle_factor");
+    return;
+  }
+  NVF_ERROR(false, "Heuristic parameters are not tunable: ", params.toString());
+}
+
+TuningKnobs clampTuningKnobs(
+    const HeuristicParams& params,
+    const TuningKnobs& knobs) {
+  auto clamped = knobs;
+  if (auto pparams = dynamic_cast<const PointwiseParams*>(&params)) {
+    clampVectorizeOrUnroll(
+        clamped,
+        "vectorize",
+        "unroll_factor",
+        pparams->vectorize,
+        (int64_t)pparams->unroll_factor);
+  } else if (auto rparams = dynamic_cast<const ReductionParams*>(&params)) {
+    clampVectorizeOrUnroll(
+        clamped,
+        "vectorize_inner_reduction",
+        "unroll_factor_inner_reduction",
+        rparams->vectorize_inner_reduction,
+        rparams->unroll_factor_inner_reduction);
+    clampVectorizeOrUnroll(
+        clamped,
+        "vectorize_iter_dom",
+        "unroll_factor_iter_dom",
+        rparams->vectorize_iter_dom,
+        rparams->unroll_factor_iter_dom);
+  } else if (auto tparams = dynamic_cast<const TransposeParams*>(&params)) {
+    for (const auto& [name, factor] :
+         {std::make_pair("vectorize_factor1", tparams->vectorize_factor1),
+          std::make_pair("vectorize_factor2", tparams->vectorize_factor2)}) {
+      clamped[name] = std::min(getKnob(clamped, name), (int64_t)factor);
+    }
+  }
+  return clamped;
+}
+
+std::vector<TuningKnobs> enumerateTuningCandidates(
+    const HeuristicParams& params) {
+  if (auto pparams = dynamic_cast<const PointwiseParams*>(&params)) {
+    return vectorizeOrUnrollCandidates(
+        "vectorize",
+        "unroll_factor",
+        pparams->vectorize,
+        (int64_t)pparams->unroll_factor);
+  }
+  if (auto rparams = dynamic_cast<const ReductionParams*>(&params)) {
+    if (!isTunableReduction(*rparams)) {
+      return {{}};
+    }
+    return knobProduct(
+        {vectorizeOrUnrollCandidates(
+             "vectorize_inner_reduction",
+             "unroll_factor_inner_reduction",
+             rparams->vectorize_inner_reduction,
+             rparams->unroll_factor_inner_reduction),
+         vectorizeOrUnrollCandidates(
+             "vectorize_iter_dom",
+             "unroll_factor_iter_dom",
+             rparams->vectorize_iter_dom,
+             rparams->unroll_factor_iter_dom)});
+  }
+  if (auto tparams = dynamic_cast<const TransposeParams*>(&params)) {
+    return knobProduct(
+        {singleKnobCandidates(
+             "vectorize_factor1",
+             lowerVectorizeFactors((int64_t)tparams->vectorize_factor1)),
+         singleKnobCandidates(
+             "vectorize_factor2",
+             lowerVectorizeFactors((int64_t)tparams->vectorize_factor2))});
+  }
+  if (auto mparams = dynamic_cast<const MatmulParams*>(&params)) {
+    // CTA tiles of four warp tiles, as in the built-in heuristic
+    const auto& tile_sizes = mparams->tile_sizes;
+    std::vector<TuningKnobs> cta_tiles = {
+        {{"cta_tile_m", tile_sizes.cta_tile.m},
+         {"cta_tile_n", tile_sizes.cta_tile.n}}};
+    for (auto [m_ratio, n_ratio] : std::vector<std::pair<int64_t, int64_t>>{
+             {1, 4}, {2, 2}, {4, 1}}) {
+      TuningKnobs cta_tile = {
+          {"cta_tile_m", tile_sizes.warp_tile.m * m_ratio},
+          {"cta_tile_n", tile_sizes.warp_tile.n * n_ratio}};
+      if (cta_tile != cta_tiles.front()) {
+        cta_tiles.push_back(cta_tile);
+      }
+    }
+    std::vector<int64_t> stages = {
+        mparams->double_buffer_options.smem_double_buffer_stage};
+    if (mparams->double_buffer_options.double_buffer_smem_write) {
+      stages = currentFirst({2, 3, 4}, stages.front());
+    }
+    return knobProduct(
+        {cta_tiles,
+         singleKnobCandidates(
+             "cta_order", currentFirst({0, 1}, (int64_t)mparams->cta_order)),
+         singleKnobCandidates(
+             "grid_swizzle_factor",
+             currentFirst({1, 2, 4}, mparams->grid_swizzle_factor)),
+         singleKnobCandidates("smem_double_buffer_stage", stages)});
+  }
+  return {{}};
+}
+
+std::optional<double> GpuMeasurementBackend::measure(
+    ScheduleHeuristic heuristic,
+    const HeuristicParams& params) {
+  Fusion fusion(*fusion_);
+  FusionGuard fg(&fusion);
+  SchedulerRuntimeInfo runtime_info(&fusion, args_);
+  // Start from the built-in heuristic so that only the knobs of params
+  // are taken
+  auto entry = SchedulerEntry::makeEntry(
+      heuristic,
+      &fusion,
+      runtime_info,
+      /*data_cache=*/nullptr,
+      /*use_heuristic_db=*/false);
+  applyTuningKnobs(*entry->params(), getTuningKnobs(params));
+  const auto& lparams = entry->params()->lparams;
+  const auto& cparams = entry->params()->cparams;
+
+  try {
+    entry->schedule(&fusion);
+    FusionExecutor fe;
+    fe.compileFusion(&fusion, args_, lparams, cparams);
+    fe.setMeasureKernelTimeFlag(true);
+    for (int64_t i = 0; i < warmup_runs_; ++i) {
+      fe.runFusion(args_, lparams, cparams);
+    }
+    double total_ms = 0;
+    for (int64_t i = 0; i < timed_runs_; ++i) {
+      fe.runFusion(args_, lparams, cparams);
+      total_ms += fe.kernelTimeMs();
+    }
+    return total_ms * 1e3 / (double)timed_runs_;
+  } catch (const std::exception& e) {
+    if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+      debug() << "Autotuning candidate failed: "
+              << toString(getTuningKnobs(params)) << "\n"
+              << e.what() << std::endl;
+    }
+    return std::nullopt;
+  }
+}
+
+std::string TuningResult::toString() const {
+  std::stringstream ss;
+  ss << "TuningResult{heuristic=" << heuristic
+     << ", default=" << nvfuser::toString(default_knobs)
+     << ", default_time_us=" << default_time_us
+     << ", best=" << nvfuser::toString(best_knobs)
+     << ", best_time_us=" << best_time_us
+     << ", num_candidates=" << num_candidates << "}";
+  return ss.str();
+}
+
+TuningResult tuneHeuristicParams(
+    ScheduleHeuristic heuristic,
+    const HeuristicParams& default_params,
+    MeasurementBackend& backend) {
+  TuningResult result;
+  result.heuristic = heuristic;
+  result.default_knobs = getTuningKnobs(default_params);
+  result.best_knobs = result.default_knobs;
+  result.default_time_us = std::numeric_limits<double>::infinity();
+  result.best_time_us = std::numeric_limits<double>::infinity();
+
+  for (const auto& knobs : enumerateTuningCandidates(default_params)) {
+    auto params = default_params.clone();
+    applyTuningKnobs(*params, knobs);
+    auto time_us = backend.measure(heuristic, *params);
+    ++result.num_candidates;
+    if (!time_us.has_value()) {
+      continue;
+    }
+    if (knobs == result.default_knobs) {
+      result.default_time_us = time_us.value();
+    }
+    if (time_us.value() < result.best_time_us) {
+      result.best_time_us = time_us.value();
+      result.best_knobs = knobs;
+    }
+  }
+  return result;
+}
+
+std::optional<TuningResult> tuneFusion(
+    Fusion* fusion,
+    const KernelArgumentHolder& args,
+    MeasurementBackend& backend,
+    HeuristicDb& db) {
+  FusionGuard fg(fusion);
+  SchedulerRuntimeInfo runtime_info(fusion, args);
+  auto heuristic = SchedulerEntry::proposeHeuristics(fusion, runtime_info);
+  NVF_CHECK(
+      heuristic.has_value(),
+      "Autotuning requires a fusion scheduled as a single kernel");
+  auto entry = SchedulerEntry::makeEntry(
+      heuristic.value(),
+      fusion,
+      runtime_info,
+      /*data_cache=*/nullptr,
+      /*use_heuristic_db=*/false);
+  if (entry->params() == nullptr || getTuningKnobs(*entry->params()).empty()) {
+    return std::nullopt;
+  }
+
+  auto result =
+      tuneHeuristicParams(heuristic.value(), *entry->params(), backend);
+  if (db.enabled() && std::isfinite(result.best_time_us)) {
+    db.write(
+        HeuristicDb::makeKey(fusion, runtime_info, heuristic.value()),
+        result.best_knobs,
+        result.best_time_us);
+  }
+  return result;
+}
+
+} // namespace nvfuser
@@ -0,0 +1,165 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <executor_kernel_arg.h>
+#include <scheduler/heuristic.h>
+#include <scheduler/heuristic_db.h>
+#include <scheduler/heuristic_types.h>
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace nvfuser {
+
+class Fusion;
+
+//! Offline autotuning of heuristic parameters
+//!
+//! The built-in heuristics pick the parameters of a schedule with
+//! hand-written formulas. The autotuner enumerates a space of
+//! parameters around them, measures each candidate with a
+//! MeasurementBackend and records the fastest one in the HeuristicDb,
+//! which SchedulerEntry::makeEntry consults when the database is
+//! enabled.
+//!
+//! Tunable parameters, or knobs, only include the ones that can be
+//! changed after the heuristic is computed without invalidating the
+//! schedule:
+//!
+//!   PointwiseParams: vectorize, unroll_factor. A vectorization factor
+//!     can only be lowered as the built-in heuristic uses the largest
+//!     factor allowed by the alignment of the inputs.
+//!   ReductionParams: vectorize_inner_reduction,
+//!     unroll_factor_inner_reduction, vectorize_iter_dom,
+//!     unroll_factor_iter_dom. Persistent and cross-grid reductions,
+//!     whose buffers and grids are sized by these factors, are not
+//!     tuned.
+//!   TransposeParams: vectorize_factor1, vectorize_factor2. Tile sizes
+//!     determine how small dimensions are split and are not tuned.
+//!   MatmulParams: cta_tile_m, cta_tile_n, cta_order,
+//!     grid_swizzle_factor, smem_double_buffer_stage. The shared memory
+//!     epilogue is disabled when the tile or the number of stages
+//!     changes, as it's only enabled when it fits the default ones.
+
+//! Current values of the knobs of params. Heuristics without knobs
+//! return an empty map.
+TuningKnobs getTuningKnobs(const HeuristicParams& params);
+
+//! Set the knobs of params and update the launch parameters that
+//! depend on them
+void applyTuningKnobs(HeuristicParams& params, const TuningKnobs& knobs);
+
+//! Knobs recorded for another run, limited to what params allows. Tuned
+//! inputs of the same shape bucket may be less aligned, so vectorization
+//! is dropped where params doesn't vectorize and vectorization factors
+//! are lowered to those of params. Unroll factors are kept.
+TuningKnobs clampTuningKnobs(
+    const HeuristicParams& params,
+    const TuningKnobs& knobs);
+
+//! Candidate knobs around the given params. The first candidate is the
+//! current value.
+std::vector<TuningKnobs> enumerateTuningCandidates(
+    const HeuristicParams& params);
+
+//! Measures the time of a heuristic parameter candidate
+class MeasurementBackend {
+ public:
+  virtual ~MeasurementBackend() = default;
+
+  //! Time in microseconds, or nullopt if the candidate is invalid,
+  //! e.g., it fails to compile or to launch
+  virtual std::optional<double> measure(
+      ScheduleHeuristic heuristic,
+      const HeuristicParams& params) = 0;
+};
+
+//! Compiles the fusion with each candidate and times it on the current
+//! GPU
+class GpuMeasurementBackend : public MeasurementBackend {
+ public:
+  GpuMeasurementBackend(
+      Fusion* fusion,
+      const KernelArgumentHolder& args,
+      int64_t warmup_runs = 2,
+      int64_t timed_runs = 10)
+      : fusion_(fusion),
+        args_(args),
+        warmup_runs_(warmup_runs),
+        timed_runs_(timed_runs) {}
+
+  std::optional<double> measure(
+      ScheduleHeuristic heuristic,
+      const HeuristicParams& params) override;
+
+ private:
+  Fusion* fusion_ = nullptr;
+  KernelArgumentHolder args_;
+  int64_t warmup_runs_ = 2;
+  int64_t timed_runs_ = 10;
+};
+
+//! Times given by a function, e.g., a cost model. Used for testing
+//! the tuner without a GPU.
+class MockMeasurementBackend : public MeasurementBackend {
+ public:
+  using TimeFunction = std::function<std::optional<double>(
+      ScheduleHeuristic,
+      const HeuristicParams&)>;
+
+  MockMeasurementBackend(TimeFunction time_function)
+      : time_function_(std::move(time_function)) {}
+
+  std::optional<double> measure(
+      ScheduleHeuristic heuristic,
+      const HeuristicParams& params) override {
+    ++num_measurements_;
+    return time_function_(heuristic, params);
+  }
+
+  int64_t numMeasurements() const {
+    return num_measurements_;
+  }
+
+ private:
+  TimeFunction time_function_;
+  int64_t num_measurements_ = 0;
+};
+
+struct TuningResult {
+  ScheduleHeuristic heuristic = ScheduleHeuristic::None;
+  TuningKnobs default_knobs;
+  TuningKnobs best_knobs;
+  //! Infinite if the default parameters failed to run
+  double default_time_us = 0;
+  double best_time_us = 0;
+  int64_t num_candidates = 0;
+
+  std::string toString() const;
+};
+
+//! Measure the candidates around default_params and return the fastest
+//! one
+TuningResult tuneHeuristicParams(
+    ScheduleHeuristic heuristic,
+    const HeuristicParams& default_params,
+    MeasurementBackend& backend);
+
+//! Tune a fusion that is scheduled as a single kernel for the given
+//! arguments and record the best parameters in db. Returns the result
+//! of tuning, or nullopt if the fusion has no tunable parameters.
+std::optional<TuningResult> tuneFusion(
+    Fusion* fusion,
+    const KernelArgumentHolder& args,
+    MeasurementBackend& backend,
+    HeuristicDb& db);
+
+} // namespace nvfuser
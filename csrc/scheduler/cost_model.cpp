@@ -0,0 +1,162 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <scheduler/cost_model.h>
+
+#include <cuda_utils.h>
+#include <expr_evaluator.h>
+#include <fusion.h>
+#include <ir/all_nodes.h>
+
+#include <ATen/cuda/CUDAContext.h>
+
+#include <algorithm>
+#include <sstream>
+#include <unordered_set>
+
+namespace nvfuser {
+
+KernelCost& KernelCost::operator+=(const KernelCost& other) {
+  bytes_read += other.bytes_read;
+  bytes_written += other.bytes_written;
+  num_launches += other.num_launches;
+  // Average the occupancies weighted by the time spent in each kernel
+  const double total_time_us = time_us + other.time_us;
+  if (total_time_us > 0) {
+    occupancy = (occupancy * time_us + other.occupancy * other.time_us) /
+        total_time_us;
+  } else {
+    occupancy = std::min(occupancy, other.occupancy);
+  }
+  time_us = total_time_us;
+  return *this;
+}
+
+std::string KernelCost::toString() const {
+  std::stringstream ss;
+  ss << "KernelCost{bytes_read=" << bytes_read
+     << ", bytes_written=" << bytes_written
+     << ", num_launches=" << num_launches << ", occupancy=" << occupancy
+     << ", time_us=" << time_us << "}";
+  return ss.str();
+}
+
+DeviceModel DeviceModel::current() {
+  const auto prop = at::cuda::getCurrentDeviceProperties();
+  DeviceModel device;
+  device.num_sms = prop->multiProcessorCount;
+  device.max_threads_per_sm = prop->maxThreadsPerMultiProcessor;
+  device.threads_per_sm_to_saturate = device.max_threads_per_sm / 2;
+  device.smem_per_sm_bytes = (int64_t)prop->sharedMemPerMultiprocessor;
+  // cudaDeviceProp::memoryClockRate is deprecated, so the memory clock
+  // is queried as a device attribute
+  int device_index = 0;
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaGetDevice(&device_index));
+  int memory_clock_khz = 0;
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceGetAttribute(
+      &memory_clock_khz, cudaDevAttrMemoryClockRate, device_index));
+  int bus_width_bits = 0;
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceGetAttribute(
+      &bus_width_bits, cudaDevAttrGlobalMemoryBusWidth, device_index));
+  // Double data rate
+  device.dram_bandwidth_gbps = 2.0 * (double)memory_clock_khz * 1e3 *
+      ((double)bus_width_bits / 8.0) / 1e9;
+  return device;
+}
+
+KernelCost SegmentCostModel::estimate(
+    Fusion* fusion,
+    ExpressionEvaluator& ee,
+    const HeuristicParams* params) const {
+  return estimate(fusion->inputs(), fusion->outputs(), ee, params);
+}
+
+double AnalyticalCostModel::occupancy(const LaunchParams& lparams) const {
+  if (!lparams.hasDim(ParallelType::BIDx) &&
+      !lparams.hasDim(ParallelType::BIDy) &&
+      !lparams.hasDim(ParallelType::BIDz)) {
+    return 1.0;
+  }
+
+  const int64_t threads_per_block =
+      lparams.bdimx() * lparams.bdimy() * lparams.bdimz();
+  const int64_t num_blocks =
+      lparams.gdimx() * lparams.gdimy() * lparams.gdimz();
+
+  int64_t blocks_per_sm = device_.max_threads_per_sm / threads_per_block;
+  if (lparams.smem() > 0) {
+    blocks_per_sm =
+        std::min(blocks_per_sm, device_.smem_per_sm_bytes / lparams.smem());
+  }
+  blocks_per_sm = std::max(blocks_per_sm, (int64_t)1);
+
+  const int64_t resident_blocks =
+      std::min(num_blocks, blocks_per_sm * device_.num_sms);
+  const double resident_threads =
+      (double)resident_blocks * (double)threads_per_block;
+  const double saturating_threads =
+      (double)device_.num_sms * (double)device_.threads_per_sm_to_saturate;
+  return std::min(1.0, resident_threads / saturating_threads);
+}
+
+int64_t AnalyticalCostModel::tensorBytes(Val* val, ExpressionEvaluator& ee)
+    const {
+  auto tv = dynamic_cast<TensorView*>(val);
+  if (tv == nullptr) {
+    return 0;
+  }
+  int64_t numel = 1;
+  for (auto id : TensorDomain::noReductions(tv->getMaybeRFactorDomain())) {
+    if (id->isBroadcast()) {
+      continue;
+    }
+    auto extent = ee.evaluate(id->extent());
+    NVF_ERROR(
+        extent.hasValue(),
+        "Could not evaluate the extent of ",
+        id->toString(),
+        " of ",
+        tv->toString());
+    numel *= extent.as<int64_t>();
+  }
+  return numel * (int64_t)dataTypeSize(tv->dtype(), DataType::Int);
+}
+
+KernelCost AnalyticalCostModel::estimate(
+    const std::vector<Val*>& inputs,
+    const std::vector<Val*>& outputs,
+    ExpressionEvaluator& ee,
+    const HeuristicParams* params) const {
+  KernelCost cost;
+  cost.num_launches = 1;
+
+  std::unordered_set<Val*> visited;
+  for (auto inp : inputs) {
+    if (visited.insert(inp).second) {
+      cost.bytes_read += tensorBytes(inp, ee);
+    }
+  }
+  visited.clear();
+  for (auto out : outputs) {
+    if (visited.insert(out).second) {
+      cost.bytes_written += tensorBytes(out, ee);
+    }
+  }
+
+  if (params != nullptr) {
+    cost.occupancy = occupancy(params->lparams);
+  }
+
+  // GB/s is bytes per nanosecond, so 1e3 bytes per microsecond
+  const double bytes_per_us =
+      device_.dram_bandwidth_gbps * 1e3 * cost.occupancy;
+  cost.time_us = device_.launch_overhead_us +
+      (double)(cost.bytes_read + cost.bytes_written) / bytes_per_us;
+  return cost;
+}
+
+} // namespace nvfuser
@@ -0,0 +1,112 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <executor_params.h>
+#include <scheduler/heuristic.h>
+
+#include <string>
+#include <vector>
+
+namespace nvfuser {
+
+class ExpressionEvaluator;
+class Fusion;
+class Val;
+
+//! Estimated cost of running a kernel, or a sum of kernels
+struct KernelCost {
+  int64_t bytes_read = 0;
+  int64_t bytes_written = 0;
+  int64_t num_launches = 0;
+  //! Fraction of the device kept busy, in (0, 1]. For a sum of
+  //! kernels, this is the average occupancy weighted by the time of
+  //! each kernel.
+  double occupancy = 1.0;
+  //! Estimated wall time in microseconds
+  double time_us = 0.0;
+
+  KernelCost& operator+=(const KernelCost& other);
+
+  std::string toString() const;
+};
+
+//! Device parameters used by the analytical cost model. The default
+//! values correspond to an A100.
+struct DeviceModel {
+  int64_t num_sms = 108;
+  double dram_bandwidth_gbps = 1555.0;
+  double launch_overhead_us = 3.0;
+  //! Number of resident threads per SM needed to saturate the memory
+  //! bandwidth
+  int64_t threads_per_sm_to_saturate = 1024;
+  int64_t max_threads_per_sm = 2048;
+  int64_t smem_per_sm_bytes = 164 * 1024;
+
+  //! Model of the current CUDA device
+  static DeviceModel current();
+};
+
+//! Interface of cost models used to rank segmentation choices. A
+//! segment is described by its inputs and outputs, whose sizes are
+//! evaluated with the given evaluator. Heuristic parameters, when
+//! available, refine the estimate with the launch configuration.
+class SegmentCostModel {
+ public:
+  virtual ~SegmentCostModel() = default;
+
+  virtual KernelCost estimate(
+      const std::vector<Val*>& inputs,
+      const std::vector<Val*>& outputs,
+      ExpressionEvaluator& ee,
+      const HeuristicParams* params = nullptr) const = 0;
+
+  //! Estimate a whole fusion as a single kernel
+  KernelCost estimate(
+      Fusion* fusion,
+      ExpressionEvaluator& ee,
+      const HeuristicParams* params = nullptr) const;
+};
+
+//! Roofline-style model of memory-bound kernels. A kernel reads its
+//! input tensors and writes its output tensors once. The time is the
+//! launch overhead plus the memory traffic over the DRAM bandwidth,
+//! scaled by the estimated occupancy.
+class AnalyticalCostModel : public SegmentCostModel {
+ public:
+  AnalyticalCostModel(DeviceModel device = DeviceModel())
+      : device_(device) {}
+
+  using SegmentCostModel::estimate;
+
+  KernelCost estimate(
+      const std::vector<Val*>& inputs,
+      const std::vector<Val*>& outputs,
+      ExpressionEvaluator& ee,
+      const HeuristicParams* params = nullptr) const override;
+
+  //! Fraction of the memory bandwidth a launch configuration is
+  //! expected to achieve. Launches without a grid dimension are
+  //! assumed to fill the device.
+  double occupancy(const LaunchParams& lparams) const;
+
+  const DeviceModel& device() const {
+    return device_;
+  }
+
+ private:
+  //! Number of bytes of a tensor. Broadcast domains are not
+  //! materialized and count as one.
+  int64_t tensorBytes(Val* val, ExpressionEvaluator& ee) const;
+
+ private:
+  DeviceModel device_;
+};
+
+} // namespace nvfuser
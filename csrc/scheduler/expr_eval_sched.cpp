@@ -0,0 +1,139 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+
+#include <executor_utils.h>
+#include <instrumentation.h>
+#include <ir/utils.h>
+#include <options.h>
+#include <scheduler/debug_utils.h>
+#include <scheduler/expr_eval_sched.h>
+
+namespace nvfuser {
+
+namespace {
+
+// Returns true if expr has an ATen implementation of Expr::evaluate that does
+// not depend on values outside of the segment
+bool isEvaluatedWithATen(Expr* expr) {
+  if (expr->isOneOf<
+          ViewOp,
+          BroadcastOp,
+          SqueezeOp,
+          SliceOp,
+          SelectOp,
+          IndexSelectOp,
+          TorchGatherOp,
+          ScanOp>()) {
+    return true;
+  }
+  if (auto ldst = dynamic_cast<LoadStoreOp*>(expr)) {
+    return ldst->opType() == LoadStoreOpType::Set &&
+        ldst->out()->isA<TensorView>();
+  }
+  if (auto rop = dynamic_cast<ReductionOp*>(expr)) {
+    return (rop->getReductionOpType() == BinaryOpType::Add ||
+            rop->getReductionOpType() == BinaryOpType::Max) &&
+        !rop->out()->as<TensorView>()->hasRFactor();
+  }
+  // CatOp::evaluate reads the unpadded inputs of its producer PadOps, so
+  // they have to be part of the same segment
+  if (auto cat = dynamic_cast<CatOp*>(expr)) {
+    return std::all_of(
+        cat->inputs().begin(), cat->inputs().end(), [](Val* inp) {
+          return !inp->isFusionInput() && inp->definition() != nullptr &&
+              inp->definition()->isA<PadOp>();
+        });
+  }
+  if (auto pad = dynamic_cast<PadOp*>(expr)) {
+    auto uses = pad->out()->uses();
+    return !pad->out()->isFusionOutput() && !uses.empty() &&
+        std::all_of(uses.begin(), uses.end(), [](Expr* use) {
+             return use->isA<CatOp>();
+           });
+  }
+  return false;
+}
+
+} // namespace
+
+ExprEvalScheduler::ExprEvalScheduler(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache)
+    : SchedulerEntry(ScheduleHeuristic::ExprEval) {
+  params_ =
+      std::make_shared<ExprEvalHeuristic>("", runtime_info.getIndexType());
+}
+
+bool ExprEvalScheduler::canScheduleCompileTime(Fusion* fusion) {
+  if (!isOptionEnabled(EnableOption::ExprEvalSegments)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        ScheduleHeuristic::ExprEval, "not enabled");
+    return false;
+  }
+
+  auto exprs = fusion->exprs();
+  if (exprs.empty()) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        ScheduleHeuristic::ExprEval, "no expression to evaluate");
+    return false;
+  }
+
+  for (auto out : fusion->outputs()) {
+    if (!out->isA<TensorView>()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::ExprEval, "output is not a tensor");
+      return false;
+    }
+  }
+
+  for (auto expr : exprs) {
+    if (!isEvaluatedWithATen(expr)) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::ExprEval,
+          "expression is not evaluated with ATen: ",
+          expr->getOpString());
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool ExprEvalScheduler::canScheduleRunTime(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  return true;
+}
+
+void ExprEvalScheduler::schedule(Fusion* fusion) {
+  // Nothing to schedule, the segment is not lowered.
+}
+
+std::vector<at::Tensor> evaluateFusionOutputs(
+    Fusion* fusion,
+    const KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("evaluateFusionOutputs");
+  ExpressionEvaluator expr_eval = executor_utils::bindInputs(args, fusion);
+
+  std::vector<at::Tensor> outputs;
+  outputs.reserve(fusion->outputs().size());
+  for (auto out : fusion->outputs()) {
+    const auto& value = expr_eval.evaluate(out);
+    NVF_ERROR(
+        value.is<at::Tensor>(),
+        "Failed to evaluate ",
+        out->toString(),
+        " with ATen");
+    outputs.push_back(value.as<at::Tensor>());
+  }
+  return outputs;
+}
+
+} // namespace nvfuser
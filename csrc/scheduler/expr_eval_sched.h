@@ -0,0 +1,77 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <scheduler/heuristic.h>
+#include <scheduler/registry.h>
+
+#include <vector>
+
+namespace nvfuser {
+
+class Fusion;
+class KernelArgumentHolder;
+class SchedulerRuntimeInfo;
+class HeuristicSummary;
+
+//! ExprEval scheduler represents the case where a segment is not lowered
+//!  to a CUDA kernel, but is run on the host through ExpressionEvaluator,
+//!  i.e., with the ATen implementation of Expr::evaluate of each of its
+//!  expressions.
+//!
+//! Typical use case of this scheduler is a segment made only of metadata
+//!  operations (reshape, permute, slice, squeeze, broadcast), which produce
+//!  aliases of their inputs, or of ops that ATen already implements with
+//!  a dedicated kernel (index_select, gather, cat). No NVRTC compilation is
+//!  needed to run such a segment.
+//!
+//! This scheduler is only considered with NVFUSER_ENABLE=expr_eval_segments.
+class ExprEvalScheduler : public SchedulerEntry {
+ public:
+  explicit ExprEvalScheduler(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+
+  //! Check if all the expressions of the fusion can be evaluated with ATen
+  static bool canScheduleCompileTime(Fusion* fusion);
+
+  static bool canScheduleRunTime(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+
+  void schedule(Fusion* fusion) override;
+};
+
+//! Provides a dummy heuristic type to ensure
+//!  unified interface on ExprEval scheduler.
+class ExprEvalHeuristic : public HeuristicParams {
+ public:
+  using HeuristicParams::HeuristicParams;
+
+  size_t hash() const override {
+    return 0;
+  }
+  std::shared_ptr<HeuristicParams> clone() const override {
+    return std::make_shared<ExprEvalHeuristic>(*this);
+  }
+  bool sameAs(const std::shared_ptr<HeuristicParams>& other) const override {
+    auto other_casted = std::dynamic_pointer_cast<ExprEvalHeuristic>(other);
+    return other_casted != nullptr && other_casted->cparams == cparams;
+  };
+};
+
+//! Runs a fusion accepted by the ExprEval scheduler with the given
+//!  arguments and returns its outputs. The outputs may alias the inputs.
+//!  The tensors can be on any device supported by ATen, including CPU.
+std::vector<at::Tensor> evaluateFusionOutputs(
+    Fusion* fusion,
+    const KernelArgumentHolder& args);
+
+} // namespace nvfuser
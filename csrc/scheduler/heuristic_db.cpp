@@ -0,0 +1,306 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <fstream>
+#include <mutex>
+#include <regex>
+#include <sstream>
+
+#include <fusion.h>
+#include <instrumentation.h>
+#include <ir/all_nodes.h>
+#include <ir/utils.h>
+#include <iter_visitor.h>
+#include <kernel_db/utils.h>
+#include <options.h>
+#include <scheduler/heuristic_db.h>
+#include <scheduler/registry.h>
+#include <utils.h>
+
+#include <ATen/cuda/CUDAContext.h>
+
+namespace nvfuser {
+
+static std::mutex heuristic_db_lock;
+
+std::string toString(const TuningKnobs& knobs) {
+  std::stringstream ss;
+  bool first = true;
+  for (const auto& [name, value] : knobs) {
+    if (!first) {
+      ss << ";";
+    }
+    first = false;
+    ss << name << "=" << value;
+  }
+  return ss.str();
+}
+
+TuningKnobs parseTuningKnobs(const std::string& str) {
+  TuningKnobs knobs;
+  std::stringstream ss(str);
+  for (std::string item; std::getline(ss, item, ';');) {
+    auto pos = item.find('=');
+    NVF_ERROR(pos != std::string::npos, "Invalid tuning knob: ", item);
+    knobs[item.substr(0, pos)] = std::stoll(item.substr(pos + 1));
+  }
+  return knobs;
+}
+
+std::string HeuristicDbKey::toString() const {
+  std::stringstream ss;
+  ss << fusion_hash << "," << shape_bucket << "," << arch << ","
+     << nvfuser::toString(heuristic);
+  return ss.str();
+}
+
+HeuristicDb::HeuristicDb(bool _disabled)
+    : disabled_(_disabled),
+      initialized_(false),
+      entries_(),
+      heuristic_db_path_(),
+      heuristic_db_txt_file_() {}
+
+HeuristicDb& HeuristicDb::get() {
+  const std::string heuristic_db_dir = "nvfuser_heuristic_db";
+  const std::string heuristic_db_file = "db.csv";
+
+  return get(
+      heuristic_db_dir,
+      heuristic_db_file,
+      true,
+      !isOptionEnabled(EnableOption::HeuristicDb),
+      false);
+}
+
+HeuristicDb& HeuristicDb::get(
+    const std::string& heuristic_db_dir,
+    const std::string& heuristic_db_file,
+    bool use_temp_dir,
+    bool disabled,
+    bool reset) {
+  std::lock_guard<std::mutex> guard(heuristic_db_lock);
+
+  static HeuristicDb singleton(disabled);
+
+  if (reset) {
+    singleton.disabled_ = true;
+    singleton.initialized_ = false;
+    singleton.entries_.clear();
+    singleton.heuristic_db_path_.clear();
+    singleton.heuristic_db_txt_file_.clear();
+  }
+
+  singleton.disabled_ = disabled;
+
+  if (!singleton.disabled_ && !singleton.initialized_) {
+    auto success = false;
+    try {
+      success =
+          singleton.open(heuristic_db_dir, heuristic_db_file, use_temp_dir);
+    } catch (const std::exception& e) {
+      TORCH_WARN(
+          "nvFuser's heuristic_db had an unexpected exception while opening. Exception: ",
+          e.what());
+    }
+    if (!success) {
+      singleton.disabled_ = true;
+    } else {
+      singleton.initialized_ = true;
+    }
+  }
+  return singleton;
+}
+
+bool HeuristicDb::open(
+    const std::string& heuristic_db_dir,
+    const std::string& heuristic_db_file,
+    bool use_temp_dir) {
+  FUSER_PERF_SCOPE("HeuristicDb::open");
+  const std::string header(
+      "fusion_hash,shape_bucket,arch,heuristic,knobs,time_us");
+
+  if (use_temp_dir) {
+    heuristic_db_path_ = fs::temp_directory_path() / heuristic_db_dir;
+  } else {
+    heuristic_db_path_ = fs::path(heuristic_db_dir);
+  }
+  if (!fs::is_directory(heuristic_db_path_)) {
+    try {
+      fs::create_directory(heuristic_db_path_);
+    } catch (const std::exception& e) {
+      TORCH_WARN(
+          "Unable to create nvFuser Heuristic DB directory! ",
+          heuristic_db_path_.string(),
+          e.what());
+      return false;
+    }
+  }
+
+  heuristic_db_txt_file_ = heuristic_db_path_ / heuristic_db_file;
+  if (fs::is_regular_file(heuristic_db_txt_file_)) {
+    std::ifstream in_file(heuristic_db_txt_file_.c_str(), std::ios::in);
+    if (in_file) {
+      std::string line;
+      if (std::getline(in_file, line) && line == header) {
+        // fusion_hash, shape_bucket, arch, heuristic, knobs, time_us
+        std::regex db_line_regex(
+            R"(^(\d+),([\w;]*),(\d+),([\w\-]+),([\w=;\-]*),([\w\.\+\-]+)$)");
+        while (std::getline(in_file, line)) {
+          std::smatch db_line_match;
+          if (!std::regex_match(line, db_line_match, db_line_regex)) {
+            TORCH_WARN("Heuristic DB: CSV line Doesn't match: ", line);
+            continue;
+          }
+          // Later lines replace earlier entries of the same key
+          std::string key = db_line_match[1].str() + "," +
+              db_line_match[2].str() + "," + db_line_match[3].str() + "," +
+              db_line_match[4].str();
+          entries_[key] = Entry{
+              parseTuningKnobs(db_line_match[5].str()),
+              std::stod(db_line_match[6].str())};
+        }
+        return true;
+      }
+      TORCH_WARN(
+          "Heuristic DB: CSV file header is corrupted or badly formed - Resetting!");
+    }
+  }
+
+  return copy_to_text_file(heuristic_db_txt_file_.string(), header + "\n");
+}
+
+std::optional<TuningKnobs> HeuristicDb::query(const HeuristicDbKey& key) const {
+  FUSER_PERF_SCOPE("HeuristicDb::query");
+  // write() may insert concurrently
+  std::lock_guard<std::mutex> guard(heuristic_db_lock);
+  auto it = entries_.find(key.toString());
+  if (it == entries_.end()) {
+    return std::nullopt;
+  }
+  return it->second.knobs;
+}
+
+bool HeuristicDb::write(
+    const HeuristicDbKey& key,
+    const TuningKnobs& knobs,
+    double time_us) {
+  FUSER_PERF_SCOPE("HeuristicDb::write");
+  std::lock_guard<std::mutex> guard(heuristic_db_lock);
+
+  std::stringstream entry;
+  entry << key.toString() << "," << nvfuser::toString(knobs) << ","
+        << time_us << "\n";
+  if (!append_to_text_file(heuristic_db_txt_file_.string(), entry.str())) {
+    return false;
+  }
+  entries_[key.toString()] = Entry{knobs, time_us};
+  return true;
+}
+
+size_t HeuristicDb::fusionHash(Fusion* fusion) {
+  // Values are numbered in the order they are first visited
+  std::unordered_map<Val*, size_t> val_ids;
+  std::stringstream ss;
+  auto print_val = [&](Val* val) {
+    auto it = val_ids.find(val);
+    if (it != val_ids.end()) {
+      ss << "%" << it->second << " ";
+      return;
+    }
+    auto id = val_ids.size();
+    val_ids.emplace(val, id);
+    ss << "%" << id << ":" << val->dtype();
+    if (auto tv = dynamic_cast<TensorView*>(val)) {
+      ss << "[" << tv->nDims() << "]";
+    } else if (val->isConstScalar()) {
+      ss << "=" << val->toInlineString();
+    }
+    ss << " ";
+  };
+
+  for (auto inp : fusion->inputs()) {
+    print_val(inp);
+  }
+  // Segments narrowed from a larger fusion may still have the producers
+  // of their inputs, which are excluded
+  for (auto expr : StmtSort::getExprsBetween(
+           fusion, fusion->inputs(), fusion->outputs())) {
+    ss << expr->getOpString() << "(";
+    for (auto attr : expr->attributes()) {
+      auto attr_val = dynamic_cast<Val*>(attr);
+      if (attr_val != nullptr && attr_val->value().hasValue()) {
+        ss << attr_val->toInlineString() << " ";
+      }
+    }
+    for (auto inp : expr->inputs()) {
+      print_val(inp);
+    }
+    ss << ")->(";
+    for (auto out : expr->outputs()) {
+      print_val(out);
+    }
+    ss << ")\n";
+  }
+  for (auto out : fusion->outputs()) {
+    print_val(out);
+  }
+  return std::hash<std::string>{}(ss.str());
+}
+
+std::string HeuristicDb::shapeBucket(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info) {
+  std::stringstream ss;
+  ss << (runtime_info.getIndexType() == PrimDataType::Int ? "i64" : "i32");
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    ss << ";";
+    auto domain = TensorDomain::noReductions(tv->getMaybeRFactorDomain());
+    if (domain.empty()) {
+      ss << "s";
+      continue;
+    }
+    bool first = true;
+    for (auto id : domain) {
+      if (!first) {
+        ss << "x";
+      }
+      first = false;
+      if (id->isBroadcast()) {
+        ss << "b";
+        continue;
+      }
+      auto extent = runtime_info.expressionEvaluator().evaluate(id->extent());
+      if (!extent.hasValue()) {
+        ss << "u";
+        continue;
+      }
+      // Exponent of the next power of two
+      int64_t log2_ceil = 0;
+      while (((int64_t)1 << log2_ceil) < extent.as<int64_t>()) {
+        ++log2_ceil;
+      }
+      ss << log2_ceil;
+    }
+  }
+  return ss.str();
+}
+
+HeuristicDbKey HeuristicDb::makeKey(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    ScheduleHeuristic heuristic) {
+  const auto prop = at::cuda::getCurrentDeviceProperties();
+  HeuristicDbKey key;
+  key.fusion_hash = fusionHash(fusion);
+  key.shape_bucket = shapeBucket(fusion, runtime_info);
+  key.arch = prop->major * 10 + prop->minor;
+  key.heuristic = heuristic;
+  return key;
+}
+
+} // namespace nvfuser
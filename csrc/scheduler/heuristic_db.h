@@ -0,0 +1,143 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#if defined(__cplusplus) && (__cplusplus >= 201703L)
+#include <filesystem>
+namespace fs = std::filesystem;
+#elif defined(__cplusplus) && (__cplusplus >= 201402L)
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem;
+#else
+#error "C++14 or Higher is required for filesystem library!"
+#endif
+
+#include <scheduler/heuristic_types.h>
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace nvfuser {
+
+class Fusion;
+class SchedulerRuntimeInfo;
+
+//! Tunable parameters of a heuristic by name. See
+//! scheduler/autotune.h for the parameters of each heuristic.
+using TuningKnobs = std::map<std::string, int64_t>;
+
+//! Serialize as "name=value;name=value"
+std::string toString(const TuningKnobs& knobs);
+
+//! Inverse of toString(const TuningKnobs&)
+TuningKnobs parseTuningKnobs(const std::string& str);
+
+//! Key of the heuristic database. The same fusion with similar input
+//! sizes on the same architecture is expected to have the same best
+//! parameters.
+struct HeuristicDbKey {
+  //! Hash of the math of the fusion, see HeuristicDb::fusionHash
+  size_t fusion_hash = 0;
+  //! Input sizes rounded up to powers of two, see
+  //! HeuristicDb::shapeBucket
+  std::string shape_bucket;
+  //! Compute capability, e.g., 80 for sm_80
+  int64_t arch = 0;
+  ScheduleHeuristic heuristic = ScheduleHeuristic::None;
+
+  std::string toString() const;
+};
+
+//! HeuristicDb is a singleton database of tuned heuristic parameters,
+//! structured like KernelDb. Entries are written by the offline
+//! autotuner and are consulted by SchedulerEntry::makeEntry to
+//! override the parameters chosen by the built-in heuristics. The
+//! database is persisted as a csv file and enabled by
+//! NVFUSER_ENABLE=heuristic_db.
+class HeuristicDb {
+  HeuristicDb(bool _disabled);
+
+  //! Open the database file, creating it if it doesn't exist
+  bool open(
+      const std::string& heuristic_db_dir,
+      const std::string& heuristic_db_file,
+      bool use_temp_dir);
+
+ public:
+  HeuristicDb(const HeuristicDb&) = delete;
+  HeuristicDb& operator=(const HeuristicDb&) = delete;
+
+  //! Thread-Safe method to get the Meyer's singleton -- Interface
+  static HeuristicDb& get();
+  //! Thread-Safe method to get the Meyer's singleton -- For testing
+  static HeuristicDb& get(
+      const std::string& heuristic_db_dir,
+      const std::string& heuristic_db_file,
+      bool use_temp_dir = true,
+      bool disabled = false,
+      bool reset = false);
+
+  bool enabled() const {
+    return !disabled_ && initialized_;
+  }
+
+  size_t size() const {
+    return entries_.size();
+  }
+
+  //! Tuned parameters of the given key, if any
+  std::optional<TuningKnobs> query(const HeuristicDbKey& key) const;
+
+  //! Record the best parameters of the given key along with their
+  //! measured time. An existing entry of the same key is replaced.
+  bool write(
+      const HeuristicDbKey& key,
+      const TuningKnobs& knobs,
+      double time_us);
+
+  //! Hash of the math of a fusion that doesn't depend on the names of
+  //! its values, so the same definition built twice, or as a segment of
+  //! a larger fusion, gets the same hash.
+  static size_t fusionHash(Fusion* fusion);
+
+  //! Sizes of the input tensors of a fusion, rounded up to powers of
+  //! two, along with the index type
+  static std::string shapeBucket(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info);
+
+  //! Key of a fusion on the current device
+  static HeuristicDbKey makeKey(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      ScheduleHeuristic heuristic);
+
+ private:
+  struct Entry {
+    TuningKnobs knobs;
+    double time_us = 0;
+  };
+
+  //! Disablement is specified by the user and can also be set by a
+  //! failure to open the db
+  bool disabled_ = true;
+  //! Db is only initialized after it is successfully open
+  bool initialized_ = false;
+  //! Hash Map of HeuristicDbKey::toString() -> entry
+  std::unordered_map<std::string, Entry> entries_;
+
+  //! Full path to the db directory
+  fs::path heuristic_db_path_;
+  //! Full path to csv file used to record and restore the db
+  fs::path heuristic_db_txt_file_;
+};
+
+} // namespace nvfuser
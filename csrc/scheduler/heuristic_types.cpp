@@ -15,6 +15,8 @@ std::string toString(ScheduleHeuristic sh) {
   switch (sh) {
     case ScheduleHeuristic::NoOp:
       return "no-op";
+    case ScheduleHeuristic::ExprEval:
+      return "expr_eval";
     case ScheduleHeuristic::PointWise:
       return "pointwise";
     case ScheduleHeuristic::Reduction:
@@ -48,6 +48,7 @@ namespace nvfuser {
 enum class ScheduleHeuristic {
   None,
   NoOp,
+  ExprEval,
   PointWise,
   Reduction,
   InnerPersistent,
@@ -58,9 +59,14 @@ enum class ScheduleHeuristic {
 };
 
 //! Define a schedule table to loop over all the heuristics in priority order.
-constexpr std::array<ScheduleHeuristic, 8> all_heuristics_in_priority_order = {
+//! ExprEval comes after Reduction so that the reductions it would evaluate
+//! with ATen are still code generated when the Reduction scheduler accepts
+//! them, but before the schedulers that would copy the results of metadata
+//! ops.
+constexpr std::array<ScheduleHeuristic, 9> all_heuristics_in_priority_order = {
     ScheduleHeuristic::NoOp,
     ScheduleHeuristic::Reduction,
+    ScheduleHeuristic::ExprEval,
     ScheduleHeuristic::Transpose,
     ScheduleHeuristic::PointWise,
     ScheduleHeuristic::InnerPersistent,
@@ -933,7 +933,34 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
     }
   }
 
-  // [Mo, No, Ko, Mi, Ni, Ki]
+  // [..., Mo, No, Ko, Mi, Ni, Ki]
+  int num_splitk_dims = 0;
+  if (params.splitk_factor != 1) {
+    NVF_ERROR(
+        params.splitk_factor > 1,
+        "Invalid split-K factor: ",
+        params.splitk_factor);
+    NVF_ERROR(
+        num_batch_dims == 0,
+        "Split-K is not supported with batch dimensions, BIDz is already used");
+    // Give each CTA along BIDz a contiguous chunk of the K tiles
+    mma_result->split(-4, params.splitk_factor, /*inner_split=*/false);
+    // [Mo, No, Kf, Ko, Mi, Ni, Ki]
+    // rFactor turns
+    //   mma_result = mma(a, b, {Kf, Ko, Ki})
+    // into
+    //   partial = mma(a, b, {Ko, Ki})
+    //   mma_result = sum(partial, {Kf})
+    // and returns the partial sum, which becomes the accumulator. The sum
+    // over Kf is parallelized like Kf in the partial sum, i.e., on BIDz, and
+    // is lowered to a grid reduction.
+    auto splitk_sum = mma_result;
+    mma_result = splitk_sum->rFactor({-4, -1});
+    mma_builder.accumulatorTv(mma_result);
+    num_splitk_dims = 1;
+  }
+
+  // [..., Mo, No, (Kf,) Ko, Mi, Ni, Ki]
   // Propagate tiling globally
   scheduler_utils::transformPropagateToAllFrom(mma_result, -1);
 
@@ -999,9 +1026,15 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
 
   //  0  1  2  3  4   5   6   7  8  9  10 11
   // [B Mo No Ko Kwo Mwo Nwo Mw Nw (Mi Ni Ki)]
+  // or, with split-K:
+  //  0  1  2  3  4   5   6   7  8  9  10 11
+  // [Mo No Kf Ko Kwo Mwo Nwo Mw Nw (Mi Ni Ki)]
   if (num_batch_dims != 0) {
     mma_result->axis(0)->parallelize(ParallelType::BIDz);
   }
+  if (num_splitk_dims != 0) {
+    mma_result->axis(num_batch_dims + 2)->parallelize(ParallelType::BIDz);
+  }
   switch (params.cta_order) {
     case MatmulParams::TileRasterizationOrder::RowMajor:
       mma_result->axis(num_batch_dims)->parallelize(ParallelType::BIDx);
@@ -1016,8 +1049,10 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
           false, "Invalid TileRasterizationOrder passed to Matmul scheduler");
   }
 
-  mma_result->axis(num_batch_dims + 4)->parallelize(ParallelType::TIDz);
-  mma_result->axis(num_batch_dims + 5)->parallelize(ParallelType::TIDy);
+  mma_result->axis(num_batch_dims + num_splitk_dims + 4)
+      ->parallelize(ParallelType::TIDz);
+  mma_result->axis(num_batch_dims + num_splitk_dims + 5)
+      ->parallelize(ParallelType::TIDy);
 
   scheduler_utils::parallelizeAllLike(
       mma_result,
@@ -1066,7 +1101,8 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
   inlineMost(ir_utils::allTvsExcept(fusion, {acr, bcr, ab, bb}));
 
   // if auto inline, will inline to position-7, leads to performance regression
-  inlineSelectedAt({acr, bcr, ab, bb}, mma_result, num_batch_dims + 6);
+  inlineSelectedAt(
+      {acr, bcr, ab, bb}, mma_result, num_batch_dims + num_splitk_dims + 6);
 
   // Propagate mma output swizzle and parallelization down the DAG
   if (params.double_buffer_options.double_buffer_smem_write) {
@@ -1092,7 +1128,8 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
 
   if (params.double_buffer_options.double_buffer_smem_read &&
       params.double_buffer_options.double_buffer_smem_write) {
-    scheduler_utils::rotateLoop(mma_result, num_batch_dims + 2, {acr, bcr});
+    scheduler_utils::rotateLoop(
+        mma_result, num_batch_dims + num_splitk_dims + 2, {acr, bcr});
   }
 }
 
@@ -97,6 +97,14 @@ class MatmulParams : public HeuristicParams {
   //! Promote reuse of prologue shared memory
   bool promote_prologue_smem_reuse = false;
 
+  //! Number of CTAs the K dimension is split across (split-K). Each of them
+  //!  accumulates a contiguous chunk of the K tiles, and the partial results
+  //!  are summed with a grid reduction along BIDz. Used for problems whose
+  //!  M x N tiles alone can't fill the GPU. Not supported with batch
+  //!  dimensions. The heuristics only set it with
+  //!  NVFUSER_ENABLE=matmul_split_k.
+  int splitk_factor = 1;
+
   std::string toString() const override {
     std::stringstream ss;
     ss << "\n===== Matmul Parameters ========\n"
@@ -122,6 +130,7 @@ class MatmulParams : public HeuristicParams {
        << "Use shared memory epilogue: " << use_smem_epilogue << "\n"
        << "Promote re-use of prologue shared memory: "
        << promote_prologue_smem_reuse << "\n"
+       << "Split-K factor: " << splitk_factor << "\n"
        << "====================================\n";
     return ss.str();
   }
@@ -138,7 +147,8 @@ class MatmulParams : public HeuristicParams {
         (nvfuser::hash(mma_macro) << 1) ^ (double_buffer_options.hash() << 2) ^
         (nvfuser::hash(tile_sizes) << 3) ^
         (std::hash<size_t>{}(static_cast<size_t>(cta_order)) << 4) ^
-        (std::hash<size_t>{}(grid_swizzle_factor) << 5);
+        (std::hash<size_t>{}(grid_swizzle_factor) << 5) ^
+        (std::hash<size_t>{}(splitk_factor) << 6);
     return attr_hash;
   }
 
@@ -159,7 +169,8 @@ class MatmulParams : public HeuristicParams {
         other_casted->grid_swizzle_factor == grid_swizzle_factor &&
         other_casted->use_smem_epilogue == use_smem_epilogue &&
         other_casted->promote_prologue_smem_reuse ==
-        promote_prologue_smem_reuse;
+        promote_prologue_smem_reuse &&
+        other_casted->splitk_factor == splitk_factor;
   }
 
   std::shared_ptr<HeuristicParams> clone() const override {
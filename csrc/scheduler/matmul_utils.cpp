@@ -306,6 +306,50 @@ std::string isMatmulFusionDefinitionSupported(
 
 } // anonymous namespace
 
+int getMatmulSplitKFactor(
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    const GemmTile& cta_tile,
+    int64_t num_sms,
+    int64_t min_k_iterations) {
+  NVF_ERROR(num_sms > 0, "Invalid number of SMs: ", num_sms);
+  const int64_t num_tiles = ceilDiv(m, cta_tile.m) * ceilDiv(n, cta_tile.n);
+  const int64_t k_iterations = ceilDiv(k, cta_tile.k);
+  if (num_tiles >= num_sms) {
+    return 1;
+  }
+
+  // Cost of the partial results of one CTA, in units of main loop
+  // iterations: a float tile of the output is written and read back, while an
+  // iteration loads half-precision tiles of both operands.
+  const double partial_tile_cost = (double)(cta_tile.m * cta_tile.n * 4) /
+      (double)((cta_tile.m + cta_tile.n) * cta_tile.k * 2);
+
+  auto cost = [&](int64_t factor) {
+    const int64_t waves = ceilDiv(num_tiles * factor, num_sms);
+    double cost = (double)(waves * ceilDiv(k_iterations, factor));
+    if (factor > 1) {
+      // The last CTA of each tile sums all the partial results
+      cost += (double)factor * partial_tile_cost;
+    }
+    return cost;
+  };
+
+  int64_t best_factor = 1;
+  double best_cost = cost(1);
+  for (int64_t factor = 2; factor <= num_sms &&
+       ceilDiv(k_iterations, factor) >= std::max(min_k_iterations, (int64_t)1);
+       factor++) {
+    const double factor_cost = cost(factor);
+    if (factor_cost < best_cost) {
+      best_factor = factor;
+      best_cost = factor_cost;
+    }
+  }
+  return (int)best_factor;
+}
+
 std::string getMatmulRunTimeRejectReason(
     Fusion* fusion,
     HeuristicSummary* data_cache,
@@ -330,6 +374,10 @@ std::string getMatmulCompileTimeRejectReason(Fusion* fusion) {
     return ss.str();
   }
 
+  if (ir_utils::hasOpsOfType<ScanOp>(fusion)) {
+    return "Matmul scheduler does not support scan ops";
+  }
+
   // #2
   {
     const auto input_layout_opt = mma_utils::getMatmulLayout(fusion);
@@ -377,6 +425,21 @@ std::shared_ptr<MatmulParams> getMatmulHeuristics(
   auto status = initCoreHeuristics(params, mma_op.value(), problem_shape);
   NVF_ERROR(status, "Initialization of core part of heuristics failed.");
 
+  // Split K across CTAs when the output tiles alone can't fill the device.
+  //  The grid reduction of the partial results uses BIDz, which is taken by
+  //  the batch dimension of batched matmuls. Opt-in until split-K kernels
+  //  have been benchmarked against the unsplit ones.
+  if (isOptionEnabled(EnableOption::MatmulSplitK) &&
+      mma_exprs.front()->as<MmaOp>()->batchAxes().empty()) {
+    params->splitk_factor = getMatmulSplitKFactor(
+        problem_shape[(size_t)MatmulDomain::M],
+        problem_shape[(size_t)MatmulDomain::N],
+        problem_shape[(size_t)MatmulDomain::K],
+        params->tile_sizes.cta_tile,
+        device_prop->multiProcessorCount,
+        params->double_buffer_options.smem_double_buffer_stage);
+  }
+
   // Set kernel index mode
   params->cparams.index_type = runtime_info.getIndexType();
 
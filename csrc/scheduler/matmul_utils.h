@@ -9,6 +9,7 @@
 
 #include <exceptions.h>
 #include <fusion.h>
+#include <mma_type.h>
 
 namespace nvfuser {
 
@@ -24,6 +25,22 @@ std::shared_ptr<MatmulParams> getMatmulHeuristics(
     SchedulerRuntimeInfo& runtime_info,
     HeuristicSummary* data_cache = nullptr);
 
+//! Returns the number of CTAs the K dimension of a M x N x K problem should be
+//!  split across. Splitting is only considered when the M x N tiles can't
+//!  fill the SMs, in the spirit of stream-K: the K iterations of all the
+//!  tiles are balanced over the SMs, minimizing the number of waves times the
+//!  iterations done by each CTA, plus the cost of reducing the partial tiles
+//!  in global memory. Each split keeps at least min_k_iterations iterations
+//!  of cta_tile.k. Doesn't depend on the current device, so that decisions
+//!  can be checked for any SM count.
+int getMatmulSplitKFactor(
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    const GemmTile& cta_tile,
+    int64_t num_sms,
+    int64_t min_k_iterations);
+
 //! An implementation of compile time checks. Returns messasge if given fusion
 //!  does not represent matmul, otherwise an empty string is returned.
 std::string getMatmulCompileTimeRejectReason(Fusion* fusion);
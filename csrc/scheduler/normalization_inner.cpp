@@ -6,6 +6,7 @@
  */
 // clang-format on
 #include <instrumentation.h>
+#include <options.h>
 #include <scheduler/debug_utils.h>
 #include <scheduler/normalization_inner.h>
 #include <scheduler/normalization_utils.h>
@@ -64,6 +65,20 @@ std::pair<int64_t, int64_t> getPersistentBufferSize(
             persistent_buffer_size_info.persistent_buffer_size,
             persistent_buffer_size_info.projected_persistent_buffer_size);
 
+  // Buffers that don't fit in registers are placed in shared memory. With
+  // the best-fit allocator, check the size they take once placed there,
+  // including the gaps of the packing.
+  if (persistent_buffer_size > scheduler_utils::register_file_size &&
+      isOptionEnabled(EnableOption::SmemBestFit)) {
+    persistent_buffer_size =
+        persistent_buffer_size_info.projected_persistent_buffer_size == 0
+        ? persistent_buffer_size_info.persistent_buffer_smem_size
+        : std::min(
+              persistent_buffer_size_info.persistent_buffer_smem_size,
+              persistent_buffer_size_info
+                  .projected_persistent_buffer_smem_size);
+  }
+
   // Init to register file size, which is half of the full register file size
   int64_t available_persistent_buffer_size =
       scheduler_utils::register_file_size;
@@ -807,6 +822,44 @@ std::shared_ptr<ReductionParams> getInnerPersistentHeuristics(
       prop.vectorize_factor);
   rparams->project_persistent_buffers = prop.project_persistent_buffers;
   rparams->cparams.index_type = runtime_info.getIndexType();
+
+  // The register count above is derived from the persistent buffer size
+  // alone. Check the scheduled kernel against it and trade iteration
+  // unrolling first, then persistent batches, for registers. A lower batch
+  // takes more threads, so it's only taken while the block stays valid.
+  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
+  reduction_scheduler_utils::lowerFactorsToRegisterEstimate(
+      fusion,
+      *rparams,
+      rparams->cparams.maxrregcount,
+      scheduleInnerPersistentKernel,
+      [&](ReductionParams& params) {
+        if (params.unroll_factor_iter_dom > 1 &&
+            !params.split_grid_dim_iter_dom_outer &&
+            ceilDiv(
+                prop.total_iteration_numel,
+                params.lparams.bdimy() * params.unroll_factor_iter_dom / 2) <=
+                scheduler_utils::x_grid_limit) {
+          params.unroll_factor_iter_dom /= 2;
+          return true;
+        }
+        if (params.schedule_3D ||
+            params.batches_per_block_inner_reduction < 2) {
+          return false;
+        }
+        const int64_t batches = params.batches_per_block_inner_reduction / 2;
+        int64_t bdimx = ceilDiv(
+            prop.inner_most_dimension_numel,
+            batches * params.unroll_factor_inner_reduction);
+        if (params.pad_inner_reduction_to_warp) {
+          bdimx = scheduler_utils::roundUpToN(bdimx, dev_prop->warpSize);
+        }
+        if (bdimx * params.lparams.bdimy() > dev_prop->maxThreadsPerBlock) {
+          return false;
+        }
+        params.batches_per_block_inner_reduction = batches;
+        return true;
+      });
   return rparams;
 }
 
@@ -21,6 +21,34 @@
 
 namespace nvfuser {
 
+namespace {
+
+// Returns the position in the rfactor domain of reference_tv that is exactly
+// mapped with the scanned axes of all the ScanOps of the fusion, or -1 if
+// there's no such position.
+int64_t getScanAxis(Fusion* fusion, TensorView* reference_tv) {
+  ComputeAtMap ca_map(fusion);
+  const auto ref_root =
+      TensorDomain::noReductions(reference_tv->getMaybeRFactorDomain());
+  int64_t scan_axis = -1;
+  for (auto sop : ir_utils::getOpsOfType<ScanOp>(fusion)) {
+    auto it = std::find_if(ref_root.begin(), ref_root.end(), [&](auto id) {
+      return ca_map.areMapped(id, sop->getScanDomain(), IdMappingMode::EXACT);
+    });
+    if (it == ref_root.end()) {
+      return -1;
+    }
+    auto pos = (int64_t)std::distance(ref_root.begin(), it);
+    if (scan_axis != -1 && scan_axis != pos) {
+      return -1;
+    }
+    scan_axis = pos;
+  }
+  return scan_axis;
+}
+
+} // namespace
+
 PointWiseScheduler::PointWiseScheduler(
     Fusion* fusion,
     SchedulerRuntimeInfo& runtime_info,
@@ -68,6 +96,20 @@ bool PointWiseScheduler::canScheduleCompileTime(Fusion* fusion) {
     return false;
   }
 
+  if (ir_utils::hasOpsOfType<ScanOp>(fusion)) {
+    if (!ir_utils::getViewOps(fusion).empty()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::PointWise, "no support for scan ops with reshape");
+      return false;
+    }
+    if (getScanAxis(fusion, getReferenceTensorView(fusion)) == -1) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::PointWise,
+          "scanned axes are not mapped to a single axis of the reference");
+      return false;
+    }
+  }
+
   if (registry_utils::hasNonUniqueBcast(fusion)) {
     scheduler_debug_utils::canScheduleRejectReason(
         ScheduleHeuristic::PointWise,
@@ -146,6 +188,26 @@ class DomainMap : public pointwise_utils::DomainMap {
   }
 };
 
+// Returns the number of threads of a block scan of rows of scan_extent
+// elements, or 0 if each thread should scan its rows serially. Serial scans
+// need short rows, and enough of them to fill the device.
+int64_t getScanBlockSize(
+    int64_t n_rows,
+    int64_t scan_extent,
+    int64_t device_multiprocessor_count,
+    int64_t max_threads_per_block) {
+  constexpr int64_t kMaxSerialScanExtent = 1024;
+  constexpr int64_t kMinBlockScanExtent = 32;
+  if (scan_extent < kMinBlockScanExtent ||
+      (scan_extent <= kMaxSerialScanExtent &&
+       n_rows >= device_multiprocessor_count * kThreadX)) {
+    return 0;
+  }
+  return std::min(
+      std::min(max_threads_per_block, (int64_t)1024),
+      scheduler_utils::lastPow2(scan_extent));
+}
+
 } // namespace
 
 std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
@@ -215,11 +277,14 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
     n_elems *= elem_counts[ref_i];
   }
 
-  // If zero dimensional or zero size, return default parameters
+  // If zero dimensional or zero size, return default parameters. Scans are
+  // also scheduled with the default parameters, i.e., without vectorization
+  // or unrolling, only choosing between a serial and a block scan. See
+  // scheduleScan.
   if (TensorDomain::noReductions(
           TensorDomain::noBroadcasts(largest_out->getLeafDomain()))
           .empty() ||
-      n_elems == 0) {
+      n_elems == 0 || ir_utils::hasOpsOfType<ScanOp>(fusion)) {
     auto vectorizable_inputs_outputs_entry = HeuristicSummaryEntry<
         HeuristicCompileTime::VectorizableInputsAndOutputs>(data_cache, []() {
       return std::make_unique<std::vector<TensorView*>>();
@@ -238,8 +303,19 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
     // All cache entries that are expected to be generated in the pointwise
     // scheduler by registry.cpp::HeuristicSummary::validate() must be created
     // before hitting this return.
-    return std::make_shared<PointwiseParams>(
+    auto params = std::make_shared<PointwiseParams>(
         "Pointwise heuristics", index_type);
+    if (n_elems != 0 && ir_utils::hasOpsOfType<ScanOp>(fusion)) {
+      const auto scan_axis = getScanAxis(fusion, largest_out);
+      NVF_ERROR(scan_axis >= 0);
+      const int64_t scan_extent = elem_counts.at(scan_axis);
+      params->scan_bdimx = getScanBlockSize(
+          n_elems / scan_extent,
+          scan_extent,
+          device_multiprocessor_count,
+          (int64_t)at::cuda::getCurrentDeviceProperties()->maxThreadsPerBlock);
+    }
+    return params;
   }
 
   // Find all vectorizable inputs/outputs
@@ -501,6 +577,53 @@ bool hasReferenceTensorView(Fusion* fusion) {
   return getReferenceTensorView(fusion) != nullptr;
 }
 
+namespace {
+
+// The scanned axis is moved to the innermost position and the other axes are
+// merged. By default, scans are computed serially by each thread along the
+// scanned axis, which is kept serial, and the other axes are parallelized
+// with BIDx and TIDx. With a block scan, each block scans a row, scan_bdimx
+// elements at a time, and the rows are parallelized with BIDx.
+void scheduleScan(
+    Fusion* fusion,
+    const PointwiseParams& params,
+    TensorView* reference_tv) {
+  const auto scan_axis = getScanAxis(fusion, reference_tv);
+  NVF_ERROR(
+      scan_axis >= 0,
+      "Scanned axes are not mapped to a single axis of ",
+      reference_tv->toString());
+
+  // [..., scan]
+  reference_tv->reorder({{scan_axis, -1}});
+  for (int64_t i = (int64_t)reference_tv->nDims() - 2; i > 0; i--) {
+    reference_tv->merge(i - 1, i);
+  }
+
+  if (params.scan_bdimx > 0) {
+    // [BIDx, scan / bdimx, TIDx]
+    reference_tv->split(-1, params.scan_bdimx);
+    reference_tv->axis(-1)->parallelize(ParallelType::TIDx);
+    if (reference_tv->nDims() > 2) {
+      reference_tv->axis(0)->parallelize(ParallelType::BIDx);
+    }
+  } else if (reference_tv->nDims() > 1) {
+    // [BIDx, TIDx, scan]
+    reference_tv->split(0, kThreadX);
+    reference_tv->axis(0)->parallelize(ParallelType::BIDx);
+    reference_tv->axis(1)->parallelize(ParallelType::TIDx);
+  }
+
+  TransformPropagator propagator(reference_tv);
+  MaxRootDomainInfoSpanningTree spanning_tree(reference_tv);
+  spanning_tree.traverse(&propagator);
+  scheduler_utils::parallelizeAllLike(reference_tv);
+
+  inlineMost();
+}
+
+} // namespace
+
 // TODO: Inline intermediate operations (avoid inlining unrolled/vectorized
 // input/output caches)
 void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
@@ -553,6 +676,12 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
       reference_tv != nullptr,
       "Could not find a fully broadcasted output to reference schedule on.");
 
+  if (ir_utils::hasOpsOfType<ScanOp>(fusion)) {
+    scheduleScan(fusion, params, reference_tv);
+    scheduler_utils::promoteProducerMemoryTypes(fusion, cached_inputs);
+    return;
+  }
+
   // Positions of rhs and lhs after merging all dimensions.
   int rhs_i = -1;
   int lhs_i = -1;
@@ -43,6 +43,10 @@ class PointwiseParams : public HeuristicParams {
   // Unroll or vectorization factor
   size_t unroll_factor = 1;
 
+  // Number of threads that scan the scanned axis together with a block scan,
+  // one row per block. 0 means each thread scans its own rows serially.
+  int64_t scan_bdimx = 0;
+
   using HeuristicParams::HeuristicParams;
 
   // Warning: Does not check launch parameters!
@@ -58,7 +62,8 @@ class PointwiseParams : public HeuristicParams {
         other.split_block == split_block &&
         other.split_grid_y_dim == split_grid_y_dim &&
         other.unroll_factor == unroll_factor &&
-        other.flip_grid_binding == flip_grid_binding;
+        other.flip_grid_binding == flip_grid_binding &&
+        other.scan_bdimx == scan_bdimx;
     return attr_equal;
   }
 
@@ -88,6 +93,9 @@ class PointwiseParams : public HeuristicParams {
     if (flip_grid_binding) {
       ss << "Flip BIDx/BIDy bindings\n";
     }
+    if (scan_bdimx > 0) {
+      ss << "Block scan, BlckX: " << scan_bdimx << "\n";
+    }
     ss << "====================================\n";
     return ss.str();
   }
@@ -99,7 +107,8 @@ class PointwiseParams : public HeuristicParams {
         static_cast<size_t>(split_block) << 5 ^
         static_cast<size_t>(split_grid_y_dim) << 6 ^
         static_cast<size_t>(unroll_factor) << 9 ^
-        static_cast<size_t>(flip_grid_binding) << 10;
+        static_cast<size_t>(flip_grid_binding) << 10 ^
+        static_cast<size_t>(scan_bdimx) << 11;
     return attr_hash;
   }
 
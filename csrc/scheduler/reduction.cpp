@@ -894,6 +894,12 @@ bool ReductionScheduler::canScheduleCompileTime(Fusion* fusion) {
     return false;
   }
 
+  if (ir_utils::hasOpsOfType<ScanOp>(fusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        ScheduleHeuristic::Reduction, "no support for scan ops.");
+    return false;
+  }
+
   auto reduction_tvs = scheduler_utils::getReductionTvs(fusion);
 
   if (reduction_tvs.empty()) {
@@ -1144,6 +1150,29 @@ std::shared_ptr<ReductionParams> getReductionHeuristics(
       max_dtype_size,
       vectorize_factor);
   heuristic->cparams.index_type = runtime_info.getIndexType();
+
+  // Keep the unrolled kernel within the registers that let half of the
+  // threads of an SM be resident. Only unroll factors that don't change the
+  // vectorization or the grid are lowered.
+  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
+  reduction_scheduler_utils::lowerFactorsToRegisterEstimate(
+      fusion,
+      *heuristic,
+      getRegPerThreadGivenThreadsPerSM(
+          dev_prop->maxThreadsPerMultiProcessor / 2),
+      scheduleReduction,
+      [](ReductionParams& params) {
+        if (params.unroll_factor_inner_reduction > 1 &&
+            !params.vectorize_inner_reduction) {
+          params.unroll_factor_inner_reduction /= 2;
+          return true;
+        }
+        if (params.unroll_factor_outer_reduction > 1) {
+          params.unroll_factor_outer_reduction /= 2;
+          return true;
+        }
+        return false;
+      });
   return heuristic;
 }
 
@@ -7,12 +7,16 @@
 // clang-format on
 #include <scheduler/reduction_utils.h>
 
+#include <debug.h>
+#include <device_lower/analysis/register_pressure.h>
+#include <device_lower/lower2device.h>
 #include <expr_evaluator.h>
 #include <inlining.h>
 #include <ir/cloner.h>
 #include <ir/utils.h>
 #include <maxinfo_propagator.h>
 #include <ops/arith.h>
+#include <options.h>
 #include <scheduler/registry.h>
 #include <scheduler/utils.h>
 #include <transform_replay.h>
@@ -389,6 +393,33 @@ void multiReductionInliner(
   inlineMost();
 }
 
+void lowerFactorsToRegisterEstimate(
+    Fusion* fusion,
+    ReductionParams& rparams,
+    int64_t max_registers,
+    const std::function<void(Fusion*, const ReductionParams&)>& schedule_fn,
+    const std::function<bool(ReductionParams&)>& lower_factor) {
+  if (!isOptionEnabled(EnableOption::RegisterEstimate)) {
+    return;
+  }
+  // Factors are lowered by halving them, so a few trials are enough for the
+  // factors the heuristics choose. Each trial lowers the whole fusion.
+  constexpr int64_t max_trials = 4;
+  for (int64_t trial = 0; trial < max_trials; trial++) {
+    Fusion trial_fusion(*fusion);
+    schedule_fn(&trial_fusion, rparams);
+    GpuLower gpulw(&trial_fusion, rparams.cparams);
+    const auto pressure = estimateRegisterPressure(gpulw.kernel());
+    if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+      debug() << "Estimated register usage: " << pressure.registers
+              << ", limit: " << max_registers << std::endl;
+    }
+    if (pressure.registers <= max_registers || !lower_factor(rparams)) {
+      return;
+    }
+  }
+}
+
 void propagateTransformation(
     TensorView* reference_tv,
     const std::unordered_set<TensorView*>& boundaryNodesSet) {
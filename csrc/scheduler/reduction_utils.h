@@ -12,6 +12,8 @@
 #include <ir/all_nodes.h>
 #include <scheduler/reduction_heuristic.h>
 
+#include <functional>
+
 namespace nvfuser {
 
 namespace reduction_scheduler_utils {
@@ -39,6 +41,18 @@ void multiReductionInliner(
     std::vector<std::pair<TensorView*, TensorView*>> cached_outputs,
     std::vector<TensorView*> dummy_outputs = {});
 
+// With EnableOption::RegisterEstimate, lower the unroll and persistent batch
+// factors of rparams until the register usage estimated by
+// estimateRegisterPressure is at most max_registers. Each trial schedules a
+// copy of fusion with schedule_fn and lowers it. lower_factor lowers one
+// factor of rparams and returns false if none can be lowered.
+void lowerFactorsToRegisterEstimate(
+    Fusion* fusion,
+    ReductionParams& rparams,
+    int64_t max_registers,
+    const std::function<void(Fusion*, const ReductionParams&)>& schedule_fn,
+    const std::function<bool(ReductionParams&)>& lower_factor);
+
 // Propagate transformations with internal cutoff boundary at boundaryNodesSet
 // in P2C forward propagate, disable propagation to TensorView in
 // boundaryNodesSet in C2P backward propagate, disable propagation from
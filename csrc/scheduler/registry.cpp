@@ -8,7 +8,9 @@
 #include <ATen/cuda/CUDAContext.h>
 #include <executor_utils.h>
 #include <scheduler/all_schedulers.h>
+#include <scheduler/autotune.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/heuristic_db.h>
 #include <scheduler/matmul_utils.h>
 #include <scheduler/registry.h>
 #include <scheduler/registry_utils.h>
@@ -180,6 +182,9 @@ bool SchedulerEntry::canSchedule(
   switch (sh) {
     case ScheduleHeuristic::NoOp:
       return checkCanSchedule<NoOpScheduler>(fusion, runtime_info, data_cache);
+    case ScheduleHeuristic::ExprEval:
+      return checkCanSchedule<ExprEvalScheduler>(
+          fusion, runtime_info, data_cache);
     case ScheduleHeuristic::PointWise:
       return checkCanSchedule<PointWiseScheduler>(
           fusion, runtime_info, data_cache);
@@ -212,13 +217,18 @@ std::unique_ptr<SchedulerEntry> SchedulerEntry::makeEntry(
     ScheduleHeuristic sh,
     Fusion* fusion,
     SchedulerRuntimeInfo& runtime_info,
-    HeuristicSummary* data_cache) {
+    HeuristicSummary* data_cache,
+    bool use_heuristic_db) {
   std::unique_ptr<SchedulerEntry> scheduler_entry = nullptr;
   switch (sh) {
     case ScheduleHeuristic::NoOp:
       scheduler_entry =
           std::make_unique<NoOpScheduler>(fusion, runtime_info, data_cache);
       break;
+    case ScheduleHeuristic::ExprEval:
+      scheduler_entry = std::make_unique<ExprEvalScheduler>(
+          fusion, runtime_info, data_cache);
+      break;
     case ScheduleHeuristic::PointWise:
       scheduler_entry = std::make_unique<PointWiseScheduler>(
           fusion, runtime_info, data_cache);
@@ -251,6 +261,20 @@ std::unique_ptr<SchedulerEntry> SchedulerEntry::makeEntry(
       NVF_ERROR(false, "unreachable");
   }
 
+  auto& params = scheduler_entry->params_;
+  if (use_heuristic_db && params != nullptr &&
+      !getTuningKnobs(*params).empty()) {
+    auto& heuristic_db = HeuristicDb::get();
+    if (heuristic_db.enabled()) {
+      auto knobs =
+          heuristic_db.query(HeuristicDb::makeKey(fusion, runtime_info, sh));
+      if (knobs.has_value()) {
+        // The recorded knobs may vectorize more than these inputs allow
+        applyTuningKnobs(*params, clampTuningKnobs(*params, knobs.value()));
+      }
+    }
+  }
+
   return scheduler_entry;
 }
 
@@ -302,6 +326,9 @@ HeuristicSummary::HeuristicSummary(
     case ScheduleHeuristic::NoOp:
       NoOpScheduler::canScheduleRunTime(fusion, runtime_info, this);
       break;
+    case ScheduleHeuristic::ExprEval:
+      ExprEvalScheduler::canScheduleRunTime(fusion, runtime_info, this);
+      break;
     case ScheduleHeuristic::PointWise:
       getPointwiseHeuristics(fusion, runtime_info, this);
       PointWiseScheduler::canScheduleRunTime(fusion, runtime_info, this);
@@ -350,6 +377,9 @@ void HeuristicSummary::validate() const {
       // TODO: need to cache the dynamically zero inputs?
       break;
     }
+    case ScheduleHeuristic::ExprEval: {
+      break;
+    }
     case ScheduleHeuristic::Transpose:
     case ScheduleHeuristic::PointWise: {
       if (heuristic_ == ScheduleHeuristic::PointWise) {
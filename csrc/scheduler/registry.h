@@ -137,12 +137,15 @@ class SchedulerEntry {
  public:
   //! Fusion runtime facing API,
   //!   builds a new entry with the given heuristics
-  //!   corresponding to the given fusion
+  //!   corresponding to the given fusion. Parameters tuned offline
+  //!   and recorded in the HeuristicDb override the built-in heuristic
+  //!   when the database is enabled, unless use_heuristic_db is false.
   static std::unique_ptr<SchedulerEntry> makeEntry(
       ScheduleHeuristic sh,
       Fusion* fusion,
       SchedulerRuntimeInfo& runtime_info,
-      HeuristicSummary* data_cache = nullptr);
+      HeuristicSummary* data_cache = nullptr,
+      bool use_heuristic_db = true);
 
   virtual ~SchedulerEntry() = default;
 
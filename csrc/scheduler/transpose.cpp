@@ -41,6 +41,12 @@ bool TransposeScheduler::canScheduleCompileTime(Fusion* fusion) {
     return false;
   }
 
+  if (ir_utils::hasOpsOfType<ScanOp>(fusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        ScheduleHeuristic::Transpose, "no support for scan ops.");
+    return false;
+  }
+
   for (auto select : ir_utils::getOpsOfType<SelectOp>(fusion)) {
     auto inner = TensorDomain::noReductions(
         select->input(0)->as<TensorView>()->getMaybeAllocationDomain());
@@ -13,6 +13,7 @@
 #include <expr_evaluator.h>
 #include <instrumentation.h>
 #include <ir/utils.h>
+#include <memory_planner.h>
 #include <ops/all_ops.h>
 #include <root_domain_map.h>
 #include <scheduler/mma_utils.h>
@@ -20,6 +21,7 @@
 #include <transform_replay.h>
 
 #include <algorithm>
+#include <limits>
 #include <queue>
 
 namespace nvfuser {
@@ -915,10 +917,66 @@ PersistentBufferSizeReturn persistentBufferSize(
         std::max(max_proj_persistence_size, projected_buffer_size);
   }
 
+  // Place the buffers as the best-fit shared memory allocator would. A
+  // buffer is live over the exprs defining the vals it is active at.
+  std::unordered_map<Expr*, int64_t> expr_positions;
+  for (auto expr : fusion->exprs()) {
+    expr_positions.emplace(expr, (int64_t)expr_positions.size());
+  }
+  auto packed_size = [&](const std::vector<bool>& mask) {
+    // Buffers in the order of all_buffers, counting each tensor once
+    std::vector<BufferLifetime> lifetimes;
+    std::unordered_map<TensorView*, size_t> lifetime_index;
+    std::vector<size_t> buffer_lifetime(all_buffers.size());
+    for (auto buffer_i : c10::irange(all_buffers.size())) {
+      if (!mask[buffer_i]) {
+        continue;
+      }
+      auto [it, inserted] =
+          lifetime_index.emplace(all_buffers[buffer_i], lifetimes.size());
+      if (inserted) {
+        lifetimes.push_back(
+            {persistent_buffer_sizes[buffer_i],
+             std::numeric_limits<int64_t>::max(),
+             -1});
+      }
+      buffer_lifetime[buffer_i] = it->second;
+    }
+    for (const auto& [val, active_buffers] : scoped_persistence_factor) {
+      auto position_it = expr_positions.find(val->definition());
+      if (position_it == expr_positions.end()) {
+        continue;
+      }
+      for (auto buffer_i : c10::irange(all_buffers.size())) {
+        if (!mask[buffer_i] || !active_buffers[buffer_i]) {
+          continue;
+        }
+        auto& lifetime = lifetimes[buffer_lifetime[buffer_i]];
+        lifetime.first_step =
+            std::min(lifetime.first_step, position_it->second);
+        lifetime.last_step = std::max(lifetime.last_step, position_it->second);
+      }
+    }
+    lifetimes.erase(
+        std::remove_if(
+            lifetimes.begin(),
+            lifetimes.end(),
+            [](const BufferLifetime& lifetime) {
+              return lifetime.last_step < lifetime.first_step;
+            }),
+        lifetimes.end());
+    // Shared memory allocations are aligned to 16 bytes
+    return planWorkspace(lifetimes, 16).size;
+  };
+
   PersistentBufferSizeReturn persistent_buffer_size;
   persistent_buffer_size.persistent_buffer_size = max_persistence_size;
   persistent_buffer_size.projected_persistent_buffer_size =
       max_proj_persistence_size;
+  persistent_buffer_size.persistent_buffer_smem_size =
+      packed_size(persistent_mask);
+  persistent_buffer_size.projected_persistent_buffer_smem_size =
+      packed_size(projected_mask);
   return persistent_buffer_size;
 }
 
@@ -225,6 +225,12 @@ ReductionTvProperties getReductionProperties(
 struct PersistentBufferSizeReturn {
   int64_t persistent_buffer_size = 0;
   int64_t projected_persistent_buffer_size = 0;
+  // The sizes above assume the buffers live at the same time are packed
+  // without gaps. These are the sizes of the buffers placed in shared memory
+  // by the best-fit allocator of EnableOption::SmemBestFit, see
+  // planWorkspace, which also leaves the gaps of the packing.
+  int64_t persistent_buffer_smem_size = 0;
+  int64_t projected_persistent_buffer_smem_size = 0;
 };
 
 // Compute the amount of register space would be needed to perform this kernel
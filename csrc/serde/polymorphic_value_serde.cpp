@@ -112,7 +112,7 @@ flatbuffers::Offset<serde::Scalar> serializeScalarCpu(
 
 flatbuffers::Offset<serde::PolymorphicValue> serializePolymorphicValue(
     flatbuffers::FlatBufferBuilder& builder,
-    std::shared_ptr<nvfuser::PolymorphicValue> v) {
+    const nvfuser::PolymorphicValue* v) {
   NVF_ERROR(!v->is<std::monostate>(), "PolymorphicValue is a std::monostate.");
   NVF_ERROR(
       !v->is<StructHandle>(),
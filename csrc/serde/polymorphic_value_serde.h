@@ -36,7 +36,7 @@ nvfuser::PolymorphicValue deserializePolymorphicValue(const serde::Scalar* c);
 
 flatbuffers::Offset<serde::PolymorphicValue> serializePolymorphicValue(
     flatbuffers::FlatBufferBuilder& builder,
-    std::shared_ptr<nvfuser::PolymorphicValue> v);
+    const nvfuser::PolymorphicValue* v);
 
 flatbuffers::Offset<serde::Scalar> serializeScalarCpu(
     flatbuffers::FlatBufferBuilder& builder,
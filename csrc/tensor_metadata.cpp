@@ -274,6 +274,8 @@ void validateAllocationSizesAndStrides(
   }
 }
 
+using InlineDims = c10::SmallVector<int64_t, TensorMetaData::kInlineRank>;
+
 // Given an ATen tensor, whose sizes and strides are w.r.t to the rFactor domain
 // of its corresponding TensorView, compute the sizes and strides of the tensor
 // with respect to its allocation domain.
@@ -283,16 +285,15 @@ void validateAllocationSizesAndStrides(
 // Another example, if the rFactor domain is [I1*I2] and the allocation domain
 // is [I1, I2], and the tensor's size is [15] and stride is [7], and the extent
 // of I2 is 5, then the resulting size will be [3, 5] and stride will be [35, 7]
-std::pair<std::vector<int64_t>, std::vector<int64_t>>
-inferAndValidateAllocationSizesAndStrides(
+std::pair<InlineDims, InlineDims> inferAndValidateAllocationSizesAndStrides(
     const at::Tensor& tensor,
     TensorView* tv,
     ExpressionEvaluator ee) {
   if (tv == nullptr || !tv->hasAllocation()) {
     // When tv is nullptr, or tv does not have allocation, the given sizes and
     // strides should already be in the target format. So nothing to do here.
-    std::vector<int64_t> sizes;
-    std::vector<int64_t> strides;
+    InlineDims sizes;
+    InlineDims strides;
     for (auto i : c10::irange(tensor.dim())) {
       sizes.emplace_back(tensor.size(i));
       strides.emplace_back(tensor.stride(i));
@@ -316,8 +317,8 @@ inferAndValidateAllocationSizesAndStrides(
 
   // Now active_ids should contain the final sizes and strides, unordered. We
   // need to put them to the correct order.
-  std::vector<int64_t> sizes;
-  std::vector<int64_t> strides;
+  InlineDims sizes;
+  InlineDims strides;
   sizes.reserve(alloc.size());
   strides.reserve(alloc.size());
   for (auto i : c10::irange(alloc.size())) {
@@ -344,8 +345,9 @@ std::vector<PolymorphicValue> GetMetaData::evaluate(
   const at::Tensor& input = inputs.at(0).as<at::Tensor>();
 
   NVF_ERROR(
-      input.is_cuda() || input.is_meta(),
-      "GetMetaData expects a CUDA tensor as input, but got undefined tensor");
+      input.is_cuda() || input.is_meta() || input.is_cpu(),
+      "GetMetaData expects a CUDA, CPU or meta tensor as input, but got ",
+      "undefined tensor");
 
   std::shared_ptr<Struct> struct_ = std::make_shared<TensorMetaData>();
   TensorMetaData* metadata = (TensorMetaData*)struct_.get();
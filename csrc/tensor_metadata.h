@@ -11,6 +11,8 @@
 #include <polymorphic_value.h>
 #include <type.h>
 
+#include <c10/util/SmallVector.h>
+
 namespace nvfuser {
 
 struct TensorMetaData : public Struct {
@@ -23,40 +25,26 @@ struct TensorMetaData : public Struct {
   c10::IntArrayRef alloc_size;
   c10::IntArrayRef alloc_stride;
   // The actual data for the above fields. Maybe empty if the fields are not
-  // owned by this object.
-  std::vector<int64_t> logical_size_data;
-  std::vector<int64_t> logical_stride_data;
-  std::vector<int64_t> alloc_size_data;
-  std::vector<int64_t> alloc_stride_data;
+  // owned by this object. Stored inline for tensors of rank up to
+  // kInlineRank, so evaluating the metadata doesn't allocate them.
+  static constexpr size_t kInlineRank = 8;
+  c10::SmallVector<int64_t, kInlineRank> logical_size_data;
+  c10::SmallVector<int64_t, kInlineRank> logical_stride_data;
+  c10::SmallVector<int64_t, kInlineRank> alloc_size_data;
+  c10::SmallVector<int64_t, kInlineRank> alloc_stride_data;
 
   std::function<PolymorphicValue()> getter(
       const std::string& key) const override {
     if (key == "data") {
       return [this]() { return PolymorphicValue(Pointer(data, dtype)); };
     } else if (key == "logical_size") {
-      if (!logical_size_data.empty()) {
-        return [this]() { return PolymorphicValue(logical_size_data); };
-      } else {
-        return [this]() { return PolymorphicValue(logical_size.vec()); };
-      }
+      return [this]() { return PolymorphicValue(logical_size.vec()); };
     } else if (key == "logical_stride") {
-      if (!logical_stride_data.empty()) {
-        return [this]() { return PolymorphicValue(logical_stride_data); };
-      } else {
-        return [this]() { return PolymorphicValue(logical_stride.vec()); };
-      }
+      return [this]() { return PolymorphicValue(logical_stride.vec()); };
     } else if (key == "alloc_size") {
-      if (!alloc_size_data.empty()) {
-        return [this]() { return PolymorphicValue(alloc_size_data); };
-      } else {
-        return [this]() { return PolymorphicValue(alloc_size.vec()); };
-      }
+      return [this]() { return PolymorphicValue(alloc_size.vec()); };
     } else if (key == "alloc_stride") {
-      if (!alloc_stride_data.empty()) {
-        return [this]() { return PolymorphicValue(alloc_stride_data); };
-      } else {
-        return [this]() { return PolymorphicValue(alloc_stride.vec()); };
-      }
+      return [this]() { return PolymorphicValue(alloc_stride.vec()); };
     } else {
       NVF_ERROR(false, "Unknown key ", key);
     }
@@ -68,22 +56,26 @@ struct TensorMetaData : public Struct {
       return [this](const PolymorphicValue& value) { data = (void*)value; };
     } else if (key == "logical_size") {
       return [this](const PolymorphicValue& value) {
-        logical_size_data = (std::vector<int64_t>)value;
+        auto values = (std::vector<int64_t>)value;
+        logical_size_data.assign(values.begin(), values.end());
         logical_size = c10::makeArrayRef(logical_size_data);
       };
     } else if (key == "logical_stride") {
       return [this](const PolymorphicValue& value) {
-        logical_stride_data = (std::vector<int64_t>)value;
+        auto values = (std::vector<int64_t>)value;
+        logical_stride_data.assign(values.begin(), values.end());
         logical_stride = c10::makeArrayRef(logical_stride_data);
       };
     } else if (key == "alloc_size") {
       return [this](const PolymorphicValue& value) {
-        alloc_size_data = (std::vector<int64_t>)value;
+        auto values = (std::vector<int64_t>)value;
+        alloc_size_data.assign(values.begin(), values.end());
         alloc_size = c10::makeArrayRef(alloc_size_data);
       };
     } else if (key == "alloc_stride") {
       return [this](const PolymorphicValue& value) {
-        alloc_stride_data = (std::vector<int64_t>)value;
+        auto values = (std::vector<int64_t>)value;
+        alloc_stride_data.assign(values.begin(), values.end());
         alloc_stride = c10::makeArrayRef(alloc_stride_data);
       };
     } else {
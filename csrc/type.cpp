@@ -516,6 +516,8 @@ static const char* binary_op_type2string(BinaryOpType t) {
       return "sub";
     case BinaryOpType::Complex:
       return "std::complex";
+    case BinaryOpType::OnlineSoftmax:
+      return "onlineSoftmax";
 
     // Integer Ops
     case BinaryOpType::Mod:
@@ -623,7 +623,12 @@ enum class BinaryOpType {
   LogicalOr,
 
   // generate complex from real and imaginary parts
-  Complex
+  Complex,
+
+  // Combine two partial results of online softmax, each of which is a
+  // running max and a sum of exp(x - max) packed in an Int. See
+  // online_softmax_stats in ops/normalization.h
+  OnlineSoftmax
 };
 
 enum class ScatterOpType { Set };
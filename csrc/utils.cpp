@@ -149,6 +149,21 @@ int8_t getCommonDeviceCUDA(
   return found_device ? index : (int8_t)0;
 }
 
+bool hasHostResidentInputs(const at::ArrayRef<c10::IValue>& inputs) {
+  bool found_host_tensor = false;
+  for (const auto& input : inputs) {
+    if (!input.isTensor()) {
+      continue;
+    }
+    const auto& tensor = input.toTensor();
+    if (!tensor.is_cpu()) {
+      return false;
+    }
+    found_host_tensor = found_host_tensor || !is_cpu_scalar(tensor);
+  }
+  return found_host_tensor;
+}
+
 bool useFallback() {
   // Keep this env var for compatibility
   const char* disable_fb_env = getNvFuserEnv("DISABLE_FALLBACK");
@@ -55,6 +55,11 @@ int8_t getCommonDeviceCUDA(
     const at::ArrayRef<c10::IValue>& inputs,
     std::optional<int8_t> selected_device = std::nullopt);
 
+//! Returns true if all tensor inputs are on the CPU and at least one of them
+//! is not a CPU scalar. Such inputs are run with the C++ backend of
+//! FusionExecutor, see codegen::generateCppKernel.
+bool hasHostResidentInputs(const at::ArrayRef<c10::IValue>& inputs);
+
 int64_t getRegPerThreadGivenThreadsPerSM(int64_t threads_per_sm);
 
 int64_t getThreadsPerSMGivenRegPerThread(int64_t reg_per_thread);
@@ -183,6 +183,39 @@ class FusionDefinition(_C._FusionDefinition):
 
         return result
 
+    def execute_batch(self, batch, *, device=None):
+        """
+        Executes the Fusion for each list of inputs of a batch in one call
+
+        The lists of inputs with the same sizes, strides and dtypes share one
+        lookup of their kernels, which are launched back to back. User
+        schedules are not used.
+
+        Args:
+            batch (List[List[Union[Tensor, Scalar]]]): A list of lists of
+                inputs to the fusion.
+
+        Kwargs:
+            device (Optional[Union[int, str, torch.device]]): See execute().
+
+        Returns:
+            List[List[Tensor]]: the outputs of each list of inputs
+        """
+        if device is not None:
+            if not isinstance(device, torch.device):
+                device = torch.device(device)
+            assert (
+                device.type == "cuda"
+            ), "If device argument is passed it must be a CUDA device"
+            device = device.index
+
+        if self.id() is None:
+            self._setup_definition()
+            self.definition()
+            self._finalize_definition()
+
+        return self._execute_batch(batch, device=device)
+
     def debug_output(self):
         """
         Retrieve string of captured debug information from the previous execution.
@@ -2551,6 +2551,23 @@ class TestNvFuserFrontend(TestCase):
         self.assertEqual(y.shape, torch.Size([3, 2, 2]))
         self.assertEqual(x.flatten(), y.flatten())
 
+    def test_execute_batch(self):
+        with FusionDefinition() as fd:
+            t0 = fd.define_tensor([-1, -1], [True, True])
+            s1 = fd.define_scalar(dtype=DataType.Double)
+            t2 = fd.ops.mul(t0, s1)
+            fd.add_output(t2)
+
+        batch = [
+            [torch.randn(4, 8, device="cuda"), 2.0],
+            [torch.randn(16, 32, device="cuda"), 3.0],
+            [torch.randn(4, 8, device="cuda"), 4.0],
+        ]
+        outputs = fd.execute_batch(batch)
+        self.assertEqual(len(outputs), len(batch))
+        for inputs, nvf_out in zip(batch, outputs):
+            self.assertEqual(nvf_out[0], inputs[0] * inputs[1])
+
 
 if __name__ == "__main__":
     run_tests()
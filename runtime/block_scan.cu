@@ -0,0 +1,84 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+// Scans one element per thread along the x dimension of the block. The rows
+// of threads with different y and z indices are scanned independently.
+//
+// carry holds the scan of the elements of the previous calls, i.e., of the
+// previous iterations of a serial loop around the block scan. The result of
+// each thread is combined with it, and it is then updated with the total of
+// the block. All the threads of a row must call the function, and they all
+// get the same carry. Threads whose read_pred is false contribute init_val,
+// and threads whose write_pred is false don't write their result.
+//
+//  EXAMPLE USAGE:
+//  blockScan<EXCLUSIVE, Aligned>
+//    (output[output_index], input[input_index], carry,
+//      [] __device__ (T& a, const T b) { a += b; },
+//      shared_mem, read_pred, write_pred, init_val);
+template <bool Exclusive, bool Aligned, typename T, typename Func>
+__device__ void blockScan(
+    T& out,
+    const T& inp_val,
+    T& carry,
+    Func scan_op,
+    T* shared_mem,
+    bool read_pred,
+    bool write_pred,
+    T init_val) {
+  const unsigned int scan_size = blockDim.x;
+  const unsigned int scan_tid = threadIdx.x;
+  T* row = shared_mem + (threadIdx.z * blockDim.y + threadIdx.y) * scan_size;
+
+  row[scan_tid] = read_pred ? inp_val : init_val;
+  block_sync::sync<Aligned>();
+
+  // Inclusive scan of the row in shared memory, doubling the distance of
+  // the combined elements at each step
+  for (unsigned int offset = 1; offset < scan_size; offset <<= 1) {
+    T val = row[scan_tid];
+    if (scan_tid >= offset) {
+      scan_op(val, row[scan_tid - offset]);
+    }
+    block_sync::sync<Aligned>();
+    row[scan_tid] = val;
+    block_sync::sync<Aligned>();
+  }
+
+  if (write_pred) {
+    T result = carry;
+    if (!Exclusive) {
+      scan_op(result, row[scan_tid]);
+    } else if (scan_tid > 0) {
+      scan_op(result, row[scan_tid - 1]);
+    }
+    out = result;
+  }
+  scan_op(carry, row[scan_size - 1]);
+  block_sync::sync<Aligned>();
+}
+
+// Use the same pred for both reads and writes
+template <bool Exclusive, bool Aligned, typename T, typename Func>
+__device__ void blockScan(
+    T& out,
+    const T& inp_val,
+    T& carry,
+    Func scan_op,
+    T* shared_mem,
+    bool read_write_pred,
+    T init_val) {
+  blockScan<Exclusive, Aligned, T, Func>(
+      out,
+      inp_val,
+      carry,
+      scan_op,
+      shared_mem,
+      read_write_pred,
+      read_write_pred,
+      init_val);
+}
@@ -0,0 +1,359 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+
+// Host runtime of the C++ backend. Kernels generated by
+// codegen::generateCppKernel use the same names as the CUDA runtime, so
+// this file provides host versions of the subset of the CUDA runtime
+// they can refer to. It is compiled by the system compiler, so the
+// standard headers are included before this file, see
+// getStructuredCppCode.
+
+#define POS_INFINITY INFINITY
+#define NEG_INFINITY (-INFINITY)
+
+struct Dim3 {
+  nvfuser_index_t x;
+  nvfuser_index_t y;
+  nvfuser_index_t z;
+};
+
+template <typename scalar_t, int size, int align_size = 1>
+struct alignas(sizeof(scalar_t) * align_size) Array {
+  scalar_t array[size];
+
+  void set(scalar_t v) {
+    for (int i = 0; i < size; ++i) {
+      array[i] = v;
+    }
+  }
+
+  scalar_t& operator[](const unsigned int i) {
+    return array[i];
+  }
+
+  const scalar_t& operator[](const unsigned int i) const {
+    return array[i];
+  }
+};
+
+template <typename T, int Dims, int AllocDims = Dims>
+struct Tensor {
+  T& operator[](nvfuser_index_t ind) {
+    return data[ind];
+  };
+
+  T* data;
+  Array<nvfuser_index_t, Dims, 1> logical_size;
+  Array<nvfuser_index_t, AllocDims, 1> alloc_stride;
+};
+
+template <typename T>
+struct Tensor<T, 0> {
+  T& operator[](nvfuser_index_t i) {
+    return *data;
+  };
+
+  T* data;
+};
+
+template <typename T>
+struct CpuScalarTensor {
+  T& operator[](int i) {
+    return data;
+  };
+
+  T data;
+};
+
+// Index arithmetic
+
+template <typename T, typename U>
+constexpr auto ceilDiv(T a, U b) {
+  if constexpr (std::is_integral_v<T> && std::is_integral_v<U>) {
+    using R = std::common_type_t<T, U>;
+    return ((R)a + (R)b - 1) / (R)b;
+  } else {
+    return std::ceil((double)a / (double)b);
+  }
+}
+
+template <typename T, typename U>
+constexpr auto max(T a, U b) {
+  using R = std::common_type_t<T, U>;
+  return (R)a > (R)b ? (R)a : (R)b;
+}
+
+template <typename T, typename U>
+constexpr auto min(T a, U b) {
+  using R = std::common_type_t<T, U>;
+  return (R)a < (R)b ? (R)a : (R)b;
+}
+
+template <typename T>
+T gcd(T a, T b) {
+  return std::gcd(a, b);
+}
+
+// Unary math functions. The CUDA code generator appends an "f" to the
+// name of the single precision version.
+
+#define NVFUSER_CPU_UNARY_FUNCTION(name, std_name) \
+  inline double name(double x) {                   \
+    return std::std_name(x);                       \
+  }                                                \
+  inline float name##f(float x) {                  \
+    return std::std_name(x);                       \
+  }
+
+NVFUSER_CPU_UNARY_FUNCTION(acos, acos)
+NVFUSER_CPU_UNARY_FUNCTION(acosh, acosh)
+NVFUSER_CPU_UNARY_FUNCTION(asin, asin)
+NVFUSER_CPU_UNARY_FUNCTION(asinh, asinh)
+NVFUSER_CPU_UNARY_FUNCTION(atan, atan)
+NVFUSER_CPU_UNARY_FUNCTION(atanh, atanh)
+NVFUSER_CPU_UNARY_FUNCTION(ceil, ceil)
+NVFUSER_CPU_UNARY_FUNCTION(cos, cos)
+NVFUSER_CPU_UNARY_FUNCTION(cosh, cosh)
+NVFUSER_CPU_UNARY_FUNCTION(exp, exp)
+NVFUSER_CPU_UNARY_FUNCTION(exp2, exp2)
+NVFUSER_CPU_UNARY_FUNCTION(expm1, expm1)
+NVFUSER_CPU_UNARY_FUNCTION(erf, erf)
+NVFUSER_CPU_UNARY_FUNCTION(erfc, erfc)
+NVFUSER_CPU_UNARY_FUNCTION(floor, floor)
+NVFUSER_CPU_UNARY_FUNCTION(lgamma, lgamma)
+NVFUSER_CPU_UNARY_FUNCTION(log, log)
+NVFUSER_CPU_UNARY_FUNCTION(log10, log10)
+NVFUSER_CPU_UNARY_FUNCTION(log1p, log1p)
+NVFUSER_CPU_UNARY_FUNCTION(log2, log2)
+NVFUSER_CPU_UNARY_FUNCTION(nearbyint, nearbyint)
+NVFUSER_CPU_UNARY_FUNCTION(sin, sin)
+NVFUSER_CPU_UNARY_FUNCTION(sinh, sinh)
+NVFUSER_CPU_UNARY_FUNCTION(sqrt, sqrt)
+NVFUSER_CPU_UNARY_FUNCTION(tan, tan)
+NVFUSER_CPU_UNARY_FUNCTION(tanh, tanh)
+NVFUSER_CPU_UNARY_FUNCTION(trunc, trunc)
+
+#undef NVFUSER_CPU_UNARY_FUNCTION
+
+inline double rsqrt(double x) {
+  return 1.0 / std::sqrt(x);
+}
+
+inline float rsqrtf(float x) {
+  return 1.0f / std::sqrt(x);
+}
+
+inline bool signbit(double x) {
+  return std::signbit(x);
+}
+
+inline bool signbitf(float x) {
+  return std::signbit(x);
+}
+
+template <typename T>
+T abs(T x) {
+  if constexpr (std::is_same_v<T, bool>) {
+    return x;
+  } else {
+    return x < 0 ? -x : x;
+  }
+}
+
+template <typename T>
+T frac(T x) {
+  return x - std::trunc(x);
+}
+
+template <typename T>
+T reciprocal(T x) {
+  return (T)1 / x;
+}
+
+template <typename T>
+T relu(T x) {
+  return x <= (T)0 ? (T)0 : x;
+}
+
+template <typename T>
+T sigmoid(T x) {
+  return (T)1 / ((T)1 + std::exp(-x));
+}
+
+template <typename T>
+T silu(T x) {
+  return x * sigmoid(x);
+}
+
+template <typename T>
+bool isfinite(T x) {
+  if constexpr (std::is_floating_point_v<T>) {
+    return std::isfinite(x);
+  } else {
+    return true;
+  }
+}
+
+template <typename T>
+bool isinf(T x) {
+  if constexpr (std::is_floating_point_v<T>) {
+    return std::isinf(x);
+  } else {
+    return false;
+  }
+}
+
+template <typename T>
+bool isnan(T x) {
+  if constexpr (std::is_floating_point_v<T>) {
+    return std::isnan(x);
+  } else {
+    return false;
+  }
+}
+
+template <typename T>
+bool isneginf(T x) {
+  return isinf(x) && x < 0;
+}
+
+template <typename T>
+bool isposinf(T x) {
+  return isinf(x) && x > 0;
+}
+
+template <typename T>
+bool isreal(T x) {
+  return true;
+}
+
+// Binary math functions
+
+// fmax and fmin propagate NaN, unlike std::fmax and std::fmin
+inline double fmax(double a, double b) {
+  if (a != a) {
+    return a;
+  } else if (b != b) {
+    return b;
+  }
+  return a > b ? a : b;
+}
+
+inline float fmax(float a, float b) {
+  if (a != a) {
+    return a;
+  } else if (b != b) {
+    return b;
+  }
+  return a > b ? a : b;
+}
+
+inline double fmin(double a, double b) {
+  if (a != a) {
+    return a;
+  } else if (b != b) {
+    return b;
+  }
+  return a < b ? a : b;
+}
+
+inline float fmin(float a, float b) {
+  if (a != a) {
+    return a;
+  } else if (b != b) {
+    return b;
+  }
+  return a < b ? a : b;
+}
+
+inline double atan2(double a, double b) {
+  return std::atan2(a, b);
+}
+
+inline float atan2f(float a, float b) {
+  return std::atan2(a, b);
+}
+
+inline double fmod(double a, double b) {
+  return std::fmod(a, b);
+}
+
+inline float fmodf(float a, float b) {
+  return std::fmod(a, b);
+}
+
+template <typename T>
+T fmod(T a, T b) {
+  return a % b;
+}
+
+inline double nextafter(double a, double b) {
+  return std::nextafter(a, b);
+}
+
+inline float nextafter(float a, float b) {
+  return std::nextafter(a, b);
+}
+
+template <typename T, typename U>
+auto pow(T a, U b) {
+  if constexpr (std::is_integral_v<T> && std::is_integral_v<U>) {
+    using R = std::common_type_t<T, U>;
+    R result = 1;
+    R base = a;
+    for (R e = b; e > 0; e >>= 1) {
+      if (e & 1) {
+        result *= base;
+      }
+      base *= base;
+    }
+    return b < 0 ? (R)0 : result;
+  } else {
+    return std::pow(a, b);
+  }
+}
+
+// Python-style remainder that has the sign of the divisor
+template <typename T>
+T remainder(T a, T b) {
+  if constexpr (std::is_integral_v<T>) {
+    auto mod = a % b;
+    if ((mod != 0) && ((b < 0) != (mod < 0))) {
+      mod += b;
+    }
+    return mod;
+  } else {
+    auto mod = std::fmod(a, b);
+    if ((mod != 0) && ((b < 0) != (mod < 0))) {
+      mod += b;
+    }
+    return mod;
+  }
+}
+
+// Ternary math functions
+
+template <typename T, typename U, typename V>
+T clamp(T x, U min_val, V max_val) {
+  return x < (T)min_val ? (T)min_val : (x > (T)max_val ? (T)max_val : x);
+}
+
+template <typename T, typename U, typename V>
+T threshold(T x, U t, V v) {
+  return x <= (T)t ? (T)v : x;
+}
+
+// Monotonic and precise lerp, see helpers.cu
+template <typename T, typename U, typename V>
+T lerp(T start, U end, V weight) {
+  if (weight < (T)0.5) {
+    return start + (T)weight * ((T)end - start);
+  } else {
+    return (T)end - ((T)end - start) * ((T)1 - (T)weight);
+  }
+}
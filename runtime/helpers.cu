@@ -106,6 +106,25 @@ __device__ float fmax(float a, float b) {
   }
 }
 
+// Combines two partial results of online softmax. Each packs the running
+// max in the upper 32 bits and the sum of exp(x - max) in the lower 32 bits
+// as floats.
+__device__ int64_t onlineSoftmax(int64_t a, int64_t b) {
+  const float a_max = __int_as_float((int)(a >> 32));
+  const float a_sum = __int_as_float((int)a);
+  const float b_max = __int_as_float((int)(b >> 32));
+  const float b_sum = __int_as_float((int)b);
+  const float max = fmax(a_max, b_max);
+  // Both are empty partial results when the max is -inf, which would make
+  // exp(a_max - max) NaN
+  const float sum = max == __int_as_float(0xff800000)
+      ? a_sum + b_sum
+      : a_sum * exp(a_max - max) + b_sum * exp(b_max - max);
+  return (int64_t)(
+      ((uint64_t)(unsigned)__float_as_int(max) << 32) |
+      (uint64_t)(unsigned)__float_as_int(sum));
+}
+
 __device__ constexpr int min(int a, int b) {
   return a > b ? b : a;
 }
@@ -0,0 +1,270 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gtest/gtest.h>
+
+#include <expr_evaluator.h>
+#include <ir/all_nodes.h>
+#include <ir/builder.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+#include <scheduler/all_schedulers.h>
+
+#include <test/utils.h>
+#include <test/validator.h>
+
+#include <torch/torch.h>
+
+namespace nvfuser {
+
+class ArgReductionTest : public NVFuserTest {};
+
+// Evaluate argmax and argmin on CPU with ExpressionEvaluator
+TEST_F(ArgReductionTest, EvaluateCpu) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto max_result = max_and_argmax(tv0, 1);
+  auto min_result = min_and_argmin(tv0, 0, /*keep_dim=*/true);
+
+  auto t0 = at::randn({13, 17}, at::TensorOptions().dtype(at::kFloat));
+  // Ties are resolved to the smallest index
+  t0.select(0, 3).fill_(1);
+
+  ExpressionEvaluator ee;
+  ee.bind(tv0, t0);
+
+  auto ref_max = at::max(t0, 1);
+  EXPECT_TRUE(at::equal(
+      ee.evaluate(max_result.values).as<at::Tensor>(),
+      std::get<0>(ref_max)));
+  EXPECT_TRUE(at::equal(
+      ee.evaluate(max_result.indices).as<at::Tensor>(),
+      std::get<1>(ref_max)));
+
+  auto ref_min = at::min(t0, 0, /*keepdim=*/true);
+  EXPECT_TRUE(at::equal(
+      ee.evaluate(min_result.values).as<at::Tensor>(),
+      std::get<0>(ref_min)));
+  EXPECT_TRUE(at::equal(
+      ee.evaluate(min_result.indices).as<at::Tensor>(),
+      std::get<1>(ref_min)));
+}
+
+// 64-bit values are reduced without packing
+TEST_F(ArgReductionTest, EvaluateCpuDouble) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2, DataType::Double);
+  fusion.addInput(tv0);
+  auto result = max_and_argmax(tv0, 0);
+
+  auto t0 = at::randn({13, 17}, at::TensorOptions().dtype(at::kDouble));
+
+  ExpressionEvaluator ee;
+  ee.bind(tv0, t0);
+
+  auto ref = at::max(t0, 0);
+  EXPECT_TRUE(at::equal(
+      ee.evaluate(result.values).as<at::Tensor>(), std::get<0>(ref)));
+  EXPECT_TRUE(at::equal(
+      ee.evaluate(result.indices).as<at::Tensor>(), std::get<1>(ref)));
+}
+
+// The index of the first NaN is returned, as with at::argmax, when 64-bit
+// values are reduced without packing
+TEST_F(ArgReductionTest, EvaluateCpuDoubleNan) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2, DataType::Double);
+  auto tv1 = makeSymbolicTensor(2, DataType::Int);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = argmax(tv0, 1);
+  auto tv3 = argmin(tv0, 0);
+  auto tv4 = argmax(tv1, 1);
+
+  auto t0 = at::randn({13, 17}, at::TensorOptions().dtype(at::kDouble));
+  t0.index_put_({2, 5}, NAN);
+  t0.index_put_({2, 9}, NAN);
+  t0.index_put_({7, 0}, NAN);
+  auto t1 = at::randint(-8, 8, {13, 17}, at::TensorOptions().dtype(at::kLong));
+
+  ExpressionEvaluator ee;
+  ee.bind(tv0, t0);
+  ee.bind(tv1, t1);
+
+  EXPECT_TRUE(at::equal(ee.evaluate(tv2).as<at::Tensor>(), at::argmax(t0, 1)));
+  EXPECT_TRUE(at::equal(ee.evaluate(tv3).as<at::Tensor>(), at::argmin(t0, 0)));
+  EXPECT_TRUE(at::equal(ee.evaluate(tv4).as<at::Tensor>(), at::argmax(t1, 1)));
+}
+
+TEST_F(ArgReductionTest, TopKEvaluateCpu) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2, DataType::Int32);
+  fusion.addInput(tv0);
+  auto largest = topk(tv0, 3, 1);
+  auto smallest = topk(tv0, 2, 0, /*largest=*/false);
+
+  auto t0 = at::randperm(12 * 19, at::TensorOptions().dtype(at::kInt))
+                .view({12, 19});
+
+  ExpressionEvaluator ee;
+  ee.bind(tv0, t0);
+
+  auto ref_largest = at::topk(t0, 3, 1);
+  EXPECT_TRUE(at::equal(
+      ee.evaluate(largest.values).as<at::Tensor>(),
+      std::get<0>(ref_largest)));
+  EXPECT_TRUE(at::equal(
+      ee.evaluate(largest.indices).as<at::Tensor>(),
+      std::get<1>(ref_largest)));
+
+  auto ref_smallest = at::topk(t0, 2, 0, /*largest=*/false);
+  EXPECT_TRUE(at::equal(
+      ee.evaluate(smallest.values).as<at::Tensor>(),
+      std::get<0>(ref_smallest)));
+  EXPECT_TRUE(at::equal(
+      ee.evaluate(smallest.indices).as<at::Tensor>(),
+      std::get<1>(ref_smallest)));
+}
+
+// argmax is scheduled as a single reduction by the reduction scheduler
+TEST_F(ArgReductionTest, ArgMaxReduction_CUDA) {
+  for (auto dtype : {DataType::Float, DataType::Half}) {
+    auto fusion_ptr = std::make_unique<Fusion>();
+    Fusion& fusion = *fusion_ptr.get();
+    FusionGuard fg(&fusion);
+
+    auto tv0 = makeContigTensor(2, dtype);
+    fusion.addInput(tv0);
+    auto result = max_and_argmax(tv0, 1);
+    fusion.addOutput(result.values);
+    fusion.addOutput(result.indices);
+
+    auto options = at::TensorOptions()
+                       .dtype(data_type_to_aten(dtype))
+                       .device(at::kCUDA, 0);
+    auto t0 = at::randn({1024, 4096}, options);
+    std::vector<c10::IValue> aten_inputs = {t0};
+
+    FusionExecutorCache executor_cache(std::move(fusion_ptr));
+    auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+    auto runtime = executor_cache.getMostRecentKernelRuntime();
+    EXPECT_FALSE(runtime->isSegmented());
+    EXPECT_EQ(
+        runtime->schedulerHeuristics()->heuristicsList().at(0)->heuristic(),
+        ScheduleHeuristic::Reduction);
+
+    auto ref = at::max(t0, 1);
+    EXPECT_TRUE(at::equal(cg_outputs.at(0), std::get<0>(ref)));
+    EXPECT_TRUE(at::equal(cg_outputs.at(1), std::get<1>(ref)));
+  }
+}
+
+// argmin along the outer dimension
+TEST_F(ArgReductionTest, ArgMinOuterReduction_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = argmin(tv0, 0);
+  fusion.addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({8192, 256}, options);
+  std::vector<c10::IValue> aten_inputs = {t0};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  EXPECT_EQ(
+      executor_cache.getMostRecentKernelRuntime()
+          ->schedulerHeuristics()
+          ->heuristicsList()
+          .at(0)
+          ->heuristic(),
+      ScheduleHeuristic::Reduction);
+  EXPECT_TRUE(at::equal(cg_outputs.at(0), at::argmin(t0, 0)));
+}
+
+// Normalizing with the max and using its index keeps the input persistent
+TEST_F(ArgReductionTest, ArgMaxPersistent_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto result = max_and_argmax(tv0, 1, /*keep_dim=*/true);
+  auto tv1 = sub(tv0, result.values);
+  fusion.addOutput(tv1);
+  fusion.addOutput(result.indices);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({512, 1024}, options);
+  std::vector<c10::IValue> aten_inputs = {t0};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  EXPECT_EQ(
+      runtime->schedulerHeuristics()->heuristicsList().at(0)->heuristic(),
+      ScheduleHeuristic::InnerPersistent);
+
+  auto ref = at::max(t0, 1, /*keepdim=*/true);
+  testValidate(
+      executor_cache.fusion(),
+      cg_outputs,
+      aten_inputs,
+      {t0 - std::get<0>(ref), std::get<1>(ref)},
+      __LINE__,
+      __FILE__);
+}
+
+TEST_F(ArgReductionTest, TopK_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto result = topk(tv0, 4, 1);
+  fusion.addOutput(result.values);
+  fusion.addOutput(result.indices);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({256, 1000}, options);
+  std::vector<c10::IValue> aten_inputs = {t0};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  // The rounds are fused into a persistent kernel. Placing the results
+  // along the top-k axis may be segmented out.
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_EQ(
+      runtime->schedulerHeuristics()->heuristicsList().at(0)->heuristic(),
+      ScheduleHeuristic::InnerPersistent);
+
+  auto ref = at::topk(t0, 4, 1);
+  EXPECT_TRUE(at::equal(cg_outputs.at(0), std::get<0>(ref)));
+  EXPECT_TRUE(at::equal(cg_outputs.at(1), std::get<1>(ref)));
+}
+
+} // namespace nvfuser
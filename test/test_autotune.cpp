@@ -0,0 +1,343 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <gtest/gtest.h>
+
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+#include <options.h>
+#include <scheduler/all_schedulers.h>
+#include <scheduler/autotune.h>
+#include <scheduler/heuristic_db.h>
+
+#include <test/utils.h>
+#include <test/validator.h>
+
+#include <torch/torch.h>
+
+#include <cmath>
+
+namespace nvfuser {
+
+class AutotuneTest : public NVFuserTest {};
+
+namespace {
+
+// Open an empty database in a temporary directory
+HeuristicDb& openTestDb(const std::string& dir) {
+  fs::path db_path = fs::temp_directory_path() / dir;
+  if (fs::is_directory(db_path)) {
+    fs::remove_all(db_path);
+  }
+  return HeuristicDb::get(dir, "db.csv", true, false, true);
+}
+
+void closeTestDb(const std::string& dir) {
+  HeuristicDb::get(dir, "db.csv", true, true, true);
+  fs::remove_all(fs::temp_directory_path() / dir);
+}
+
+} // namespace
+
+TEST_F(AutotuneTest, KnobsToString) {
+  TuningKnobs knobs = {{"unroll_factor", 4}, {"vectorize", 1}};
+  EXPECT_EQ(toString(knobs), "unroll_factor=4;vectorize=1");
+  EXPECT_EQ(parseTuningKnobs(toString(knobs)), knobs);
+  EXPECT_TRUE(parseTuningKnobs("").empty());
+}
+
+// Vectorization factors are only lowered, unroll factors are explored
+TEST_F(AutotuneTest, PointwiseCandidates) {
+  PointwiseParams vectorized;
+  vectorized.vectorize = true;
+  vectorized.unroll_factor = 8;
+  std::vector<TuningKnobs> expected = {
+      {{"vectorize", 1}, {"unroll_factor", 8}},
+      {{"vectorize", 1}, {"unroll_factor", 4}},
+      {{"vectorize", 1}, {"unroll_factor", 2}},
+      {{"vectorize", 0}, {"unroll_factor", 1}}};
+  EXPECT_EQ(enumerateTuningCandidates(vectorized), expected);
+
+  PointwiseParams unrolled;
+  unrolled.unroll_factor = 2;
+  auto candidates = enumerateTuningCandidates(unrolled);
+  ASSERT_EQ(candidates.size(), 4);
+  EXPECT_EQ(candidates.front(), getTuningKnobs(unrolled));
+
+  applyTuningKnobs(unrolled, candidates.back());
+  EXPECT_FALSE(unrolled.vectorize);
+  EXPECT_EQ(unrolled.unroll_factor, 8);
+}
+
+// Persistent and cross-grid reductions have no knobs
+TEST_F(AutotuneTest, ReductionCandidates) {
+  ReductionParams rparams;
+  rparams.fastest_dim = true;
+  rparams.cross_block_inner_reduction = true;
+  rparams.vectorize_inner_reduction = true;
+  rparams.unroll_factor_inner_reduction = 4;
+  rparams.unroll_factor_iter_dom = 1;
+  rparams.lparams = LaunchParams(1024, -1, -1, 128, -1, -1);
+
+  auto candidates = enumerateTuningCandidates(rparams);
+  // (vec 4, vec 2, unrolled 1) x (1, 2, 4, 8)
+  EXPECT_EQ(candidates.size(), 3 * 4);
+  EXPECT_EQ(candidates.front(), getTuningKnobs(rparams));
+
+  // The grid is inferred again when the factors change
+  applyTuningKnobs(rparams, candidates.back());
+  EXPECT_EQ(rparams.unroll_factor_iter_dom, 8);
+  EXPECT_FALSE(rparams.vectorize_inner_reduction);
+  EXPECT_FALSE(rparams.lparams.hasDim(ParallelType::BIDx));
+  EXPECT_EQ(rparams.lparams.bdimx(), 128);
+
+  ReductionParams persistent = rparams;
+  persistent.persistent_kernel = true;
+  EXPECT_TRUE(getTuningKnobs(persistent).empty());
+  EXPECT_EQ(enumerateTuningCandidates(persistent).size(), 1);
+}
+
+// The number of threads of a transpose depends on its vectorization
+TEST_F(AutotuneTest, TransposeCandidates) {
+  TransposeParams tparams;
+  tparams.vectorize_factor1 = 4;
+  tparams.vectorize_factor2 = 2;
+  tparams.lparams.bind(tparams.getThreadsPerBlock(), ParallelType::TIDx);
+  EXPECT_EQ(tparams.lparams.bdimx(), 128);
+
+  auto candidates = enumerateTuningCandidates(tparams);
+  EXPECT_EQ(candidates.size(), 3 * 2);
+
+  tparams.tile_size1 = 8;
+  tparams.tile_size2 = 8;
+  applyTuningKnobs(
+      tparams, {{"vectorize_factor1", 2}, {"vectorize_factor2", 1}});
+  EXPECT_EQ(tparams.vectorize_factor1, 2);
+  EXPECT_EQ(tparams.lparams.bdimx(), 32);
+}
+
+// Recorded knobs don't vectorize beyond what the heuristic allows
+TEST_F(AutotuneTest, ClampKnobs) {
+  PointwiseParams vectorized;
+  vectorized.vectorize = true;
+  vectorized.unroll_factor = 2;
+  TuningKnobs expected = {{"vectorize", 1}, {"unroll_factor", 2}};
+  EXPECT_EQ(
+      clampTuningKnobs(vectorized, {{"vectorize", 1}, {"unroll_factor", 8}}),
+      expected);
+  expected = {{"vectorize", 0}, {"unroll_factor", 4}};
+  EXPECT_EQ(clampTuningKnobs(vectorized, expected), expected);
+
+  PointwiseParams unaligned;
+  unaligned.unroll_factor = 1;
+  expected = {{"vectorize", 0}, {"unroll_factor", 4}};
+  EXPECT_EQ(
+      clampTuningKnobs(unaligned, {{"vectorize", 1}, {"unroll_factor", 4}}),
+      expected);
+
+  TransposeParams tparams;
+  tparams.vectorize_factor1 = 2;
+  tparams.vectorize_factor2 = 4;
+  expected = {{"vectorize_factor1", 2}, {"vectorize_factor2", 2}};
+  EXPECT_EQ(
+      clampTuningKnobs(
+          tparams, {{"vectorize_factor1", 4}, {"vectorize_factor2", 2}}),
+      expected);
+}
+
+TEST_F(AutotuneTest, MatmulCandidates) {
+  MatmulParams mparams;
+  mparams.tile_sizes = {
+      GemmTile(128, 128, 32), GemmTile(64, 64, 32), GemmTile(16, 8, 16)};
+  mparams.double_buffer_options.double_buffer_smem_write = true;
+  mparams.double_buffer_options.smem_double_buffer_stage = 3;
+  mparams.use_smem_epilogue = true;
+
+  auto candidates = enumerateTuningCandidates(mparams);
+  // 3 CTA tiles x 2 orders x 3 swizzles x 3 stages
+  EXPECT_EQ(candidates.size(), 3 * 2 * 3 * 3);
+  EXPECT_EQ(candidates.front(), getTuningKnobs(mparams));
+
+  // Applying the default knobs keeps the epilogue
+  applyTuningKnobs(mparams, candidates.front());
+  EXPECT_TRUE(mparams.use_smem_epilogue);
+
+  auto knobs = getTuningKnobs(mparams);
+  knobs["cta_tile_m"] = 64;
+  knobs["cta_tile_n"] = 256;
+  applyTuningKnobs(mparams, knobs);
+  EXPECT_EQ(mparams.tile_sizes.cta_tile.m, 64);
+  EXPECT_EQ(mparams.tile_sizes.cta_tile.n, 256);
+  EXPECT_FALSE(mparams.use_smem_epilogue);
+}
+
+// The tuner picks the fastest valid candidate of the backend
+TEST_F(AutotuneTest, MockBackend) {
+  ReductionParams rparams;
+  rparams.fastest_dim = true;
+  rparams.vectorize_inner_reduction = true;
+  rparams.unroll_factor_inner_reduction = 8;
+
+  MockMeasurementBackend backend(
+      [](ScheduleHeuristic heuristic,
+         const HeuristicParams& params) -> std::optional<double> {
+        EXPECT_EQ(heuristic, ScheduleHeuristic::Reduction);
+        const auto& candidate = *dynamic_cast<const ReductionParams*>(&params);
+        // Unrolling the iteration domain by 8 fails to launch
+        if (candidate.unroll_factor_iter_dom == 8) {
+          return std::nullopt;
+        }
+        return 10.0 +
+            std::abs(candidate.unroll_factor_inner_reduction - 4.0) +
+            std::abs(candidate.unroll_factor_iter_dom - 6.0);
+      });
+
+  auto result =
+      tuneHeuristicParams(ScheduleHeuristic::Reduction, rparams, backend);
+  EXPECT_EQ(result.num_candidates, 4 * 4);
+  EXPECT_EQ(backend.numMeasurements(), result.num_candidates);
+  EXPECT_EQ(result.default_time_us, 10.0 + 4.0 + 5.0);
+  EXPECT_EQ(result.best_time_us, 10.0 + 0.0 + 2.0);
+  TuningKnobs expected = {
+      {"vectorize_inner_reduction", 1},
+      {"unroll_factor_inner_reduction", 4},
+      {"vectorize_iter_dom", 0},
+      {"unroll_factor_iter_dom", 4}};
+  EXPECT_EQ(result.best_knobs, expected);
+}
+
+// Entries are persisted and the latest one of a key wins
+TEST_F(AutotuneTest, DatabasePersistence) {
+  const std::string db_dir = "nvfuser_heuristic_db_persistence_test";
+  auto& db = openTestDb(db_dir);
+  ASSERT_TRUE(db.enabled());
+  EXPECT_EQ(db.size(), 0);
+
+  HeuristicDbKey key;
+  key.fusion_hash = 1234;
+  key.shape_bucket = "i32;10x12;b";
+  key.arch = 80;
+  key.heuristic = ScheduleHeuristic::PointWise;
+  HeuristicDbKey other_arch = key;
+  other_arch.arch = 90;
+
+  TuningKnobs first = {{"vectorize", 1}, {"unroll_factor", 4}};
+  TuningKnobs second = {{"vectorize", 1}, {"unroll_factor", 2}};
+  ASSERT_TRUE(db.write(key, first, 12.5));
+  ASSERT_TRUE(db.write(key, second, 11.0));
+  EXPECT_EQ(db.size(), 1);
+  EXPECT_FALSE(db.query(other_arch).has_value());
+
+  // Reopen from the file
+  auto& reopened = HeuristicDb::get(db_dir, "db.csv", true, false, true);
+  ASSERT_TRUE(reopened.enabled());
+  EXPECT_EQ(reopened.size(), 1);
+  auto knobs = reopened.query(key);
+  ASSERT_TRUE(knobs.has_value());
+  EXPECT_EQ(knobs.value(), second);
+
+  closeTestDb(db_dir);
+}
+
+// The hash doesn't depend on the names of values
+TEST_F(AutotuneTest, FusionHash) {
+  auto define = [](Fusion& fusion, bool shift_names, bool use_mul) {
+    FusionGuard fg(&fusion);
+    if (shift_names) {
+      makeSymbolicTensor(2);
+      IrBuilder::create<Val>(DataType::Int);
+    }
+    auto tv0 = makeSymbolicTensor(2);
+    fusion.addInput(tv0);
+    auto tv1 = use_mul ? mul(tv0, tv0) : add(tv0, tv0);
+    auto tv2 = sum(tv1, {1});
+    fusion.addOutput(tv2);
+  };
+
+  Fusion fusion_a;
+  define(fusion_a, false, false);
+  Fusion fusion_b;
+  define(fusion_b, true, false);
+  Fusion fusion_c;
+  define(fusion_c, false, true);
+
+  EXPECT_EQ(
+      HeuristicDb::fusionHash(&fusion_a), HeuristicDb::fusionHash(&fusion_b));
+  EXPECT_NE(
+      HeuristicDb::fusionHash(&fusion_a), HeuristicDb::fusionHash(&fusion_c));
+}
+
+// Tuned parameters are picked up by the fusion executor cache
+TEST_F(AutotuneTest, TunedPointwise_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::HeuristicDb);
+  const std::string db_dir = "nvfuser_heuristic_db_pointwise_test";
+  auto& db = openTestDb(db_dir);
+  ASSERT_TRUE(db.enabled());
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = add(tv0, tv1);
+  auto tv3 = sin(tv2);
+  fusion.addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 2048}, options);
+  at::Tensor t1 = at::randn({1024, 2048}, options);
+  std::vector<c10::IValue> aten_inputs = {t0, t1};
+  auto args = KernelArgumentHolder::createKernelArgumentHolder(aten_inputs);
+
+  // Every candidate must run on the GPU
+  GpuMeasurementBackend gpu_backend(&fusion, args, 1, 2);
+  auto gpu_result = tuneFusion(&fusion, args, gpu_backend, db);
+  ASSERT_TRUE(gpu_result.has_value());
+  EXPECT_TRUE(std::isfinite(gpu_result->default_time_us));
+  EXPECT_LE(gpu_result->best_time_us, gpu_result->default_time_us);
+
+  // Force a non-default winner
+  MockMeasurementBackend mock_backend(
+      [](ScheduleHeuristic, const HeuristicParams& params) {
+        auto pparams = dynamic_cast<const PointwiseParams*>(&params);
+        return std::optional<double>(
+            pparams->vectorize && pparams->unroll_factor == 2 ? 1.0 : 2.0);
+      });
+  auto mock_result = tuneFusion(&fusion, args, mock_backend, db);
+  ASSERT_TRUE(mock_result.has_value());
+  TuningKnobs expected = {{"vectorize", 1}, {"unroll_factor", 2}};
+  ASSERT_EQ(mock_result->best_knobs, expected);
+  EXPECT_EQ(db.size(), 1);
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  const auto& heuristic =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  EXPECT_EQ(heuristic->heuristic(), ScheduleHeuristic::PointWise);
+  EXPECT_EQ(getTuningKnobs(*heuristic->params()), expected);
+
+  testValidate(
+      executor_cache.fusion(),
+      cg_outputs,
+      aten_inputs,
+      {(t0 + t1).sin()},
+      __LINE__,
+      __FILE__);
+
+  closeTestDb(db_dir);
+}
+
+} // namespace nvfuser
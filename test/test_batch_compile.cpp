@@ -0,0 +1,208 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <executor.h>
+#include <executor_utils.h>
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+#include <options.h>
+
+#include <test/utils.h>
+#include <test/validator.h>
+
+#include <torch/torch.h>
+
+#include <unordered_set>
+
+namespace nvfuser {
+
+class BatchCompileTest : public NVFuserTest {
+ protected:
+  void SetUp() override {
+    NVFuserTest::SetUp();
+    EnableOptionsGuard::getCurOptions().set(EnableOption::BatchCompile);
+  }
+
+ private:
+  EnableOptionsGuard enable_guard_;
+  DisableOptionsGuard disable_guard_;
+};
+
+namespace {
+
+// Number of modules loaded for the kernels of the most recent runtime
+int64_t numModules(FusionExecutorCache* fec) {
+  std::unordered_set<CUmodule> modules;
+  for (const auto& executor :
+       fec->getMostRecentKernelRuntime()->executors()) {
+    EXPECT_TRUE(executor.isCompiled());
+    EXPECT_FALSE(executor.hasDeferredCompile());
+    modules.insert(executor.compiledKernel().module);
+  }
+  return (int64_t)modules.size();
+}
+
+} // namespace
+
+// Without parallel compilation, the kernels are compiled in one batch
+TEST_F(BatchCompileTest, SegmentChain) {
+  DisableOptionsGuard::getCurOptions().set(DisableOption::ParallelCompile);
+  auto fec = makeSegmentChain(8);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({128, 33}, options);
+  auto outputs = fec->runFusionWithInputs({t0});
+
+  EXPECT_EQ(
+      fec->getMostRecentKernelRuntime()->fusionSegments()->groups().size(), 8);
+  EXPECT_EQ(numModules(fec.get()), 1);
+  testValidate(
+      fec->fusion(), outputs, {t0}, {t0 * 256}, __LINE__, __FILE__);
+}
+
+// Batches take the kernels compiled before from the module cache and add
+// the kernels they compile to it
+TEST_F(BatchCompileTest, ModuleCache) {
+  DisableOptionsGuard::getCurOptions().set(DisableOption::ParallelCompile);
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ModuleCache);
+  auto& cache = executor_utils::CompiledKernelCache::get();
+  cache.clear();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({128, 33}, options);
+  // The segments of the chain generate the same code
+  auto fec0 = makeSegmentChain(4);
+  fec0->runFusionWithInputs({t0});
+  EXPECT_EQ(cache.misses(), 1);
+  EXPECT_EQ(cache.hits(), 0);
+
+  auto fec1 = makeSegmentChain(4);
+  auto outputs = fec1->runFusionWithInputs({t0});
+  EXPECT_EQ(cache.misses(), 1);
+  EXPECT_EQ(cache.hits(), 4);
+  EXPECT_EQ(numModules(fec1.get()), 1);
+  testValidate(
+      fec1->fusion(), outputs, {t0}, {t0 * 16}, __LINE__, __FILE__);
+  cache.clear();
+}
+
+TEST_F(BatchCompileTest, MaxBatchSize) {
+  DisableOptionsGuard::getCurOptions().set(DisableOption::ParallelCompile);
+  EnableOptionsGuard::getCurOptions().set(EnableOption::BatchCompile, {"3"});
+  auto fec = makeSegmentChain(8);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({128, 33}, options);
+  auto outputs = fec->runFusionWithInputs({t0});
+
+  EXPECT_EQ(numModules(fec.get()), 3);
+  testValidate(
+      fec->fusion(), outputs, {t0}, {t0 * 256}, __LINE__, __FILE__);
+}
+
+TEST_F(BatchCompileTest, ParallelBatches) {
+  auto fec = makeSegmentChain(16);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({128, 33}, options);
+  for (auto i : c10::irange(2)) {
+    (void)i;
+    auto outputs = fec->runFusionWithInputs({t0});
+    testValidate(
+        fec->fusion(), outputs, {t0}, {t0 * 65536}, __LINE__, __FILE__);
+  }
+  EXPECT_LE(numModules(fec.get()), 16);
+}
+
+// The kernels of several caches are compiled in one batch
+TEST_F(BatchCompileTest, AcrossCaches) {
+  DisableOptionsGuard::getCurOptions().set(DisableOption::ParallelCompile);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({128, 33}, options);
+
+  std::vector<std::unique_ptr<FusionExecutorCache>> fecs;
+  std::vector<std::pair<FusionExecutorCache*, std::vector<c10::IValue>>>
+      fusions;
+  for (auto i : c10::irange(3)) {
+    fecs.push_back(makeSegmentChain(i + 2));
+    fusions.emplace_back(fecs.back().get(), std::vector<c10::IValue>{t0});
+  }
+  // A cache given twice is compiled once
+  fusions.emplace_back(fecs.front().get(), std::vector<c10::IValue>{t0});
+  FusionExecutorCache::compileFusionsBatch(fusions);
+
+  std::unordered_set<CUmodule> modules;
+  for (auto i : c10::irange(fecs.size())) {
+    auto fec = fecs.at(i).get();
+    EXPECT_TRUE(fec->isCompiled({t0}));
+    auto outputs = fec->runFusionWithInputs({t0});
+    EXPECT_EQ(numModules(fec), 1);
+    modules.insert(fec->getMostRecentKernelRuntime()
+                       ->executors()
+                       .front()
+                       .compiledKernel()
+                       .module);
+    testValidate(
+        fec->fusion(),
+        outputs,
+        {t0},
+        {t0 * (double)(1 << (i + 2))},
+        __LINE__,
+        __FILE__);
+  }
+  EXPECT_EQ(modules.size(), 1);
+}
+
+// Kernels of independent executors compiled in one program
+TEST_F(BatchCompileTest, ExecutorBatch) {
+  Fusion fusion0;
+  {
+    FusionGuard fg(&fusion0);
+    auto tv0 = makeContigTensor(1);
+    fusion0.addInput(tv0);
+    fusion0.addOutput(add(tv0, IrBuilder::create<Val>(1.0)));
+  }
+  Fusion fusion1;
+  {
+    FusionGuard fg(&fusion1);
+    auto tv0 = makeContigTensor(1);
+    fusion1.addInput(tv0);
+    fusion1.addOutput(exp(tv0));
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({1024}, options);
+
+  FusionExecutor fe0;
+  FusionExecutor fe1;
+  fe0.setDeferNvrtcCompile(true);
+  fe1.setDeferNvrtcCompile(true);
+  fe0.compileFusion(&fusion0, {t0});
+  fe1.compileFusion(&fusion1, {t0});
+  EXPECT_FALSE(fe0.isCompiled());
+  EXPECT_TRUE(fe0.hasDeferredCompile());
+  EXPECT_EQ(fe0.deferredCompileKey(), fe1.deferredCompileKey());
+
+  FusionExecutor::compileKernelBatch({&fe0, &fe1});
+  ASSERT_TRUE(fe0.isCompiled());
+  ASSERT_TRUE(fe1.isCompiled());
+  EXPECT_EQ(fe0.compiledKernel().module, fe1.compiledKernel().module);
+  EXPECT_NE(fe0.compiledKernel().function, fe1.compiledKernel().function);
+
+  auto outputs0 = fe0.runFusion({t0});
+  auto outputs1 = fe1.runFusion({t0});
+  testValidate(&fusion0, outputs0, {t0}, {t0 + 1}, __LINE__, __FILE__);
+  testValidate(&fusion1, outputs1, {t0}, {t0.exp()}, __LINE__, __FILE__);
+}
+
+} // namespace nvfuser
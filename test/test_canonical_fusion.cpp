@@ -0,0 +1,163 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <canonical_fusion.h>
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+
+#include <test/utils.h>
+#include <test/validator.h>
+
+#include <torch/torch.h>
+
+namespace nvfuser {
+
+class CanonicalFusionTest : public NVFuserTest {};
+
+namespace {
+
+// tv0 * 2 + tv1 and tv0 * 2 - tv1, with the two outputs defined in either
+// order
+std::unique_ptr<Fusion> twoOutputs(bool add_first) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+
+  TensorView* sum = nullptr;
+  TensorView* difference = nullptr;
+  if (add_first) {
+    sum = add(mul(tv0, IrBuilder::create<Val>(2.0)), tv1);
+    difference = sub(mul(tv0, IrBuilder::create<Val>(2.0)), tv1);
+  } else {
+    difference = sub(mul(tv0, IrBuilder::create<Val>(2.0)), tv1);
+    sum = add(mul(tv0, IrBuilder::create<Val>(2.0)), tv1);
+  }
+  fusion->addOutput(sum);
+  fusion->addOutput(difference);
+  return fusion;
+}
+
+// tv0 * factor
+std::unique_ptr<Fusion> scale(double factor, bool contiguous = true) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = contiguous ? makeContigTensor(1) : makeSymbolicTensor(1);
+  fusion->addInput(tv0);
+  fusion->addOutput(mul(tv0, IrBuilder::create<Val>(factor)));
+  return fusion;
+}
+
+} // namespace
+
+TEST_F(CanonicalFusionTest, OpOrder) {
+  auto fusion0 = twoOutputs(true);
+  auto fusion1 = twoOutputs(false);
+  CanonicalFusion canonical0(fusion0.get());
+  CanonicalFusion canonical1(fusion1.get());
+  EXPECT_EQ(canonical0.hash(), canonical1.hash());
+  EXPECT_EQ(canonical0, canonical1) << canonical0.toString() << "\n"
+                                    << canonical1.toString();
+  // The names of the Vals differ
+  EXPECT_NE(fusion0->outputs().at(0)->name(), fusion1->outputs().at(0)->name());
+}
+
+TEST_F(CanonicalFusionTest, Constants) {
+  auto fusion = scale(2.0);
+  CanonicalFusion canonical(fusion.get());
+  EXPECT_EQ(canonical, CanonicalFusion(scale(2.0).get()));
+  EXPECT_NE(canonical, CanonicalFusion(scale(2.0000001).get()));
+  EXPECT_NE(
+      CanonicalFusion(scale(0.0).get()), CanonicalFusion(scale(-0.0).get()));
+}
+
+TEST_F(CanonicalFusionTest, Differences) {
+  auto fusion = twoOutputs(true);
+  CanonicalFusion canonical(fusion.get());
+
+  // Inputs are positional
+  {
+    Fusion swapped;
+    FusionGuard fg(&swapped);
+    auto tv0 = makeContigTensor(2);
+    auto tv1 = makeContigTensor(2);
+    swapped.addInput(tv1);
+    swapped.addInput(tv0);
+    swapped.addOutput(add(mul(tv0, IrBuilder::create<Val>(2.0)), tv1));
+    swapped.addOutput(sub(mul(tv0, IrBuilder::create<Val>(2.0)), tv1));
+    EXPECT_NE(canonical, CanonicalFusion(&swapped));
+  }
+
+  // So are outputs
+  {
+    auto reordered = twoOutputs(true);
+    auto sum = reordered->outputs().at(0);
+    reordered->removeOutput(sum);
+    reordered->addOutput(sum);
+    EXPECT_NE(canonical, CanonicalFusion(reordered.get()));
+  }
+
+  EXPECT_NE(
+      CanonicalFusion(scale(2.0).get()),
+      CanonicalFusion(scale(2.0, false).get()));
+}
+
+TEST_F(CanonicalFusionTest, Reshape) {
+  auto reshapeFusion = [](const std::vector<int64_t>& new_shape) {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    auto tv0 = makeContigConcreteTensor({4, 6});
+    fusion->addInput(tv0);
+    fusion->addOutput(reshape(tv0, {4, 6}, new_shape));
+    return fusion;
+  };
+  CanonicalFusion canonical(reshapeFusion({2, 12}).get());
+  EXPECT_EQ(canonical, CanonicalFusion(reshapeFusion({2, 12}).get()));
+  EXPECT_NE(canonical, CanonicalFusion(reshapeFusion({12, 2}).get()));
+}
+
+// Equal fusions defined separately share one FusionExecutorCache
+TEST_F(CanonicalFusionTest, Registry_CUDA) {
+  auto& registry = FusionExecutorCacheRegistry::get();
+  const auto hits = registry.hits();
+
+  auto fec0 = registry.getOrCreate(twoOutputs(true));
+  auto fec1 = registry.getOrCreate(twoOutputs(false));
+  auto fec2 = registry.getOrCreate(scale(2.0));
+  EXPECT_EQ(fec0, fec1);
+  EXPECT_NE(fec0, fec2);
+  EXPECT_EQ(registry.hits(), hits + 1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({8, 32}, options);
+  auto t1 = at::randn({8, 32}, options);
+  auto outputs = fec0->runFusionWithInputs({t0, t1});
+  EXPECT_TRUE(fec1->isCompiled({t0, t1}));
+  testValidate(
+      fec1->fusion(),
+      outputs,
+      {t0, t1},
+      {t0 * 2 + t1, t0 * 2 - t1},
+      __LINE__,
+      __FILE__);
+
+  // The registry doesn't keep the caches alive
+  const auto size = registry.size();
+  fec0.reset();
+  fec1.reset();
+  EXPECT_EQ(registry.size(), size - 1);
+}
+
+} // namespace nvfuser
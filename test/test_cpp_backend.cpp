@@ -0,0 +1,263 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <executor.h>
+#include <expr_evaluator.h>
+#include <fusion.h>
+#include <inlining.h>
+#include <ir/all_nodes.h>
+#include <kernel_db/cpp_kernel_db.h>
+#include <ops/all_ops.h>
+#include <scheduler/utils.h>
+#include <transform_replay.h>
+
+#include <test/utils.h>
+#include <test/validator.h>
+
+#include <torch/torch.h>
+
+namespace nvfuser {
+
+// The C++ backend still lowers with GpuLower, which queries the CUDA
+// device, so these tests use the NVFuserTest fixture like the others
+class CppBackendTest : public NVFuserTest {
+ protected:
+  void SetUp() override {
+    NVFuserTest::SetUp();
+    EnableOptionsGuard::getCurOptions().set(EnableOption::CppBackend);
+  }
+
+ private:
+  EnableOptionsGuard enable_guard_;
+};
+
+namespace {
+
+at::TensorOptions cpuOptions(at::ScalarType dtype = at::kFloat) {
+  return at::TensorOptions().dtype(dtype).device(at::kCPU);
+}
+
+// Evaluate the outputs of the fusion with ATen on the host
+std::vector<at::Tensor> evaluateOnHost(
+    Fusion* fusion,
+    const std::vector<c10::IValue>& inputs) {
+  ExpressionEvaluator ee;
+  for (auto i : c10::irange(inputs.size())) {
+    ee.bind(fusion->inputs().at(i), inputs.at(i).toTensor());
+  }
+  std::vector<at::Tensor> outputs;
+  for (auto out : fusion->outputs()) {
+    outputs.push_back(ee.evaluate(out).as<at::Tensor>());
+  }
+  return outputs;
+}
+
+} // namespace
+
+TEST_F(CppBackendTest, Pointwise) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  auto tv1 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = add(tv0, mul(tv1, IrBuilder::create<Val>(2.0)));
+  auto tv3 = where(gt(tv2, IrBuilder::create<Val>(0.0)), sin(tv2), neg(tv2));
+  fusion.addOutput(tv3);
+  inlineMost();
+
+  auto t0 = at::randn({13, 17}, cpuOptions());
+  auto t1 = at::randn({13, 17}, cpuOptions());
+  std::vector<c10::IValue> inputs = {t0, t1};
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, inputs);
+  EXPECT_TRUE(fe.isCompiledForCpu());
+  auto cg_outputs = fe.runFusion(inputs);
+
+  ASSERT_EQ(cg_outputs.size(), 1);
+  EXPECT_TRUE(cg_outputs.at(0).is_cpu());
+  auto ref = evaluateOnHost(&fusion, inputs);
+  EXPECT_TRUE(at::allclose(cg_outputs.at(0), ref.at(0)));
+}
+
+// Blocks and threads are simulated by the loops of the generated kernel
+TEST_F(CppBackendTest, ParallelPointwise) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = exp(tv0);
+  auto tv2 = add(tv1, IrBuilder::create<Val>(1.0));
+  fusion.addOutput(tv2);
+
+  tv2->merge(0);
+  tv2->split(0, 128);
+  TransformPropagatorWithCheck propagator(tv2);
+  MaxRootDomainInfoSpanningTree(tv2).traverse(&propagator);
+  tv2->axis(0)->parallelize(ParallelType::BIDx);
+  tv2->axis(1)->parallelize(ParallelType::TIDx);
+  scheduler_utils::parallelizeAllLike(tv2);
+  inlineMost();
+
+  // Not divisible by the block size
+  auto t0 = at::randn({31, 67}, cpuOptions());
+  std::vector<c10::IValue> inputs = {t0};
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, inputs);
+  auto cg_outputs = fe.runFusion(inputs);
+
+  EXPECT_EQ(fe.lastLaunchParams().gdimx(), ceilDiv(31 * 67, 128));
+  EXPECT_EQ(fe.lastLaunchParams().bdimx(), 128);
+  auto ref = evaluateOnHost(&fusion, inputs);
+  EXPECT_TRUE(at::allclose(cg_outputs.at(0), ref.at(0)));
+}
+
+// Serial reductions and dynamically sized intermediates are supported
+TEST_F(CppBackendTest, SerialReduction) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2, DataType::Double);
+  fusion.addInput(tv0);
+  auto tv1 = mul(tv0, tv0);
+  auto tv2 = sum(tv1, {1});
+  fusion.addOutput(tv2);
+
+  auto t0 = at::randn({7, 129}, cpuOptions(at::kDouble));
+  std::vector<c10::IValue> inputs = {t0};
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, inputs);
+  auto cg_outputs = fe.runFusion(inputs);
+
+  auto ref = evaluateOnHost(&fusion, inputs);
+  EXPECT_TRUE(at::allclose(cg_outputs.at(0), ref.at(0)));
+}
+
+TEST_F(CppBackendTest, Broadcast) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(1);
+  auto tv1 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = broadcast(tv0, {false, true});
+  auto tv3 = sub(tv1, tv2);
+  fusion.addOutput(tv3);
+  inlineMost();
+
+  auto t0 = at::randn({9}, cpuOptions());
+  auto t1 = at::randn({9, 33}, cpuOptions());
+  std::vector<c10::IValue> inputs = {t0, t1};
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, inputs);
+  auto cg_outputs = fe.runFusion(inputs);
+
+  auto ref = evaluateOnHost(&fusion, inputs);
+  EXPECT_TRUE(at::allclose(cg_outputs.at(0), ref.at(0)));
+}
+
+// Without the option, CPU tensors don't select the C++ backend
+TEST_F(CppBackendTest, RequiresOption) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sin(tv0);
+  fusion.addOutput(tv1);
+
+  auto t0 = at::randn({13, 17}, cpuOptions());
+  std::vector<c10::IValue> inputs = {t0};
+
+  EnableOptionsGuard::getCurOptions().unset(EnableOption::CppBackend);
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, inputs);
+  EXPECT_FALSE(fe.isCompiledForCpu());
+}
+
+// Reductions across threads need communication and are rejected
+TEST_F(CppBackendTest, RejectBlockReduction) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion.addOutput(tv1);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+
+  auto t0 = at::randn({4, 32}, cpuOptions());
+  std::vector<c10::IValue> inputs = {t0};
+
+  FusionExecutor fe;
+  EXPECT_THAT(
+      [&]() { fe.compileFusion(&fusion, inputs); },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("does not support parallel reductions")));
+}
+
+// Libraries are looked up by the kernel code and restored when the db
+// is reopened
+TEST_F(CppBackendTest, KernelDb) {
+  const std::string db_dir = "nvfuser_cpp_kernel_db_test";
+  fs::path db_path = CppKernelDb::cacheDirectory() / db_dir;
+  if (fs::is_directory(db_path)) {
+    fs::remove_all(db_path);
+  }
+  auto& db = CppKernelDb::get(db_dir, true, true);
+  ASSERT_TRUE(db.enabled());
+  EXPECT_EQ(db.size(), 0);
+
+  const std::string code = R"(
+extern "C" void add_one(void** args, const long* launch_dims) {
+  *reinterpret_cast<long*>(args[0]) += 1;
+}
+)";
+  auto library = db.getLibrary(code);
+  EXPECT_EQ(db.numCompilations(), 1);
+  EXPECT_EQ(db.getLibrary(code), library);
+  EXPECT_EQ(db.numCompilations(), 1);
+  EXPECT_EQ(db.size(), 1);
+
+  auto& reopened_db = CppKernelDb::get(db_dir, true, true);
+  EXPECT_EQ(reopened_db.size(), 1);
+  EXPECT_EQ(reopened_db.getLibrary(code), library);
+  EXPECT_EQ(reopened_db.numCompilations(), 0);
+
+  EXPECT_THAT(
+      [&]() { reopened_db.getLibrary("this is not C++"); },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("C++ kernel compilation failed")));
+
+  // Libraries others can modify are not loaded
+  fs::permissions(library, fs::perms::group_write, fs::perm_options::add);
+  auto& untrusted_db = CppKernelDb::get(db_dir, true, true);
+  EXPECT_EQ(untrusted_db.size(), 0);
+  EXPECT_NE(untrusted_db.getLibrary(code), "");
+  EXPECT_EQ(untrusted_db.numCompilations(), 1);
+
+  // Neither is a directory others can access
+  fs::permissions(db_path, fs::perms::group_read, fs::perm_options::add);
+  EXPECT_FALSE(CppKernelDb::get(db_dir, true, true).enabled());
+
+  fs::remove_all(db_path);
+  // Restore the default db for the other tests
+  CppKernelDb::get("nvfuser_cpp_kernel_db", true, true);
+}
+
+} // namespace nvfuser
@@ -9168,6 +9168,13 @@ TEST_F(NVFuserTest, FusionPersistentBufferCalculation1_CUDA) {
   NVF_ERROR(
       persistent_buffer_size.projected_persistent_buffer_size ==
       static_cast<int64_t>(aten_t0.size(1) * dataTypeSize(DataType::Float)));
+  // In shared memory, the buffer takes its size aligned to 16 bytes
+  const auto smem_size = static_cast<int64_t>(
+      ceilDiv(aten_t0.size(1) * dataTypeSize(DataType::Float), 16) * 16);
+  NVF_ERROR(persistent_buffer_size.persistent_buffer_smem_size == smem_size);
+  NVF_ERROR(
+      persistent_buffer_size.projected_persistent_buffer_smem_size ==
+      smem_size);
 }
 
 TEST_F(NVFuserTest, FusionPersistentBufferCalculation2_CUDA) {
@@ -9623,6 +9623,285 @@ TEST_F(NVFuserTest, ConstLongExpressions) {
   testValidate(fusion, outputs, {}, {t0}, __LINE__, __FILE__);
 }
 
+// Test that allocOutputSpace returns outputs of the right shapes without
+// compiling nor running the fusion
+TEST_F(NVFuserTest, FusionExecutorCacheAllocOutputSpace_CUDA) {
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  Fusion* fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = castOp(DataType::Half, broadcast(tv1, {false, true}));
+  fusion->addOutput(tv1);
+  fusion->addOutput(tv2);
+  fusion->addOutput(tv0);
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({7, 13}, options);
+  auto outputs = fec.allocOutputSpace({t0});
+
+  EXPECT_EQ(fec.getMostRecentKernelRuntime(), nullptr);
+  ASSERT_EQ(outputs.size(), 3);
+  EXPECT_EQ(outputs[0].sizes(), at::IntArrayRef({7}));
+  EXPECT_EQ(outputs[0].scalar_type(), at::kFloat);
+  EXPECT_EQ(outputs[1].sizes(), at::IntArrayRef({7, 1}));
+  EXPECT_EQ(outputs[1].scalar_type(), at::kHalf);
+  EXPECT_TRUE(outputs[1].is_cuda());
+  // inputs forwarded as outputs are returned as is
+  EXPECT_TRUE(outputs[2].is_same(t0));
+}
+
+// Statements are allocated from the arena of their container. Check that
+// membership is tracked through removal, move and copy.
+TEST_F(NVFuserTest, FusionIrContainerArena_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  auto tv2 = mul(tv1, tv1);
+  fusion->addOutput(tv2);
+
+  // Removed statements are destroyed, but the container can still be asked
+  // about their dangling pointers
+  Val* unused = IrBuilder::create<Val>(2.0);
+  EXPECT_TRUE(fusion->inContainer(unused));
+  fusion->removeVal(unused);
+  EXPECT_FALSE(fusion->inContainer(unused));
+
+  Fusion other;
+  EXPECT_FALSE(other.inContainer(tv1));
+
+  // Moving keeps the statements in place
+  Fusion moved = std::move(*fusion);
+  EXPECT_TRUE(moved.inContainer(tv1));
+  EXPECT_FALSE(fusion->inContainer(tv1));
+  EXPECT_EQ(tv1->container(), &moved);
+  FusionGuard moved_fg(&moved);
+  fusion.reset();
+  EXPECT_TRUE(moved.inContainer(tv2));
+
+  // Copies are made in insertion order
+  Fusion copy = moved;
+  auto vals = moved.deterministic_vals();
+  auto copied_vals = copy.deterministic_vals();
+  ASSERT_EQ(vals.size(), copied_vals.size());
+  for (auto i : c10::irange(vals.size())) {
+    EXPECT_FALSE(copy.inContainer(vals.at(i)));
+    EXPECT_TRUE(copy.inContainer(copied_vals.at(i)));
+    EXPECT_EQ(vals.at(i)->name(), copied_vals.at(i)->name());
+    EXPECT_EQ(vals.at(i)->vtype(), copied_vals.at(i)->vtype());
+  }
+}
+
+// exprs() and usedMathVals() are cached until the fusion is mutated
+TEST_F(NVFuserTest, FusionCachedTraversals_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  auto tv2 = sin(tv1);
+  fusion.addOutput(tv2);
+
+  auto version = fusion.version();
+  auto exprs = fusion.exprs();
+  EXPECT_EQ(exprs, fusion.exprs());
+  EXPECT_EQ(exprs, StmtSort::getExprs(&fusion));
+  EXPECT_EQ(fusion.usedMathVals(), fusion.usedMathVals());
+  EXPECT_EQ(version, fusion.version());
+
+  // Registering an expression invalidates the cache
+  auto tv3 = cos(tv2);
+  EXPECT_GT(fusion.version(), version);
+  EXPECT_EQ(fusion.exprs().size(), 2);
+
+  fusion.replaceOutput(tv2, tv3);
+  EXPECT_EQ(fusion.exprs().size(), 3);
+  EXPECT_EQ(fusion.exprs().back(), tv3->definition());
+  EXPECT_THAT(fusion.usedMathVals(), testing::Contains(tv3));
+
+  // So does removing one
+  fusion.replaceOutput(tv3, tv1);
+  fusion.removeExpr(tv3->definition());
+  EXPECT_EQ(fusion.exprs(), std::vector<Expr*>{tv1->definition()});
+  EXPECT_THAT(fusion.usedMathVals(), testing::Not(testing::Contains(tv2)));
+
+  // Copies don't share the cache of the original
+  Fusion copy = fusion;
+  auto copied_exprs = copy.exprs();
+  ASSERT_EQ(copied_exprs.size(), 1);
+  EXPECT_TRUE(copy.inContainer(copied_exprs.at(0)));
+}
+
+// The traversals of DependencyCheck are cached until the fusion is mutated
+TEST_F(NVFuserTest, FusionCachedDependencies_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  auto tv2 = sin(tv1);
+  auto tv3 = cos(tv0);
+  fusion.addOutput(tv2);
+  fusion.addOutput(tv1);
+
+  EXPECT_TRUE(DependencyCheck::isDependencyOf(tv0, tv2));
+  EXPECT_FALSE(DependencyCheck::isDependencyOf(tv3, tv2));
+  EXPECT_EQ(
+      DependencyCheck::getAllExprsBetween({tv1}, {tv2}),
+      std::vector<Expr*>{tv2->definition()});
+  EXPECT_EQ(
+      DependencyCheck::getAllValsBetween({tv0}, {tv2}),
+      (std::vector<Val*>{tv0, tv1, tv2}));
+  EXPECT_EQ(fusion.getTerminatingOutputs(), std::vector<Val*>{tv2});
+  ASSERT_NE(fusion.dependencyCache(), nullptr);
+  EXPECT_EQ(fusion.dependencyCache()->between.size(), 2);
+
+  // Registering an expression empties the cache
+  auto tv4 = add(tv2, tv3);
+  EXPECT_TRUE(fusion.dependencyCache()->between.empty());
+  EXPECT_TRUE(DependencyCheck::isDependencyOf(tv3, tv4));
+  EXPECT_EQ(DependencyCheck::getAllExprsBetween({tv0}, {tv4}).size(), 4);
+
+  // So do changes of the outputs
+  fusion.removeOutput(tv2);
+  EXPECT_EQ(fusion.getTerminatingOutputs(), std::vector<Val*>{tv1});
+  fusion.addOutput(tv4);
+  EXPECT_EQ(fusion.getTerminatingOutputs(), std::vector<Val*>{tv4});
+}
+
+// A fusion made only of metadata ops is evaluated with ATen, which also works
+// for CPU tensors
+TEST_F(NVFuserTest, FusionExprEvalSegmentCpu_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = reshape(tv0, {8, 6}, {4, 12});
+  auto tv2 = permute(tv1, {1, 0});
+  auto tv3 = slice(
+      tv2,
+      {{IrBuilder::create<Val>(2L), IrBuilder::create<Val>(10L)},
+       {IrBuilder::create<Val>(1L), IrBuilder::create<Val>(3L)}});
+  fusion.addOutput(tv3);
+
+  EXPECT_FALSE(ExprEvalScheduler::canScheduleCompileTime(&fusion));
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ExprEvalSegments);
+  EXPECT_TRUE(ExprEvalScheduler::canScheduleCompileTime(&fusion));
+
+  auto t0 = at::randn({8, 6}, at::TensorOptions().dtype(at::kFloat));
+  KernelArgumentHolder args;
+  args.push(std::vector<at::Tensor>{t0});
+  auto outputs = evaluateFusionOutputs(&fusion, args);
+
+  auto ref = t0.reshape({4, 12}).permute({1, 0}).slice(0, 2, 10).slice(1, 1, 3);
+  ASSERT_EQ(outputs.size(), 1);
+  EXPECT_TRUE(outputs.at(0).is_cpu());
+  EXPECT_TRUE(outputs.at(0).equal(ref));
+  // Metadata ops produce an alias of the input
+  EXPECT_EQ(outputs.at(0).storage().data(), t0.storage().data());
+
+  // Pointwise math is left to the code generator
+  auto tv4 = add(tv3, IrBuilder::create<Val>(1.0));
+  fusion.addOutput(tv4);
+  EXPECT_FALSE(ExprEvalScheduler::canScheduleCompileTime(&fusion));
+}
+
+TEST_F(NVFuserTest, FusionExprEvalSegment_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(1, DataType::Int);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = index_select(tv0, 0, tv1);
+  auto tv3 = permute(tv2, {1, 0});
+  auto tv4 = broadcast(tv3, {false, false, true});
+  fusion.addOutput(tv3);
+  fusion.addOutput(tv4);
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ExprEvalSegments);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto options_i = at::TensorOptions().dtype(at::kLong).device(at::kCUDA, 0);
+  auto t0 = at::randn({32, 64}, options);
+  auto t1 = at::randint(0, 32, {16}, options_i);
+  std::vector<c10::IValue> aten_inputs = {t0, t1};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  EXPECT_EQ(
+      runtime->schedulerHeuristics()->heuristicsList().at(0)->heuristic(),
+      ScheduleHeuristic::ExprEval);
+  // Nothing was compiled
+  EXPECT_FALSE(runtime->executors().at(0).isCompiled());
+  EXPECT_TRUE(executor_cache.isCompiled(aten_inputs));
+
+  auto t2 = at::index_select(t0, 0, t1);
+  testValidate(
+      executor_cache.fusion(),
+      outputs,
+      aten_inputs,
+      {t2.permute({1, 0}), t2.permute({1, 0}).unsqueeze(-1)},
+      __LINE__,
+      __FILE__);
+}
+
+// Reductions are left to the Reduction scheduler when it accepts them
+TEST_F(NVFuserTest, FusionExprEvalSegmentReduction_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = permute(tv0, {1, 0});
+  auto tv2 = sum(tv1, {1});
+  fusion.addOutput(tv2);
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ExprEvalSegments);
+  EXPECT_TRUE(ExprEvalScheduler::canScheduleCompileTime(&fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({32, 64}, options);
+  std::vector<c10::IValue> aten_inputs = {t0};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  EXPECT_EQ(
+      runtime->schedulerHeuristics()->heuristicsList().at(0)->heuristic(),
+      ScheduleHeuristic::Reduction);
+
+  testValidate(
+      executor_cache.fusion(),
+      outputs,
+      aten_inputs,
+      {t0.sum({0})},
+      __LINE__,
+      __FILE__);
+}
+
 // Test file size should be up to 10K LoC. Create a new file for more tests.
 
 } // namespace nvfuser
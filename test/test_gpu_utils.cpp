@@ -10,6 +10,7 @@
 #include <gtest/gtest.h>
 
 #include <device_lower/utils.h>
+#include <executor_kernel_arg.h>
 #include <executor_utils.h>
 #include <fusion.h>
 #include <ops/all_ops.h>
@@ -1080,4 +1081,35 @@ TEST_F(NVFuserTest, FusionSASSDumpError_CUDA) {
   testValidate(fe.kernel(), cg_outputs, {t0}, {t0}, __LINE__, __FILE__);
 }
 
+// Arguments keep their addresses until erased, also when the holder is
+// moved, and the slots of erased arguments are reused
+TEST_F(NVFuserTest, KernelArgumentHolderSlots) {
+  KernelArgumentHolder args;
+  std::vector<const PolymorphicValue*> addresses;
+  for (auto i : c10::irange(40)) {
+    args.push(PolymorphicValue((int64_t)i));
+    addresses.push_back(args.back());
+  }
+  for (auto i : c10::irange(40)) {
+    EXPECT_EQ(args[i], addresses.at(i));
+  }
+
+  args.erase(addresses.at(3));
+  EXPECT_EQ(args.size(), 39);
+  EXPECT_EQ(args[3]->as<int64_t>(), 4);
+  args.push(at::randn({2, 3}));
+  EXPECT_EQ(args.back(), addresses.at(3));
+
+  KernelArgumentHolder moved_args(std::move(args));
+  EXPECT_EQ(moved_args.size(), 40);
+  EXPECT_EQ(moved_args[0], addresses.at(0));
+  EXPECT_TRUE(moved_args.back()->is<at::Tensor>());
+
+  // Copies don't share the arguments
+  KernelArgumentHolder copied_args = moved_args;
+  EXPECT_EQ(copied_args.size(), 40);
+  EXPECT_NE(copied_args[0], moved_args[0]);
+  EXPECT_EQ(copied_args[38]->as<int64_t>(), 39);
+}
+
 } // namespace nvfuser
@@ -0,0 +1,152 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <gtest/gtest.h>
+
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+#include <options.h>
+
+#include <test/utils.h>
+#include <test/validator.h>
+
+#include <torch/torch.h>
+
+namespace nvfuser {
+
+class LaunchPlanTest : public NVFuserTest {
+ protected:
+  void SetUp() override {
+    NVFuserTest::SetUp();
+    EnableOptionsGuard::getCurOptions().set(EnableOption::LaunchPlan);
+  }
+
+ private:
+  EnableOptionsGuard opt_guard_;
+};
+
+TEST_F(LaunchPlanTest, Replay) {
+  auto fec = makeSegmentChain(3);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  // The first run records the plan, the others replay it
+  std::vector<at::Tensor> outputs;
+  std::vector<at::Tensor> inputs;
+  for (auto i : c10::irange(3)) {
+    (void)i;
+    inputs.push_back(at::randn({5, 33}, options));
+    outputs.push_back(fec->runFusionWithInputs({inputs.back()}).at(0));
+  }
+
+  auto runtime = fec->getMostRecentKernelRuntime();
+  EXPECT_TRUE(runtime->isSegmented());
+  EXPECT_EQ(runtime->fusionSegments()->groups().size(), 3);
+  EXPECT_EQ(runtime->numLaunchPlans(), 1);
+
+  // Each run allocates its own outputs
+  for (auto i : c10::irange(inputs.size())) {
+    EXPECT_TRUE(at::allclose(outputs.at(i), inputs.at(i) * 8));
+  }
+}
+
+TEST_F(LaunchPlanTest, NewShapeRecordsNewPlan) {
+  auto fec = makeSegmentChain(2);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  auto t0 = at::randn({5, 33}, options);
+  auto t1 = at::randn({7, 65}, options);
+  for (auto i : c10::irange(2)) {
+    (void)i;
+    auto out0 = fec->runFusionWithInputs({t0}).at(0);
+    EXPECT_TRUE(at::allclose(out0, t0 * 4));
+    auto out1 = fec->runFusionWithInputs({t1}).at(0);
+    EXPECT_TRUE(at::allclose(out1, t1 * 4));
+  }
+  EXPECT_EQ(fec->getMostRecentKernelRuntime()->numLaunchPlans(), 2);
+}
+
+// Scalar inputs are patched into the recorded arguments
+TEST_F(LaunchPlanTest, ScalarInput) {
+  auto fec = makeSegmentChain(2, /*with_scalar=*/true);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  auto t0 = at::randn({5, 33}, options);
+  auto out = fec->runFusionWithInputs({t0, 2.0}).at(0);
+  EXPECT_TRUE(at::allclose(out, t0 * 4));
+  out = fec->runFusionWithInputs({t0, 3.0}).at(0);
+  EXPECT_TRUE(at::allclose(out, t0 * 9));
+  out = fec->runFusionWithInputs({t0, -1.0}).at(0);
+  EXPECT_TRUE(at::allclose(out, t0));
+  EXPECT_EQ(fec->getMostRecentKernelRuntime()->numLaunchPlans(), 1);
+}
+
+// Intermediate buffers, e.g., of grid reductions, are allocated for each
+// launch
+TEST_F(LaunchPlanTest, Reduction) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion_ptr->addInput(tv0);
+  auto tv1 = sum(tv0, {0});
+  auto tv2 = segment_set(tv1);
+  auto tv3 = add(tv2, IrBuilder::create<Val>(1.0));
+  fusion_ptr->addOutput(tv3);
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (auto i : c10::irange(3)) {
+    (void)i;
+    auto t0 = at::randn({16384, 64}, options);
+    auto outputs = fec.runFusionWithInputs({t0});
+    testValidate(
+        fec.fusion(), outputs, {t0}, {t0.sum({0}) + 1}, __LINE__, __FILE__);
+  }
+  EXPECT_EQ(fec.getMostRecentKernelRuntime()->numLaunchPlans(), 1);
+}
+
+// Random numbers take a new philox offset for each run, so their launches
+// are not replayed
+TEST_F(LaunchPlanTest, RandomNumbers) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion_ptr->addInput(tv0);
+  auto tv1 = segment_set(mul(tv0, IrBuilder::create<Val>(2.0)));
+  auto tv2 = add(tv1, rand_like(tv1));
+  fusion_ptr->addOutput(tv2);
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::zeros({5, 33}, options);
+  auto out0 = fec.runFusionWithInputs({t0}).at(0);
+  auto out1 = fec.runFusionWithInputs({t0}).at(0);
+
+  EXPECT_TRUE(fec.getMostRecentKernelRuntime()->isSegmented());
+  EXPECT_EQ(fec.getMostRecentKernelRuntime()->numLaunchPlans(), 0);
+  EXPECT_FALSE(at::equal(out0, out1));
+}
+
+TEST_F(LaunchPlanTest, DisabledByDefault) {
+  EnableOptionsGuard::getCurOptions().unset(EnableOption::LaunchPlan);
+  auto fec = makeSegmentChain(2);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  auto t0 = at::randn({5, 33}, options);
+  for (auto i : c10::irange(2)) {
+    (void)i;
+    auto out = fec->runFusionWithInputs({t0}).at(0);
+    EXPECT_TRUE(at::allclose(out, t0 * 4));
+  }
+  EXPECT_EQ(fec->getMostRecentKernelRuntime()->numLaunchPlans(), 0);
+}
+
+} // namespace nvfuser
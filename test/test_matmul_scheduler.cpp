@@ -12,6 +12,7 @@
 #include <mma_type.h>
 #include <ops/all_ops.h>
 #include <scheduler/all_schedulers.h>
+#include <scheduler/matmul_utils.h>
 #include <scheduler/mma_utils.h>
 #include <test/utils.h>
 #include <test/validator.h>
@@ -1365,6 +1366,43 @@ TEST_F(MatmulSchedulerTest, StridedBatchEpilogueSingleBias_CUDA) {
   }
 }
 
+// Split-K decisions don't depend on the current device and can be checked for
+// any SM count
+TEST_F(MatmulSchedulerTest, SplitKFactor) {
+  const GemmTile cta_tile(128, 128, 32);
+  constexpr int64_t num_sms = 108;
+  constexpr int64_t min_k_iterations = 3;
+
+  // Enough output tiles to fill the device
+  EXPECT_EQ(
+      getMatmulSplitKFactor(
+          2048, 2048, 4096, cta_tile, num_sms, min_k_iterations),
+      1);
+  // Not enough work along K to amortize the reduction of the partial tiles
+  EXPECT_EQ(
+      getMatmulSplitKFactor(128, 256, 512, cta_tile, num_sms, min_k_iterations),
+      1);
+
+  // Skinny problems with a large K are split, without exceeding a wave
+  for (int64_t n : {128, 1024, 4096}) {
+    const int64_t num_tiles = ceilDiv(n, cta_tile.n);
+    const int64_t factor = getMatmulSplitKFactor(
+        16, n, 8192, cta_tile, num_sms, min_k_iterations);
+    EXPECT_GT(factor, 1) << "N = " << n;
+    EXPECT_LE(num_tiles * factor, num_sms) << "N = " << n;
+  }
+
+  // More SMs allow more splits
+  EXPECT_LE(
+      getMatmulSplitKFactor(16, 1024, 8192, cta_tile, 40, min_k_iterations),
+      getMatmulSplitKFactor(16, 1024, 8192, cta_tile, 132, min_k_iterations));
+
+  // Each split keeps at least min_k_iterations iterations
+  const int64_t factor =
+      getMatmulSplitKFactor(16, 128, 1024, cta_tile, num_sms, 8);
+  EXPECT_GE(ceilDiv(ceilDiv(1024, cta_tile.k), factor), 8);
+}
+
 #undef NVFUSER_TEST_CUDA_ARCH_GUARD
 
 } // namespace nvfuser
@@ -0,0 +1,234 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <kernel_cache.h>
+#include <memory_planner.h>
+#include <ops/all_ops.h>
+#include <options.h>
+
+#include <test/utils.h>
+#include <test/validator.h>
+
+#include <torch/torch.h>
+
+#include <random>
+
+namespace nvfuser {
+
+class MemoryPlanTest : public NVFuserTest {
+ protected:
+  void SetUp() override {
+    NVFuserTest::SetUp();
+    EnableOptionsGuard::getCurOptions().set(EnableOption::MemoryPlan);
+  }
+
+ private:
+  EnableOptionsGuard opt_guard_;
+};
+
+namespace {
+
+// Buffers i and j overlap both in time and in the workspace
+bool conflict(
+    const std::vector<BufferLifetime>& buffers,
+    const WorkspaceLayout& layout,
+    size_t i,
+    size_t j,
+    int64_t alignment) {
+  const auto& a = buffers.at(i);
+  const auto& b = buffers.at(j);
+  if (a.size == 0 || b.size == 0) {
+    return false;
+  }
+  const bool overlap_in_time =
+      a.first_step <= b.last_step && b.first_step <= a.last_step;
+  const auto a_end =
+      layout.offsets.at(i) + ceilDiv(a.size, alignment) * alignment;
+  const auto b_end =
+      layout.offsets.at(j) + ceilDiv(b.size, alignment) * alignment;
+  const bool overlap_in_memory =
+      layout.offsets.at(i) < b_end && layout.offsets.at(j) < a_end;
+  return overlap_in_time && overlap_in_memory;
+}
+
+// The first input signature of a FusionExecutorCache has id 1
+constexpr size_t kFirstInputId = 1;
+
+} // namespace
+
+// Each tensor of a chain is only live while it's produced and consumed,
+// so two buffers are enough
+TEST_F(MemoryPlanTest, PlanChain) {
+  std::vector<BufferLifetime> buffers;
+  for (auto step : c10::irange(6)) {
+    buffers.push_back({1000, step, step + 1});
+  }
+
+  auto layout = planWorkspace(buffers, 256);
+  EXPECT_EQ(layout.size, 2048);
+  EXPECT_EQ(layout.size, peakLiveBytes(buffers, 256));
+  for (auto i : c10::irange(buffers.size())) {
+    EXPECT_EQ(layout.offsets.at(i), (int64_t)(i % 2) * 1024);
+  }
+}
+
+// The last buffer fits in the gap left between two buffers live at the
+// same time, instead of growing the workspace
+TEST_F(MemoryPlanTest, PlanBestFit) {
+  std::vector<BufferLifetime> buffers = {
+      {4096, 0, 1}, {3072, 2, 3}, {2048, 0, 5}, {1024, 2, 5}};
+
+  auto layout = planWorkspace(buffers, 256);
+  EXPECT_EQ(layout.size, 6144);
+  EXPECT_EQ(layout.size, peakLiveBytes(buffers, 256));
+  EXPECT_EQ(layout.offsets.at(0), 0);
+  EXPECT_EQ(layout.offsets.at(1), 0);
+  EXPECT_EQ(layout.offsets.at(2), 4096);
+  EXPECT_EQ(layout.offsets.at(3), 3072);
+}
+
+TEST_F(MemoryPlanTest, PlanRandomLifetimes) {
+  std::mt19937 generator(0);
+  for (auto trial : c10::irange(200)) {
+    (void)trial;
+    std::vector<BufferLifetime> buffers;
+    const auto num_buffers = (int64_t)(generator() % 32);
+    int64_t total_bytes = 0;
+    for (auto i : c10::irange(num_buffers)) {
+      (void)i;
+      const auto first_step = (int64_t)(generator() % 16);
+      const auto last_step = first_step + (int64_t)(generator() % 4);
+      const auto size = (int64_t)(generator() % 10000);
+      buffers.push_back({size, first_step, last_step});
+      total_bytes += ceilDiv(size, 128) * 128;
+    }
+
+    auto layout = planWorkspace(buffers, 128);
+    ASSERT_EQ(layout.offsets.size(), buffers.size());
+    for (auto i : c10::irange(buffers.size())) {
+      EXPECT_EQ(layout.offsets.at(i) % 128, 0);
+      for (auto j : c10::irange(i)) {
+        EXPECT_FALSE(conflict(buffers, layout, i, j, 128));
+      }
+    }
+    EXPECT_GE(layout.size, peakLiveBytes(buffers, 128));
+    EXPECT_LE(layout.size, total_bytes);
+  }
+}
+
+TEST_F(MemoryPlanTest, PlanInvalidLifetime) {
+  EXPECT_THAT(
+      [&]() { planWorkspace({{64, 2, 1}}); },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("Invalid buffer")));
+  EXPECT_THAT(
+      [&]() { planWorkspace({{64, 0, 1}}, 0); },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("Invalid workspace alignment")));
+}
+
+// The intermediates of a chain of segments share two buffers of the
+// workspace
+TEST_F(MemoryPlanTest, SegmentChain) {
+  auto fec = makeSegmentChain(4);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  std::vector<at::Tensor> inputs;
+  std::vector<at::Tensor> outputs;
+  for (auto i : c10::irange(3)) {
+    (void)i;
+    inputs.push_back(at::randn({128, 33}, options));
+    outputs.push_back(fec->runFusionWithInputs({inputs.back()}).at(0));
+  }
+
+  auto runtime = fec->getMostRecentKernelRuntime();
+  EXPECT_EQ(runtime->fusionSegments()->groups().size(), 4);
+  auto memory_plan = runtime->memoryPlan(kFirstInputId);
+  ASSERT_NE(memory_plan, nullptr);
+  const int64_t tensor_bytes = 128 * 33 * 4;
+  EXPECT_EQ(memory_plan->plannedBytes(), 3 * tensor_bytes);
+  EXPECT_EQ(
+      memory_plan->workspaceSize(), 2 * ceilDiv(tensor_bytes, 256) * 256);
+
+  // Fusion outputs are not placed in the workspace
+  for (auto i : c10::irange(inputs.size())) {
+    EXPECT_TRUE(at::allclose(outputs.at(i), inputs.at(i) * 16));
+  }
+}
+
+TEST_F(MemoryPlanTest, NewShapeRecordsNewPlan) {
+  auto fec = makeSegmentChain(3);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  auto t0 = at::randn({5, 33}, options);
+  auto t1 = at::randn({7, 65}, options);
+  for (auto i : c10::irange(2)) {
+    (void)i;
+    auto out0 = fec->runFusionWithInputs({t0}).at(0);
+    EXPECT_TRUE(at::allclose(out0, t0 * 8));
+    auto out1 = fec->runFusionWithInputs({t1}).at(0);
+    EXPECT_TRUE(at::allclose(out1, t1 * 8));
+  }
+  auto runtime = fec->getMostRecentKernelRuntime();
+  EXPECT_NE(runtime->memoryPlan(kFirstInputId), nullptr);
+  EXPECT_NE(runtime->memoryPlan(kFirstInputId + 1), nullptr);
+}
+
+// Intermediates read by several later segments stay live until their last
+// use
+TEST_F(MemoryPlanTest, LongLivedIntermediate) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion_ptr->addInput(tv0);
+  auto tv1 = segment_set(exp(tv0));
+  auto tv2 = segment_set(mul(tv1, IrBuilder::create<Val>(2.0)));
+  auto tv3 = segment_set(add(tv2, IrBuilder::create<Val>(1.0)));
+  auto tv4 = add(tv3, tv1);
+  fusion_ptr->addOutput(tv4);
+  FusionExecutorCache fec(std::move(fusion_ptr));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({64, 65}, options);
+  for (auto i : c10::irange(2)) {
+    (void)i;
+    auto cg_outputs = fec.runFusionWithInputs({t0});
+    testValidate(
+        fec.fusion(),
+        cg_outputs,
+        {t0},
+        {t0.exp() * 2 + 1 + t0.exp()},
+        __LINE__,
+        __FILE__);
+  }
+  EXPECT_NE(
+      fec.getMostRecentKernelRuntime()->memoryPlan(kFirstInputId), nullptr);
+}
+
+TEST_F(MemoryPlanTest, DisabledByDefault) {
+  EnableOptionsGuard::getCurOptions().unset(EnableOption::MemoryPlan);
+  auto fec = makeSegmentChain(3);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  auto t0 = at::randn({5, 33}, options);
+  for (auto i : c10::irange(2)) {
+    (void)i;
+    auto out = fec->runFusionWithInputs({t0}).at(0);
+    EXPECT_TRUE(at::allclose(out, t0 * 8));
+  }
+  EXPECT_EQ(
+      fec->getMostRecentKernelRuntime()->memoryPlan(kFirstInputId), nullptr);
+}
+
+} // namespace nvfuser
@@ -0,0 +1,206 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <executor_utils.h>
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+#include <options.h>
+
+#include <test/utils.h>
+#include <test/validator.h>
+
+#include <torch/torch.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace nvfuser {
+
+using executor_utils::CompiledKernel;
+using executor_utils::CompiledKernelCache;
+
+class ModuleCacheTest : public NVFuserTest {
+ protected:
+  void SetUp() override {
+    NVFuserTest::SetUp();
+    EnableOptionsGuard::getCurOptions().set(EnableOption::ModuleCache);
+    CompiledKernelCache::get().clear();
+  }
+
+  void TearDown() override {
+    CompiledKernelCache::get().clear();
+    NVFuserTest::TearDown();
+  }
+
+ private:
+  EnableOptionsGuard enable_guard_;
+};
+
+namespace {
+
+// Stands in for NVRTC. The kernels have no module, so nothing is loaded.
+CompiledKernelCache::CompileFunction mockCompile(
+    std::atomic<int64_t>& num_compiles,
+    const std::string& kernel_name) {
+  return [&num_compiles, kernel_name]() {
+    ++num_compiles;
+    auto compiled_kernel = std::make_unique<CompiledKernel>();
+    compiled_kernel->kernel_name = kernel_name;
+    return compiled_kernel;
+  };
+}
+
+} // namespace
+
+TEST_F(ModuleCacheTest, HitRate) {
+  CompiledKernelCache cache;
+  std::atomic<int64_t> num_compiles{0};
+
+  for (const std::string key : {"a", "b", "a", "a", "b", "c"}) {
+    auto compiled_kernel =
+        cache.getOrCompile(key, mockCompile(num_compiles, key));
+    EXPECT_EQ(compiled_kernel->kernel_name, key);
+  }
+  EXPECT_EQ(num_compiles, 3);
+  EXPECT_EQ(cache.misses(), 3);
+  EXPECT_EQ(cache.hits(), 3);
+  EXPECT_EQ(cache.size(), 3);
+
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0);
+  cache.getOrCompile("a", mockCompile(num_compiles, "a"));
+  EXPECT_EQ(num_compiles, 4);
+}
+
+// Threads asking for a kernel being compiled wait for it
+TEST_F(ModuleCacheTest, SingleFlight) {
+  CompiledKernelCache cache;
+  std::atomic<int64_t> num_compiles{0};
+  auto slow_compile = [&num_compiles]() {
+    ++num_compiles;
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto compiled_kernel = std::make_unique<CompiledKernel>();
+    compiled_kernel->kernel_name = "slow";
+    return compiled_kernel;
+  };
+
+  const int64_t num_threads = 8;
+  std::vector<std::unique_ptr<CompiledKernel>> compiled_kernels(num_threads);
+  std::vector<std::thread> threads;
+  for (auto i : c10::irange(num_threads)) {
+    threads.emplace_back([&, i]() {
+      compiled_kernels.at(i) = cache.getOrCompile("slow", slow_compile);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(num_compiles, 1);
+  EXPECT_EQ(cache.misses(), 1);
+  EXPECT_EQ(cache.hits(), num_threads - 1);
+  for (const auto& compiled_kernel : compiled_kernels) {
+    ASSERT_NE(compiled_kernel, nullptr);
+    EXPECT_EQ(compiled_kernel->kernel_name, "slow");
+  }
+}
+
+// A failed compilation is retried by the next request
+TEST_F(ModuleCacheTest, FailedCompile) {
+  CompiledKernelCache cache;
+  std::atomic<int64_t> num_compiles{0};
+  auto failing_compile = [&num_compiles]() -> std::unique_ptr<CompiledKernel> {
+    ++num_compiles;
+    NVF_ERROR(false, "NVRTC failed");
+  };
+
+  EXPECT_THAT(
+      [&]() { cache.getOrCompile("a", failing_compile); },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("NVRTC failed")));
+  EXPECT_EQ(cache.size(), 0);
+
+  cache.getOrCompile("a", mockCompile(num_compiles, "a"));
+  EXPECT_EQ(num_compiles, 2);
+  EXPECT_EQ(cache.size(), 1);
+}
+
+// The least recently used kernels are dropped beyond the maximum size
+TEST_F(ModuleCacheTest, Eviction) {
+  CompiledKernelCache cache;
+  cache.setMaxSize(2);
+  std::atomic<int64_t> num_compiles{0};
+
+  for (const std::string key : {"a", "b", "a", "c"}) {
+    cache.getOrCompile(key, mockCompile(num_compiles, key));
+  }
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_NE(cache.find("a"), nullptr);
+  EXPECT_EQ(cache.find("b"), nullptr);
+  EXPECT_NE(cache.find("c"), nullptr);
+  EXPECT_EQ(num_compiles, 3);
+
+  // Kernels compiled outside of the cache count as misses
+  auto kernel = std::make_unique<CompiledKernel>();
+  kernel->kernel_name = "d";
+  EXPECT_EQ(cache.insert("d", std::move(kernel))->kernel_name, "d");
+  EXPECT_EQ(cache.misses(), 4);
+  EXPECT_EQ(cache.find("a"), nullptr);
+
+  cache.setMaxSize(1);
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_NE(cache.find("d"), nullptr);
+}
+
+// Identical kernels of different FusionExecutorCaches share a module
+TEST_F(ModuleCacheTest, FusionExecutorCaches_CUDA) {
+  auto makeFusion = []() {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    auto tv0 = makeContigTensor(2);
+    fusion->addInput(tv0);
+    auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+    fusion->addOutput(sum(tv1, {1}));
+    return fusion;
+  };
+  auto fec0 = std::make_unique<FusionExecutorCache>(makeFusion());
+  FusionExecutorCache fec1(makeFusion());
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({128, 1024}, options);
+  auto outputs0 = fec0->runFusionWithInputs({t0});
+  auto outputs1 = fec1.runFusionWithInputs({t0});
+
+  auto& cache = CompiledKernelCache::get();
+  EXPECT_EQ(cache.misses(), 1);
+  EXPECT_EQ(cache.hits(), 1);
+  const auto& executor0 =
+      fec0->getMostRecentKernelRuntime()->executors().front();
+  const auto& executor1 =
+      fec1.getMostRecentKernelRuntime()->executors().front();
+  EXPECT_NE(executor0.kernelName(), executor1.kernelName());
+  EXPECT_EQ(
+      executor0.compiledKernel().function,
+      executor1.compiledKernel().function);
+  testValidate(
+      fec1.fusion(), outputs1, {t0}, {(t0 + 1).sum({1})}, __LINE__, __FILE__);
+
+  // The module outlives the executor that compiled it
+  fec0.reset();
+  outputs1 = fec1.runFusionWithInputs({t0});
+  testValidate(
+      fec1.fusion(), outputs1, {t0}, {(t0 + 1).sum({1})}, __LINE__, __FILE__);
+}
+
+} // namespace nvfuser
@@ -6,6 +6,7 @@
  */
 // clang-format on
 #ifdef USE_DISTRIBUTED
+#include <gmock/gmock-matchers.h>
 #include <gtest/gtest.h>
 
 #include <codegen.h>
@@ -25,6 +26,7 @@
 #include <kernel_cache.h>
 #include <kernel_ir.h>
 #include <mma_type.h>
+#include <multidevice/executor.h>
 #include <multidevice/pipeline.h>
 #include <multidevice/pipeline_ir.h>
 #include <multidevice/runtime.h>
@@ -46,6 +48,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <unordered_set>
 
 namespace nvfuser {
 
@@ -240,6 +243,88 @@ TEST_F(MultiDeviceTest, Pipeline) {
   testValidateMultidevice(std::move(fusion_ptr), runtime, inputs, outputs);
 }
 
+// Runs two independent branches, each made of a stage and a communication,
+// with the concurrent executor. Checks that every expr was executed on its own
+// stream and that the inputs read across streams had their use recorded.
+// Whether the branches actually overlap on the device depends on its load,
+// so it is left to the timeline dump and not checked here.
+TEST_F(MultiDeviceTest, Pipeline_ConcurrentBranches) {
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  TensorView* tv1 = sum(tv0, {0});
+  TensorView* tv2 = makeContigTensor(2);
+  fusion.addInput(tv2);
+  TensorView* tv3 = sum(tv2, {0});
+
+  TensorView* tv4 = set(tv1);
+  TensorView* tv5 = set(tv3);
+  TensorView* tv6 = add(tv4, tv5);
+  fusion.addOutput(tv6);
+
+  PipelineStageDescriptor stage0, stage1, stage2;
+  stage0.addVal({tv0, tv1});
+  stage1.addVal({tv2, tv3});
+  stage2.addVal({tv4, tv5, tv6});
+  stage0.mesh = {0};
+  stage1.mesh = {0};
+  stage2.mesh = {1};
+
+  PipelineDescriptor descriptor{.stage_descriptors{
+      std::move(stage0), std::move(stage1), std::move(stage2)}};
+  Pipeline pipeline(&fusion, std::move(descriptor));
+
+  int requested_world_size = 2;
+  if (!comm.is_available() || comm.size() < requested_world_size) {
+    GTEST_SKIP() << "This test needs distributed setting with at least "
+                 << requested_world_size << " ranks";
+  }
+
+  MultiDeviceRuntime runtime(&pipeline, comm);
+
+  c10::TensorOptions options =
+      at::TensorOptions().dtype(at::kFloat).device(comm.device());
+  std::vector<c10::IValue> inputs{
+      at::randn({256, 256}, options), at::randn({256, 256}, options)};
+
+  // run twice to check that the executor can be reused
+  auto outputs = runtime.runWithInput(inputs);
+  outputs = runtime.runWithInput(inputs);
+  c10::cuda::getCurrentCUDAStream().synchronize();
+
+  // 3 stages and 2 communications, each on its own stream, none of them the
+  // caller's
+  EXPECT_EQ(runtime.timings().size(), 5);
+  std::unordered_set<c10::StreamId> stream_ids;
+  for (const auto& timing : runtime.timings()) {
+    EXPECT_LE(timing.start, timing.end);
+    ASSERT_TRUE(timing.stream.has_value());
+    EXPECT_NE(timing.stream.value(), c10::cuda::getCurrentCUDAStream());
+    stream_ids.insert(timing.stream->id());
+  }
+  EXPECT_EQ(stream_ids.size(), 5);
+
+  if (comm.deviceId() == 0) {
+    // The branches read the global inputs, produced on the caller's stream,
+    // and the communications read the outputs of the branches, produced on
+    // the streams of the stages
+    for (const auto& timing : runtime.timings()) {
+      if (timing.expr->isA<PipelineStage>() &&
+          !timing.expr->as<PipelineStage>()->descriptor()->mesh.has(0)) {
+        continue;
+      }
+      for (auto input : timing.expr->inputs()) {
+        EXPECT_THAT(timing.recorded_inputs, ::testing::Contains(input));
+      }
+    }
+  }
+
+  testValidateMultidevice(std::move(fusion_ptr), runtime, inputs, outputs);
+}
+
 } // namespace nvfuser
 
 #endif
@@ -6,10 +6,15 @@
  */
 // clang-format on
 #ifdef USE_DISTRIBUTED
+#include <gmock/gmock-matchers.h>
 #include <gtest/gtest.h>
 
+#include <fusion.h>
 #include <multidevice/communication.h>
 #include <multidevice/communicator.h>
+#include <multidevice/lower_communication.h>
+#include <multidevice/pipeline.h>
+#include <ops/all_ops.h>
 #include <test/multidevice.h>
 
 #include <iostream>
@@ -283,6 +288,232 @@ TEST_F(MultiDeviceTest, Communication_SendRecvToSelf) {
   comm.barrier();
 }
 
+namespace {
+
+// Returns the PipelineCommunication transferring from producer to consumer
+PipelineCommunication* getCommunication(
+    Pipeline& pipeline,
+    Val* producer,
+    Val* consumer) {
+  for (auto expr : pipeline.exprs()) {
+    if (auto c = dynamic_cast<PipelineCommunication*>(expr)) {
+      if (c->in()->as<PipelineVal>()->getOriginalVal() == producer &&
+          c->out()->as<PipelineVal>()->getOriginalVal() == consumer) {
+        return c;
+      }
+    }
+  }
+  NVF_ERROR(false, "no communication found");
+  return nullptr;
+}
+
+// Returns, for each device, the (root, team) of the lowered communications
+std::vector<std::vector<std::pair<DeviceIdxType, Team>>> lowerForAllDevices(
+    PipelineCommunication* c,
+    int64_t number_of_devices,
+    const DeviceTopology& topology) {
+  // The lowering does not touch the data, so CPU tensors are enough. They
+  // have one slice per device in case they are sharded.
+  at::Tensor input = at::empty({number_of_devices, tensor_size});
+  at::Tensor output = at::empty({number_of_devices, tensor_size});
+  std::vector<std::vector<std::pair<DeviceIdxType, Team>>> result;
+  for (auto device : c10::irange(number_of_devices)) {
+    result.emplace_back();
+    for (auto& comm : lowerCommunication(device, c, input, output, topology)) {
+      result.back().emplace_back(comm->params().root, comm->params().team);
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_F(NVFuserTest, DeviceTopology_Parse) {
+  auto topology = DeviceTopology::fromString("0:0:0;0:0:1;0:1:2;1:0:0");
+  EXPECT_EQ(topology.level(0, 0), TopologyLevel::Self);
+  EXPECT_EQ(topology.level(0, 1), TopologyLevel::Socket);
+  EXPECT_EQ(topology.level(0, 2), TopologyLevel::Node);
+  EXPECT_EQ(topology.level(0, 3), TopologyLevel::Network);
+  // undescribed devices are each on their own node
+  EXPECT_EQ(topology.level(4, 5), TopologyLevel::Network);
+
+  std::vector<Team> expected_groups = {{3}, {2, 0}};
+  EXPECT_EQ(topology.groupByNode({3, 2, 0}), expected_groups);
+
+  EXPECT_THAT(
+      [&]() { DeviceTopology::fromString("0:a"); },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("invalid topology entry")));
+}
+
+TEST_F(NVFuserTest, LowerCommunication_AssignReceiversToSenders) {
+  // Without topology, the receivers are balanced across the senders
+  auto flat = assignReceiversToSenders({0, 2}, {3, 1}, DeviceTopology());
+  ASSERT_EQ(flat.size(), 2);
+  EXPECT_EQ(flat.at(0).sender, 0);
+  EXPECT_EQ(flat.at(0).receivers, Team({3}));
+  EXPECT_EQ(flat.at(1).sender, 2);
+  EXPECT_EQ(flat.at(1).receivers, Team({1}));
+
+  // Two nodes {0, 1} and {2, 3}, and a third node {4, 5} without sender
+  auto topology = DeviceTopology::fromString("0;0;1;1;2;2");
+  auto assignments =
+      assignReceiversToSenders({0, 2}, {3, 1, 2, 4, 5}, topology);
+  ASSERT_EQ(assignments.size(), 2);
+  EXPECT_EQ(assignments.at(0).sender, 0);
+  EXPECT_EQ(assignments.at(0).receivers, Team({1, 4, 5}));
+  EXPECT_EQ(assignments.at(1).sender, 2);
+  EXPECT_EQ(assignments.at(1).receivers, Team({3, 2}));
+}
+
+TEST_F(NVFuserTest, LowerCommunication_TopologyAware) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  TensorView* tv1 = sum(tv0, {0});
+  TensorView* tv2 = set(tv1);
+  TensorView* tv3 = neg(tv2);
+  TensorView* tv4 = set(tv3);
+  TensorView* tv5 = neg(tv4);
+  fusion.addOutput(tv5);
+  TensorView* tv6 = set(tv1);
+  TensorView* tv7 = neg(tv6);
+  fusion.addOutput(tv7);
+
+  PipelineStageDescriptor stage0, stage1, stage2, stage3;
+  stage0.addVal({tv0, tv1});
+  stage1.addVal({tv2, tv3});
+  stage2.addVal({tv4, tv5});
+  stage3.addVal({tv6, tv7});
+  stage0.mesh = {0};
+  stage1.mesh = {0, 2};
+  stage2.mesh = {3, 1};
+  stage3.mesh = {1, 2, 3};
+
+  PipelineDescriptor descriptor{.stage_descriptors{
+      std::move(stage0),
+      std::move(stage1),
+      std::move(stage2),
+      std::move(stage3)}};
+  Pipeline pipeline(&fusion, std::move(descriptor));
+
+  // two nodes: {0, 1} and {2, 3}
+  auto topology = DeviceTopology::fromString("0;0;1;1");
+
+  // The data is replicated on devices 0 and 2, each receiver fetches it from
+  // the sender on its node
+  auto replicated = lowerForAllDevices(
+      getCommunication(pipeline, tv3, tv4), /*number_of_devices=*/4, topology);
+  using Comms = std::vector<std::pair<DeviceIdxType, Team>>;
+  EXPECT_EQ(replicated.at(0), Comms({{0, {1, 0}}}));
+  EXPECT_EQ(replicated.at(1), Comms({{0, {1, 0}}}));
+  EXPECT_EQ(replicated.at(2), Comms({{2, {3, 2}}}));
+  EXPECT_EQ(replicated.at(3), Comms({{2, {3, 2}}}));
+
+  // Hierarchical broadcast: the data is sent once to the remote node, where
+  // device 2 forwards it to device 3
+  auto hierarchical = lowerForAllDevices(
+      getCommunication(pipeline, tv1, tv6), /*number_of_devices=*/4, topology);
+  EXPECT_EQ(hierarchical.at(0), Comms({{0, {2, 0}}, {0, {1, 0}}}));
+  EXPECT_EQ(hierarchical.at(1), Comms({{0, {1, 0}}}));
+  EXPECT_EQ(hierarchical.at(2), Comms({{0, {2, 0}}, {2, {3, 2}}}));
+  EXPECT_EQ(hierarchical.at(3), Comms({{2, {3, 2}}}));
+}
+
+TEST_F(NVFuserTest, LowerCommunication_HierarchicalAllgather) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  TensorView* tv1 = neg(tv0);
+  TensorView* tv2 = set(tv1);
+  TensorView* tv3 = neg(tv2);
+  fusion.addOutput(tv3);
+  tv0->axis(0)->parallelize(ParallelType::DIDx);
+  tv1->axis(0)->parallelize(ParallelType::DIDx);
+
+  // two nodes: {0, 1} and {2, 3}
+  auto topology = DeviceTopology::fromString("0;0;1;1");
+  using Comms = std::vector<std::pair<DeviceIdxType, Team>>;
+
+  auto lower = [&](std::vector<DeviceIdxType> devices) {
+    PipelineStageDescriptor stage0, stage1;
+    stage0.addVal({tv0, tv1});
+    stage1.addVal({tv2, tv3});
+    stage0.mesh = devices;
+    stage1.mesh = devices;
+    PipelineDescriptor descriptor{
+        .stage_descriptors{std::move(stage0), std::move(stage1)}};
+    Pipeline pipeline(&fusion, std::move(descriptor));
+    return lowerForAllDevices(
+        getCommunication(pipeline, tv1, tv2),
+        /*number_of_devices=*/4,
+        topology);
+  };
+
+  // Allgather within each node, then one transfer of the two slices of each
+  // node to the leader of the other node, which forwards them to its peer
+  auto hierarchical = lower({0, 1, 2, 3});
+  EXPECT_EQ(
+      hierarchical.at(0),
+      Comms({{-1, {0, 1}}, {0, {2, 0}}, {2, {0, 2}}, {0, {1, 0}}}));
+  EXPECT_EQ(hierarchical.at(1), Comms({{-1, {0, 1}}, {0, {1, 0}}}));
+  EXPECT_EQ(
+      hierarchical.at(2),
+      Comms({{-1, {2, 3}}, {0, {2, 0}}, {2, {0, 2}}, {2, {3, 2}}}));
+  EXPECT_EQ(hierarchical.at(3), Comms({{-1, {2, 3}}, {2, {3, 2}}}));
+
+  // The slices of a node are not contiguous in this mesh, so the allgather
+  // is not decomposed
+  auto flat = lower({0, 2, 1, 3});
+  for (auto device : c10::irange(4)) {
+    EXPECT_EQ(flat.at(device), Comms({{-1, {0, 2, 1, 3}}}));
+  }
+}
+
+TEST_F(NVFuserTest, LowerCommunication_HierarchicalAllgatherBuffers) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  TensorView* tv1 = neg(tv0);
+  TensorView* tv2 = set(tv1);
+  TensorView* tv3 = neg(tv2);
+  fusion.addOutput(tv3);
+  tv0->axis(0)->parallelize(ParallelType::DIDx);
+  tv1->axis(0)->parallelize(ParallelType::DIDx);
+
+  PipelineStageDescriptor stage0, stage1;
+  stage0.addVal({tv0, tv1});
+  stage1.addVal({tv2, tv3});
+  stage0.mesh = {0, 1, 2, 3, 4, 5};
+  stage1.mesh = {0, 1, 2, 3, 4, 5};
+  PipelineDescriptor descriptor{
+      .stage_descriptors{std::move(stage0), std::move(stage1)}};
+  Pipeline pipeline(&fusion, std::move(descriptor));
+
+  // two nodes of three devices
+  auto topology = DeviceTopology::fromString("0;0;0;1;1;1");
+  at::Tensor input = at::empty({6, tensor_size});
+  at::Tensor output = at::empty({6, tensor_size});
+  auto comms = lowerCommunication(
+      0, getCommunication(pipeline, tv1, tv2), input, output, topology);
+
+  // The leader sends the three slices of its node in one transfer, and
+  // receives the three slices of the other node in one transfer
+  ASSERT_EQ(comms.size(), 4);
+  EXPECT_EQ(comms.at(1)->params().src_bufs.at(0).size(0), 3);
+  EXPECT_EQ(comms.at(1)->params().src_bufs.at(0).data_ptr(), output.data_ptr());
+  EXPECT_EQ(comms.at(2)->params().dst_bufs.at(0).size(0), 3);
+  EXPECT_EQ(
+      comms.at(2)->params().dst_bufs.at(0).data_ptr(),
+      output.index({3}).data_ptr());
+}
+
 } // namespace nvfuser
 
 #endif
@@ -0,0 +1,210 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gtest/gtest.h>
+
+#include <expr_evaluator.h>
+#include <ir/all_nodes.h>
+#include <ir/builder.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+#include <optimization/online_softmax.h>
+#include <scheduler/all_schedulers.h>
+
+#include <test/utils.h>
+#include <test/validator.h>
+
+#include <torch/torch.h>
+
+namespace nvfuser {
+
+class OnlineSoftmaxTest : public NVFuserTest {};
+
+// Evaluate the combined reduction on CPU with ExpressionEvaluator
+TEST_F(OnlineSoftmaxTest, EvaluateCpu) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto stats = online_softmax_stats(tv0, {1});
+  auto tv1 = online_softmax(tv0, 1);
+  auto tv2 = logsumexp(tv0, {0}, /*keepdim=*/true);
+
+  auto t0 = at::randn({13, 17}, at::TensorOptions().dtype(at::kFloat));
+  // A row of -inf except for one element
+  t0.select(0, 2).fill_(-std::numeric_limits<float>::infinity());
+  t0.select(0, 2).select(0, 5).fill_(1);
+
+  ExpressionEvaluator ee;
+  ee.bind(tv0, t0);
+
+  auto ref_max = std::get<0>(at::max(t0, 1));
+  auto ref_sum = at::exp(t0 - ref_max.unsqueeze(1)).sum(1);
+  EXPECT_TRUE(at::equal(ee.evaluate(stats.max).as<at::Tensor>(), ref_max));
+  EXPECT_TRUE(at::allclose(ee.evaluate(stats.sum).as<at::Tensor>(), ref_sum));
+  EXPECT_TRUE(
+      at::allclose(ee.evaluate(tv1).as<at::Tensor>(), at::softmax(t0, 1)));
+  EXPECT_TRUE(at::allclose(
+      ee.evaluate(tv2).as<at::Tensor>(),
+      at::logsumexp(t0, {0}, /*keepdim=*/true)));
+}
+
+// The statistics are a single reduction
+TEST_F(OnlineSoftmaxTest, Stats_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  fusion.addInput(tv0);
+  auto stats = online_softmax_stats(tv0, {1});
+  fusion.addOutput(stats.max);
+  fusion.addOutput(stats.sum);
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  auto t0 = at::randn({128, 50257}, options);
+  std::vector<c10::IValue> aten_inputs = {t0};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  EXPECT_EQ(
+      runtime->schedulerHeuristics()->heuristicsList().at(0)->heuristic(),
+      ScheduleHeuristic::Reduction);
+
+  auto t0_float = t0.to(at::kFloat);
+  auto ref_max = std::get<0>(at::max(t0_float, 1));
+  auto ref_sum = at::exp(t0_float - ref_max.unsqueeze(1)).sum(1);
+  testValidate(
+      executor_cache.fusion(),
+      cg_outputs,
+      aten_inputs,
+      {ref_max, ref_sum},
+      __LINE__,
+      __FILE__);
+}
+
+// Cross entropy fuses on top of the statistics without persistence
+TEST_F(OnlineSoftmaxTest, CrossEntropy_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(1, DataType::Int);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = logsumexp(tv0, {1}, /*keepdim=*/false);
+  auto vocab_size = tv0->getRootDomain().at(1)->extent();
+  auto tv3 = broadcast(iota(vocab_size), {true, false});
+  auto tv4 = eq(tv3, broadcast(tv1, {false, true}));
+  auto tv5 = sum(where(tv4, tv0, IrBuilder::create<Val>(0.0)), {1});
+  auto tv6 = sub(tv2, tv5);
+  fusion.addOutput(tv6);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({64, 128256}, options);
+  auto t1 = at::randint(128256, {64}, options.dtype(at::kLong));
+  std::vector<c10::IValue> aten_inputs = {t0, t1};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  EXPECT_EQ(
+      runtime->schedulerHeuristics()->heuristicsList().at(0)->heuristic(),
+      ScheduleHeuristic::Reduction);
+
+  auto ref = at::cross_entropy_loss(
+      t0, t1, /*weight=*/{}, at::Reduction::None);
+  testValidate(
+      executor_cache.fusion(),
+      cg_outputs,
+      aten_inputs,
+      {ref},
+      __LINE__,
+      __FILE__);
+}
+
+// Rows that fit are persistent
+TEST_F(OnlineSoftmaxTest, Persistent_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = online_softmax(tv0, 1);
+  fusion.addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({1024, 4096}, options);
+  std::vector<c10::IValue> aten_inputs = {t0};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  EXPECT_EQ(
+      runtime->schedulerHeuristics()->heuristicsList().at(0)->heuristic(),
+      ScheduleHeuristic::InnerPersistent);
+
+  testValidate(
+      executor_cache.fusion(),
+      cg_outputs,
+      aten_inputs,
+      {at::softmax(t0, 1)},
+      __LINE__,
+      __FILE__);
+}
+
+// Softmax of rows too large to be persistent is rewritten to compute the
+// max and the sum in a single reduction kernel
+TEST_F(OnlineSoftmaxTest, LargeRowSoftmax_CUDA) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({8, 1 << 22}, options);
+  std::vector<c10::IValue> aten_inputs = {t0};
+
+  auto run = [&]() {
+    auto fusion_ptr = std::make_unique<Fusion>();
+    Fusion& fusion = *fusion_ptr.get();
+    FusionGuard fg(&fusion);
+
+    auto tv0 = makeContigTensor(2);
+    fusion.addInput(tv0);
+    auto tv1 = softmax(tv0, 1);
+    fusion.addOutput(tv1);
+
+    FusionExecutorCache executor_cache(std::move(fusion_ptr));
+    auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+    testValidate(
+        executor_cache.fusion(),
+        cg_outputs,
+        aten_inputs,
+        {at::softmax(t0, 1)},
+        __LINE__,
+        __FILE__);
+    return executor_cache.getMostRecentKernelRuntime()
+        ->fusionSegments()
+        ->groups()
+        .size();
+  };
+
+  const auto num_online_segments = run();
+  EXPECT_EQ(num_online_segments, 2);
+
+  optimization::OptimizationPassGuard<optimization::OnlineSoftmaxPass> guard(
+      false);
+  EXPECT_GT(run(), num_online_segments);
+}
+
+} // namespace nvfuser
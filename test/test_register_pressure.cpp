@@ -0,0 +1,324 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <debug.h>
+#include <device_lower/analysis/register_pressure.h>
+#include <device_lower/lower2device.h>
+#include <executor.h>
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <ops/all_ops.h>
+#include <options.h>
+#include <scheduler/all_schedulers.h>
+
+#include <test/utils.h>
+#include <test/validator.h>
+
+#include <torch/torch.h>
+
+#include <ATen/cuda/CUDAContext.h>
+
+#include <regex>
+
+namespace nvfuser {
+
+class RegisterPressureTest : public NVFuserTest {};
+
+namespace {
+
+// Define tv2 = tv0 + 1 + 1 where the intermediate is a local buffer of
+// buffer_size elements
+void localBufferDefinition(int64_t buffer_size, DataType dtype) {
+  auto fusion = FusionGuard::getCurFusion();
+  auto tv0 = makeContigTensor(1, dtype);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  auto tv2 = add(tv1, IrBuilder::create<Val>(1.0));
+  fusion->addOutput(tv2);
+
+  tv2->split(0, buffer_size);
+  tv1->computeAt(tv2, 1);
+}
+
+// Define the fp16 layer norm of a 2D input
+void layerNormHalfDefinition() {
+  auto fusion = FusionGuard::getCurFusion();
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  fusion->addInput(tv0);
+  auto tv1 = castOp(DataType::Float, tv0);
+  auto result =
+      layer_norm(tv1, 1, nullptr, nullptr, IrBuilder::create<Val>(1e-5));
+  fusion->addOutput(castOp(DataType::Half, result.output));
+}
+
+// Inner persistent schedule of layerNormHalfDefinition where each thread
+// holds batches * vectorize_factor elements of the input, see
+// innerPersistentHeuristic
+ReductionParams layerNormHalfParams(int64_t batches, int64_t vectorize_factor) {
+  ReductionParams rparams;
+  rparams.persistent_kernel = true;
+  rparams.project_persistent_buffers = true;
+  rparams.fastest_dim = true;
+  rparams.cross_block_inner_reduction = true;
+  rparams.block_dim_inner_reduction = ParallelType::TIDx;
+  rparams.pad_inner_reduction_to_warp = true;
+  rparams.batches_per_block_inner_reduction = batches;
+  rparams.unroll_factor_inner_reduction = vectorize_factor;
+  rparams.vectorize_inner_reduction = true;
+  rparams.grid_dim_iter_dom = ParallelType::BIDx;
+  rparams.cparams.index_type = PrimDataType::Int32;
+  return rparams;
+}
+
+// A kernel of the corpus and the registers ptxas reported for it
+struct PtxasReport {
+  std::string name;
+  // Architecture the kernel was compiled for
+  std::string arch;
+  int64_t batches;
+  int64_t vectorize_factor;
+  int64_t registers;
+};
+
+// Registers reported by ptxas for inner persistent kernels with 8, 16, 64,
+// 128 and 256 bytes of persistent buffer per thread, as listed in
+// innerPersistentHeuristic. New reports are printed by
+// RegisterPressureTest.PtxasCorpus_CUDA.
+const std::vector<PtxasReport>& ptxasCorpus() {
+  static const std::vector<PtxasReport> corpus = {
+      {"layer_norm_fp16_buffer_8", "sm_80", 1, 4, 27},
+      {"layer_norm_fp16_buffer_16", "sm_80", 1, 8, 40},
+      {"layer_norm_fp16_buffer_64", "sm_80", 4, 8, 62},
+      {"layer_norm_fp16_buffer_128", "sm_80", 8, 8, 73},
+      {"layer_norm_fp16_buffer_256", "sm_80", 16, 8, 105},
+  };
+  return corpus;
+}
+
+// The estimate may exceed the count of ptxas, which only costs occupancy
+// when the heuristics lower their factors to it, by up to kMaxOverestimate.
+// An estimate below the count lets the heuristics pick factors that spill,
+// so it may only be below by kMaxUnderestimate.
+constexpr int64_t kMaxOverestimate = 64;
+constexpr int64_t kMaxUnderestimate = 8;
+
+// Scheduled copy of layerNormHalfDefinition for a report of the corpus
+std::unique_ptr<Fusion> corpusFusion(const PtxasReport& report) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  layerNormHalfDefinition();
+  scheduleInnerPersistentKernel(
+      fusion.get(),
+      layerNormHalfParams(report.batches, report.vectorize_factor));
+  return fusion;
+}
+
+// Registers used by the kernel in a verbose ptxas log, e.g.,
+// "ptxas info    : Used 40 registers, 380 bytes cmem[0]"
+int64_t ptxasRegisterCount(const std::string& log) {
+  std::smatch match;
+  const std::regex used_registers("Used ([0-9]+) registers");
+  NVF_CHECK(
+      std::regex_search(log, match, used_registers),
+      "Register count not found in the ptxas log: ",
+      log);
+  return std::stoll(match[1]);
+}
+
+} // namespace
+
+TEST_F(RegisterPressureTest, LocalBuffer) {
+  int64_t previous_registers = 0;
+  for (int64_t buffer_size : {1, 4, 16}) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+    localBufferDefinition(buffer_size, DataType::Float);
+
+    GpuLower gpulw(&fusion);
+    auto pressure = estimateRegisterPressure(gpulw.kernel());
+    EXPECT_EQ(pressure.buffer_registers, buffer_size);
+    EXPECT_EQ(pressure.vectorized_registers, 0);
+    EXPECT_GE(
+        pressure.registers,
+        pressure.buffer_registers + pressure.scalar_registers);
+    EXPECT_GT(pressure.registers, previous_registers);
+    previous_registers = pressure.registers;
+  }
+}
+
+// 64-bit values take two registers
+TEST_F(RegisterPressureTest, DoubleBuffer) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+  localBufferDefinition(8, DataType::Double);
+
+  GpuLower gpulw(&fusion);
+  EXPECT_EQ(estimateRegisterPressure(gpulw.kernel()).buffer_registers, 16);
+}
+
+TEST_F(RegisterPressureTest, VectorizedBuffer) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  auto tv2 = add(tv1, IrBuilder::create<Val>(1.0));
+  fusion.addOutput(tv2);
+
+  tv2->split(0, 4);
+  tv1->computeAt(tv2, 1);
+  tv1->axis(1)->parallelize(ParallelType::Vectorize);
+
+  GpuLower gpulw(&fusion);
+  auto pressure = estimateRegisterPressure(gpulw.kernel());
+  EXPECT_EQ(pressure.buffer_registers, 4);
+  EXPECT_EQ(pressure.vectorized_registers, 4);
+}
+
+// Buffers allocated in different loop nests are not live at the same time
+TEST_F(RegisterPressureTest, DisjointScopes) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  auto tv2 = add(tv1, IrBuilder::create<Val>(1.0));
+  fusion.addOutput(tv2);
+  auto tv3 = mul(tv0, IrBuilder::create<Val>(2.0));
+  auto tv4 = mul(tv3, IrBuilder::create<Val>(2.0));
+  fusion.addOutput(tv4);
+
+  tv2->split(0, 8);
+  tv1->computeAt(tv2, 1);
+  tv4->split(0, 8);
+  tv3->computeAt(tv4, 1);
+
+  GpuLower gpulw(&fusion);
+  EXPECT_EQ(estimateRegisterPressure(gpulw.kernel()).buffer_registers, 8);
+}
+
+// The estimate is never above the limit of ptxas
+TEST_F(RegisterPressureTest, Capped) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+  localBufferDefinition(1024, DataType::Float);
+
+  GpuLower gpulw(&fusion);
+  auto pressure = estimateRegisterPressure(gpulw.kernel());
+  EXPECT_EQ(pressure.buffer_registers, 1024);
+  EXPECT_EQ(pressure.registers, 255);
+}
+
+// Estimates of the kernels of the corpus are checked against the recorded
+// counts of ptxas, so this doesn't need a GPU
+TEST_F(RegisterPressureTest, PtxasCorpus) {
+  int64_t previous_registers = 0;
+  for (const auto& report : ptxasCorpus()) {
+    auto fusion = corpusFusion(report);
+    GpuLower gpulw(fusion.get(), {.index_type = PrimDataType::Int32});
+    auto pressure = estimateRegisterPressure(gpulw.kernel());
+    EXPECT_LE(pressure.registers, report.registers + kMaxOverestimate)
+        << report.name;
+    EXPECT_GE(pressure.registers, report.registers - kMaxUnderestimate)
+        << report.name;
+    // Reports are ordered by the registers ptxas used
+    EXPECT_GE(pressure.registers, previous_registers) << report.name;
+    previous_registers = pressure.registers;
+  }
+}
+
+// Same check against the current ptxas. The reports to record for the
+// corpus are printed.
+TEST_F(RegisterPressureTest, PtxasCorpus_CUDA) {
+  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
+  const std::string arch =
+      "sm_" + std::to_string(dev_prop->major * 10 + dev_prop->minor);
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+
+  for (const auto& report : ptxasCorpus()) {
+    auto fusion = corpusFusion(report);
+    // 128 threads for each row
+    at::Tensor aten_input = at::randn(
+        {1024, report.batches * report.vectorize_factor * 128}, options);
+
+    CompileParams compile_opts = {
+        .index_type = PrimDataType::Int32, .enable_ptxas_verbose = true};
+    FusionExecutor fe;
+    fe.compileFusion(fusion.get(), {aten_input}, LaunchParams(), compile_opts);
+
+    auto registers = ptxasRegisterCount(fe.compiledKernel().compile_log);
+    auto pressure = estimateRegisterPressure(fe.kernel());
+    debug() << "{\"" << report.name << "\", \"" << arch << "\", "
+            << report.batches << ", " << report.vectorize_factor << ", "
+            << registers << "}, estimate: " << pressure.registers
+            << std::endl;
+    EXPECT_LE(pressure.registers, registers + kMaxOverestimate)
+        << report.name;
+    EXPECT_GE(pressure.registers, registers - kMaxUnderestimate)
+        << report.name;
+  }
+}
+
+// With EnableOption::RegisterEstimate, the inner persistent heuristic lowers
+// its factors instead of compiling a kernel whose estimate is above the
+// register count it chose
+TEST_F(RegisterPressureTest, PersistentHeuristic_CUDA) {
+  const int64_t hidden_size = 1024 * 10;
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::Tensor aten_input = at::randn({2048, hidden_size}, options);
+
+  auto compile = [&](bool register_estimate) {
+    EnableOptionsGuard opt_guard;
+    if (register_estimate) {
+      EnableOptionsGuard::getCurOptions().set(EnableOption::RegisterEstimate);
+    }
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    layerNormHalfDefinition();
+
+    auto params = getInnerPersistentHeuristics(fusion.get(), {aten_input});
+    NVF_CHECK(params, "Persistent schedule was not generated!");
+    scheduleInnerPersistentKernel(fusion.get(), *params);
+
+    auto fe = std::make_unique<FusionExecutor>();
+    fe->compileFusion(
+        fusion.get(), {aten_input}, params->lparams, params->cparams);
+    auto cg_outputs = fe->runFusion({aten_input});
+    auto aten_output = std::get<0>(at::native_layer_norm(
+        aten_input.to(at::kFloat),
+        {hidden_size},
+        c10::nullopt,
+        c10::nullopt,
+        1e-5));
+    testValidate(
+        fusion.get(),
+        cg_outputs,
+        {aten_input},
+        {aten_output.to(at::kHalf)},
+        __LINE__,
+        __FILE__,
+        "");
+    return std::make_pair(params, estimateRegisterPressure(fe->kernel()));
+  };
+
+  auto [default_params, default_pressure] = compile(false);
+  auto [params, pressure] = compile(true);
+  EXPECT_LE(
+      params->batches_per_block_inner_reduction,
+      default_params->batches_per_block_inner_reduction);
+  EXPECT_LE(
+      params->unroll_factor_iter_dom, default_params->unroll_factor_iter_dom);
+  EXPECT_LE(pressure.registers, default_pressure.registers);
+}
+
+} // namespace nvfuser
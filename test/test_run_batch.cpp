@@ -0,0 +1,120 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+
+#include <test/utils.h>
+#include <test/validator.h>
+
+#include <torch/torch.h>
+
+namespace nvfuser {
+
+class RunBatchTest : public NVFuserTest {};
+
+// Sets of inputs of two signatures, interleaved
+TEST_F(RunBatchTest, Signatures_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeContigTensor(2);
+  auto s1 = IrBuilder::create<Val>(DataType::Double);
+  fusion->addInput(tv0);
+  fusion->addInput(s1);
+  auto tv2 = mul(tv0, s1);
+  fusion->addOutput(tv2);
+  fusion->addOutput(sum(tv2, {1}));
+  FusionExecutorCache fec(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<std::vector<c10::IValue>> batch;
+  for (auto i : c10::irange(6)) {
+    auto t0 = i % 2 ? at::randn({8, 1024}, options)
+                    : at::randn({128, 32}, options);
+    batch.push_back({t0, (double)i});
+  }
+
+  auto outputs = fec.runFusionWithInputsBatch(batch);
+  ASSERT_EQ(outputs.size(), batch.size());
+  for (auto i : c10::irange(batch.size())) {
+    auto t0 = batch.at(i).at(0).toTensor();
+    auto t2 = t0 * batch.at(i).at(1).toDouble();
+    testValidate(
+        fec.fusion(),
+        outputs.at(i),
+        batch.at(i),
+        {t2, t2.sum({1})},
+        __LINE__,
+        __FILE__);
+  }
+}
+
+// Sets of inputs with the same sizes and strides but a different alignment
+// have different signatures and don't share the cache id of their arguments
+TEST_F(RunBatchTest, Alignment_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  fusion->addOutput(add(tv0, IrBuilder::create<Val>(1.0)));
+  FusionExecutorCache fec(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<std::vector<c10::IValue>> batch;
+  for (auto i : c10::irange(4)) {
+    auto t0 = at::randn({1025}, options).narrow(0, i % 2, 1024);
+    batch.push_back({t0});
+  }
+
+  auto outputs = fec.runFusionWithInputsBatch(batch);
+  ASSERT_EQ(outputs.size(), batch.size());
+  for (auto i : c10::irange(batch.size())) {
+    auto t0 = batch.at(i).at(0).toTensor();
+    testValidate(
+        fec.fusion(), outputs.at(i), batch.at(i), {t0 + 1}, __LINE__, __FILE__);
+  }
+}
+
+// Aliased outputs update their input and are not returned, as with
+// runFusionWithInputs
+TEST_F(RunBatchTest, AliasedOutput_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = add(tv0, IrBuilder::create<Val>(1.0));
+  fusion->addOutput(tv2);
+  fusion->aliasOutputToInput(add(tv1, IrBuilder::create<Val>(1.0)), tv1);
+  FusionExecutorCache fec(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<std::vector<c10::IValue>> batch;
+  std::vector<at::Tensor> originals;
+  for (auto i : c10::irange(3)) {
+    (void)i;
+    auto t1 = at::randn({16, 64}, options);
+    originals.push_back(t1.clone());
+    batch.push_back({at::randn({16, 64}, options), t1});
+  }
+
+  auto outputs = fec.runFusionWithInputsBatch(batch);
+  for (auto i : c10::irange(batch.size())) {
+    ASSERT_EQ(outputs.at(i).size(), 1);
+    EXPECT_TRUE(outputs.at(i).at(0).allclose(batch.at(i).at(0).toTensor() + 1));
+    EXPECT_TRUE(batch.at(i).at(1).toTensor().allclose(originals.at(i) + 1));
+  }
+}
+
+} // namespace nvfuser
@@ -0,0 +1,336 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <device_lower/lower2device.h>
+#include <executor.h>
+#include <expr_evaluator.h>
+#include <inlining.h>
+#include <ir/all_nodes.h>
+#include <ir/builder.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+#include <scheduler/all_schedulers.h>
+
+#include <test/utils.h>
+#include <test/validator.h>
+
+#include <torch/torch.h>
+
+namespace nvfuser {
+
+class ScanTest : public NVFuserTest {};
+
+namespace {
+
+// Reference of an exclusive scan from an inclusive one
+at::Tensor exclusiveScan(
+    at::Tensor inclusive,
+    int64_t dim,
+    const at::Scalar& init) {
+  auto first = at::full_like(inclusive.narrow(dim, 0, 1), init);
+  return at::cat(
+      {first, inclusive.narrow(dim, 0, inclusive.size(dim) - 1)}, dim);
+}
+
+} // namespace
+
+// Evaluate scans on CPU with ExpressionEvaluator
+TEST_F(ScanTest, EvaluateCpu) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = cumsum(tv0, 1);
+  auto tv2 = cumsum(tv0, 0, /*is_exclusive=*/true);
+  auto tv3 = cumprod(tv0, -1);
+  auto tv4 = cummax(tv0, 0);
+  auto tv5 = cummin(tv0, 1, /*is_exclusive=*/true);
+  fusion.addOutput(tv1);
+  fusion.addOutput(tv2);
+  fusion.addOutput(tv3);
+  fusion.addOutput(tv4);
+  fusion.addOutput(tv5);
+
+  auto t0 = at::randn({7, 9}, at::TensorOptions().dtype(at::kFloat));
+
+  ExpressionEvaluator ee;
+  ee.bind(tv0, t0);
+
+  EXPECT_TRUE(at::allclose(
+      ee.evaluate(tv1).as<at::Tensor>(), at::cumsum(t0, 1)));
+  EXPECT_TRUE(at::allclose(
+      ee.evaluate(tv2).as<at::Tensor>(),
+      exclusiveScan(at::cumsum(t0, 0), 0, 0)));
+  EXPECT_TRUE(at::allclose(
+      ee.evaluate(tv3).as<at::Tensor>(), at::cumprod(t0, 1)));
+  EXPECT_TRUE(at::equal(
+      ee.evaluate(tv4).as<at::Tensor>(), std::get<0>(at::cummax(t0, 0))));
+  EXPECT_TRUE(at::equal(
+      ee.evaluate(tv5).as<at::Tensor>(),
+      exclusiveScan(
+          std::get<0>(at::cummin(t0, 1)),
+          1,
+          std::numeric_limits<double>::infinity())));
+}
+
+// The initial value keeps its type, e.g., complex, when evaluated
+TEST_F(ScanTest, EvaluateComplexInit) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(1, DataType::ComplexDouble);
+  fusion.addInput(tv0);
+  auto init = IrBuilder::create<Val>(
+      std::complex<double>(1.0, -2.0), DataType::ComplexDouble);
+  auto tv1 = scanOp(BinaryOpType::Add, 0, init, tv0);
+  auto tv2 = scanOp(BinaryOpType::Mul, 0, init, tv0, /*is_exclusive=*/true);
+  fusion.addOutput(tv1);
+  fusion.addOutput(tv2);
+
+  auto t0 = at::randn({17}, at::TensorOptions().dtype(at::kComplexDouble));
+  const c10::complex<double> init_value(1.0, -2.0);
+
+  ExpressionEvaluator ee;
+  ee.bind(tv0, t0);
+
+  EXPECT_TRUE(at::allclose(
+      ee.evaluate(tv1).as<at::Tensor>(), at::cumsum(t0, 0) + init_value));
+  EXPECT_TRUE(at::allclose(
+      ee.evaluate(tv2).as<at::Tensor>(),
+      exclusiveScan(at::cumprod(t0, 0) * init_value, 0, init_value)));
+}
+
+// Integral and boolean inputs are promoted to Int as with sum
+TEST_F(ScanTest, IntegralPromotion) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(1, DataType::Bool);
+  fusion.addInput(tv0);
+  auto tv1 = cumsum(tv0, 0);
+  fusion.addOutput(tv1);
+
+  EXPECT_EQ(tv1->getDataType(), DataType::Int);
+
+  auto t0 = at::randn({33}, at::TensorOptions().dtype(at::kFloat)) > 0;
+
+  ExpressionEvaluator ee;
+  ee.bind(tv0, t0);
+  EXPECT_TRUE(at::equal(ee.evaluate(tv1).as<at::Tensor>(), at::cumsum(t0, 0)));
+}
+
+// Manually scheduled scan along the innermost axis
+TEST_F(ScanTest, InnerScan_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = mul(tv0, IrBuilder::create<Val>(2.0));
+  auto tv2 = cumsum(tv1, 1);
+  auto tv3 = cumsum(tv1, 1, /*is_exclusive=*/true);
+  auto tv4 = add(tv2, tv3);
+  fusion.addOutput(tv4);
+
+  tv4->split(0, 128);
+  TransformPropagatorWithCheck propagator(tv4);
+  MaxRootDomainInfoSpanningTree(tv4).traverse(&propagator);
+  tv4->axis(0)->parallelize(ParallelType::BIDx);
+  tv4->axis(1)->parallelize(ParallelType::TIDx);
+  scheduler_utils::parallelizeAllLike(tv4);
+  inlineMost();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({1000, 37}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  auto cg_outputs = fe.runFusion({t0});
+
+  auto t1 = at::cumsum(t0 * 2, 1);
+  auto t4 = t1 + exclusiveScan(t1, 1, 0);
+  testValidate(&fusion, cg_outputs, {t0}, {t4}, __LINE__, __FILE__);
+}
+
+// Parallelizing the scanned axis is not supported
+TEST_F(ScanTest, ParallelScanNotSupported_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = cumsum(tv0, 0);
+  fusion.addOutput(tv1);
+
+  tv1->axis(0)->parallelize(ParallelType::TIDx);
+
+  EXPECT_THAT(
+      [&]() { GpuLower gpulw(&fusion); },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(::testing::HasSubstr(
+          "Scan along a parallelized axis is not supported")));
+}
+
+// Scanned axis split into a serial loop and TIDx, scanned by the threads of
+// a block together
+TEST_F(ScanTest, BlockScan_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = cumsum(tv0, 1);
+  auto tv2 = cummax(tv0, 1, /*is_exclusive=*/true);
+  fusion.addOutput(tv1);
+  fusion.addOutput(tv2);
+
+  for (auto tv : {tv1, tv2}) {
+    // [BIDx, serial, TIDx]
+    tv->split(1, 128);
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(2)->parallelize(ParallelType::TIDx);
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  // The scanned extent is not divisible by the number of threads
+  auto t0 = at::randn({5, 1000}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  EXPECT_TRUE(fe.kernel()->summary().has_block_scans);
+  auto cg_outputs = fe.runFusion({t0});
+
+  auto t1 = at::cumsum(t0, 1);
+  auto t2 = exclusiveScan(
+      std::get<0>(at::cummax(t0, 1)),
+      1,
+      -std::numeric_limits<double>::infinity());
+  testValidate(&fusion, cg_outputs, {t0}, {t1, t2}, __LINE__, __FILE__);
+}
+
+// Scans over a vocabulary, as in top-p sampling. There are too few rows for
+// serial scans, so the pointwise scheduler uses a block scan.
+TEST_F(ScanTest, LongScan_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = cumsum(exp(tv0), 1);
+  fusion.addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({4, 32000}, options);
+  std::vector<c10::IValue> aten_inputs = {t0};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  const auto& heuristic =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  EXPECT_EQ(heuristic->heuristic(), ScheduleHeuristic::PointWise);
+  EXPECT_GT(heuristic->pointwiseParams().scan_bdimx, 0);
+
+  // The sums are accumulated in a different order than ATen's
+  EXPECT_TRUE(at::allclose(
+      cg_outputs.at(0), at::cumsum(t0.exp(), 1), /*rtol=*/1e-4, /*atol=*/1e-4));
+}
+
+// Scans fused with pointwise ops by the pointwise scheduler
+TEST_F(ScanTest, FusedWithPointwise_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  // Positions from a mask, as in packed sequences
+  auto tv0 = makeContigTensor(2, DataType::Bool);
+  auto tv1 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = cumsum(tv0, 1, /*is_exclusive=*/true);
+  auto tv3 = where(tv0, tv2, IrBuilder::create<Val>(-1L));
+  auto tv4 = cummax(exp(tv1), 0);
+  auto tv5 = sub(tv4, tv1);
+  fusion.addOutput(tv3);
+  fusion.addOutput(tv5);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({129, 255}, options) > 0;
+  auto t1 = at::randn({129, 255}, options);
+  std::vector<c10::IValue> aten_inputs = {t0, t1};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  // The two scans are not along the same axis of the reference
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_TRUE(runtime->isSegmented());
+  for (const auto& heuristic :
+       runtime->schedulerHeuristics()->heuristicsList()) {
+    EXPECT_EQ(heuristic->heuristic(), ScheduleHeuristic::PointWise);
+  }
+
+  auto t2 = exclusiveScan(at::cumsum(t0, 1), 1, 0);
+  auto t3 = at::where(t0, t2, -1);
+  auto t5 = std::get<0>(at::cummax(t1.exp(), 0)) - t1;
+  testValidate(
+      executor_cache.fusion(),
+      cg_outputs,
+      aten_inputs,
+      {t3, t5},
+      __LINE__,
+      __FILE__);
+}
+
+TEST_F(ScanTest, SingleSegment_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(3);
+  auto tv1 = makeContigTensor(1);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = add(tv0, broadcast(tv1, {true, true, false}));
+  auto tv3 = cumprod(tv2, 1);
+  auto tv4 = cumsum(neg(tv2), 1);
+  auto tv5 = add(tv3, tv4);
+  fusion.addOutput(tv5);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::rand({8, 31, 65}, options);
+  auto t1 = at::rand({65}, options);
+  std::vector<c10::IValue> aten_inputs = {t0, t1};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  EXPECT_EQ(
+      runtime->schedulerHeuristics()->heuristicsList().at(0)->heuristic(),
+      ScheduleHeuristic::PointWise);
+
+  auto t2 = t0 + t1;
+  auto t5 = at::cumprod(t2, 1) + at::cumsum(-t2, 1);
+  testValidate(
+      executor_cache.fusion(),
+      cg_outputs,
+      aten_inputs,
+      {t5},
+      __LINE__,
+      __FILE__);
+}
+
+} // namespace nvfuser
@@ -0,0 +1,289 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <gtest/gtest.h>
+
+#include <expr_evaluator.h>
+#include <fusion_segmenter.h>
+#include <ir/all_nodes.h>
+#include <ops/all_ops.h>
+#include <scheduler/all_schedulers.h>
+#include <scheduler/cost_model.h>
+
+#include <test/utils.h>
+
+#include <torch/torch.h>
+
+namespace nvfuser {
+
+class SegmentCostModelTest : public NVFuserTest {};
+
+namespace {
+
+// Only sizes are needed by the cost model
+at::Tensor metaTensor(at::IntArrayRef sizes, at::ScalarType dtype) {
+  return at::empty(sizes, at::TensorOptions().dtype(dtype).device(at::kMeta));
+}
+
+// Sum of the costs of kernels given by their inputs and outputs
+KernelCost segmentationCost(
+    const SegmentCostModel& model,
+    const std::vector<std::pair<std::vector<Val*>, std::vector<Val*>>>&
+        kernels,
+    ExpressionEvaluator& ee) {
+  KernelCost cost;
+  for (const auto& [inputs, outputs] : kernels) {
+    cost += model.estimate(inputs, outputs, ee);
+  }
+  return cost;
+}
+
+} // namespace
+
+// A single layer norm backward kernel is preferred over computing the
+// input and parameter gradients separately, which reads the inputs
+// twice
+TEST_F(SegmentCostModelTest, LayerNormBackward) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  const int64_t m = 8192;
+  const int64_t n = 1024;
+
+  auto dy = makeContigTensor(2);
+  auto x = makeContigTensor(2);
+  auto mean = makeConcreteTensor({-1, 1});
+  auto rstd = makeConcreteTensor({-1, 1});
+  auto weight = makeContigTensor(1);
+  auto bias = makeContigTensor(1);
+  fusion.addInput(dy);
+  fusion.addInput(x);
+  fusion.addInput(mean);
+  fusion.addInput(rstd);
+  fusion.addInput(weight);
+  fusion.addInput(bias);
+
+  auto grads = layer_norm_backward(
+      dy, x, {n}, mean, rstd, weight, bias, {true, true, true});
+  fusion.addOutput(grads.grad_input);
+  fusion.addOutput(grads.grad_weight);
+  fusion.addOutput(grads.grad_bias);
+
+  ExpressionEvaluator ee;
+  ee.bind(dy, metaTensor({m, n}, at::kFloat));
+  ee.bind(x, metaTensor({m, n}, at::kFloat));
+  ee.bind(mean, metaTensor({m, 1}, at::kFloat));
+  ee.bind(rstd, metaTensor({m, 1}, at::kFloat));
+  ee.bind(weight, metaTensor({n}, at::kFloat));
+  ee.bind(bias, metaTensor({n}, at::kFloat));
+
+  AnalyticalCostModel model;
+
+  auto single = model.estimate(&fusion, ee);
+  EXPECT_EQ(single.num_launches, 1);
+  EXPECT_EQ(single.bytes_read, (2 * m * n + 2 * m + 2 * n) * 4);
+  EXPECT_EQ(single.bytes_written, (m * n + 2 * n) * 4);
+
+  auto split = segmentationCost(
+      model,
+      {{{dy, x, mean, rstd, weight}, {grads.grad_input}},
+       {{dy, x, mean, rstd}, {grads.grad_weight, grads.grad_bias}}},
+      ee);
+  EXPECT_EQ(split.num_launches, 2);
+  EXPECT_GT(split.bytes_read, single.bytes_read);
+  EXPECT_LT(single.time_us, split.time_us);
+}
+
+// Splitting softmax from dropout materializes the softmax output,
+// which is written once and read back
+TEST_F(SegmentCostModelTest, SoftmaxDropout) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  const int64_t m = 4096;
+  const int64_t n = 2048;
+
+  auto x = makeContigTensor(2, DataType::Half);
+  fusion.addInput(x);
+  auto x_float = castOp(DataType::Float, x);
+  auto y = softmax(x_float, 1);
+  auto y_half = castOp(DataType::Half, y);
+  auto dropout_results = dropout(y_half, IrBuilder::create<Val>(0.9));
+  auto out = castOp(DataType::Half, dropout_results.output);
+  fusion.addOutput(out);
+  fusion.addOutput(dropout_results.mask);
+
+  ExpressionEvaluator ee;
+  ee.bind(x, metaTensor({m, n}, at::kHalf));
+
+  AnalyticalCostModel model;
+
+  auto single = model.estimate(&fusion, ee);
+  auto split = segmentationCost(
+      model,
+      {{{x}, {y_half}}, {{y_half}, {out, dropout_results.mask}}},
+      ee);
+  auto split_float = segmentationCost(
+      model, {{{x}, {y}}, {{y}, {out, dropout_results.mask}}}, ee);
+
+  // The softmax output is written and read in half precision
+  EXPECT_EQ(split.bytes_read - single.bytes_read, m * n * 2);
+  EXPECT_EQ(split.bytes_written - single.bytes_written, m * n * 2);
+
+  EXPECT_LT(single.time_us, split.time_us);
+  EXPECT_LT(split.time_us, split_float.time_us);
+}
+
+// Broadcast domains are not materialized
+TEST_F(SegmentCostModelTest, BroadcastBytes) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeConcreteTensor({1, -1});
+  auto tv1 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = add(tv0, tv1);
+  auto tv3 = sum(tv2, {1});
+  fusion.addOutput(tv3);
+
+  ExpressionEvaluator ee;
+  ee.bind(tv0, metaTensor({1, 100}, at::kFloat));
+  ee.bind(tv1, metaTensor({10, 100}, at::kFloat));
+
+  AnalyticalCostModel model;
+  auto cost = model.estimate(&fusion, ee);
+  EXPECT_EQ(cost.bytes_read, (100 + 1000) * 4);
+  EXPECT_EQ(cost.bytes_written, 10 * 4);
+}
+
+// Launches too small to fill the device are penalized
+TEST_F(SegmentCostModelTest, Occupancy) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = neg(tv0);
+  fusion.addOutput(tv1);
+
+  ExpressionEvaluator ee;
+  ee.bind(tv0, metaTensor({1 << 20}, at::kFloat));
+
+  DeviceModel device;
+  AnalyticalCostModel model(device);
+
+  PointwiseParams unset_params;
+  PointwiseParams full_params;
+  full_params.lparams = LaunchParams(4 * device.num_sms, -1, -1, 512);
+  PointwiseParams small_params;
+  small_params.lparams = LaunchParams(1, -1, -1, 128);
+
+  EXPECT_DOUBLE_EQ(model.occupancy(unset_params.lparams), 1.0);
+  EXPECT_DOUBLE_EQ(model.occupancy(full_params.lparams), 1.0);
+  EXPECT_LT(model.occupancy(small_params.lparams), 0.01);
+
+  auto full = model.estimate(&fusion, ee, &full_params);
+  auto small = model.estimate(&fusion, ee, &small_params);
+  EXPECT_EQ(full.bytes_read, small.bytes_read);
+  EXPECT_LT(full.time_us, small.time_us);
+
+  // Shared memory limits the number of resident blocks
+  PointwiseParams smem_params = full_params;
+  smem_params.lparams.setSmem(device.smem_per_sm_bytes);
+  EXPECT_LT(model.occupancy(smem_params.lparams), 1.0);
+}
+
+// The occupancy of a sum of kernels is weighted by their times
+TEST_F(SegmentCostModelTest, SumOccupancy) {
+  KernelCost long_full;
+  long_full.num_launches = 1;
+  long_full.occupancy = 1.0;
+  long_full.time_us = 30.0;
+  KernelCost short_small;
+  short_small.num_launches = 1;
+  short_small.occupancy = 0.2;
+  short_small.time_us = 10.0;
+
+  KernelCost sum = long_full;
+  sum += short_small;
+  EXPECT_EQ(sum.num_launches, 2);
+  EXPECT_DOUBLE_EQ(sum.time_us, 40.0);
+  EXPECT_DOUBLE_EQ(sum.occupancy, 0.8);
+
+  // The order of the kernels doesn't matter
+  KernelCost reversed = short_small;
+  reversed += long_full;
+  EXPECT_DOUBLE_EQ(reversed.occupancy, sum.occupancy);
+}
+
+namespace {
+
+// Reject persistent kernels regardless of the memory traffic
+class NoPersistentCostModel : public SegmentCostModel {
+ public:
+  using SegmentCostModel::estimate;
+
+  KernelCost estimate(
+      const std::vector<Val*>& inputs,
+      const std::vector<Val*>& outputs,
+      ExpressionEvaluator& ee,
+      const HeuristicParams* params) const override {
+    KernelCost cost;
+    cost.num_launches = 1;
+    auto rparams = dynamic_cast<const ReductionParams*>(params);
+    cost.time_us =
+        (rparams != nullptr && rparams->persistent_kernel) ? 1e6 : 1.0;
+    return cost;
+  }
+};
+
+std::unique_ptr<Fusion> makeNormalizationFusion() {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = broadcast(tv1, {false, true});
+  auto tv3 = sub(tv0, tv2);
+  fusion->addOutput(tv3);
+  return fusion;
+}
+
+} // namespace
+
+// The segmenter only takes merges the cost model considers profitable
+TEST_F(SegmentCostModelTest, SegmenterUsesCostModel_CUDA) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 1024}, options);
+
+  KernelArgumentHolder args;
+  args.setDeviceIndex(0);
+  args.push(t0);
+
+  auto fusion = makeNormalizationFusion();
+
+  SegmentCandidateFinderOptions analytical_options;
+  analytical_options.cost_model =
+      std::make_shared<AnalyticalCostModel>(DeviceModel::current());
+  auto merged = SegmentCandidateFinder::segment(
+      fusion.get(), args, analytical_options);
+  EXPECT_EQ(merged->groups().size(), 1);
+
+  SegmentCandidateFinderOptions no_persistent_options;
+  no_persistent_options.cost_model = std::make_shared<NoPersistentCostModel>();
+  auto segmented = SegmentCandidateFinder::segment(
+      fusion.get(), args, no_persistent_options);
+  EXPECT_EQ(segmented->groups().size(), 2);
+  for (auto group : segmented->groups()) {
+    EXPECT_NE(group->heuristic(), ScheduleHeuristic::InnerPersistent);
+  }
+}
+
+} // namespace nvfuser
@@ -0,0 +1,105 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <gtest/gtest.h>
+
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+#include <options.h>
+
+#include <test/utils.h>
+#include <test/validator.h>
+
+#include <torch/torch.h>
+
+namespace nvfuser {
+
+class SegmentGraphTest : public NVFuserTest {
+ protected:
+  void SetUp() override {
+    NVFuserTest::SetUp();
+    EnableOptionsGuard::getCurOptions().set(EnableOption::SegmentGraph);
+  }
+
+ private:
+  EnableOptionsGuard opt_guard_;
+};
+
+TEST_F(SegmentGraphTest, Replay) {
+  auto fec = makeSegmentChain(3);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  // The first run records the graph, the others replay it
+  std::vector<at::Tensor> outputs;
+  std::vector<at::Tensor> inputs;
+  for (auto i : c10::irange(3)) {
+    (void)i;
+    inputs.push_back(at::randn({5, 33}, options));
+    outputs.push_back(fec->runFusionWithInputs({inputs.back()}).at(0));
+  }
+
+  auto runtime = fec->getMostRecentKernelRuntime();
+  EXPECT_TRUE(runtime->isSegmented());
+  EXPECT_EQ(runtime->fusionSegments()->groups().size(), 3);
+  EXPECT_EQ(runtime->numSegmentGraphs(), 1);
+
+  // Replays don't overwrite the outputs of earlier calls
+  for (auto i : c10::irange(inputs.size())) {
+    EXPECT_TRUE(at::allclose(outputs.at(i), inputs.at(i) * 8));
+  }
+}
+
+TEST_F(SegmentGraphTest, NewShapeRecordsNewGraph) {
+  auto fec = makeSegmentChain(2);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  auto t0 = at::randn({5, 33}, options);
+  auto t1 = at::randn({7, 65}, options);
+  for (auto i : c10::irange(2)) {
+    (void)i;
+    auto out0 = fec->runFusionWithInputs({t0}).at(0);
+    EXPECT_TRUE(at::allclose(out0, t0 * 4));
+    auto out1 = fec->runFusionWithInputs({t1}).at(0);
+    EXPECT_TRUE(at::allclose(out1, t1 * 4));
+  }
+  EXPECT_EQ(fec->getMostRecentKernelRuntime()->numSegmentGraphs(), 2);
+}
+
+// Scalars are baked into the graph, so other values run the segments
+// one by one
+TEST_F(SegmentGraphTest, ScalarInput) {
+  auto fec = makeSegmentChain(2, /*with_scalar=*/true);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  auto t0 = at::randn({5, 33}, options);
+  for (auto i : c10::irange(2)) {
+    (void)i;
+    auto out = fec->runFusionWithInputs({t0, 2.0}).at(0);
+    EXPECT_TRUE(at::allclose(out, t0 * 4));
+  }
+  auto out = fec->runFusionWithInputs({t0, 3.0}).at(0);
+  EXPECT_TRUE(at::allclose(out, t0 * 9));
+}
+
+TEST_F(SegmentGraphTest, DisabledByDefault) {
+  EnableOptionsGuard::getCurOptions().unset(EnableOption::SegmentGraph);
+  auto fec = makeSegmentChain(2);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  auto t0 = at::randn({5, 33}, options);
+  for (auto i : c10::irange(2)) {
+    (void)i;
+    auto out = fec->runFusionWithInputs({t0}).at(0);
+    EXPECT_TRUE(at::allclose(out, t0 * 4));
+  }
+  EXPECT_EQ(fec->getMostRecentKernelRuntime()->numSegmentGraphs(), 0);
+}
+
+} // namespace nvfuser
@@ -15,6 +15,7 @@
 #include <ir/utils.h>
 #include <kernel_cache.h>
 #include <ops/all_ops.h>
+#include <options.h>
 #include <test/utils.h>
 #include <test/validator.h>
 #include <utils.h>
@@ -415,4 +416,176 @@ TEST_F(SmemReuseTest, MultiplePromoteReuse) {
   }
 }
 
+// Lower the fusion and return the bytes of shared memory used by its
+// allocations
+int64_t loweredSmemUsage(Fusion* fusion) {
+  GpuLower gpulw(fusion);
+  ExpressionEvaluator ee;
+  int64_t smem_usage = 0;
+  for (auto alloc : gpulw.kernel()->summary().dynamic_smem_allocations) {
+    EXPECT_NE(alloc->address(), nullptr);
+    auto addr = ee.evaluate(alloc->address()).as<int64_t>();
+    auto size = ee.evaluate(alloc->size()).as<int64_t>() *
+        dataTypeSize(alloc->buffer()->dtype());
+    smem_usage = std::max(smem_usage, addr + size);
+  }
+  return smem_usage;
+}
+
+// The stack allocator only reclaims memory from the top of the stack, so a
+// long-lived allocation pushed on top of a dead one keeps the dead one's
+// memory in use
+//
+//   T  a ----- s0
+//   X  a --------------- s1
+//   Y            b ----------------------- d
+//   Z                        c ----- s2
+//
+// where s0, s1 and s2 synchronize each thread block. The stack allocator
+// pushes Y on top of X, and then Z on top of Y. The best-fit allocator
+// places Z where X and T were.
+TEST_F(SmemReuseTest, BestFitAvoidsFragmentation) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  int64_t H = 128, S = 8;
+
+  auto tv0 = full(
+      {IrBuilder::create<Val>(H)}, fusion->oneVal(), DataType::Float);
+  auto tv1 = set(tv0); // pos = a. T = tv1
+  tv1->setMemoryType(MemoryType::Shared);
+  auto tv2 = set(tv0); // X = tv2
+  tv2->setMemoryType(MemoryType::Shared);
+
+  auto tv3 = add(tv1, tv2);
+  fusion->addOutput(tv3);
+  auto tv4 = sum(tv3, {0}); // s0
+  fusion->addOutput(tv4);
+  tv4->axis(0)->parallelize(ParallelType::TIDx);
+
+  auto tv5 = full(
+      {IrBuilder::create<Val>(S)}, fusion->oneVal(), DataType::Float);
+  auto tv6 = mul(tv4, tv5); // pos = b. Y = tv6
+  tv6->setMemoryType(MemoryType::Shared);
+
+  auto tv7 = sum(tv6, {0});
+  auto tv8 = add(tv2, tv7); // Last read of X
+  fusion->addOutput(tv8);
+  auto tv9 = sum(tv8, {0}); // s1
+  fusion->addOutput(tv9);
+  tv9->axis(0)->parallelize(ParallelType::TIDx);
+
+  auto tv10 = full(
+      {IrBuilder::create<Val>(2 * H)}, fusion->oneVal(), DataType::Float);
+  auto tv11 = mul(tv9, tv10); // pos = c. Z = tv11
+  tv11->setMemoryType(MemoryType::Shared);
+  auto tv12 = sum(tv11, {0}); // s2
+  fusion->addOutput(tv12);
+  tv12->axis(0)->parallelize(ParallelType::TIDx);
+
+  auto tv13 = mul(tv12, tv6); // pos = d
+  fusion->addOutput(tv13);
+
+  const auto stack_usage = loweredSmemUsage(fusion.get());
+  EXPECT_EQ(stack_usage, alignInt(H * 4) + alignInt(S * 4) + 2 * H * 4);
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SmemBestFit);
+  const auto best_fit_usage = loweredSmemUsage(fusion.get());
+  EXPECT_EQ(best_fit_usage, alignInt(2 * H * 4) + S * 4);
+  EXPECT_LT(best_fit_usage, stack_usage);
+}
+
+// The best-fit allocator is only used when it needs less memory than the
+// stack allocator
+TEST_F(SmemReuseTest, BestFitNotWorse) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  int64_t H = 5;
+  needsReorderedPushDefinition(H);
+
+  const auto stack_usage = loweredSmemUsage(fusion.get());
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SmemBestFit);
+  EXPECT_LE(loweredSmemUsage(fusion.get()), stack_usage);
+}
+
+// Sizes that aren't constant are placed in slots that later allocations of
+// the same size reuse
+//
+//   T  a ----- s0
+//   X  a --------------- s1
+//   Y            b ----------------------- d
+//   Z                        c ----- s2
+//
+// where all four have the symbolic size h. The stack allocator pushes Y on
+// top of X, and then Z on top of Y. The best-fit allocator places Y where T
+// was and Z where X was.
+TEST_F(SmemReuseTest, BestFitSymbolicSizes) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  int64_t H = 128;
+  auto h = IrBuilder::create<Val>(DataType::Index);
+  fusion->addInput(h);
+
+  auto tv0 = full({h}, fusion->oneVal(), DataType::Float);
+  auto tv1 = set(tv0); // pos = a. T = tv1
+  tv1->setMemoryType(MemoryType::Shared);
+  auto tv2 = set(tv0); // X = tv2
+  tv2->setMemoryType(MemoryType::Shared);
+
+  auto tv3 = add(tv1, tv2);
+  fusion->addOutput(tv3);
+  auto tv4 = sum(tv3, {0}); // s0
+  fusion->addOutput(tv4);
+  tv4->axis(0)->parallelize(ParallelType::TIDx);
+
+  auto tv5 = full({h}, fusion->oneVal(), DataType::Float);
+  auto tv6 = mul(tv4, tv5); // pos = b. Y = tv6
+  tv6->setMemoryType(MemoryType::Shared);
+
+  auto tv7 = sum(tv6, {0});
+  auto tv8 = add(tv2, tv7); // Last read of X
+  fusion->addOutput(tv8);
+  auto tv9 = sum(tv8, {0}); // s1
+  fusion->addOutput(tv9);
+  tv9->axis(0)->parallelize(ParallelType::TIDx);
+
+  auto tv10 = full({h}, fusion->oneVal(), DataType::Float);
+  auto tv11 = mul(tv9, tv10); // pos = c. Z = tv11
+  tv11->setMemoryType(MemoryType::Shared);
+  auto tv12 = sum(tv11, {0}); // s2
+  fusion->addOutput(tv12);
+  tv12->axis(0)->parallelize(ParallelType::TIDx);
+
+  auto tv13 = mul(tv12, tv6); // pos = d
+  fusion->addOutput(tv13);
+
+  // Bytes used by the allocations of the lowered kernel with h = H
+  auto smem_usage = [&]() {
+    GpuLower gpulw(fusion.get());
+    ExpressionEvaluator ee;
+    ee.bind(gpulw.kernel()->inputs().at(0), H);
+    int64_t smem_usage = 0;
+    for (auto alloc : gpulw.kernel()->summary().dynamic_smem_allocations) {
+      EXPECT_NE(alloc->address(), nullptr);
+      auto addr = ee.evaluate(alloc->address()).as<int64_t>();
+      auto size = ee.evaluate(alloc->size()).as<int64_t>() *
+          dataTypeSize(alloc->buffer()->dtype());
+      smem_usage = std::max(smem_usage, addr + size);
+    }
+    return smem_usage;
+  };
+
+  const auto stack_usage = smem_usage();
+  EXPECT_EQ(stack_usage, 3 * H * 4);
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SmemBestFit);
+  EXPECT_EQ(smem_usage(), 2 * H * 4);
+}
+
 } // namespace nvfuser
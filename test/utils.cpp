@@ -8,7 +8,9 @@
 #include <test/utils.h>
 
 #include <c10/util/Exception.h>
+#include <c10/util/irange.h>
 
+#include <ir/builder.h>
 #include <ops/all_ops.h>
 
 #include <sstream>
@@ -739,4 +741,27 @@ size_t getATenRandomSeed() {
   return seed;
 }
 
+std::unique_ptr<FusionExecutorCache> makeSegmentChain(
+    int64_t num_segments,
+    bool with_scalar) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion_ptr->addInput(tv0);
+  Val* scalar = IrBuilder::create<Val>(2.0);
+  if (with_scalar) {
+    scalar = IrBuilder::create<Val>(DataType::Double);
+    fusion_ptr->addInput(scalar);
+  }
+  auto tv = tv0;
+  for (auto i : c10::irange(num_segments)) {
+    (void)i;
+    tv = segment_set(mul(tv, scalar));
+  }
+  fusion_ptr->addOutput(tv);
+
+  return std::make_unique<FusionExecutorCache>(std::move(fusion_ptr));
+}
+
 } // namespace nvfuser
@@ -631,4 +631,10 @@ TensorView* biasEpilogue(TensorView* tensor, TensorView* bias);
 // Utility to generate tensor with bias applied on the input tensor,
 // to be used to caldulate reference data
 at::Tensor atBiasEpilogue(const at::Tensor& tensor, const at::Tensor& bias);
+
+// A chain of pointwise ops broken into num_segments kernels. Each segment
+// multiplies by 2, or by a Double scalar input if with_scalar.
+std::unique_ptr<FusionExecutorCache> makeSegmentChain(
+    int64_t num_segments,
+    bool with_scalar = false);
 } // namespace nvfuser